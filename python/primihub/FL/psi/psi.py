@@ -18,7 +18,7 @@ def sample_alignment(X, id, roles, protocol: str):
     parties = guest
     receiver = host
 
-    valid_psi_protocel = {"ECDH", "KKRT"}
+    valid_psi_protocel = {"ECDH", "KKRT", "MT_KKRT", "CM20"}
     protocol = protocol.upper()
     if protocol not in valid_psi_protocel:
         raise ValueError(
@@ -27,6 +27,8 @@ def sample_alignment(X, id, roles, protocol: str):
     protocol = {
         "ECDH": PsiType.ECDH,
         "KKRT": PsiType.KKRT,
+        "MT_KKRT": PsiType.MT_KKRT,
+        "CM20": PsiType.CM20,
     }[protocol]
 
     if is_integer_dtype(input):
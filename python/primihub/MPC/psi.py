@@ -22,6 +22,8 @@ from primihub.utils.logger_util import logger
 class PsiType(Enum):
     KKRT = "KKRT"
     ECDH = "ECDH"
+    MT_KKRT = "MT_KKRT"
+    CM20 = "CM20"
 
 class DataType(Enum):
     Interger = 0
@@ -43,3 +43,37 @@ class MPCJointStatistics:
         """
         return self.mpc_executor.sum(input)
 
+
+    def open_session(self):
+        """
+        set up the mpc channels once, following max/min/avg/sum/batch
+        calls reuse them until close_session.
+        all parties must issue the same sequence of calls in the session
+        """
+        self.mpc_executor.open_session()
+
+    def close_session(self):
+        self.mpc_executor.close_session()
+
+    def batch(self, requests):
+        """
+        Input:
+          requests: list of (statistics, value, rows), statistics is one of
+            max, min, avg, sum, rows is only used by avg
+        Output:
+          result of each request
+        """
+        items = []
+        for item in requests:
+            op, value = item[0], item[1]
+            rows = item[2] if len(item) > 2 else 0
+            items.append((op, float(value), int(rows)))
+        return self.mpc_executor.execute_batch(items)
+
+    def __enter__(self):
+        self.open_session()
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close_session()
+        return False
@@ -105,38 +105,57 @@ class WorkerClient:
                 4: "FINISHED"
             }
             party_status = {}
-            is_fail = False
-
-            while True:
-                time.sleep(1)
+            fail_status = []
+
+            def handle_status(task_status):
+                """return True once the task has finished"""
+                party = task_status.party
+                status = task_status.status
+
+                if status == worker_pb2.TaskStatus.StatusCode.FAIL or \
+                   status == worker_pb2.TaskStatus.StatusCode.NONEXIST:
+                    fail_status.append(task_status)
+                    return True
+
+                if party:
+                    print('party:', party)
+                    print('status:', status_map[status])
+                    print(20*'-')
+
+                    if status != worker_pb2.TaskStatus.StatusCode.RUNNING:
+                        party_status[party] = status_map[status]
+
+                return len(party_status) == PushTaskReply.party_count
+
+            # status is pushed by the server as soon as it is updated
+            is_finished = False
+            try:
+                status_stream = self.stub.WatchTaskStatus(task_info)
+                for task_status in status_stream:
+                    if handle_status(task_status):
+                        is_finished = True
+                        status_stream.cancel()
+                        break
+            except grpc.RpcError as e:
+                print(f'watch task status failed: {e.code()}, '
+                      'fall back to fetch task status')
 
+            # for server without WatchTaskStatus
+            fetch_interval = 0.1
+            while not is_finished:
                 TaskStatusReply = self.stub.FetchTaskStatus(task_info)
                 for task_status in TaskStatusReply.task_status:
-                    party = task_status.party
-                    status = task_status.status
-
-                    if status == worker_pb2.TaskStatus.StatusCode.FAIL or \
-                       status == worker_pb2.TaskStatus.StatusCode.NONEXIST:
-                        is_fail = True
-
-                    if is_fail:
+                    if handle_status(task_status):
+                        is_finished = True
                         break
-
-                    if party:
-                        print('party:', party)
-                        print('status:', status_map[status])
-                        print(20*'-')
-
-                        if status != worker_pb2.TaskStatus.StatusCode.RUNNING:
-                            party_status[party] = status_map[status]
-
-                if is_fail or len(party_status) == PushTaskReply.party_count:
-                    break
+                if not is_finished:
+                    time.sleep(fetch_interval)
+                    fetch_interval = min(fetch_interval * 2, 1)
 
             end_time = time.time()
             print(f'time spend: {end_time - start_time:.3f} s')
 
-            if is_fail:
-                print(f"fail: {TaskStatusReply}")
+            if fail_status:
+                print(f"fail: {fail_status[0]}")
             else:
                 print(f'status: {party_status}')
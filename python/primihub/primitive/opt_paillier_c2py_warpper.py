@@ -143,3 +143,44 @@ def opt_paillier_cons_mul(pub, op1_cipher_text, op2_cons_value):
     opt_paillier_c2py.opt_paillier_cons_mul_warpper(cons_mul_res_cipher_text, op1_cipher_text, str(op2_cons_value), pub)
 
     return cons_mul_res_cipher_text
+
+# native handles: keys and ciphertexts stay in GMP form on the C++ side,
+# batch operations run on all cores with the GIL released
+OptPaillierPublicKey = opt_paillier_c2py.OptPaillierPublicKey
+OptPaillierSecretKey = opt_paillier_c2py.OptPaillierSecretKey
+OptPaillierCiphertextVector = opt_paillier_c2py.OptPaillierCiphertextVector
+
+def opt_paillier_keygen_native(k_sec = 112):
+
+    return opt_paillier_c2py.opt_paillier_keygen_native(k_sec)
+
+def opt_paillier_to_native_keys(pub, prv = None):
+
+    native_pub = OptPaillierPublicKey.from_legacy(pub)
+    native_prv = None if prv is None else OptPaillierSecretKey.from_legacy(prv)
+
+    return native_pub, native_prv
+
+def opt_paillier_encrypt_batch(pub, plain_texts, prv = None):
+    """
+    plain_texts: int64 numpy array or a list of int,
+    encryption uses CRT and fixed-base precomputation if prv is given
+    """
+    return opt_paillier_c2py.opt_paillier_encrypt_batch(pub, plain_texts, prv)
+
+def opt_paillier_decrypt_batch(pub, prv, cipher_texts):
+
+    return opt_paillier_c2py.opt_paillier_decrypt_batch(pub, prv, cipher_texts)
+
+def opt_paillier_add_batch(pub, op1_cipher_texts, op2_cipher_texts):
+
+    return opt_paillier_c2py.opt_paillier_add_batch(pub, op1_cipher_texts, op2_cipher_texts)
+
+def opt_paillier_cons_mul_batch(pub, cipher_texts, cons_values):
+    """
+    cons_values: int64 numpy array of the same length, or a single int
+    """
+    if isinstance(cons_values, int):
+        cons_values = [cons_values]
+
+    return opt_paillier_c2py.opt_paillier_cons_mul_batch(pub, cipher_texts, cons_values)
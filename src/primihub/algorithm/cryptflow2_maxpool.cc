@@ -9,6 +9,10 @@
 #include <glog/logging.h>
 #include <omp.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 using namespace std;
 using namespace primihub::sci;
 using namespace primihub::cryptflow2;
@@ -141,8 +145,23 @@ int MaxPoolExecutor::loadParams(primihub::rpc::Task &task) {
   __address = ep.ip();
   __port = ep.port();
 
+  auto p_it = param_map.find("NumThreads");
+  if (p_it != param_map.end()) {
+    __num_threads = std::max(p_it->second.value_int32(), 1);
+  }
+  p_it = param_map.find("BatchSize");
+  if (p_it != param_map.end()) {
+    batch_size = p_it->second.value_int32();
+  }
+  p_it = param_map.find("Verify");
+  if (p_it != param_map.end()) {
+    verify_ = p_it->second.value_int32() != 0;
+  }
+
   LOG(INFO) << "Notice: node " << node_id << ", party id " << __party
             << ", host " << __address << ", port " << __port << ".";
+  LOG(INFO) << "Maxpool runs with " << __num_threads << " threads, "
+            << "batch size " << batch_size << ", verify " << verify_ << ".";
 
   LOG(INFO) << "Input data " << input_filepath_ << ".";
 
@@ -211,6 +230,8 @@ int MaxPoolExecutor::loadDataset() {
 int MaxPoolExecutor::initPartyComm() {
   /********** Setup IO and Base OTs ***********/
   /********************************************/
+  iopackArr.resize(__num_threads, nullptr);
+  otpackArr.resize(__num_threads, nullptr);
   for (int i = 0; i < __num_threads; i++) {
     iopackArr[i] = new IOPack(__party, __port + i, __address);
     if (i & 1) {
@@ -226,24 +247,48 @@ int MaxPoolExecutor::initPartyComm() {
 
 int MaxPoolExecutor::execute() {
   auto start = clock_start();
-  int chunk_size = num_rows / __num_threads;
-  for (int i = 0; i < __num_threads; ++i) {
+  // both parties hold shares of the same shape, so they split rows alike
+  int thread_num = std::min(__num_threads, std::max(num_rows, 1));
+  int chunk_size = num_rows / thread_num;
+  std::vector<std::thread> threads;
+  threads.reserve(thread_num);
+  for (int i = 0; i < thread_num; ++i) {
     int offset = i * chunk_size;
     int lnum_rows;
-    if (i == (__num_threads - 1)) {
+    if (i == (thread_num - 1)) {
       lnum_rows = num_rows - offset;
     } else {
       lnum_rows = chunk_size;
     }
-    ring_maxpool_thread(i, z + offset, x + offset * num_cols, lnum_rows,
-                        num_cols);
+    threads.emplace_back(&MaxPoolExecutor::ring_maxpool_thread, this, i,
+                         z + offset, x + offset * num_cols, lnum_rows,
+                         num_cols);
+  }
+  for (auto &t : threads) {
+    t.join();
   }
 
   long long t = time_from(start);
 
+  LOG(INFO) << "Number of Maxpool rows (num_cols=" << num_cols << ")/s:\t"
+            << (double(num_rows) / t) * 1e6 << ", threads " << thread_num;
+  LOG(INFO) << "Maxpool Time (bitlength=" << __bitlength << "; b=" << b << ")\t"
+            << t << " mus";
+
+  int ret = 0;
+  if (verify_) {
+    ret = verify();
+  }
+
+  delete[] x;
+  delete[] z;
+  return ret;
+}
+
+int MaxPoolExecutor::verify(void) {
   /************** Verification ****************/
   /********************************************/
-
+  int ret = 0;
   switch (__party) {
   case primihub::sci::ALICE: {
     iopackArr[0]->io->send_data(x, sizeof(uint64_t) * num_rows * num_cols);
@@ -269,38 +314,35 @@ int MaxPoolExecutor::execute() {
                              ? xi[i * num_cols + c]
                              : maxpool_output;
       }
-      assert((zi[i] == maxpool_output) && "MaxPool output is incorrect");
-    }
-    LOG(INFO) << "Maxpool output:";
-    cout << "[";
-    for (int i = 0; i < num_rows; i++) {
-      std::cout << zi[i] << ", ";
+      if (zi[i] != maxpool_output) {
+        LOG(ERROR) << "MaxPool output is incorrect at row " << i << ", "
+                   << "expect " << maxpool_output << ", get " << zi[i];
+        ret = -1;
+        break;
+      }
+      VLOG(5) << "Maxpool output of row " << i << ": " << zi[i];
     }
-    std::cout << "] \n";
     delete[] xi;
     delete[] zi;
-    LOG(INFO) << "Maxpool Passed.";
+    if (ret == 0) {
+      LOG(INFO) << "Maxpool Passed.";
+    }
     break;
   }
   }
-
-  LOG(INFO) << "Number of Maxpool rows (num_cols=" << num_cols << ")/s:\t"
-            << (double(num_rows) / t) * 1e6 << std::endl;
-  LOG(INFO) << "Maxpool Time (bitlength=" << __bitlength << "; b=" << b << ")\t"
-            << t << " mus" << endl;
-
-  delete[] x;
-  delete[] z;
+  return ret;
 }
 
 int MaxPoolExecutor::finishPartyComm() {
   /******************* Cleanup ****************/
   /********************************************/
 
-  for (int i = 0; i < __num_threads; i++) {
+  for (size_t i = 0; i < iopackArr.size(); i++) {
     delete iopackArr[i];
     delete otpackArr[i];
   }
+  iopackArr.clear();
+  otpackArr.clear();
   return 0;
 }
 
@@ -317,11 +359,11 @@ void MaxPoolExecutor::ring_maxpool_thread(int tid, uint64_t *z, uint64_t *x,
   if (batch_size) {
     for (int j = 0; j < lnum_rows; j += batch_size) {
       if (batch_size <= lnum_rows - j) {
-        maxpool_oracle->funcMaxMPC(batch_size, lnum_cols, x + j, z + j,
-                                   nullptr);
+        maxpool_oracle->funcMaxMPC(batch_size, lnum_cols, x + j * lnum_cols,
+                                   z + j, nullptr);
       } else {
-        maxpool_oracle->funcMaxMPC(lnum_rows - j, lnum_cols, x + j, z + j,
-                                   nullptr);
+        maxpool_oracle->funcMaxMPC(lnum_rows - j, lnum_cols,
+                                   x + j * lnum_cols, z + j, nullptr);
       }
     }
   } else {
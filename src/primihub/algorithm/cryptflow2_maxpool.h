@@ -33,12 +33,11 @@
 
 #include <fstream>
 #include <thread>
+#include <vector>
 
 using namespace std;
 using namespace primihub::sci;
 
-#define MAX_THREADS 4
-
 namespace primihub::cryptflow2
 {
   class MaxPoolExecutor : public AlgorithmBase
@@ -65,13 +64,20 @@ namespace primihub::cryptflow2
     uint64_t *x;            // input
     uint64_t *z;            // output
 
-    IOPack *iopackArr[MAX_THREADS];
-    OTPack *otpackArr[MAX_THREADS];
+    // one IOPack and OTPack on port __port + i for the i-th thread
+    std::vector<IOPack *> iopackArr;
+    std::vector<OTPack *> otpackArr;
     void ring_maxpool_thread(int, uint64_t *, uint64_t *, int, int);
+    /**
+     * ALICE sends her shares of input and output to BOB, BOB reconstructs
+     * and checks every row, only for debug since it reveals the input
+    */
+    int verify(void);
 
     int __party = 0;                // __party ID
     int __bitlength = 32;           // __bitlength of input
     int __num_threads = 1;          // thread_number
+    bool verify_ = false;           // check output in plaintext after run
     string __address = "127.0.0.1"; // network __address
     int __port = 32000;             // network ports
   };
@@ -34,6 +34,8 @@
 #include <rapidjson/document.h>
 
 #include <float.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <limits>
 #include <utility>
@@ -94,6 +96,40 @@ int MissingProcess::_strToInt64(const std::string &str, int64_t &i64_val) {
   return 0;
 }
 
+double MissingProcess::maxOrMinOfAllParty(double local_value, bool has_value,
+                                          bool is_max) {
+  constexpr double kBound = MPCOperator::kMaxOrMinBound;
+  bool out_of_bound{false};
+  if (!has_value) {
+    local_value = is_max ? -kBound : kBound;
+  } else if (!(local_value >= -kBound && local_value <= kBound)) {
+    LOG(ERROR) << "value: " << local_value << " is out of the range of "
+               << "secure " << (is_max ? "max" : "min") << ": ["
+               << -kBound << ", " << kBound << "]";
+    out_of_bound = true;
+  }
+  // every party has to agree to stop before sharing
+  if (mpc_op_exec_->MaxOrMinOutOfBound(out_of_bound)) {
+    RaiseException("some party has a value out of the range of secure max "
+                   "or min");
+  }
+  eMatrix<double> m(1, 1);
+  m(0, 0) = local_value;
+  std::vector<sf64Matrix<D16>> sh_values;
+  for (uint32_t pid = 0; pid < 3; pid++) {
+    sf64Matrix<D16> sh_value(1, 1);
+    if (party_id_ == pid) {
+      mpc_op_exec_->createShares(m, sh_value);
+    } else {
+      mpc_op_exec_->createShares(sh_value);
+    }
+    sh_values.emplace_back(std::move(sh_value));
+  }
+  auto sh_result = mpc_op_exec_->MPC_MaxOrMin(std::move(sh_values), is_max);
+  eMatrix<double> result = mpc_op_exec_->revealAll(sh_result);
+  return result(0, 0);
+}
+
 int MissingProcess::_strToDouble(const std::string &str, double &d_val) {
   try {
     VLOG(5) << "Convert string '" << str << "' into double value.";
@@ -518,14 +554,10 @@ int MissingProcess::execute() {
       int64_t int_max = LONG_MIN;
       int64_t int_min = LONG_MAX;
       double double_min = DBL_MAX;
-      double double_max = DBL_MIN;
+      double double_max = -DBL_MAX;
       // 0:avge 1:max 2:min
       int process_type = 0;
       int col_index = -1;
-      double double_col_max = 0;
-      int64_t int_col_max = 0;
-      double double_col_min = 0;
-      int64_t int_col_min = 0;
 
       // For each column type of which maybe double or int64, read every row as
       // a string then try to convert string into int64 value or double value,
@@ -667,427 +699,33 @@ int MissingProcess::execute() {
 
         // MPC
         //.........................................................................................
-        const Decimal myD = D16;
         // 1:max 2:min 3:avg
         // enum replace { MAX, MIN, AVG };
         // replace replace_type = AVG;
 
-        if (replace_type_ == "MAX") {
-          if (iter->second == 1 || iter->second == 3) {
-            i64Matrix m(1, 1);
-
-            std::vector<bool> mpc_res;
-
-            m(0, 0) = int_max;
-            LOG(INFO) << "The max of party" << party_id_
-                      << " column is: " << int_max << ".";
-
-            sbMatrix sh_res;
-            // first compare:p0-p1
-            if (party_id_ != 2) {
-              mpc_op_exec_->MPC_Compare(m, sh_res);
-            } else {
-              mpc_op_exec_->MPC_Compare(sh_res);
-            }
-
-            i64Matrix tmp;
-            tmp.resize(sh_res.rows(), sh_res.i64Cols());
-            mpc_op_exec_->enc.revealAll(mpc_op_exec_->runtime, sh_res, tmp)
-                .get();
-            for (i64 i = 0; i < tmp.rows(); i++) {
-              mpc_res.emplace_back(static_cast<bool>(tmp(i, 0)));
-            }
-            LOG(INFO) << "Second: The revealed sh_res is " << tmp << ".";
-            LOG(INFO) << "Second: The mpc_res is " << mpc_res[0] << ".";
-            // second compare
-            // 0:p0 is greater
-            // 1:p1 is greater
-            // 2:p2
-            int flag = 0;
-            sbMatrix sh_res2;
-            for (size_t i = 0; i < mpc_res.size(); i++) {
-              // p0<p1
-              if (mpc_res[i]) {
-                flag = 1;
-                // p1-p2
-                if (party_id_ != 0) {
-                  mpc_op_exec_->MPC_Compare(m, sh_res2);
-                } else {
-                  mpc_op_exec_->MPC_Compare(sh_res2);
-                }
-              } else {
-                flag = 0;
-                // p0-p2
-                if (party_id_ != 1) {
-                  mpc_op_exec_->MPC_Compare(m, sh_res2);
-                } else {
-                  mpc_op_exec_->MPC_Compare(sh_res2);
-                }
-              }
-            }
-
-            std::vector<bool> mpc_res2;
-            i64Matrix tmp2;
-            tmp2.resize(sh_res2.rows(), sh_res2.i64Cols());
-            mpc_op_exec_->enc.revealAll(mpc_op_exec_->runtime, sh_res2, tmp2)
-                .get();
-            for (i64 i = 0; i < tmp2.rows(); i++) {
-              mpc_res2.emplace_back(static_cast<bool>(tmp2(i, 0)));
-            }
-
-            LOG(INFO) << "Second: The revealed sh_res2 is " << tmp2 << ".";
-            LOG(INFO) << "Second: The mpc_res2 is " << mpc_res2[0] << ".";
-
-            si64Matrix sh_max;
-            sh_max.resize(m.rows(), m.cols());
-            for (size_t i = 0; i < mpc_res2.size(); i++) {
-              // max is p2
-              if (mpc_res2[i]) {
-                flag = 2;
-                if (party_id_ == 2) {
-                  mpc_op_exec_->createShares(m, sh_max);
-                } else {
-                  mpc_op_exec_->createShares(sh_max);
-                }
-              } else {
-                // max is p0 or p1
-                if (flag == 0) {
-                  if (party_id_ == 0) {
-                    mpc_op_exec_->createShares(m, sh_max);
-                  } else {
-                    mpc_op_exec_->createShares(sh_max);
-                  }
-                } else if (flag == 1) {
-                  if (party_id_ == 1) {
-                    mpc_op_exec_->createShares(m, sh_max);
-                  } else {
-                    mpc_op_exec_->createShares(sh_max);
-                  }
-                }
-              }
-              i64Matrix plain_max(1, 1);
-              plain_max = mpc_op_exec_->revealAll(sh_max);
-              LOG(WARNING) << "The max value is " << plain_max << " in party "
-                           << flag << ".";
-              int_col_max = plain_max(0, 0);
-            }
-
-            replaceValue(iter, table, col_index, int_col_max, abnormal_index,
-                         use_db, false);
-          } else if (iter->second == 2) {
-            f64Matrix<myD> m(1, 1);
-
-            std::vector<bool> mpc_res;
-
-            m(0, 0) = double_max;
-            LOG(INFO) << "The max of party" << party_id_
-                      << " column is: " << double_max << ".";
-
-            sbMatrix sh_res;
-            // first compare:p0-p1
-            if (party_id_ != 2) {
-              mpc_op_exec_->MPC_Compare(m, sh_res);
-            } else {
-              mpc_op_exec_->MPC_Compare(sh_res);
-            }
-            LOG(INFO) << "The first compare is completely. ";
-
-            i64Matrix tmp;
-            tmp.resize(sh_res.rows(), sh_res.i64Cols());
-            mpc_op_exec_->enc.revealAll(mpc_op_exec_->runtime, sh_res, tmp)
-                .get();
-            for (i64 i = 0; i < tmp.rows(); i++) {
-              mpc_res.emplace_back(static_cast<bool>(tmp(i, 0)));
-            }
-
-            LOG(INFO) << "First: the revealed sh_res is " << tmp << ".";
-            LOG(INFO) << "First: The mpc_res is " << mpc_res[0] << ".";
-
-            // second compare
-            // 0:p0 is greater
-            // 1:p1 is greater
-            // 2:p2
-            int flag = 0;
-            sbMatrix sh_res2;
-            for (size_t i = 0; i < mpc_res.size(); i++) {
-              // p0<p1
-              if (mpc_res[i]) {
-                flag = 1;
-                // p1-p2
-                if (party_id_ != 0) {
-                  mpc_op_exec_->MPC_Compare(m, sh_res2);
-                } else {
-                  mpc_op_exec_->MPC_Compare(sh_res2);
-                }
-              } else {  // p0>=p1
-                flag = 0;
-                // p0-p2
-                if (party_id_ != 1) {
-                  mpc_op_exec_->MPC_Compare(m, sh_res2);
-                } else {
-                  mpc_op_exec_->MPC_Compare(sh_res2);
-                }
-              }
-            }
-
-            std::vector<bool> mpc_res2;
-            i64Matrix tmp2;
-            tmp2.resize(sh_res2.rows(), sh_res2.i64Cols());
-            mpc_op_exec_->enc.revealAll(mpc_op_exec_->runtime, sh_res2, tmp2)
-                .get();
-            for (i64 i = 0; i < tmp2.rows(); i++) {
-              mpc_res2.emplace_back(static_cast<bool>(tmp2(i, 0)));
-            }
-
-            LOG(INFO) << "Second: The revealed sh_res is " << tmp2 << ".";
-            LOG(INFO) << "Second: The mpc_res2 is " << mpc_res2[0] << ".";
-
-            sf64Matrix<myD> sh_max;
-            sh_max.resize(m.rows(), m.cols());
-            for (size_t i = 0; i < mpc_res2.size(); i++) {
-              // max is p2
-              if (mpc_res2[i]) {
-                flag = 2;
-                if (party_id_ == 2) {
-                  mpc_op_exec_->createShares(m, sh_max);
-                } else {
-                  mpc_op_exec_->createShares(sh_max);
-                }
-              } else {
-                // max is p0 or p1
-                if (flag == 0) {
-                  if (party_id_ == 0) {
-                    mpc_op_exec_->createShares(m, sh_max);
-                  } else {
-                    mpc_op_exec_->createShares(sh_max);
-                  }
-                } else if (flag == 1) {
-                  if (party_id_ == 1) {
-                    mpc_op_exec_->createShares(m, sh_max);
-                  } else {
-                    mpc_op_exec_->createShares(sh_max);
-                  }
-                }
-              }
-              eMatrix<double> plain_max(1, 1);
-              plain_max = mpc_op_exec_->revealAll(sh_max);
-              LOG(WARNING) << "The max value is " << plain_max << " in party "
-                           << flag << ".";
-              double_col_max = plain_max(0, 0);
-            }
-
-            replaceValue(iter, table, col_index, double_col_max, abnormal_index,
-                         use_db, true);
-          } else {
-            LOG(ERROR) << "Can't find value of column " << iter->first << ".";
-          }
-        } else if (replace_type_ == "MIN") {
+        if (replace_type_ == "MAX" || replace_type_ == "MIN") {
+          bool is_max = (replace_type_ == "MAX");
           if (iter->second == 1 || iter->second == 3) {
-            i64Matrix m(1, 1);
-
-            std::vector<bool> mpc_res;
-
-            m(0, 0) = int_min;
-            LOG(INFO) << "The min of party" << party_id_
-                      << " column is: " << int_min << ".";
-
-            sbMatrix sh_res;
-            // first compare:p0-p1
-            if (party_id_ != 2) {
-              mpc_op_exec_->MPC_Compare(m, sh_res);
-            } else {
-              mpc_op_exec_->MPC_Compare(sh_res);
-            }
-
-            i64Matrix tmp;
-            tmp.resize(sh_res.rows(), sh_res.i64Cols());
-            mpc_op_exec_->enc.revealAll(mpc_op_exec_->runtime, sh_res, tmp)
-                .get();
-            for (i64 i = 0; i < tmp.rows(); i++) {
-              mpc_res.emplace_back(static_cast<bool>(tmp(i, 0)));
-            }
-            LOG(INFO) << "Second: The revealed sh_res is " << tmp << ".";
-            LOG(INFO) << "Second: The mpc_res is " << mpc_res[0] << ".";
-            // second compare
-            // 0:p0 is greater
-            // 1:p1 is greater
-            // 2:p2
-            int flag = 0;
-            sbMatrix sh_res2;
-            for (size_t i = 0; i < mpc_res.size(); i++) {
-              // p0<p1
-              if (!mpc_res[i]) {
-                flag = 1;
-                // p1-p2
-                if (party_id_ != 0) {
-                  mpc_op_exec_->MPC_Compare(m, sh_res2);
-                } else {
-                  mpc_op_exec_->MPC_Compare(sh_res2);
-                }
-              } else {
-                flag = 0;
-                // p0-p2
-                if (party_id_ != 1) {
-                  mpc_op_exec_->MPC_Compare(m, sh_res2);
-                } else {
-                  mpc_op_exec_->MPC_Compare(sh_res2);
-                }
-              }
-            }
-
-            std::vector<bool> mpc_res2;
-            i64Matrix tmp2;
-            tmp2.resize(sh_res2.rows(), sh_res2.i64Cols());
-            mpc_op_exec_->enc.revealAll(mpc_op_exec_->runtime, sh_res2, tmp2)
-                .get();
-            for (i64 i = 0; i < tmp2.rows(); i++) {
-              mpc_res2.emplace_back(static_cast<bool>(tmp2(i, 0)));
-            }
-
-            LOG(INFO) << "Second: The revealed sh_res2 is " << tmp2 << ".";
-            LOG(INFO) << "Second: The mpc_res2 is " << mpc_res2[0] << ".";
-
-            si64Matrix sh_min;
-            sh_min.resize(m.rows(), m.cols());
-
-            for (size_t i = 0; i < mpc_res2.size(); i++) {
-              // min is p2
-              if (!mpc_res2[i]) {
-                flag = 2;
-                if (party_id_ == 2) {
-                  mpc_op_exec_->createShares(m, sh_min);
-                } else {
-                  mpc_op_exec_->createShares(sh_min);
-                }
-              } else {
-                // min is p0 or p1
-                if (flag == 0) {
-                  if (party_id_ == 0) {
-                    mpc_op_exec_->createShares(m, sh_min);
-                  } else {
-                    mpc_op_exec_->createShares(sh_min);
-                  }
-                } else if (flag == 1) {
-                  if (party_id_ == 1) {
-                    mpc_op_exec_->createShares(m, sh_min);
-                  } else {
-                    mpc_op_exec_->createShares(sh_min);
-                  }
-                }
-              }
-              i64Matrix plain_min(1, 1);
-              plain_min = mpc_op_exec_->revealAll(sh_min);
-              LOG(WARNING) << "The min value is " << plain_min << " in party "
-                           << flag << ".";
-              int_col_min = plain_min(0, 0);
-            }
-
-            replaceValue(iter, table, col_index, int_col_min, abnormal_index,
-                         use_db, false);
+            int64_t local_value = is_max ? int_max : int_min;
+            LOG(INFO) << "The " << replace_type_ << " of party" << party_id_
+                      << " column is: " << local_value << ".";
+            int64_t int_col_value =
+                std::llround(maxOrMinOfAllParty(local_value, int_count > 0,
+                                                is_max));
+            LOG(INFO) << "The " << replace_type_ << " value is "
+                      << int_col_value << ".";
+            replaceValue(iter, table, col_index, int_col_value,
+                         abnormal_index, use_db, false);
           } else if (iter->second == 2) {
-            f64Matrix<myD> m(1, 1);
-
-            std::vector<bool> mpc_res;
-
-            m(0, 0) = double_min;
-
-            LOG(INFO) << "The min of party" << party_id_
-                      << " column is: " << double_min << ".";
-
-            sbMatrix sh_res;
-            // first compare:p0-p1
-            if (party_id_ != 2) {
-              mpc_op_exec_->MPC_Compare(m, sh_res);
-            } else {
-              mpc_op_exec_->MPC_Compare(sh_res);
-            }
-            LOG(INFO) << "The first compare is completely. ";
-
-            i64Matrix tmp;
-            tmp.resize(sh_res.rows(), sh_res.i64Cols());
-            mpc_op_exec_->enc.revealAll(mpc_op_exec_->runtime, sh_res, tmp)
-                .get();
-            for (i64 i = 0; i < tmp.rows(); i++) {
-              mpc_res.emplace_back(static_cast<bool>(tmp(i, 0)));
-            }
-
-            LOG(INFO) << "First: the revealed sh_res is " << tmp << ".";
-            LOG(INFO) << "First: The mpc_res is " << mpc_res[0] << ".";
-
-            // second compare
-            // 0:p0 is greater
-            // 1:p1 is greater
-            // 2:p2
-            int flag = 0;
-            sbMatrix sh_res2;
-            for (size_t i = 0; i < mpc_res.size(); i++) {
-              // p0>=p1
-              if (!mpc_res[i]) {
-                flag = 1;
-                // p1-p2
-                if (party_id_ != 0) {
-                  mpc_op_exec_->MPC_Compare(m, sh_res2);
-                } else {
-                  mpc_op_exec_->MPC_Compare(sh_res2);
-                }
-              }
-              // p0<p1
-              else {     // NOLINT
-                flag = 0;
-                // p0-p2
-                if (party_id_ != 1) {
-                  mpc_op_exec_->MPC_Compare(m, sh_res2);
-                } else {
-                  mpc_op_exec_->MPC_Compare(sh_res2);
-                }
-              }
-            }
-
-            std::vector<bool> mpc_res2;
-            i64Matrix tmp2;
-            tmp2.resize(sh_res2.rows(), sh_res2.i64Cols());
-            mpc_op_exec_->enc.revealAll(mpc_op_exec_->runtime, sh_res2, tmp2)
-                .get();
-            for (i64 i = 0; i < tmp2.rows(); i++) {
-              mpc_res2.emplace_back(static_cast<bool>(tmp2(i, 0)));
-            }
-
-            sf64Matrix<myD> sh_min;
-            sh_min.resize(m.rows(), m.cols());
-            for (size_t i = 0; i < mpc_res2.size(); i++) {
-              // min is p2
-              if (!mpc_res2[i]) {
-                flag = 2;
-                if (party_id_ == 2) {
-                  mpc_op_exec_->createShares(m, sh_min);
-                } else {
-                  mpc_op_exec_->createShares(sh_min);
-                }
-              } else {
-                // min is p0 or p1
-                if (flag == 0) {
-                  if (party_id_ == 0) {
-                    mpc_op_exec_->createShares(m, sh_min);
-                  } else {
-                    mpc_op_exec_->createShares(sh_min);
-                  }
-                } else if (flag == 1) {
-                  if (party_id_ == 1) {
-                    mpc_op_exec_->createShares(m, sh_min);
-                  } else {
-                    mpc_op_exec_->createShares(sh_min);
-                  }
-                }
-              }
-              eMatrix<double> plain_min(1, 1);
-              plain_min = mpc_op_exec_->revealAll(sh_min);
-              LOG(WARNING) << "The min value is " << plain_min << " in party "
-                           << flag << ".";
-              double_col_min = plain_min(0, 0);
-            }
-
-            replaceValue(iter, table, col_index, double_col_min, abnormal_index,
-                         use_db, true);
+            double local_value = is_max ? double_max : double_min;
+            LOG(INFO) << "The " << replace_type_ << " of party" << party_id_
+                      << " column is: " << local_value << ".";
+            double double_col_value =
+                maxOrMinOfAllParty(local_value, double_count > 0, is_max);
+            LOG(INFO) << "The " << replace_type_ << " value is "
+                      << double_col_value << ".";
+            replaceValue(iter, table, col_index, double_col_value,
+                         abnormal_index, use_db, true);
           } else {
             LOG(ERROR) << "Can't find value of column " << iter->first << ".";
           }
@@ -57,6 +57,12 @@ class MissingProcess : public AlgorithmBase {
 
   int _strToInt64(const std::string &str, int64_t &i64_val);
   int _strToDouble(const std::string &str, double &d_val);
+  /**
+   * global max or min of the local values of all parties,
+   * only the final result is revealed.
+   * a party without value takes part with the sentinel
+  */
+  double maxOrMinOfAllParty(double local_value, bool has_value, bool is_max);
   int _avoidStringArray(std::shared_ptr<arrow::Array> array);
   void _buildNewColumn(std::vector<std::string> &col_val,
                        std::shared_ptr<arrow::Array> &array);
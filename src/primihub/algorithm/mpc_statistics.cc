@@ -365,6 +365,29 @@ int MPCStatisticsExecutor::loadParams(primihub::rpc::Task &task) {
 retcode MPCStatisticsExecutor::execute(const eMatrix<double>& input_data_info,
     const std::vector<std::string>& col_names,
     std::vector<double>* result) {
+  return Compute(executor_.get(), input_data_info, col_names, result);
+}
+
+retcode MPCStatisticsExecutor::execute(MPCStatisticsType type,
+    const eMatrix<double>& input_data_info,
+    const std::vector<std::string>& col_names,
+    std::vector<double>* result) {
+  auto it = session_executors_.find(type);
+  if (it == session_executors_.end()) {
+    auto executor = MakeOperator(type);
+    if (executor == nullptr) {
+      return retcode::FAIL;
+    }
+    executor->setupChannel(this->party_id(), this->CommPkgPtr());
+    it = session_executors_.emplace(type, std::move(executor)).first;
+  }
+  return Compute(it->second.get(), input_data_info, col_names, result);
+}
+
+retcode MPCStatisticsExecutor::Compute(MPCStatisticsOperator* executor,
+    const eMatrix<double>& input_data_info,
+    const std::vector<std::string>& col_names,
+    std::vector<double>* result) {
   eMatrix<double> col_data;
   eMatrix<double> col_rows;
   col_data.resize(input_data_info.rows(), 1);
@@ -373,12 +396,12 @@ retcode MPCStatisticsExecutor::execute(const eMatrix<double>& input_data_info,
     col_data(i, 0) = input_data_info(i, 0);
     col_rows(i, 0) = input_data_info(i, 1);
   }
-  auto ret = executor_->CipherTextDataCompute(col_data, col_names, col_rows);
+  auto ret = executor->CipherTextDataCompute(col_data, col_names, col_rows);
   if (ret != retcode::SUCCESS) {
     LOG(ERROR) << "Run MPC statistics executor failed.";
     return retcode::FAIL;
   }
-  executor_->getResult(result_);
+  executor->getResult(result_);
   int64_t rows = result_.rows();
   int cols = result_.cols();
   LOG(INFO) << "rows: " << rows << " cols: " << cols;
@@ -404,53 +427,63 @@ int MPCStatisticsExecutor::execute() {
   return 0;
 }
 
+retcode MPCStatisticsExecutor::StatisticsType(
+    rpc::Algorithm::StatisticsOpType op_type, MPCStatisticsType* type) {
+  switch (op_type) {
+  case rpc::Algorithm::MAX:
+    *type = MPCStatisticsType::MAX;
+    break;
+  case rpc::Algorithm::MIN:
+    *type = MPCStatisticsType::MIN;
+    break;
+  case rpc::Algorithm::AVG:
+    *type = MPCStatisticsType::AVG;
+    break;
+  case rpc::Algorithm::SUM:
+    *type = MPCStatisticsType::SUM;
+    break;
+  default:
+    LOG(ERROR) << "Unknown Algorithm operation type: "
+               << static_cast<int>(op_type);
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+std::unique_ptr<MPCStatisticsOperator> MPCStatisticsExecutor::MakeOperator(
+    MPCStatisticsType type) {
+  switch (type) {
+  case MPCStatisticsType::AVG:
+  case MPCStatisticsType::SUM:
+    return std::make_unique<MPCSumOrAvg>(type);
+  case MPCStatisticsType::MAX:
+  case MPCStatisticsType::MIN:
+    return std::make_unique<MPCMinOrMax>(type);
+  default:
+    LOG(ERROR) << "No executor for "
+               << MPCStatisticsOperator::statisticsTypeToString(type) << ".";
+    return nullptr;
+  }
+}
+
 retcode MPCStatisticsExecutor::InitEngine() {
   if (type_ == MPCStatisticsType::UNKNOWN) {
     auto algorithm = task_config_.algorithm();
     auto op_type = algorithm.statistics_op_type();
-    switch (op_type) {
-    case rpc::Algorithm::MAX:
-      type_ = MPCStatisticsType::MAX;
-      break;
-    case rpc::Algorithm::MIN:
-      type_ = MPCStatisticsType::MIN;
-      break;
-    case rpc::Algorithm::AVG:
-      type_ = MPCStatisticsType::AVG;
-      break;
-    case rpc::Algorithm::SUM:
-      type_ = MPCStatisticsType::SUM;
-      break;
-    default: {
+    if (StatisticsType(op_type, &type_) != retcode::SUCCESS) {
       std::stringstream ss;
       ss  << "Unknown Algorithm operation type: "
           << static_cast<int>(op_type);
       RaiseException(ss.str());
     }
-    }
   }
-  switch (type_) {
-  case MPCStatisticsType::AVG:
-    executor_ = std::make_unique<MPCSumOrAvg>(type_);
-    break;
-  case MPCStatisticsType::SUM:
-    executor_ = std::make_unique<MPCSumOrAvg>(type_);
-    break;
-  case MPCStatisticsType::MAX:
-    executor_ = std::make_unique<MPCMinOrMax>(type_);
-    break;
-  case MPCStatisticsType::MIN:
-    executor_ = std::make_unique<MPCMinOrMax>(type_);
-    break;
-  default: {
+  executor_ = MakeOperator(type_);
+  if (executor_ == nullptr) {
     std::stringstream ss;
     ss << "No executor for "
        << MPCStatisticsOperator::statisticsTypeToString(type_) << ".";
     RaiseException(ss.str());
   }
-
-    return retcode::FAIL;
-  }
   executor_->setupChannel(this->party_id(), this->CommPkgPtr());
   return retcode::SUCCESS;
 }
@@ -45,10 +45,25 @@ class MPCStatisticsExecutor : public AlgorithmBase {
                   std::vector<double>* result) override;
   retcode InitEngine() override;
   int saveModel() override;
+  /**
+   * run statistics of type on the party channels set up by initPartyComm,
+   * the operator of each type is set up once and reused by later calls
+  */
+  retcode execute(MPCStatisticsType type,
+                  const eMatrix<double>& input_data_info,
+                  const std::vector<std::string>& col_names,
+                  std::vector<double>* result);
+  static retcode StatisticsType(rpc::Algorithm::StatisticsOpType op_type,
+                                MPCStatisticsType* type);
 
  private:
   retcode _parseColumnName(const std::string &json_str);
   retcode _parseColumnDtype(const std::string &json_str);
+  std::unique_ptr<MPCStatisticsOperator> MakeOperator(MPCStatisticsType type);
+  retcode Compute(MPCStatisticsOperator* executor,
+                  const eMatrix<double>& input_data_info,
+                  const std::vector<std::string>& col_names,
+                  std::vector<double>* result);
 
   bool do_nothing_ = false;
 
@@ -70,6 +85,8 @@ class MPCStatisticsExecutor : public AlgorithmBase {
 
   MPCStatisticsType type_{MPCStatisticsType::UNKNOWN};
   std::unique_ptr<MPCStatisticsOperator> executor_;
+  std::map<MPCStatisticsType, std::unique_ptr<MPCStatisticsOperator>>
+      session_executors_;
 };
 }  // namespace primihub
 #endif  // SRC_PRIMIHUB_ALGORITHM_MPC_STATISTICS_H_
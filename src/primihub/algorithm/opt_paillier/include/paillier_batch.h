@@ -0,0 +1,118 @@
+/**
+  \file 		paillier_batch.h
+  \copyright Copyright (C) 2023 PrimiHub
+ */
+
+#ifndef __OPT_PAILLIER_BATCH__
+#define __OPT_PAILLIER_BATCH__
+
+#include <gmp.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include "paillier.h"
+#include "crt_datapack.h"
+
+namespace primihub {
+class ThreadPool;
+}
+
+/**
+ * @brief batch engine of the optimized paillier cryptosystem
+ *
+ * arrays are split into chunks which run on a fixed thread pool.
+ * every worker thread keeps its own GMP scratch variables, so the
+ * inner loops neither mpz_init nor mpz_clear. randomness of a chunk
+ * is read from /dev/urandom at once instead of once per item.
+ * results are identical to the single item functions in paillier.h
+ * except for the random r used by encryption.
+ *
+ * res and inputs are arrays of initialized mpz_t of length num,
+ * res may alias an input
+ */
+class opt_paillier_batch {
+ public:
+  /**
+   * thread_num = 0 means hardware concurrency
+   */
+  explicit opt_paillier_batch(size_t thread_num = 0);
+  ~opt_paillier_batch();
+
+  void encrypt(
+    mpz_t* res,
+    const mpz_t* plaintexts,
+    size_t num,
+    const opt_public_key_t* pub);
+
+  /**
+   * h_s^r mod n^2 by CRT and the fixed-base tables of pub
+   */
+  void encrypt_crt_fb(
+    mpz_t* res,
+    const mpz_t* plaintexts,
+    size_t num,
+    const opt_public_key_t* pub,
+    const opt_secret_key_t* prv);
+
+  void decrypt_crt(
+    mpz_t* res,
+    const mpz_t* ciphertexts,
+    size_t num,
+    const opt_public_key_t* pub,
+    const opt_secret_key_t* prv);
+
+  void add(
+    mpz_t* res,
+    const mpz_t* op1,
+    const mpz_t* op2,
+    size_t num,
+    const opt_public_key_t* pub);
+
+  void constant_mul(
+    mpz_t* res,
+    const mpz_t* op1,
+    const mpz_t* op2,
+    size_t num,
+    const opt_public_key_t* pub);
+
+  /**
+   * pack seq into ceil(seq_size / crt_size) integers
+   */
+  void data_packing_crt(
+    mpz_t* res,
+    char** seq,
+    size_t seq_size,
+    const CrtMod* crtmod,
+    int radix = 10);
+
+  /**
+   * seq is an array of seq_size pointers allocated by the caller,
+   * each retrieved string is allocated by GMP
+   */
+  void data_retrieve_crt(
+    char** seq,
+    const mpz_t* packs,
+    size_t seq_size,
+    const CrtMod* crtmod,
+    int radix = 10);
+
+  /**
+   * run fn(begin, end) on chunks of [0, num) and wait for all of them,
+   * the first exception thrown by fn is rethrown
+   */
+  void parallel_for(
+    size_t num,
+    const std::function<void(size_t begin, size_t end)>& fn);
+
+  size_t thread_num() const;
+
+ private:
+  void run(
+    size_t num,
+    size_t grain,
+    const std::function<void(size_t begin, size_t end)>& fn);
+
+  std::unique_ptr<primihub::ThreadPool> pool_;
+};
+
+#endif
@@ -0,0 +1,314 @@
+/**
+  \file 		paillier_batch.cc
+  \copyright Copyright (C) 2023 PrimiHub
+ */
+
+#include "../include/paillier_batch.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <vector>
+#include "src/primihub/util/thread_pool.h"
+
+namespace {
+// items of a chunk for cheap operations such as add
+constexpr size_t kLightGrain = 64;
+// items of a chunk for modular exponentiations
+constexpr size_t kHeavyGrain = 1;
+
+/**
+ * GMP variables of a worker thread, initialized once per thread
+ */
+struct batch_scratch {
+  mpz_t r;
+  mpz_t cp;
+  mpz_t cq;
+  mpz_t temp;
+  mpz_t fb_temp;
+  std::vector<ui> digits;
+  std::vector<unsigned char> rand_buf;
+
+  batch_scratch() {
+    mpz_inits(r, cp, cq, temp, fb_temp, nullptr);
+  }
+  ~batch_scratch() {
+    mpz_clears(r, cp, cq, temp, fb_temp, nullptr);
+  }
+};
+
+batch_scratch& local_scratch() {
+  thread_local batch_scratch scratch;
+  return scratch;
+}
+
+void fill_random(unsigned char* buf, size_t len) {
+  int furandom = open("/dev/urandom", O_RDONLY);
+  if (furandom < 0) {
+    throw std::runtime_error("open /dev/urandom failed");
+  }
+  size_t offset = 0;
+  while (offset < len) {
+    ssize_t result = read(furandom, buf + offset, len - offset);
+    if (result <= 0) {
+      close(furandom);
+      throw std::runtime_error("read /dev/urandom failed");
+    }
+    offset += result;
+  }
+  close(furandom);
+}
+
+/**
+ * random r of bitlen bits for each item in [begin, end),
+ * item k is imported by random_at(scratch, k - begin, bitlen)
+ */
+void prepare_random(batch_scratch& s, size_t count, mp_bitcnt_t bitlen) {
+  size_t byte_count = (bitlen + 7) / 8;
+  s.rand_buf.resize(byte_count * count);
+  fill_random(s.rand_buf.data(), s.rand_buf.size());
+}
+
+void random_at(batch_scratch& s, size_t k, mp_bitcnt_t bitlen) {
+  size_t byte_count = (bitlen + 7) / 8;
+  mpz_import(s.r, byte_count, 1, 1, 0, 0, s.rand_buf.data() + k * byte_count);
+  mpz_tdiv_r_2exp(s.r, s.r, bitlen);
+}
+
+/**
+ * w bits of x starting from bit pos
+ */
+ui get_window(const mpz_t x, size_t pos, size_t w) {
+  size_t idx = pos / GMP_NUMB_BITS;
+  size_t off = pos % GMP_NUMB_BITS;
+  mp_limb_t value = mpz_getlimbn(x, idx) >> off;
+  if (off + w > GMP_NUMB_BITS) {
+    value |= mpz_getlimbn(x, idx + 1) << (GMP_NUMB_BITS - off);
+  }
+  return static_cast<ui>(value & ((static_cast<mp_limb_t>(1) << w) - 1));
+}
+
+/**
+ * same as fbpowmod_extend, but the exponent digits are sliced from
+ * the limbs directly and no temporary is allocated
+ */
+void fbpowmod_scratch(
+  const fb_instance& fb_ins,
+  mpz_t result,
+  const mpz_t exp,
+  batch_scratch& s) {
+    size_t bits = mpz_cmp_ui(exp, 0) > 0 ? mpz_sizeinbase(exp, 2) : 0;
+    size_t t = (bits + fb_ins.m_w - 1) / fb_ins.m_w;
+    if (t > fb_ins.m_t + 1) {
+      throw std::invalid_argument("exponent exceeds fixed-base table");
+    }
+    s.digits.resize(t);
+    for (size_t i = 0; i < t; ++i) {
+      s.digits[i] = get_window(exp, i * fb_ins.m_w, fb_ins.m_w);
+    }
+    mpz_set_ui(s.fb_temp, 1);
+    mpz_set_ui(result, 1);
+    for (size_t j = fb_ins.m_h - 1; j >= 1; --j) {
+      for (size_t i = 0; i < t; ++i) {
+        if (s.digits[i] == j) {
+          mpz_mul(s.fb_temp, s.fb_temp, fb_ins.m_table_G[i]);
+          mpz_mod(s.fb_temp, s.fb_temp, fb_ins.m_mod);
+        }
+      }
+      mpz_mul(result, result, s.fb_temp);
+      mpz_mod(result, result, fb_ins.m_mod);
+    }
+  }
+}  // namespace
+
+opt_paillier_batch::opt_paillier_batch(size_t thread_num)
+    : pool_(std::make_unique<primihub::ThreadPool>(thread_num)) {}
+
+opt_paillier_batch::~opt_paillier_batch() = default;
+
+size_t opt_paillier_batch::thread_num() const {
+  return pool_->size();
+}
+
+void opt_paillier_batch::parallel_for(
+  size_t num,
+  const std::function<void(size_t begin, size_t end)>& fn) {
+    run(num, kLightGrain, fn);
+  }
+
+void opt_paillier_batch::run(
+  size_t num,
+  size_t grain,
+  const std::function<void(size_t begin, size_t end)>& fn) {
+    size_t chunk_num = std::min(pool_->size() * 4, (num + grain - 1) / grain);
+    if (chunk_num <= 1) {
+      if (num > 0) {
+        fn(0, num);
+      }
+      return;
+    }
+    size_t chunk_size = (num + chunk_num - 1) / chunk_num;
+    std::vector<std::future<void>> futs;
+    futs.reserve(chunk_num);
+    for (size_t begin = 0; begin < num; begin += chunk_size) {
+      size_t end = std::min(num, begin + chunk_size);
+      futs.push_back(pool_->enqueue(fn, begin, end));
+    }
+    // chunks reference the caller's arrays, wait for all before rethrowing
+    std::exception_ptr error = nullptr;
+    for (auto& fut : futs) {
+      try {
+        fut.get();
+      } catch (...) {
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+      }
+    }
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+
+void opt_paillier_batch::encrypt(
+  mpz_t* res,
+  const mpz_t* plaintexts,
+  size_t num,
+  const opt_public_key_t* pub) {
+    run(num, kHeavyGrain, [&](size_t begin, size_t end) {
+      auto& s = local_scratch();
+      prepare_random(s, end - begin, pub->lbits);
+      for (size_t i = begin; i < end; ++i) {
+        random_at(s, i - begin, pub->lbits);
+        // (1+m*n) * h_s^r mod n^2
+        mpz_mul(s.temp, plaintexts[i], pub->n);
+        mpz_add_ui(s.temp, s.temp, 1);
+        mpz_powm(s.r, pub->h_s, s.r, pub->n_squared);
+        mpz_mul(s.temp, s.temp, s.r);
+        mpz_mod(res[i], s.temp, pub->n_squared);
+      }
+    });
+  }
+
+void opt_paillier_batch::encrypt_crt_fb(
+  mpz_t* res,
+  const mpz_t* plaintexts,
+  size_t num,
+  const opt_public_key_t* pub,
+  const opt_secret_key_t* prv) {
+    run(num, kHeavyGrain, [&](size_t begin, size_t end) {
+      auto& s = local_scratch();
+      prepare_random(s, end - begin, pub->lbits);
+      for (size_t i = begin; i < end; ++i) {
+        random_at(s, i - begin, pub->lbits);
+        // h_s^r mod P^2, Q^2 by fixed-base, then CRT
+        fbpowmod_scratch(pub->fb_mod_P_sqaured, s.cp, s.r, s);
+        fbpowmod_scratch(pub->fb_mod_Q_sqaured, s.cq, s.r, s);
+        mpz_sub(s.cq, s.cq, s.cp);
+        mpz_addmul(s.cp, s.cq, prv->P_squared_mul_P_squared_inverse);
+        mpz_mod(s.r, s.cp, pub->n_squared);
+
+        mpz_mul(s.temp, plaintexts[i], pub->n);
+        mpz_add_ui(s.temp, s.temp, 1);
+        mpz_mul(s.temp, s.temp, s.r);
+        mpz_mod(res[i], s.temp, pub->n_squared);
+      }
+    });
+  }
+
+void opt_paillier_batch::decrypt_crt(
+  mpz_t* res,
+  const mpz_t* ciphertexts,
+  size_t num,
+  const opt_public_key_t* pub,
+  const opt_secret_key_t* prv) {
+    run(num, kHeavyGrain, [&](size_t begin, size_t end) {
+      auto& s = local_scratch();
+      for (size_t i = begin; i < end; ++i) {
+        // cp = L(c^(2p) mod P^2, P) * inv1 mod P
+        mpz_mod(s.temp, ciphertexts[i], prv->P_squared);
+        mpz_powm(s.cp, s.temp, prv->double_p, prv->P_squared);
+        mpz_sub_ui(s.cp, s.cp, 1);
+        mpz_divexact(s.cp, s.cp, prv->P);
+        mpz_mul(s.cp, s.cp, prv->Q_mul_double_p_inverse);
+        mpz_mod(s.cp, s.cp, prv->P);
+        // cq = L(c^(2q) mod Q^2, Q) * inv2 mod Q
+        mpz_mod(s.temp, ciphertexts[i], prv->Q_squared);
+        mpz_powm(s.cq, s.temp, prv->double_q, prv->Q_squared);
+        mpz_sub_ui(s.cq, s.cq, 1);
+        mpz_divexact(s.cq, s.cq, prv->Q);
+        mpz_mul(s.cq, s.cq, prv->P_mul_double_q_inverse);
+        mpz_mod(s.cq, s.cq, prv->Q);
+        // cp + (cq - cp) * (P * (P^-1 mod Q)) mod n
+        mpz_sub(s.cq, s.cq, s.cp);
+        mpz_addmul(s.cp, s.cq, prv->P_mul_P_inverse);
+        mpz_mod(res[i], s.cp, pub->n);
+      }
+    });
+  }
+
+void opt_paillier_batch::add(
+  mpz_t* res,
+  const mpz_t* op1,
+  const mpz_t* op2,
+  size_t num,
+  const opt_public_key_t* pub) {
+    run(num, kLightGrain, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        opt_paillier_add(res[i], op1[i], op2[i], pub);
+      }
+    });
+  }
+
+void opt_paillier_batch::constant_mul(
+  mpz_t* res,
+  const mpz_t* op1,
+  const mpz_t* op2,
+  size_t num,
+  const opt_public_key_t* pub) {
+    run(num, kHeavyGrain, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        opt_paillier_constant_mul(res[i], op1[i], op2[i], pub);
+      }
+    });
+  }
+
+void opt_paillier_batch::data_packing_crt(
+  mpz_t* res,
+  char** seq,
+  size_t seq_size,
+  const CrtMod* crtmod,
+  int radix) {
+    size_t crt_size = crtmod->crt_size;
+    size_t pack_num = (seq_size + crt_size - 1) / crt_size;
+    run(pack_num, kHeavyGrain, [&](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; ++k) {
+        size_t offset = k * crt_size;
+        size_t data_size = std::min(crt_size, seq_size - offset);
+        ::data_packing_crt(res[k], seq + offset, data_size, crtmod, radix);
+      }
+    });
+  }
+
+void opt_paillier_batch::data_retrieve_crt(
+  char** seq,
+  const mpz_t* packs,
+  size_t seq_size,
+  const CrtMod* crtmod,
+  int radix) {
+    size_t crt_size = crtmod->crt_size;
+    size_t pack_num = (seq_size + crt_size - 1) / crt_size;
+    run(pack_num, kHeavyGrain, [&](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; ++k) {
+        size_t offset = k * crt_size;
+        size_t data_size = std::min(crt_size, seq_size - offset);
+        char** nums = nullptr;
+        ::data_retrieve_crt(nums, packs[k], crtmod, data_size, radix);
+        std::copy(nums, nums + data_size, seq + offset);
+        free(nums);
+      }
+    });
+  }
@@ -16,7 +16,9 @@
 
 #include "src/primihub/cli/cli.h"
 #include <fstream>  // std::ifstream
+#include <cstdio>
 #include <string>
+#include <algorithm>
 #include <chrono>
 #include <random>
 #include <vector>
@@ -32,80 +34,85 @@
 namespace pb_util = primihub::proto::util;
 
 namespace primihub {
+namespace {
+constexpr size_t kMaxFetchIntervalMs = 1000;
+constexpr int kMaxTransferRetry = 3;
+}  // namespace
+
 retcode SDKClient::CheckTaskStauts(const rpc::PushTaskReply& task_reply_info) {
   const auto& task_info = task_reply_info.task_info();
   size_t party_count = task_reply_info.party_count();
   LOG(INFO) << "party count: " << party_count;
   std::map<std::string, std::string> task_status;
-  // fecth task status
+  bool is_finished{false};
+  bool task_exist{true};
+  // return false once the task has finished
+  auto process_status = [&](const rpc::TaskStatus& status_info) -> bool {
+    auto party = status_info.party();
+    auto status_code = status_info.status();
+    auto message = status_info.message();
+    VLOG(5) << "task_status party: " << party << " "
+        << "status: " << static_cast<int>(status_code) << " "
+        << "message: " << message;
+    if (status_code != primihub::rpc::TaskStatus::RUNNING) {
+      VLOG(0) << pb_util::TaskStatusToString(status_info);
+    }
+    if (status_code == primihub::rpc::TaskStatus::NONEXIST) {
+      LOG(ERROR) << "task does not exist on server: " << message;
+      task_exist = false;
+      is_finished = true;
+      return false;
+    }
+    if (status_code == primihub::rpc::TaskStatus::SUCCESS ||
+        status_code == primihub::rpc::TaskStatus::FAIL) {
+      if (party != AUX_COMPUTE_NODE) {
+        task_status[party] = message;
+      }
+      if (status_code == primihub::rpc::TaskStatus::FAIL) {
+        is_finished = true;
+      }
+    }
+    if (task_status.size() == party_count) {
+      LOG(INFO) << "all node has finished";
+      for (const auto& [party_name, msg_info] : task_status) {
+        LOG(INFO) << "party name: " << party_name
+                  << " msg: " << msg_info;
+      }
+      is_finished = true;
+    }
+    return !is_finished;
+  };
+
+  rpc::TaskContext request;
+  request.CopyFrom(task_info);
+  // status is pushed by server as soon as it is updated
+  auto ret = channel_->watchTaskStatus(request, process_status);
+  if (ret != retcode::SUCCESS || !is_finished) {
+    LOG(WARNING) << "watch task status is interrupted, "
+                 << "fall back to fetch task status";
+  }
+  // fetch task status, for server without WatchTaskStatus
   size_t fetch_count = 0;
-  do {
-    rpc::TaskContext request;
-    request.CopyFrom(task_info);
+  while (!is_finished) {
     rpc::TaskStatusReply status_reply;
-    auto ret = channel_->fetchTaskStatus(request, &status_reply);
-    // parse task status
+    ret = channel_->fetchTaskStatus(request, &status_reply);
     if (ret != retcode::SUCCESS) {
       LOG(ERROR) << "fetch task status from server failed";
       return retcode::FAIL;
     }
-    bool is_finished{false};
     for (const auto& status_info : status_reply.task_status()) {
-      auto party = status_info.party();
-      auto status_code = status_info.status();
-      auto message = status_info.message();
-      VLOG(5) << "task_status party: " << party << " "
-          << "status: " << static_cast<int>(status_code) << " "
-          << "message: " << message;
-      if (status_code !=primihub::rpc::TaskStatus::RUNNING) {
-        VLOG(0) << pb_util::TaskStatusToString(status_info);
-      }
-      if (status_info.status() == primihub::rpc::TaskStatus::SUCCESS ||
-          status_info.status() == primihub::rpc::TaskStatus::FAIL) {
-        if (party == AUX_COMPUTE_NODE) {
-        } else {
-          task_status[party] = message;
-        }
-        if (status_info.status() == primihub::rpc::TaskStatus::FAIL) {
-          is_finished = true;
-        }
-      }
-      if (task_status.size() == party_count) {
-        LOG(INFO) << "all node has finished";
-        for (const auto& [party_name, msg_info] : task_status) {
-          LOG(INFO) << "party name: " << party_name
-                    << " msg: " << msg_info;
-        }
-        is_finished = true;
+      if (!process_status(status_info)) {
         break;
       }
     }
     if (is_finished) {
       break;
     }
-    // // for test active kill task
-    // {
-    //   std::this_thread::sleep_for(std::chrono::seconds(5));
-    //   LOG(INFO) << "begin to kill task by client";
-    //   rpc::KillTaskRequest request;
-    //   auto task_info = request.mutable_task_info();
-    //   task_info->set_task_id(task_id);
-    //   task_info->set_job_id(job_id);
-    //   task_info->set_request_id(request_id);
-    //   request.set_executor(rpc::KillTaskRequest::CLIENT);
-    //   rpc::KillTaskResponse status_reply;
-    //   auto ret = channel_->killTask(request, &status_reply);
-    //   break;
-    // }
-
-    if (fetch_count < 1000) {
-      std::this_thread::sleep_for(
-          std::chrono::milliseconds(fetch_count*100));
-    } else {
-      std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
-  } while (true);
-  return retcode::SUCCESS;
+    fetch_count++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(
+        std::min<size_t>(fetch_count * 100, kMaxFetchIntervalMs)));
+  }
+  return task_exist ? retcode::SUCCESS : retcode::FAIL;
 }
 
 retcode SDKClient::RegisterDataset(const rpc::NewDatasetRequest& req,
@@ -176,4 +183,157 @@ retcode SDKClient::SaveData(const std::string& file_name,
   }
   return retcode::SUCCESS;
 }
+
+namespace {
+/**
+ * source of a part file, the remote file has to be the same
+ * when the download is resumed
+*/
+struct PartSource {
+  std::string remote_path;
+  uint64_t file_size{0};
+  int64_t mtime{0};
+  bool operator==(const PartSource& other) const {
+    return remote_path == other.remote_path &&
+           file_size == other.file_size &&
+           mtime == other.mtime;
+  }
+};
+
+bool LoadPartSource(const std::string& meta_file, PartSource* source) {
+  std::ifstream fin(meta_file);
+  return static_cast<bool>(std::getline(fin, source->remote_path) &&
+                           fin >> source->file_size >> source->mtime);
+}
+
+bool SavePartSource(const std::string& meta_file, const PartSource& source) {
+  std::ofstream fout(meta_file, std::ios::trunc);
+  fout << source.remote_path << "\n"
+       << source.file_size << " " << source.mtime << "\n";
+  fout.close();
+  return static_cast<bool>(fout);
+}
+
+void DiscardPartFile(const std::string& part_file,
+                     const std::string& meta_file) {
+  std::remove(part_file.c_str());
+  std::remove(meta_file.c_str());
+}
+}  // namespace
+
+retcode SDKClient::DownloadFile(const rpc::TaskContext& task_info,
+                                const std::string& remote_path,
+                                const std::string& save_as) {
+  if (ValidateDir(save_as)) {
+    LOG(ERROR) << "check file path failed: " << save_as;
+    return retcode::FAIL;
+  }
+  std::string part_file = save_as + ".part";
+  std::string meta_file = part_file + ".meta";
+  PartSource part_source;
+  bool has_source = FileSize(part_file) > 0 &&
+                    LoadPartSource(meta_file, &part_source) &&
+                    part_source.remote_path == remote_path;
+  if (!has_source) {
+    if (FileSize(part_file) > 0) {
+      LOG(WARNING) << "source of " << part_file << " is unknown, "
+                   << "download " << remote_path << " from the beginning";
+    }
+    DiscardPartFile(part_file, meta_file);
+  }
+  for (int i = 0; i <= kMaxTransferRetry; i++) {
+    int64_t part_size = FileSize(part_file);
+    uint64_t downloaded = part_size > 0 ? part_size : 0;
+    rpc::DownloadRequest request;
+    request.set_request_id(task_info.request_id());
+    request.add_file_list(remote_path);
+    request.set_compress_type(rpc::CompressType::ZLIB);
+    if (downloaded > 0) {
+      LOG(INFO) << "resume download of " << remote_path << " "
+                << "from offset: " << downloaded;
+      auto range = request.add_file_range();
+      range->set_file_name(remote_path);
+      range->set_offset(downloaded);
+    }
+    std::ofstream fout(part_file, std::ios::binary | std::ios::app);
+    if (!fout) {
+      LOG(ERROR) << "open file: " << part_file << " failed";
+      return retcode::FAIL;
+    }
+    bool block_received{false};
+    bool source_changed{false};
+    auto ret = channel_->DownloadData(request,
+        [&](const rpc::DownloadRespone& block,
+            std::string&& data) -> retcode {
+          if (!block_received) {
+            block_received = true;
+            PartSource source{remote_path, block.file_size(), block.mtime()};
+            if (!has_source) {
+              has_source = SavePartSource(meta_file, source);
+              if (!has_source) {
+                LOG(ERROR) << "save source of " << part_file << " failed";
+                return retcode::FAIL;
+              }
+              part_source = std::move(source);
+            } else if (!(source == part_source)) {
+              LOG(WARNING) << remote_path << " is modified after "
+                           << part_file << " is written";
+              source_changed = true;
+              return retcode::FAIL;
+            }
+          }
+          if (block.offset() != downloaded) {
+            LOG(ERROR) << "unexpected offset: " << block.offset() << " "
+                       << "expected: " << downloaded;
+            return retcode::FAIL;
+          }
+          fout.write(data.data(), data.size());
+          downloaded += data.size();
+          return fout ? retcode::SUCCESS : retcode::FAIL;
+        });
+    fout.close();
+    if (ret == retcode::SUCCESS) {
+      if (std::rename(part_file.c_str(), save_as.c_str()) != 0) {
+        LOG(ERROR) << "rename " << part_file << " to " << save_as
+                   << " failed";
+        return retcode::FAIL;
+      }
+      std::remove(meta_file.c_str());
+      LOG(INFO) << "save data to " << save_as << " size: " << downloaded;
+      return retcode::SUCCESS;
+    }
+    // a resumed request is rejected before any block when the remote file
+    // is shorter than the part file, which means it is modified as well
+    if (source_changed || (part_size > 0 && !block_received)) {
+      LOG(WARNING) << "discard " << part_file << ", "
+                   << "download " << remote_path << " from the beginning";
+      DiscardPartFile(part_file, meta_file);
+      has_source = false;
+    }
+    LOG(WARNING) << "download of " << remote_path << " is interrupted "
+                 << "at offset: " << downloaded << ", "
+                 << "attempt: " << i + 1 << "/" << kMaxTransferRetry + 1;
+  }
+  return retcode::FAIL;
+}
+
+retcode SDKClient::UploadFile(const std::string& local_file,
+                              const std::string& remote_file) {
+  uint64_t offset{0};
+  for (int i = 0; i <= kMaxTransferRetry; i++) {
+    rpc::UploadFileResponse reply;
+    auto ret = channel_->UploadData(local_file, remote_file, offset, &reply);
+    if (ret == retcode::SUCCESS) {
+      LOG(INFO) << "upload " << local_file << " to " << reply.file_path()
+                << " size: " << reply.size();
+      return retcode::SUCCESS;
+    }
+    // size is what the node has received, 0 if the stream did not start
+    offset = reply.size();
+    LOG(WARNING) << "upload of " << local_file << " is interrupted "
+                 << "at offset: " << offset << ", "
+                 << "attempt: " << i + 1 << "/" << kMaxTransferRetry + 1;
+  }
+  return retcode::FAIL;
+}
 }  // namespace primihub
@@ -66,6 +66,21 @@ class SDKClient {
                        std::vector<std::string>* recv_data);
   retcode SaveData(const std::string& file_name,
                    const std::vector<std::string>& recv_data);
+  /**
+   * stream remote_path into <save_as>.part and rename it when finished,
+   * an interrupted download is resumed from the size of the part file.
+   * the size and modify time of remote_path are kept in <save_as>.part.meta,
+   * the part file is discarded if remote_path has changed since then
+  */
+  retcode DownloadFile(const rpc::TaskContext& task_info,
+                       const std::string& remote_path,
+                       const std::string& save_as);
+  /**
+   * upload local_file to the storage path of the node as remote_file,
+   * an interrupted upload is resumed from the size received by the node
+  */
+  retcode UploadFile(const std::string& local_file,
+                     const std::string& remote_file);
   retcode CheckTaskStauts(const rpc::PushTaskReply& task_reply_info);
   retcode RegisterDataset(const rpc::NewDatasetRequest& req,
                           rpc::NewDatasetResponse* reply);
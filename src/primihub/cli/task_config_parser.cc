@@ -322,20 +322,12 @@ retcode DownloadData(primihub::SDKClient& client,
   for (const auto& file_cfg : download_files_cfg) {
     // download data from server
     const auto& remote_path = file_cfg.remote_file_path;
-    std::vector<std::string> file_list;
-    file_list.push_back(remote_path);
-    std::vector<std::string> downloaded_data;
-    LOG(INFO) << "Begin to Download file from remote path: " << remote_path;
-    auto ret = client.DownloadData(task_info, file_list, &downloaded_data);
-    if (ret != primihub::retcode::SUCCESS) {
-      LOG(ERROR) << "Download Data Failed";
-      return retcode::FAIL;
-    }
     auto& file_name = file_cfg.save_as;
-    LOG(INFO) << "save data to " << file_name;
-    ret = client.SaveData(file_name, downloaded_data);
+    LOG(INFO) << "Begin to Download file from remote path: " << remote_path
+              << " save as: " << file_name;
+    auto ret = client.DownloadFile(task_info, remote_path, file_name);
     if (ret != primihub::retcode::SUCCESS) {
-      LOG(WARNING) << "SaveData to " << file_name << " Failed";
+      LOG(ERROR) << "Download Data Failed";
       return retcode::FAIL;
     }
   }
@@ -34,6 +34,7 @@ namespace primihub {
 [[maybe_unused]] static int WAIT_TASK_WORKER_READY_TIMEOUT_MS = 5*1000;
 [[maybe_unused]] static int CACHED_TASK_STATUS_TIMEOUT_S = 5;
 [[maybe_unused]] static int SCHEDULE_WORKER_TIMEOUT_S = 20;
+[[maybe_unused]] static int MAX_TASK_STATUS_WATCHERS = 128;
 [[maybe_unused]] static int CONTROL_CMD_TIMEOUT_S = 5;
 [[maybe_unused]] static int GRPC_RETRY_MAX_TIMES = 3;
 // common type definition
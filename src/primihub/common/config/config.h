@@ -126,6 +126,10 @@ struct Tee {
   std::string cert_path;
 };
 
+struct TaskProcessPoolConfig {
+  uint32_t size{0};  // number of warm task processes, 0: disabled
+};
+
 struct NodeConfig {
   Node server_config;
   ServerInfo meta_service_config;
@@ -136,6 +140,9 @@ struct NodeConfig {
   ServerInfo proxy_server_cfg;
   StorageInfo storage_info;
   bool disable_report{false};
+  TaskProcessPoolConfig task_process_pool;
+  // ttl of dataset meta cached by DatasetService, 0: disabled
+  int64_t meta_cache_ttl_ms{60 * 1000};
 };
 
 }  // namespace primihub::common
@@ -326,6 +333,15 @@ template <> struct convert<NodeConfig> {
     if (node["tee"]) {
       nc.tee_conf = node["tee"].as<Tee>();
     }
+    if (node["meta_cache_ttl_ms"]) {
+      nc.meta_cache_ttl_ms = node["meta_cache_ttl_ms"].as<int64_t>();
+    }
+    if (node["task_process_pool"]) {
+      const auto& pool_cfg = node["task_process_pool"];
+      if (pool_cfg["size"]) {
+        nc.task_process_pool.size = pool_cfg["size"].as<uint32_t>();
+      }
+    }
     return true;
   }
 };
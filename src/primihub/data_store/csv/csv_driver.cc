@@ -14,13 +14,22 @@
  limitations under the License.
  */
 
+#include <dirent.h>
 #include <sys/stat.h>
+#include <utime.h>
+#include <unistd.h>
 #include <glog/logging.h>
+#include <arrow/ipc/api.h>
 
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <functional>
 #include <variant>
 #include <iostream>
+#include <map>
 #include <sstream>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <memory>
@@ -225,6 +234,256 @@ std::shared_ptr<arrow::Table> ReadCSVFile(const std::string& file_path,
   return Read(input, read_opt, parse_opt, convert_opt);
 }
 
+std::shared_ptr<arrow::csv::StreamingReader> OpenCSVStream(
+    const std::string& file_path,
+    const ReadOptions& read_opt,
+    const ParseOptions& parse_opt,
+    const ConvertOptions& convert_opt) {
+  auto local_fs_options = arrow::fs::LocalFileSystemOptions::Defaults();
+  local_fs_options.use_mmap = true;
+  arrow::fs::LocalFileSystem local_fs(local_fs_options);
+  auto result_ifstream = local_fs.OpenInputStream(file_path);
+  if (!result_ifstream.ok()) {
+    std::stringstream ss;
+    ss << "Failed to open file: " << file_path << " "
+        << "detail: " << result_ifstream.status();
+    RaiseException(ss.str());
+  }
+  std::shared_ptr<arrow::io::InputStream> input = result_ifstream.ValueOrDie();
+  arrow::io::IOContext io_context = arrow::io::default_io_context();
+  auto maybe_reader = arrow::csv::StreamingReader::Make(
+      io_context, input, read_opt, parse_opt, convert_opt);
+  if (!maybe_reader.ok()) {
+    std::stringstream ss;
+    ss << "open csv stream failed, " << "detail: " << maybe_reader.status();
+    RaiseException(ss.str());
+  }
+  return maybe_reader.ValueOrDie();
+}
+
+/**
+ * read next non-empty batch, batch is nullptr at the end of stream
+*/
+void ReadNextBatch(arrow::csv::StreamingReader* reader,
+                   std::shared_ptr<arrow::RecordBatch>* batch) {
+  do {
+    auto status = reader->ReadNext(batch);
+    if (!status.ok()) {
+      std::stringstream ss;
+      ss << "read csv batch failed, " << "detail: " << status;
+      RaiseException(ss.str());
+    }
+  } while (*batch != nullptr && (*batch)->num_rows() == 0);
+}
+
+// -------------------------parsed data cache--------------------------------
+static const char kCacheKeyMeta[] = "primihub.csv_cache_key";
+static const char kCacheFilePrefix[] = "csv_";
+static const char kCacheFileSuffix[] = ".arrow";
+
+/**
+ * cache key covers the data file (path, size, mtime) and every option
+ * that changes the parsed table: delimiter, quoting, header handling,
+ * selected columns with their types and null/bool spellings
+*/
+std::string MakeCacheKey(const std::string& file_path,
+                         const ReadOptions& read_opt,
+                         const ParseOptions& parse_opt,
+                         const ConvertOptions& convert_opt) {
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat) != 0) {
+    return std::string("");
+  }
+  std::stringstream key;
+  key << file_path << "|" << file_stat.st_size << "|"
+      << file_stat.st_mtim.tv_sec << "." << file_stat.st_mtim.tv_nsec;
+  key << "|parse:" << static_cast<int>(parse_opt.delimiter)
+      << "," << parse_opt.quoting << static_cast<int>(parse_opt.quote_char)
+      << "," << parse_opt.double_quote
+      << "," << parse_opt.escaping << static_cast<int>(parse_opt.escape_char)
+      << "," << parse_opt.newlines_in_values
+      << "," << parse_opt.ignore_empty_lines;
+  key << "|read:" << read_opt.skip_rows << ","
+      << read_opt.autogenerate_column_names;
+  for (const auto& name : read_opt.column_names) {
+    key << "," << name.size() << ":" << name;
+  }
+  key << "|columns:" << convert_opt.include_missing_columns;
+  for (const auto& name : convert_opt.include_columns) {
+    key << "," << name.size() << ":" << name;
+  }
+  // column_types is unordered, sort it to get a stable key
+  std::map<std::string, std::string> column_types;
+  for (const auto& [name, type] : convert_opt.column_types) {
+    column_types[name] = type->ToString();
+  }
+  key << "|types:";
+  for (const auto& [name, type] : column_types) {
+    key << "," << name.size() << ":" << name << ":" << type;
+  }
+  key << "|convert:" << convert_opt.strings_can_be_null << ","
+      << convert_opt.quoted_strings_can_be_null;
+  auto append_values = [&key](const char* tag,
+                              const std::vector<std::string>& values) {
+    key << "|" << tag;
+    for (const auto& value : values) {
+      key << "," << value.size() << ":" << value;
+    }
+  };
+  append_values("null", convert_opt.null_values);
+  append_values("true", convert_opt.true_values);
+  append_values("false", convert_opt.false_values);
+  return key.str();
+}
+
+std::string MakeCacheFilePath(const std::string& cache_dir,
+                              const std::string& cache_key) {
+  std::stringstream cache_file;
+  cache_file << cache_dir;
+  if (!cache_dir.empty() && cache_dir.back() != '/') {
+    cache_file << "/";
+  }
+  cache_file << kCacheFilePrefix << std::hex
+             << std::hash<std::string>{}(cache_key) << kCacheFileSuffix;
+  return cache_file.str();
+}
+
+/**
+ * keep at most max_files cache files in cache_dir,
+ * the least recently used (by mtime, refreshed on hit) are removed first
+*/
+void EvictCache(const std::string& cache_dir, size_t max_files) {
+  DIR* dir = ::opendir(cache_dir.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+  std::vector<std::pair<int64_t, std::string>> cache_files;
+  std::string prefix{kCacheFilePrefix};
+  std::string suffix{kCacheFileSuffix};
+  for (dirent* entry = ::readdir(dir); entry != nullptr;
+      entry = ::readdir(dir)) {
+    std::string name{entry->d_name};
+    if (name.size() <= prefix.size() + suffix.size() ||
+        name.compare(0, prefix.size(), prefix) != 0 ||
+        name.compare(name.size() - suffix.size(),
+                     suffix.size(), suffix) != 0) {
+      continue;
+    }
+    std::string file_path = cache_dir + "/" + name;
+    struct stat file_stat;
+    if (stat(file_path.c_str(), &file_stat) != 0) {
+      continue;
+    }
+    cache_files.emplace_back(file_stat.st_mtim.tv_sec, std::move(file_path));
+  }
+  ::closedir(dir);
+  if (cache_files.size() <= max_files) {
+    return;
+  }
+  std::sort(cache_files.begin(), cache_files.end());
+  size_t evict_num = cache_files.size() - max_files;
+  for (size_t i = 0; i < evict_num; i++) {
+    VLOG(5) << "evict csv cache file: " << cache_files[i].second;
+    remove(cache_files[i].second.c_str());
+  }
+}
+
+/**
+ * load table from arrow ipc file,
+ * nullptr if cache is missing, broken or written for another key
+*/
+std::shared_ptr<arrow::Table> LoadCache(const std::string& cache_file,
+                                        const std::string& cache_key) {
+  if (!FileExists(cache_file)) {
+    return nullptr;
+  }
+  auto maybe_file = arrow::io::MemoryMappedFile::Open(
+      cache_file, arrow::io::FileMode::READ);
+  if (!maybe_file.ok()) {
+    LOG(WARNING) << "open cache file: " << cache_file << " failed, "
+                 << maybe_file.status();
+    return nullptr;
+  }
+  auto maybe_reader =
+      arrow::ipc::RecordBatchFileReader::Open(maybe_file.ValueOrDie());
+  if (!maybe_reader.ok()) {
+    LOG(WARNING) << "read cache file: " << cache_file << " failed, "
+                 << maybe_reader.status();
+    return nullptr;
+  }
+  auto reader = maybe_reader.ValueOrDie();
+  auto metadata = reader->schema()->metadata();
+  if (metadata == nullptr ||
+      metadata->FindKey(kCacheKeyMeta) < 0 ||
+      metadata->value(metadata->FindKey(kCacheKeyMeta)) != cache_key) {
+    VLOG(5) << "cache file: " << cache_file << " does not match cache key";
+    return nullptr;
+  }
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  batches.reserve(reader->num_record_batches());
+  for (int i = 0; i < reader->num_record_batches(); i++) {
+    auto maybe_batch = reader->ReadRecordBatch(i);
+    if (!maybe_batch.ok()) {
+      LOG(WARNING) << "read cache file: " << cache_file << " failed, "
+                   << maybe_batch.status();
+      return nullptr;
+    }
+    batches.push_back(maybe_batch.ValueOrDie());
+  }
+  auto maybe_table = arrow::Table::FromRecordBatches(reader->schema(), batches);
+  if (!maybe_table.ok()) {
+    LOG(WARNING) << "load cache file: " << cache_file << " failed, "
+                 << maybe_table.status();
+    return nullptr;
+  }
+  // refresh mtime, used as last access time by EvictCache
+  utime(cache_file.c_str(), nullptr);
+  return maybe_table.ValueOrDie()->ReplaceSchemaMetadata(nullptr);
+}
+
+/**
+ * write table into arrow ipc file, the file is written to a temporary
+ * path and renamed, so a concurrent reader never sees a partial file
+*/
+retcode StoreCache(const std::string& cache_file,
+                   const std::string& cache_key,
+                   const std::shared_ptr<arrow::Table>& table) {
+  auto ret = ValidateDir(cache_file);
+  if (ret != 0) {
+    LOG(WARNING) << "invalid cache file path: " << cache_file;
+    return retcode::FAIL;
+  }
+  std::string tmp_file = cache_file + ".tmp." + std::to_string(getpid());
+  auto maybe_stream = arrow::io::FileOutputStream::Open(tmp_file);
+  if (!maybe_stream.ok()) {
+    LOG(WARNING) << "open file: " << tmp_file << " failed, "
+                 << maybe_stream.status();
+    return retcode::FAIL;
+  }
+  auto stream = maybe_stream.ValueOrDie();
+  auto metadata = arrow::key_value_metadata({kCacheKeyMeta}, {cache_key});
+  auto keyed_table = table->ReplaceSchemaMetadata(metadata);
+  auto maybe_writer =
+      arrow::ipc::MakeFileWriter(stream, keyed_table->schema());
+  arrow::Status status = maybe_writer.status();
+  if (status.ok()) {
+    auto writer = maybe_writer.ValueOrDie();
+    status = writer->WriteTable(*keyed_table);
+    if (status.ok()) {
+      status = writer->Close();
+    }
+  }
+  if (status.ok()) {
+    status = stream->Close();
+  }
+  if (!status.ok() || rename(tmp_file.c_str(), cache_file.c_str()) != 0) {
+    LOG(WARNING) << "write cache file: " << cache_file << " failed, " << status;
+    remove(tmp_file.c_str());
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
 std::string ReadRawData(const std::string& file_path, int64_t line_number) {
   // read data first 100 lines
   std::ifstream csv_data(file_path, std::ios::in);
@@ -257,6 +516,16 @@ std::string CSVAccessInfo::toString() {
   nlohmann::json js;
   js["type"] = kDriveType[DriverType::CSV];
   js["data_path"] = this->file_path_;
+  if (!use_threads) {
+    js["useThreads"] = false;
+  }
+  if (block_size > 0) {
+    js["blockSize"] = block_size;
+  }
+  if (!cache_dir.empty()) {
+    js["cacheDir"] = cache_dir;
+    js["cacheMaxFiles"] = cache_max_files;
+  }
   js["schema"] = SchemaToJsonString();
   ss << js;
   return ss.str();
@@ -282,10 +551,11 @@ retcode CSVAccessInfo::fromJsonString(const std::string& access_info) {
 }
 
 retcode CSVAccessInfo::ParseFromJsonImpl(const nlohmann::json& meta_info) {
+  nlohmann::json js_access_info;
   try {
     // this->file_path_ = access_info["access_meta"];
     std::string access_info = meta_info["access_meta"].get<std::string>();
-    nlohmann::json js_access_info = nlohmann::json::parse(access_info);
+    js_access_info = nlohmann::json::parse(access_info);
     this->file_path_ = js_access_info["data_path"].get<std::string>();
   } catch (std::exception& e) {
     this->file_path_ = meta_info["access_meta"];
@@ -295,12 +565,51 @@ retcode CSVAccessInfo::ParseFromJsonImpl(const nlohmann::json& meta_info) {
           << "detail: " << meta_info;
       RaiseException(ss.str());
     }
+    return retcode::SUCCESS;
   }
-  return retcode::SUCCESS;
+  // out of the try, a bad option must not be taken as the path
+  return ParseLoadOptions(js_access_info);
 }
 
 retcode CSVAccessInfo::ParseFromYamlConfigImpl(const YAML::Node& meta_info) {
   this->file_path_ = meta_info["source"].as<std::string>();
+  if (meta_info["useThreads"]) {
+    this->use_threads = meta_info["useThreads"].as<bool>();
+  }
+  if (meta_info["blockSize"]) {
+    this->block_size = meta_info["blockSize"].as<int32_t>();
+  }
+  if (meta_info["cacheDir"]) {
+    this->cache_dir = meta_info["cacheDir"].as<std::string>();
+  }
+  if (meta_info["cacheMaxFiles"]) {
+    this->cache_max_files = meta_info["cacheMaxFiles"].as<uint32_t>();
+  }
+  return retcode::SUCCESS;
+}
+
+retcode CSVAccessInfo::ParseLoadOptions(
+    const nlohmann::json& js_access_info) {
+  auto get_option = [&js_access_info](const char* key, auto* value) {
+    auto it = js_access_info.find(key);
+    if (it == js_access_info.end()) {
+      return true;
+    }
+    try {
+      *value = it->template get<std::remove_pointer_t<decltype(value)>>();
+    } catch (nlohmann::json::exception& e) {
+      LOG(ERROR) << "invalid csv option " << key << ": " << it->dump()
+                 << ", " << e.what();
+      return false;
+    }
+    return true;
+  };
+  if (!get_option("useThreads", &this->use_threads) ||
+      !get_option("blockSize", &this->block_size) ||
+      !get_option("cacheDir", &this->cache_dir) ||
+      !get_option("cacheMaxFiles", &this->cache_max_files)) {
+    return retcode::FAIL;
+  }
   return retcode::SUCCESS;
 }
 
@@ -310,8 +619,9 @@ retcode CSVAccessInfo::ParseFromMetaInfoImpl(const DatasetMetaInfo& meta_info) {
     LOG(WARNING) << "no access info for " << meta_info.id;
     return retcode::SUCCESS;
   }
+  nlohmann::json js_access_info;
   try {
-    nlohmann::json js_access_info = nlohmann::json::parse(access_info);
+    js_access_info = nlohmann::json::parse(access_info);
     this->file_path_ = js_access_info["data_path"].get<std::string>();
   } catch (std::exception& e) {
     this->file_path_ = access_info;
@@ -324,7 +634,8 @@ retcode CSVAccessInfo::ParseFromMetaInfoImpl(const DatasetMetaInfo& meta_info) {
     }
     return retcode::SUCCESS;
   }
-  return retcode::SUCCESS;
+  // out of the try, a bad option must not be taken as the path
+  return ParseLoadOptions(js_access_info);
 }
 
 // csv cursor implementation
@@ -438,6 +749,14 @@ retcode CSVCursor::MakeCsvOptions(
     CsvOptions* options) {
   auto& read_options = options->read_options;
   read_options.skip_rows = 1;  // skip title row
+  auto access_info =
+      dynamic_cast<CSVAccessInfo*>(this->driver_->dataSetAccessInfo().get());
+  if (access_info != nullptr) {
+    read_options.use_threads = access_info->use_threads;
+    if (access_info->block_size > 0) {
+      read_options.block_size = access_info->block_size;
+    }
+  }
   auto& arrow_schema = this->driver_->dataSetAccessInfo()->arrow_schema;
   auto field_names = arrow_schema->field_names();
   read_options.column_names = field_names;
@@ -492,15 +811,95 @@ std::shared_ptr<Dataset> CSVCursor::read() {
 }
 
 std::shared_ptr<Dataset> CSVCursor::read(int64_t offset, int64_t limit) {
-  return nullptr;
+  if (offset < 0 || limit < 0) {
+    std::stringstream ss;
+    ss << "invalid offset: " << offset << " or limit: " << limit;
+    RaiseException(ss.str());
+  }
+  auto reader = MakeStreamingReader();
+  if (reader == nullptr) {
+    return nullptr;
+  }
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  int64_t rows_to_skip = offset;
+  int64_t collected_rows = 0;
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (collected_rows < limit) {
+    csv::ReadNextBatch(reader.get(), &batch);
+    if (batch == nullptr) {
+      break;
+    }
+    int64_t num_rows = batch->num_rows();
+    if (rows_to_skip >= num_rows) {
+      rows_to_skip -= num_rows;
+      continue;
+    }
+    int64_t length = std::min(num_rows - rows_to_skip, limit - collected_rows);
+    batches.push_back(batch->Slice(rows_to_skip, length));
+    collected_rows += length;
+    rows_to_skip = 0;
+  }
+  auto result = arrow::Table::FromRecordBatches(reader->schema(), batches);
+  if (!result.ok()) {
+    std::stringstream ss;
+    ss << "make table from batches failed, " << result.status();
+    RaiseException(ss.str());
+  }
+  return std::make_shared<Dataset>(result.ValueOrDie(), this->driver_);
+}
+
+std::shared_ptr<arrow::RecordBatch> CSVCursor::next(int64_t batch_size) {
+  if (batch_size <= 0) {
+    RaiseException("batch size must be positive");
+  }
+  if (stream_reader_ == nullptr) {
+    stream_reader_ = MakeStreamingReader();
+    if (stream_reader_ == nullptr) {
+      return nullptr;
+    }
+  }
+  if (pending_batch_ == nullptr) {
+    csv::ReadNextBatch(stream_reader_.get(), &pending_batch_);
+    if (pending_batch_ == nullptr) {
+      return nullptr;
+    }
+  }
+  std::shared_ptr<arrow::RecordBatch> batch;
+  if (pending_batch_->num_rows() <= batch_size) {
+    batch = std::move(pending_batch_);
+    pending_batch_ = nullptr;
+  } else {
+    batch = pending_batch_->Slice(0, batch_size);
+    pending_batch_ = pending_batch_->Slice(batch_size);
+  }
+  next_offset_ += batch->num_rows();
+  return batch;
+}
+
+void CSVCursor::rewind() {
+  stream_reader_.reset();
+  pending_batch_.reset();
+  next_offset_ = 0;
+}
+
+std::shared_ptr<arrow::csv::StreamingReader> CSVCursor::MakeStreamingReader() {
+  CsvOptions csv_options;
+  auto ret = MakeCsvOptions(&csv_options);
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "make csv file options failed";
+    return nullptr;
+  }
+  return csv::OpenCSVStream(this->file_path_, csv_options.read_options,
+                            csv_options.parse_options,
+                            csv_options.convert_options);
 }
 
 std::shared_ptr<Dataset> CSVCursor::ReadImpl(const std::string& file_path,
     const ReadOptions& read_options,
     const ParseOptions& parse_options,
     const ConvertOptions& convert_options) {
-  auto arrow_table = csv::ReadCSVFile(file_path, read_options,
-                                      parse_options, convert_options);
+  auto arrow_table = ReadWithCache(file_path, read_options,
+                                   parse_options, convert_options);
   if (arrow_table == nullptr) {
     return nullptr;
   }
@@ -508,6 +907,45 @@ std::shared_ptr<Dataset> CSVCursor::ReadImpl(const std::string& file_path,
   return dataset;
 }
 
+std::shared_ptr<arrow::Table> CSVCursor::ReadWithCache(
+    const std::string& file_path,
+    const ReadOptions& read_options,
+    const ParseOptions& parse_options,
+    const ConvertOptions& convert_options) {
+  auto access_info =
+      dynamic_cast<CSVAccessInfo*>(this->driver_->dataSetAccessInfo().get());
+  if (access_info == nullptr || access_info->cache_dir.empty()) {
+    return csv::ReadCSVFile(file_path, read_options,
+                            parse_options, convert_options);
+  }
+  std::string cache_key = csv::MakeCacheKey(
+      file_path, read_options, parse_options, convert_options);
+  if (cache_key.empty()) {
+    return csv::ReadCSVFile(file_path, read_options,
+                            parse_options, convert_options);
+  }
+  std::string cache_file =
+      csv::MakeCacheFilePath(access_info->cache_dir, cache_key);
+  SCopedTimer timer;
+  auto arrow_table = csv::LoadCache(cache_file, cache_key);
+  if (arrow_table != nullptr) {
+    VLOG(5) << "load " << file_path << " from cache: " << cache_file << " "
+            << "time cost(ms): " << timer.timeElapse();
+    return arrow_table;
+  }
+  arrow_table = csv::ReadCSVFile(file_path, read_options,
+                                 parse_options, convert_options);
+  if (arrow_table != nullptr) {
+    auto ret = csv::StoreCache(cache_file, cache_key, arrow_table);
+    if (ret == retcode::SUCCESS) {
+      VLOG(5) << "store parsed data of " << file_path << " "
+              << "to cache: " << cache_file;
+      csv::EvictCache(access_info->cache_dir, access_info->cache_max_files);
+    }
+  }
+  return arrow_table;
+}
+
 std::shared_ptr<Dataset> CSVCursor::ReadImpl(std::string_view input_data,
     const ReadOptions& read_options,
     const ParseOptions& parse_options,
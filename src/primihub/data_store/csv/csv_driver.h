@@ -41,8 +41,23 @@ struct CSVAccessInfo : public DataSetAccessInfo {
   retcode ParseFromYamlConfigImpl(const YAML::Node& meta_info) override;
   retcode ParseFromMetaInfoImpl(const DatasetMetaInfo& meta_info) override;
 
+ protected:
+  /**
+   * optional loading options: useThreads, blockSize, cacheDir, cacheMaxFiles
+   * FAIL with the key logged if an option has a wrong type
+  */
+  retcode ParseLoadOptions(const nlohmann::json& js_access_info);
+
  public:
   std::string file_path_;
+  // parse blocks of file concurrently
+  bool use_threads{true};
+  // bytes of each parsing block, 0 means arrow default
+  int32_t block_size{0};
+  // dir of parsed data cache in arrow ipc format, empty means disabled
+  std::string cache_dir;
+  // max number of cache files kept in cache_dir, least recently used go first
+  uint32_t cache_max_files{64};
 };
 
 class CSVCursor : public Cursor {
@@ -66,10 +81,20 @@ class CSVCursor : public Cursor {
   std::shared_ptr<Dataset> read(
       const std::shared_ptr<arrow::Schema>& data_schema) override;
   std::shared_ptr<Dataset> read(int64_t offset, int64_t limit) override;
+  /**
+   * batches are read from file by arrow::csv::StreamingReader,
+   * the file is never loaded as a whole
+  */
+  std::shared_ptr<arrow::RecordBatch> next(int64_t batch_size) override;
+  void rewind() override;
   int write(std::shared_ptr<Dataset> dataset) override;
   void close() override;
 
  protected:
+  /**
+   * open a streaming reader over the file using options of this cursor
+  */
+  std::shared_ptr<arrow::csv::StreamingReader> MakeStreamingReader();
   /**
    * convert column index to column name
   */
@@ -100,6 +125,15 @@ class CSVCursor : public Cursor {
                                     const ParseOptions& parse_opt,
                                     const ConvertOptions& convert_opt);
 
+  /**
+   * read from parsed data cache if present and up to date,
+   * otherwise parse the csv file and refresh the cache
+  */
+  std::shared_ptr<arrow::Table> ReadWithCache(const std::string& file_path,
+                                              const ReadOptions& read_opt,
+                                              const ParseOptions& parse_opt,
+                                              const ConvertOptions& convert_opt);
+
   std::shared_ptr<Dataset> ReadImpl(std::string_view content_buf,
                                     const ReadOptions& read_opt,
                                     const ParseOptions& parse_opt,
@@ -110,6 +144,9 @@ class CSVCursor : public Cursor {
   unsigned long long offset_{0};   // NOLINT
   std::shared_ptr<CSVDriver> driver_;
   std::vector<int> colum_index_;
+  std::shared_ptr<arrow::csv::StreamingReader> stream_reader_{nullptr};
+  // rows read from stream but not returned by next yet
+  std::shared_ptr<arrow::RecordBatch> pending_batch_{nullptr};
 };
 
 class CSVDriver : public DataDriver,
@@ -15,7 +15,9 @@
  */
 
 #include "src/primihub/data_store/driver.h"
+#include <arrow/api.h>
 #include "src/primihub/util/arrow_wrapper_util.h"
+#include "src/primihub/common/value_check_util.h"
 
 namespace primihub {
 
@@ -196,6 +198,45 @@ Cursor::MakeArrowSchema(const std::vector<FieldType>& data_schema) {
   VLOG(5) << "arrow_schema: " << arrow_schema->field_names().size();
   return arrow_schema;
 }
+
+std::shared_ptr<arrow::RecordBatch> Cursor::next(int64_t batch_size) {
+  if (batch_size <= 0) {
+    RaiseException("batch size must be positive");
+  }
+  auto dataset = read(next_offset_, batch_size);
+  if (dataset == nullptr) {
+    return nullptr;
+  }
+  auto& table = std::get<std::shared_ptr<arrow::Table>>(dataset->data);
+  if (table == nullptr || table->num_rows() == 0) {
+    return nullptr;
+  }
+  next_offset_ += table->num_rows();
+  return TableToRecordBatch(table);
+}
+
+std::shared_ptr<arrow::RecordBatch> Cursor::TableToRecordBatch(
+    const std::shared_ptr<arrow::Table>& table) {
+  auto result = table->CombineChunks();
+  if (!result.ok()) {
+    RaiseException("combine chunks failed: " + result.status().ToString());
+  }
+  auto combined_table = result.ValueOrDie();
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  columns.reserve(combined_table->num_columns());
+  for (const auto& column : combined_table->columns()) {
+    if (column->num_chunks() == 0) {
+      auto empty_array = arrow::MakeArrayOfNull(column->type(), 0);
+      columns.push_back(empty_array.ValueOrDie());
+    } else {
+      columns.push_back(column->chunk(0));
+    }
+  }
+  return arrow::RecordBatch::Make(combined_table->schema(),
+                                  combined_table->num_rows(),
+                                  std::move(columns));
+}
+
 ////////////////////// DataDriver /////////////////////////////
 std::string DataDriver::getDriverType() const {
   return driver_type;
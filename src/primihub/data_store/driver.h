@@ -88,7 +88,22 @@ class Cursor {
   virtual ~Cursor() = default;
   virtual std::shared_ptr<Dataset> readMeta() = 0;
   virtual std::shared_ptr<Dataset> read() = 0;
+  /**
+   * read at most limit rows after skipping the first offset rows,
+   * the result is empty if offset is beyond the end of data
+  */
   virtual std::shared_ptr<Dataset> read(int64_t offset, int64_t limit) = 0;
+  /**
+   * iterate over data batch by batch, memory is bounded by one batch,
+   * each batch has at most batch_size rows,
+   * return nullptr when all data has been read.
+   * the default implementation pages through read(offset, limit)
+  */
+  virtual std::shared_ptr<arrow::RecordBatch> next(int64_t batch_size);
+  /**
+   * restart the iteration of next from the first row
+  */
+  virtual void rewind() {next_offset_ = 0;}
   virtual std::shared_ptr<Dataset> read(const std::vector<FieldType>& data_schema) {
     auto arrow_schema = MakeArrowSchema(data_schema);
     return read(arrow_schema);
@@ -101,9 +116,17 @@ class Cursor {
 
  protected:
   std::shared_ptr<arrow::Schema> MakeArrowSchema(const std::vector<FieldType>& data_schema);
+  /**
+   * merge chunks of table into one record batch
+  */
+  std::shared_ptr<arrow::RecordBatch> TableToRecordBatch(
+      const std::shared_ptr<arrow::Table>& table);
 
  public:
   std::vector<int> selected_column_index_;
+
+ protected:
+  int64_t next_offset_{0};
 };
 
 class DataDriver {
@@ -0,0 +1,122 @@
+/*
+ Copyright 2023 PrimiHub
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "src/primihub/data_store/mysql/column_builder.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <limits>
+
+namespace primihub {
+namespace mysql {
+ColumnBuilder::ColumnBuilder(int field_type) {
+  switch (field_type) {
+  case arrow::Type::type::INT64:
+  case arrow::Type::type::UINT64:
+    kind_ = Kind::kInt64;
+    builder_ = std::make_unique<arrow::Int64Builder>();
+    break;
+  case arrow::Type::type::INT32:
+  case arrow::Type::type::INT16:
+  case arrow::Type::type::INT8:
+  case arrow::Type::type::UINT32:
+  case arrow::Type::type::UINT16:
+  case arrow::Type::type::UINT8:
+    kind_ = Kind::kInt32;
+    builder_ = std::make_unique<arrow::Int32Builder>();
+    break;
+  case arrow::Type::type::FLOAT:
+    kind_ = Kind::kFloat;
+    builder_ = std::make_unique<arrow::FloatBuilder>();
+    break;
+  case arrow::Type::type::DOUBLE:
+    kind_ = Kind::kDouble;
+    builder_ = std::make_unique<arrow::DoubleBuilder>();
+    break;
+  default:
+    kind_ = Kind::kString;
+    builder_ = std::make_unique<arrow::StringBuilder>();
+    break;
+  }
+}
+
+arrow::Status ColumnBuilder::AppendText(const char* data,
+                                        unsigned long length) {  // NOLINT
+  if (data == nullptr) {
+    return builder_->AppendNull();
+  }
+  switch (kind_) {
+  case Kind::kInt32:
+  case Kind::kInt64: {
+    int64_t value{0};
+    auto res = std::from_chars(data, data + length, value);
+    if (res.ec != std::errc() || res.ptr != data + length || length == 0) {
+      return builder_->AppendNull();
+    }
+    return AppendInt64(value);
+  }
+  case Kind::kFloat:
+  case Kind::kDouble: {
+    char* end{nullptr};
+    double value = std::strtod(data, &end);
+    if (length == 0 || end != data + length) {
+      return builder_->AppendNull();
+    }
+    return AppendDouble(value);
+  }
+  default:
+    return static_cast<arrow::StringBuilder*>(builder_.get())->Append(
+        data, static_cast<int32_t>(length));
+  }
+}
+
+arrow::Status ColumnBuilder::AppendInt64(int64_t value) {
+  if (kind_ == Kind::kInt32) {
+    // value out of int32 range can not be represented, treat as null
+    if (value < std::numeric_limits<int32_t>::min() ||
+        value > std::numeric_limits<int32_t>::max()) {
+      return builder_->AppendNull();
+    }
+    return static_cast<arrow::Int32Builder*>(builder_.get())->Append(
+        static_cast<int32_t>(value));
+  }
+  return static_cast<arrow::Int64Builder*>(builder_.get())->Append(value);
+}
+
+arrow::Status ColumnBuilder::AppendUInt64(uint64_t value) {
+  if (value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+    return builder_->AppendNull();
+  }
+  return AppendInt64(static_cast<int64_t>(value));
+}
+
+arrow::Status ColumnBuilder::AppendDouble(double value) {
+  if (kind_ == Kind::kFloat) {
+    return static_cast<arrow::FloatBuilder*>(builder_.get())->Append(
+        static_cast<float>(value));
+  }
+  return static_cast<arrow::DoubleBuilder*>(builder_.get())->Append(value);
+}
+
+arrow::Status ColumnBuilder::AppendNull() {
+  return builder_->AppendNull();
+}
+
+arrow::Status ColumnBuilder::Finish(std::shared_ptr<arrow::Array>* out) {
+  return builder_->Finish(out);
+}
+}  // namespace mysql
+}  // namespace primihub
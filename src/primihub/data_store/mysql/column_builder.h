@@ -0,0 +1,56 @@
+/*
+ Copyright 2023 PrimiHub
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef SRC_PRIMIHUB_DATA_STORE_MYSQL_COLUMN_BUILDER_H_
+#define SRC_PRIMIHUB_DATA_STORE_MYSQL_COLUMN_BUILDER_H_
+#include <arrow/api.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace primihub {
+namespace mysql {
+/**
+ * append mysql cell into arrow builder without intermediate std::string,
+ * the array type is kept the same as arrow_wrapper::util::MakeArrowArray,
+ * NULL and unparsable or out of range numeric cell are appended as null
+*/
+class ColumnBuilder {
+ public:
+  enum class Kind {kInt32, kInt64, kFloat, kDouble, kString};
+  explicit ColumnBuilder(int field_type);
+
+  Kind kind() const {return kind_;}
+  bool IsNumeric() const {return kind_ != Kind::kString;}
+
+  /**
+   * data: text of the cell, nullptr for NULL,
+   * text from MYSQL_ROW is always terminated by '\0'
+  */
+  arrow::Status AppendText(const char* data, unsigned long length);  // NOLINT
+  arrow::Status AppendInt64(int64_t value);
+  arrow::Status AppendUInt64(uint64_t value);
+  arrow::Status AppendDouble(double value);
+  arrow::Status AppendNull();
+  arrow::Status Finish(std::shared_ptr<arrow::Array>* out);
+
+ private:
+  Kind kind_{Kind::kString};
+  std::unique_ptr<arrow::ArrayBuilder> builder_{nullptr};
+};
+}  // namespace mysql
+}  // namespace primihub
+#endif  // SRC_PRIMIHUB_DATA_STORE_MYSQL_COLUMN_BUILDER_H_
@@ -19,12 +19,16 @@
 #include <arrow/api.h>
 #include <arrow/io/api.h>
 
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <type_traits>
 
 #include <nlohmann/json.hpp>
 #include "src/primihub/data_store/driver.h"
+#include "src/primihub/data_store/mysql/column_builder.h"
 #include "src/primihub/util/util.h"
 #include "src/primihub/util/thread_local_data.h"
 #include "src/primihub/common/value_check_util.h"
@@ -50,6 +54,12 @@ std::string MySQLAccessInfo::toString() {
     js["query_index"] = std::move(quey_col_info);
   }
   js["dbUrl"] = this->db_url;
+  if (use_binary_protocol) {
+    js["useBinaryProtocol"] = true;
+  }
+  if (!order_by.empty()) {
+    js["orderBy"] = this->order_by;
+  }
   js["schema"] = SchemaToJsonString();
   // ss << std::setw(4) << js;
   ss << js;
@@ -71,6 +81,12 @@ retcode MySQLAccessInfo::ParseFromJsonImpl(const nlohmann::json& access_info) {
     if (js.contains("dbUrl")) {
       this->db_url = js["dbUrl"].get<std::string>();
     }
+    if (js.contains("useBinaryProtocol")) {
+      this->use_binary_protocol = js["useBinaryProtocol"].get<bool>();
+    }
+    if (js.contains("orderBy")) {
+      this->order_by = js["orderBy"].get<std::string>();
+    }
     this->query_colums.clear();
   } catch (std::exception& e) {
     std::stringstream ss;
@@ -114,6 +130,12 @@ retcode MySQLAccessInfo::ParseFromYamlConfigImpl(const YAML::Node& meta_info) {
     if (meta_info["dbUrl"]) {
       this->db_url = meta_info["dbUrl"].as<std::string>();
     }
+    if (meta_info["useBinaryProtocol"]) {
+      this->use_binary_protocol = meta_info["useBinaryProtocol"].as<bool>();
+    }
+    if (meta_info["orderBy"]) {
+      this->order_by = meta_info["orderBy"].as<std::string>();
+    }
   } catch (std::exception& e) {
     size_t len = strlen(e.what());
     len = len > 1024 ? 1024 : len;
@@ -130,6 +152,54 @@ auto sql_result_deleter = [](MYSQL_RES* result) {
   }
 };
 
+auto sql_stmt_deleter = [](MYSQL_STMT* stmt) {
+  if (stmt) {
+    mysql_stmt_close(stmt);
+  }
+};
+
+namespace {
+using mysql::ColumnBuilder;
+
+std::vector<ColumnBuilder> MakeColumnBuilders(
+    const std::shared_ptr<arrow::Schema>& table_schema, size_t num_fields) {
+  int schema_fields = table_schema->num_fields();
+  std::vector<ColumnBuilder> builders;
+  builders.reserve(num_fields);
+  for (size_t i = 0; i < num_fields; i++) {
+    if (i >= static_cast<size_t>(schema_fields)) {
+      std::stringstream ss;
+      ss << "index out of range, current index: " << i << " "
+          << "total colnum fields: " << schema_fields;
+      RaiseException(ss.str());
+    }
+    auto& field_ptr = table_schema->field(i);
+    int field_type = field_ptr->type()->id();
+    VLOG(7) << "field_name: " << field_ptr->name() << " type: " << field_type;
+    builders.emplace_back(field_type);
+  }
+  return builders;
+}
+
+void FinishColumnBuilders(std::vector<ColumnBuilder>* builders,
+                          std::vector<std::shared_ptr<arrow::Array>>* data_arr) {
+  for (auto& builder : *builders) {
+    std::shared_ptr<arrow::Array> array;
+    auto status = builder.Finish(&array);
+    if (!status.ok()) {
+      RaiseException("build arrow array failed: " + status.ToString());
+    }
+    data_arr->push_back(std::move(array));
+  }
+}
+
+void CheckAppendStatus(const arrow::Status& status) {
+  if (!status.ok()) {
+    RaiseException("append data to arrow builder failed: " + status.ToString());
+  }
+}
+}  // namespace
+
 MySQLCursor::MySQLCursor(const std::string& sql, std::shared_ptr<MySQLDriver> driver) {
   this->sql_ = sql;
   this->driver_ = driver;
@@ -151,7 +221,14 @@ MySQLCursor::~MySQLCursor() {
   this->close();
 }
 
-void MySQLCursor::close() {}
+void MySQLCursor::close() {
+  // result must be released before the connection is closed
+  if (stream_result_ != nullptr) {
+    mysql_free_result(stream_result_);
+    stream_result_ = nullptr;
+  }
+  stream_conn_.reset();
+}
 
 std::shared_ptr<arrow::Schema> MySQLCursor::makeArrowSchema() {
   auto arrow_schema = this->driver_->dataSetAccessInfo()->ArrowSchema();
@@ -207,13 +284,30 @@ retcode MySQLCursor::fetchData(const std::string& query_sql,
     std::vector<std::shared_ptr<arrow::Array>>* data_arr) {
   SCopedTimer timer;
   VLOG(0) << "FetchData using Query SQL: [" << this->sql_ << "]";
-  std::vector<std::vector<std::string>> result_data;
   // fetch data from db
-  auto db_conn_ptr = this->getDBConnector(this->driver_->dataSetAccessInfo());
+  auto& access_info_ptr = this->driver_->dataSetAccessInfo();
+  auto db_conn_ptr = this->getDBConnector(access_info_ptr);
   auto db_connector = db_conn_ptr.get();
   if (query_sql.empty()) {
     RaiseException("empty query sql is invalid");
   }
+  auto access_info = dynamic_cast<MySQLAccessInfo*>(access_info_ptr.get());
+  retcode ret{retcode::SUCCESS};
+  if (access_info != nullptr && access_info->use_binary_protocol) {
+    ret = FetchBinaryResult(db_connector, query_sql, table_schema, data_arr);
+  } else {
+    ret = FetchTextResult(db_connector, query_sql, table_schema, data_arr);
+  }
+  VLOG(5) << "fetch data and build arrow data total cost(ms): "
+          << timer.timeElapse();
+  VLOG(5) << "end of fetch data: " << data_arr->size();
+  return ret;
+}
+
+retcode MySQLCursor::FetchTextResult(MYSQL* db_connector,
+    const std::string& query_sql,
+    const std::shared_ptr<arrow::Schema>& table_schema,
+    std::vector<std::shared_ptr<arrow::Array>>* data_arr) {
   if (0 != mysql_real_query(db_connector,
                             query_sql.data(), query_sql.length())) {
     std::stringstream ss;
@@ -238,46 +332,165 @@ retcode MySQLCursor::fetchData(const std::string& query_sql,
         << " expected: " << selected_fields;
     RaiseException(ss.str());
   }
-  result_data.resize(num_fields);
+  auto builders = MakeColumnBuilders(table_schema, num_fields);
   MYSQL_ROW row;
   while (nullptr != (row = mysql_fetch_row(result.get()))) {
-    unsigned long* lengths;
-    lengths = mysql_fetch_lengths(result.get());
+    unsigned long* lengths = mysql_fetch_lengths(result.get());
     for (uint32_t i = 0; i < num_fields; i++) {
-      std::string item{"NA"};
-      if (lengths[i] > 0) {
-        item = std::string(row[i], lengths[i]);
-      }
-      // VLOG(7) << "fetch item: " << item << " length: " << lengths[i];
-      result_data[i].push_back(std::move(item));
+      CheckAppendStatus(builders[i].AppendText(row[i], lengths[i]));
     }
   }
-  auto fetch_cost = timer.timeElapse();
-  VLOG(5) << "mysql_fetch_row cost(ms): " << fetch_cost;
-  auto start_ = timer.timeElapse();
-  int schema_fields = table_schema->num_fields();
-  auto& all_select_index = this->SelectedColumnIndex();
-  for (size_t i = 0; i < selected_fields; i++) {
-    // int index = all_select_index[i];
-    if (i < schema_fields) {
-      auto& field_ptr = table_schema->field(i);
-      int field_type = field_ptr->type()->id();
-      VLOG(7) << "field_name: " << field_ptr->name() << " type: " << field_type;
-      auto array = arrow_wrapper::util::MakeArrowArray(field_type, result_data[i]);
-      data_arr->push_back(std::move(array));
-    } else {
-      std::stringstream ss;
-      ss << "index out of range, current index: " << i << " "
-          << "total colnum fields: " << schema_fields;
-      RaiseException(ss.str());
-    }
+  if (mysql_errno(db_connector) != 0) {
+    std::stringstream ss;
+    ss << "fetch row failed: " << mysql_error(db_connector);
+    RaiseException(ss.str());
   }
-  auto end_ = timer.timeElapse();
-  auto buid_data_cost = end_ - start_;
-  VLOG(5) << "build arrow data time cost(ms): " << buid_data_cost
-          << " total cost(ms): " << end_;
+  FinishColumnBuilders(&builders, data_arr);
+  return retcode::SUCCESS;
+}
 
-  VLOG(5) << "end of fetch data: " << data_arr->size();
+retcode MySQLCursor::FetchBinaryResult(MYSQL* db_connector,
+    const std::string& query_sql,
+    const std::shared_ptr<arrow::Schema>& table_schema,
+    std::vector<std::shared_ptr<arrow::Array>>* data_arr) {
+  using StmtPtr = std::unique_ptr<MYSQL_STMT, decltype(sql_stmt_deleter)>;
+  StmtPtr stmt{mysql_stmt_init(db_connector), sql_stmt_deleter};
+  if (stmt == nullptr) {
+    std::stringstream ss;
+    ss << "init statement failed: " << mysql_error(db_connector);
+    RaiseException(ss.str());
+  }
+  if (0 != mysql_stmt_prepare(stmt.get(),
+                              query_sql.data(), query_sql.length())) {
+    std::stringstream ss;
+    ss << "prepare statement failed: " << mysql_stmt_error(stmt.get());
+    RaiseException(ss.str());
+  }
+  uint32_t num_fields = mysql_stmt_field_count(stmt.get());
+  VLOG(5) << "numbers of fields: " << num_fields;
+  size_t selected_fields = this->SelectedColumnIndex().size();
+  if (num_fields != selected_fields) {
+    std::stringstream ss;
+    ss << "query column size does not match, query size: " << num_fields
+        << " expected: " << selected_fields;
+    RaiseException(ss.str());
+  }
+  if (0 != mysql_stmt_execute(stmt.get())) {
+    std::stringstream ss;
+    ss << "execute statement failed: " << mysql_stmt_error(stmt.get());
+    RaiseException(ss.str());
+  }
+  auto builders = MakeColumnBuilders(table_schema, num_fields);
+  // signedness of integer columns is taken from result metadata
+  using ResultPtr = std::unique_ptr<MYSQL_RES, decltype(sql_result_deleter)>;
+  ResultPtr metadata{mysql_stmt_result_metadata(stmt.get()),
+                     sql_result_deleter};
+  if (metadata == nullptr) {
+    std::stringstream ss;
+    ss << "fetch result metadata failed: " << mysql_stmt_error(stmt.get());
+    RaiseException(ss.str());
+  }
+  MYSQL_FIELD* fields = mysql_fetch_fields(metadata.get());
+  // result buffer of each column, server converts value to the bound type
+  using null_flag_t = std::remove_pointer_t<decltype(MYSQL_BIND::is_null)>;
+  constexpr size_t kInitStringBufferSize = 256;
+  std::vector<MYSQL_BIND> binds(num_fields);
+  std::vector<int64_t> int_values(num_fields, 0);
+  std::vector<double> double_values(num_fields, 0);
+  std::vector<std::vector<char>> str_values(num_fields);
+  std::vector<unsigned long> lengths(num_fields, 0);
+  std::vector<null_flag_t> is_null(num_fields, 0);
+  // set by client if the value is truncated when converted to bound type
+  std::vector<null_flag_t> is_error(num_fields, 0);
+  memset(binds.data(), 0, sizeof(MYSQL_BIND) * num_fields);
+  for (uint32_t i = 0; i < num_fields; i++) {
+    auto& bind = binds[i];
+    switch (builders[i].kind()) {
+    case ColumnBuilder::Kind::kInt32:
+    case ColumnBuilder::Kind::kInt64:
+      bind.buffer_type = MYSQL_TYPE_LONGLONG;
+      bind.buffer = &int_values[i];
+      bind.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+      break;
+    case ColumnBuilder::Kind::kFloat:
+    case ColumnBuilder::Kind::kDouble:
+      bind.buffer_type = MYSQL_TYPE_DOUBLE;
+      bind.buffer = &double_values[i];
+      break;
+    default:
+      str_values[i].resize(kInitStringBufferSize);
+      bind.buffer_type = MYSQL_TYPE_STRING;
+      bind.buffer = str_values[i].data();
+      bind.buffer_length = str_values[i].size();
+      break;
+    }
+    bind.length = &lengths[i];
+    bind.is_null = &is_null[i];
+    bind.error = &is_error[i];
+  }
+  if (0 != mysql_stmt_bind_result(stmt.get(), binds.data())) {
+    std::stringstream ss;
+    ss << "bind result failed: " << mysql_stmt_error(stmt.get());
+    RaiseException(ss.str());
+  }
+  // rows are streamed from server, mysql_stmt_store_result is not called
+  std::vector<char> long_str_buf;
+  int fetch_ret{0};
+  while ((fetch_ret = mysql_stmt_fetch(stmt.get())) == 0 ||
+         fetch_ret == MYSQL_DATA_TRUNCATED) {
+    for (uint32_t i = 0; i < num_fields; i++) {
+      auto& builder = builders[i];
+      if (is_null[i]) {
+        CheckAppendStatus(builder.AppendNull());
+        continue;
+      }
+      // truncated number such as '12abc' or out of range value,
+      // appended as null the same as text protocol
+      if (builder.IsNumeric() && is_error[i]) {
+        CheckAppendStatus(builder.AppendNull());
+        continue;
+      }
+      switch (builder.kind()) {
+      case ColumnBuilder::Kind::kInt32:
+      case ColumnBuilder::Kind::kInt64:
+        if (binds[i].is_unsigned) {
+          CheckAppendStatus(
+              builder.AppendUInt64(static_cast<uint64_t>(int_values[i])));
+        } else {
+          CheckAppendStatus(builder.AppendInt64(int_values[i]));
+        }
+        break;
+      case ColumnBuilder::Kind::kFloat:
+      case ColumnBuilder::Kind::kDouble:
+        CheckAppendStatus(builder.AppendDouble(double_values[i]));
+        break;
+      default: {
+        const char* data = str_values[i].data();
+        if (lengths[i] > binds[i].buffer_length) {
+          // value is truncated, fetch the whole value of this column
+          long_str_buf.resize(lengths[i]);
+          MYSQL_BIND column_bind = binds[i];
+          column_bind.buffer = long_str_buf.data();
+          column_bind.buffer_length = long_str_buf.size();
+          if (0 != mysql_stmt_fetch_column(stmt.get(), &column_bind, i, 0)) {
+            std::stringstream ss;
+            ss << "fetch column failed: " << mysql_stmt_error(stmt.get());
+            RaiseException(ss.str());
+          }
+          data = long_str_buf.data();
+        }
+        CheckAppendStatus(builder.AppendText(data, lengths[i]));
+        break;
+      }
+      }
+    }
+  }
+  if (fetch_ret != MYSQL_NO_DATA) {
+    std::stringstream ss;
+    ss << "fetch row failed: " << mysql_stmt_error(stmt.get());
+    RaiseException(ss.str());
+  }
+  FinishColumnBuilders(&builders, data_arr);
   return retcode::SUCCESS;
 }
 
@@ -308,7 +521,181 @@ std::shared_ptr<Dataset> MySQLCursor::read(
 }
 
 std::shared_ptr<Dataset> MySQLCursor::read(int64_t offset, int64_t limit) {
-  return nullptr;
+  if (offset < 0 || limit < 0) {
+    std::stringstream ss;
+    ss << "invalid offset: " << offset << " or limit: " << limit;
+    RaiseException(ss.str());
+  }
+  // LIMIT without ORDER BY gives no stable order between pages
+  std::string query_sql = this->sql_;
+  query_sql.append(OrderByClause())
+           .append(" LIMIT ").append(std::to_string(offset))
+           .append(", ").append(std::to_string(limit));
+  auto schema = makeArrowSchema();
+  std::vector<std::shared_ptr<arrow::Array>> array_data;
+  auto ret = fetchData(query_sql, schema, &array_data);
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "fetchdata failed using sql: " << query_sql;
+    return nullptr;
+  }
+  auto table = arrow::Table::Make(schema, array_data);
+  return std::make_shared<Dataset>(table, this->driver_);
+}
+
+std::string MySQLCursor::OrderByClause() {
+  if (!order_by_clause_.empty()) {
+    return order_by_clause_;
+  }
+  auto access_info =
+      dynamic_cast<MySQLAccessInfo*>(this->driver_->dataSetAccessInfo().get());
+  if (access_info == nullptr) {
+    RaiseException("access info for mysql is not available");
+  }
+  std::vector<std::string> order_keys;
+  if (!access_info->order_by.empty()) {
+    str_split(access_info->order_by, &order_keys, ',');
+  } else {
+    auto ret = GetPrimaryKey(&order_keys);
+    if (ret != retcode::SUCCESS) {
+      RaiseException("get primary key of table failed");
+    }
+  }
+  std::string order_by_clause;
+  for (auto& key : order_keys) {
+    auto begin = key.find_first_not_of(" `");
+    if (begin == std::string::npos) {
+      continue;
+    }
+    auto end = key.find_last_not_of(" `");
+    order_by_clause.append(order_by_clause.empty() ? " ORDER BY " : ",")
+        .append("`").append(key.substr(begin, end - begin + 1)).append("`");
+  }
+  if (order_by_clause.empty()) {
+    std::stringstream ss;
+    ss << "paged read of table: " << access_info->table_name << " "
+       << "needs a stable row order, set orderBy in access info "
+       << "or add a primary key to the table";
+    RaiseException(ss.str());
+  }
+  order_by_clause_ = std::move(order_by_clause);
+  return order_by_clause_;
+}
+
+retcode MySQLCursor::GetPrimaryKey(std::vector<std::string>* primary_key) {
+  auto& access_info_ptr = this->driver_->dataSetAccessInfo();
+  auto access_info = dynamic_cast<MySQLAccessInfo*>(access_info_ptr.get());
+  if (access_info == nullptr) {
+    LOG(ERROR) << "access info for mysql is not available";
+    return retcode::FAIL;
+  }
+  std::string query_sql{
+      "SELECT `COLUMN_NAME` FROM information_schema.KEY_COLUMN_USAGE "
+      "WHERE CONSTRAINT_NAME = 'PRIMARY' AND TABLE_NAME = '"};
+  query_sql.append(access_info->table_name);
+  query_sql.append("' AND TABLE_SCHEMA = '");
+  query_sql.append(access_info->db_name);
+  query_sql.append("' ORDER BY ORDINAL_POSITION ASC");
+  auto db_conn_ptr = this->getDBConnector(access_info_ptr);
+  auto db_connector = db_conn_ptr.get();
+  if (0 != mysql_real_query(db_connector,
+                            query_sql.data(), query_sql.length())) {
+    LOG(ERROR) << "query primary key failed: " << mysql_error(db_connector);
+    return retcode::FAIL;
+  }
+  using ResultPtr = std::unique_ptr<MYSQL_RES, decltype(sql_result_deleter)>;
+  ResultPtr result{mysql_use_result(db_connector), sql_result_deleter};
+  if (result == nullptr) {
+    LOG(ERROR) << "fetch primary key failed: " << mysql_error(db_connector);
+    return retcode::FAIL;
+  }
+  MYSQL_ROW row;
+  while (nullptr != (row = mysql_fetch_row(result.get()))) {
+    unsigned long* lengths = mysql_fetch_lengths(result.get());
+    primary_key->emplace_back(row[0], lengths[0]);
+  }
+  VLOG(5) << "primary key size of " << access_info->table_name << ": "
+          << primary_key->size();
+  return retcode::SUCCESS;
+}
+
+void MySQLCursor::OpenStream() {
+  stream_schema_ = makeArrowSchema();
+  auto& access_info_ptr = this->driver_->dataSetAccessInfo();
+  // closure type of the deleter is not assignable, move the handle by release
+  stream_conn_.reset(this->getDBConnector(access_info_ptr).release());
+  auto db_connector = stream_conn_.get();
+  VLOG(5) << "open stream using Query SQL: [" << this->sql_ << "]";
+  if (0 != mysql_real_query(db_connector,
+                            this->sql_.data(), this->sql_.length())) {
+    std::stringstream ss;
+    ss << "query execute failed: " << mysql_error(db_connector);
+    this->close();
+    RaiseException(ss.str());
+  }
+  stream_result_ = mysql_use_result(db_connector);
+  if (stream_result_ == nullptr) {
+    std::stringstream ss;
+    ss << "fetch result failed: " << mysql_error(db_connector);
+    this->close();
+    RaiseException(ss.str());
+  }
+  uint32_t num_fields = mysql_num_fields(stream_result_);
+  size_t selected_fields = this->SelectedColumnIndex().size();
+  if (num_fields != selected_fields) {
+    std::stringstream ss;
+    ss << "query column size does not match, query size: " << num_fields
+        << " expected: " << selected_fields;
+    this->close();
+    RaiseException(ss.str());
+  }
+}
+
+std::shared_ptr<arrow::RecordBatch> MySQLCursor::next(int64_t batch_size) {
+  if (batch_size <= 0) {
+    RaiseException("batch size must be positive");
+  }
+  if (stream_finished_) {
+    return nullptr;
+  }
+  if (stream_result_ == nullptr) {
+    OpenStream();
+  }
+  uint32_t num_fields = mysql_num_fields(stream_result_);
+  auto builders = MakeColumnBuilders(stream_schema_, num_fields);
+  int64_t num_rows = 0;
+  MYSQL_ROW row;
+  while (num_rows < batch_size) {
+    row = mysql_fetch_row(stream_result_);
+    if (row == nullptr) {
+      if (mysql_errno(stream_conn_.get()) != 0) {
+        std::stringstream ss;
+        ss << "fetch row failed: " << mysql_error(stream_conn_.get());
+        this->close();
+        RaiseException(ss.str());
+      }
+      stream_finished_ = true;
+      this->close();
+      break;
+    }
+    unsigned long* lengths = mysql_fetch_lengths(stream_result_);
+    for (uint32_t i = 0; i < num_fields; i++) {
+      CheckAppendStatus(builders[i].AppendText(row[i], lengths[i]));
+    }
+    num_rows++;
+  }
+  if (num_rows == 0) {
+    return nullptr;
+  }
+  std::vector<std::shared_ptr<arrow::Array>> array_data;
+  FinishColumnBuilders(&builders, &array_data);
+  next_offset_ += num_rows;
+  return arrow::RecordBatch::Make(stream_schema_, num_rows, array_data);
+}
+
+void MySQLCursor::rewind() {
+  this->close();
+  stream_finished_ = false;
+  next_offset_ = 0;
 }
 
 std::shared_ptr<Dataset> MySQLCursor::ReadImpl(
@@ -65,6 +65,11 @@ struct MySQLAccessInfo : public DataSetAccessInfo {
   std::string table_name;
   std::string db_url;
   std::vector<std::string> query_colums;
+  // fetch data using prepared statement and binary protocol
+  bool use_binary_protocol{false};
+  // comma separated columns ordering rows of paged read,
+  // primary key of the table is used if empty
+  std::string order_by;
 };
 
 class MySQLCursor : public Cursor {
@@ -77,7 +82,18 @@ class MySQLCursor : public Cursor {
     std::shared_ptr<Dataset> readMeta() override;
     std::shared_ptr<Dataset> read() override;
     std::shared_ptr<Dataset> read(const std::shared_ptr<arrow::Schema>& data_schema) override;
+    /**
+     * offset and limit are pushed down to server by LIMIT clause,
+     * rows are ordered by orderBy of access info or primary key of the table,
+     * so that pages do not overlap or miss rows
+    */
     std::shared_ptr<Dataset> read(int64_t offset, int64_t limit) override;
+    /**
+     * rows are streamed from server by mysql_use_result,
+     * the connection is kept open until all rows are read or close/rewind
+    */
+    std::shared_ptr<arrow::RecordBatch> next(int64_t batch_size) override;
+    void rewind() override;
     int write(std::shared_ptr<Dataset> dataset) override;
     void close() override;
 
@@ -89,12 +105,39 @@ class MySQLCursor : public Cursor {
     retcode fetchData(const std::string& query_sql,
                       const std::shared_ptr<arrow::Schema>& data_schema,
                       std::vector<std::shared_ptr<arrow::Array>>* data_arr);
+    /**
+     * text protocol, cells are appended from MYSQL_ROW into arrow builders
+    */
+    retcode FetchTextResult(MYSQL* db_connector,
+                            const std::string& query_sql,
+                            const std::shared_ptr<arrow::Schema>& data_schema,
+                            std::vector<std::shared_ptr<arrow::Array>>* data_arr);
+    /**
+     * binary protocol, typed values are fetched by prepared statement
+    */
+    retcode FetchBinaryResult(MYSQL* db_connector,
+                              const std::string& query_sql,
+                              const std::shared_ptr<arrow::Schema>& data_schema,
+                              std::vector<std::shared_ptr<arrow::Array>>* data_arr);
     std::shared_ptr<arrow::Schema> makeArrowSchema();
+    void OpenStream();
+    /**
+     * ORDER BY clause used by paged read, exception if no order key is found
+    */
+    std::string OrderByClause();
+    retcode GetPrimaryKey(std::vector<std::string>* primary_key);
 
  private:
     std::string sql_;
     size_t offset{0};
     std::shared_ptr<MySQLDriver> driver_{nullptr};
+    // streaming state used by next
+    std::unique_ptr<MYSQL, decltype(conn_threadsafe_dctor)> stream_conn_{
+        nullptr, conn_threadsafe_dctor};
+    MYSQL_RES* stream_result_{nullptr};
+    std::shared_ptr<arrow::Schema> stream_schema_{nullptr};
+    bool stream_finished_{false};
+    std::string order_by_clause_;
 };
 
 class MySQLDriver : public DataDriver, public std::enable_shared_from_this<MySQLDriver> {
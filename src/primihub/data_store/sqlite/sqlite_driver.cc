@@ -107,7 +107,9 @@ SQLiteCursor::SQLiteCursor(const std::string& sql,
 
 SQLiteCursor::~SQLiteCursor() { this->close(); }
 
-void SQLiteCursor::close() {}
+void SQLiteCursor::close() {
+  stream_query_.reset();
+}
 
 std::shared_ptr<Dataset> SQLiteCursor::readMeta() {
   std::string query_meta_sql = sql_;
@@ -127,7 +129,60 @@ std::shared_ptr<Dataset> SQLiteCursor::read(const std::shared_ptr<arrow::Schema>
 }
 
 std::shared_ptr<Dataset> SQLiteCursor::read(int64_t offset, int64_t limit) {
-  return nullptr;
+  if (offset < 0 || limit < 0) {
+    std::stringstream ss;
+    ss << "invalid offset: " << offset << " or limit: " << limit;
+    RaiseException(ss.str());
+  }
+  std::string query_sql = sql_;
+  query_sql.append(" limit ").append(std::to_string(limit))
+           .append(" offset ").append(std::to_string(offset));
+  VLOG(5) << "page query sql: " << query_sql;
+  return readInternal(query_sql);
+}
+
+std::shared_ptr<arrow::RecordBatch> SQLiteCursor::next(int64_t batch_size) {
+  if (batch_size <= 0) {
+    RaiseException("batch size must be positive");
+  }
+  if (stream_finished_) {
+    return nullptr;
+  }
+  if (stream_query_ == nullptr) {
+    auto& db_connector = this->driver_->getDBConnector();
+    if (db_connector == nullptr) {
+      RaiseException("db connector for sqlite is invalid");
+    }
+    stream_query_ = std::make_unique<SQLite::Statement>(*db_connector, sql_);
+  }
+  std::vector<std::vector<std::string>> query_result;
+  query_result.resize(SelectedColumnIndex().size());
+  int64_t num_rows = 0;
+  while (num_rows < batch_size) {
+    if (!stream_query_->executeStep()) {
+      stream_finished_ = true;
+      stream_query_.reset();
+      break;
+    }
+    for (int i = 0; i < stream_query_->getColumnCount(); i++) {
+      query_result[i].push_back(stream_query_->getColumn(i).getString());
+    }
+    num_rows++;
+  }
+  if (num_rows == 0) {
+    return nullptr;
+  }
+  std::shared_ptr<arrow::Schema> schema;
+  std::vector<std::shared_ptr<arrow::Array>> array_data;
+  MakeArrowData(query_result, &schema, &array_data);
+  next_offset_ += num_rows;
+  return arrow::RecordBatch::Make(schema, num_rows, array_data);
+}
+
+void SQLiteCursor::rewind() {
+  stream_query_.reset();
+  stream_finished_ = false;
+  next_offset_ = 0;
 }
 
 std::shared_ptr<Dataset> SQLiteCursor::readInternal(const std::string& query_sql) {
@@ -148,6 +203,18 @@ std::shared_ptr<Dataset> SQLiteCursor::readInternal(const std::string& query_sql
       query_result[i].push_back(std::move(result));
     }
   }
+  std::shared_ptr<arrow::Schema> schema;
+  std::vector<std::shared_ptr<arrow::Array>> array_data;
+  MakeArrowData(query_result, &schema, &array_data);
+  table = arrow::Table::Make(schema, array_data);
+  auto dataset = std::make_shared<Dataset>(table, this->driver_);
+  return dataset;
+}
+
+void SQLiteCursor::MakeArrowData(
+    const std::vector<std::vector<std::string>>& query_result,
+    std::shared_ptr<arrow::Schema>* schema,
+    std::vector<std::shared_ptr<arrow::Array>>* array_data_ptr) {
   // convert data to arrow format
   auto table_schema = this->driver_->dataSetAccessInfo()->ArrowSchema();
   if (VLOG_IS_ON(5)) {
@@ -156,7 +223,7 @@ std::shared_ptr<Dataset> SQLiteCursor::readInternal(const std::string& query_sql
               << "size: " << table_schema->field_names().size();
     }
   }
-  std::vector<std::shared_ptr<arrow::Array>> array_data;
+  auto& array_data = *array_data_ptr;
   std::vector<std::shared_ptr<arrow::Field>> result_schema_filed;
   int schema_fields = table_schema->num_fields();
   auto& selected_fields = this->SelectedColumnIndex();
@@ -180,10 +247,7 @@ std::shared_ptr<Dataset> SQLiteCursor::readInternal(const std::string& query_sql
     i++;
   }
   VLOG(5) << "end of fetch data: " << array_data.size();
-  auto schema = std::make_shared<arrow::Schema>(result_schema_filed);
-  table = arrow::Table::Make(schema, array_data);
-  auto dataset = std::make_shared<Dataset>(table, this->driver_);
-  return dataset;
+  *schema = std::make_shared<arrow::Schema>(result_schema_filed);
 }
 
 std::shared_ptr<arrow::Table> SQLiteCursor::read_from_abnormal(
@@ -60,7 +60,15 @@ public:
   std::shared_ptr<Dataset> readMeta() override;
   std::shared_ptr<Dataset> read() override;
   std::shared_ptr<Dataset> read(const std::shared_ptr<arrow::Schema>& data_schema) override;
+  /**
+   * offset and limit are pushed down to sqlite by LIMIT/OFFSET clause
+  */
   std::shared_ptr<Dataset> read(int64_t offset, int64_t limit) override;
+  /**
+   * step the query statement, the statement is kept open between calls
+  */
+  std::shared_ptr<arrow::RecordBatch> next(int64_t batch_size) override;
+  void rewind() override;
   std::shared_ptr<Dataset> readInternal(const std::string& query_sql);
   std::shared_ptr<arrow::Table>
   read_from_abnormal(std::map<std::string, uint32_t> col_type,
@@ -85,6 +93,13 @@ public:
     std::vector<int64_t> int_values;
     sql_type_t col_type_;
   };
+  /**
+   * convert string value of selected columns into arrow array
+   * according to the dataset schema
+  */
+  void MakeArrowData(const std::vector<std::vector<std::string>>& query_result,
+                     std::shared_ptr<arrow::Schema>* schema,
+                     std::vector<std::shared_ptr<arrow::Array>>* array_data);
   sql_type_t get_sql_type_by_type_name(const std::string& type_name) {
     auto it = sql_type_name_to_enum.find(type_name);
     if (it != sql_type_name_to_enum.end()) {
@@ -101,6 +116,8 @@ public:
   std::string sql_;
   unsigned long long offset_{0};
   std::shared_ptr<SQLiteDriver> driver_{nullptr};
+  std::unique_ptr<SQLite::Statement> stream_query_{nullptr};
+  bool stream_finished_{false};
   std::map<std::string, sql_type_t> sql_type_name_to_enum {
     {"TEXT", sql_type_t::STRING},
     {"INTEGER", sql_type_t::INT64},
@@ -15,6 +15,7 @@
  */
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <sstream>
 #include <time.h>
 #include <string>
@@ -617,7 +618,7 @@ template <Decimal Dbit>
 int MPCExpressExecutor<Dbit>::importExpress(const std::string &expr) {
   parseExpress(expr);
   bool ret = checkExpress();
-  if (ret == false) {
+  if (ret == false || compileExpress()) {
     LOG(ERROR) << "Import express '" << expr << "' failed.";
     return -1;
   }
@@ -1203,106 +1204,333 @@ void MPCExpressExecutor<Dbit>::BeforeMPCRun(std::stack<std::string> &token_stk,
   suffix_stk_.pop();
 }
 
+template <Decimal Dbit> int MPCExpressExecutor<Dbit>::compileExpress(void) {
+  std::stack<std::string> tmp_stk = suffix_stk_;
+  std::stack<int> node_stk;
+  // Key of leaf node is the token, key of inner node is operator and index
+  // of operands, operands of '+' and '*' are sorted to find b*a for a*b.
+  std::map<std::string, int> node_index;
+
+  expr_nodes_.clear();
+  while (!tmp_stk.empty()) {
+    std::string token = tmp_stk.top();
+    tmp_stk.pop();
+
+    ExprNode node;
+    std::string key;
+    if (isOperator(token)) {
+      if (node_stk.size() < 2) {
+        LOG(ERROR) << "Lack operand for operator '" << token << "'.";
+        return -1;
+      }
+      node.op = token[0];
+      node.rhs = node_stk.top();
+      node_stk.pop();
+      node.lhs = node_stk.top();
+      node_stk.pop();
+      node.name = "(" + expr_nodes_[node.lhs].name + token +
+                  expr_nodes_[node.rhs].name + ")";
+
+      int first = node.lhs;
+      int second = node.rhs;
+      if ((node.op == '+' || node.op == '*') && first > second)
+        std::swap(first, second);
+      key = token + " " + std::to_string(first) + " " + std::to_string(second);
+    } else {
+      node.op = '\0';
+      node.lhs = -1;
+      node.rhs = -1;
+      node.name = token;
+      key = token;
+    }
+
+    auto iter = node_index.find(key);
+    if (iter != node_index.end()) {
+      node_stk.push(iter->second);
+      continue;
+    }
+
+    int index = static_cast<int>(expr_nodes_.size());
+    node_index[key] = index;
+    node_stk.push(index);
+    expr_nodes_.emplace_back(std::move(node));
+  }
+
+  if (node_stk.size() != 1) {
+    LOG(ERROR) << "Illegal express found, too many operand in express.";
+    return -1;
+  }
+
+  return 0;
+}
+
 template <Decimal Dbit>
-void MPCExpressExecutor<Dbit>::AfterMPCRun(std::stack<std::string> &token_stk,
-                                           std::stack<TokenValue> &val_stk,
-                                           std::string &new_token,
-                                           TokenValue &res) {
-  token_stk.push(new_token);
-  token_val_map_[new_token] = res;
-  val_stk.push(res);
+bool MPCExpressExecutor<Dbit>::isConstNode(int index) {
+  const ExprNode &node = expr_nodes_[index];
+  if (node.op != '\0')
+    return false;
+  return token_type_map_[node.name] == TokenType::VALUE;
 }
 
-template <Decimal Dbit> int MPCExpressExecutor<Dbit>::runMPCEvaluate(void) {
-  std::stack<std::string> stk1;
-  std::stack<TokenValue> val_stk;
+template <Decimal Dbit>
+bool MPCExpressExecutor<Dbit>::isShareMulNode(const ExprNode &node) {
+  return node.op == '*' && !isConstNode(node.lhs) && !isConstNode(node.rhs);
+}
 
-  while (!suffix_stk_.empty()) {
-    std::string token = suffix_stk_.top();
-    if (token == "+") {
-      std::string a, b;
-      TokenValue val1, val2, res;
-      BeforeMPCRun(stk1, val_stk, val1, val2, a, b);
+template <Decimal Dbit>
+bool MPCExpressExecutor<Dbit>::isInteractiveNode(const ExprNode &node) {
+  if (node.op == '/')
+    return true;
+  // Multiply FP64 share with constant needs truncation.
+  if (node.op == '*')
+    return fp64_run_ || isShareMulNode(node);
+  return false;
+}
 
-      if (fp64_run_) {
-        LOG(INFO) << "Run FP64 Add between '" << a << "' and '" << b << "'.";
-        runMPCAddFP64(val1, val2, res);
-        LOG(INFO) << "Run FP64 Add finish.";
-      } else {
-        LOG(INFO) << "Run I64 Add between '" << a << " and '" << b << "'.";
-        si64Matrix sh_sum;
-        runMPCAddI64(val1, val2, res);
-        LOG(INFO) << "Run I64 Add finish.";
-      }
+template <Decimal Dbit>
+void MPCExpressExecutor<Dbit>::createFP64Shares(TokenValue &val,
+                                                sf64Matrix<Dbit> &sh_val,
+                                                sf64Matrix<Dbit> *&p_sh_val) {
+  if (val.type == 0 || val.type == 4) {
+    sh_val.resize(feed_dict_->getColumnValuesCount(), 1);
+    createFP64Shares(val, sh_val);
+    p_sh_val = &sh_val;
+  } else {
+    p_sh_val = val.val_union.sh_fp64_m;
+  }
+}
 
-      std::string new_token = "(" + a + "+" + b + ")";
-      AfterMPCRun(stk1, val_stk, new_token, res);
-    } else if (token == "-") {
-      std::string a, b;
-      TokenValue val1, val2, res;
-      BeforeMPCRun(stk1, val_stk, val1, val2, a, b);
+template <Decimal Dbit>
+void MPCExpressExecutor<Dbit>::createI64Shares(TokenValue &val,
+                                               si64Matrix &sh_val,
+                                               si64Matrix *&p_sh_val) {
+  if (val.type == 1 || val.type == 4) {
+    sh_val.resize(feed_dict_->getColumnValuesCount(), 1);
+    createI64Shares(val, sh_val);
+    p_sh_val = &sh_val;
+  } else {
+    p_sh_val = val.val_union.sh_i64_m;
+  }
+}
 
-      if (fp64_run_) {
-        LOG(INFO) << "Run FP64 Sub between '" << a << "' and '" << b << "'.";
-        runMPCSubFP64(val1, val2, res);
-        LOG(INFO) << "Run FP64 Sub finish.";
-      } else {
-        LOG(INFO) << "Run I64 Sub between '" << a << " and '" << b << "'.";
-        si64Matrix sh_sum;
-        runMPCSubI64(val1, val2, res);
-        LOG(INFO) << "Run I64 Sub finish.";
-      }
+template <Decimal Dbit>
+void MPCExpressExecutor<Dbit>::runMPCMulBatchFP64(
+    const std::vector<int> &indexes, std::vector<TokenValue> &vals) {
+  uint32_t val_count = feed_dict_->getColumnValuesCount();
+  u64 batch = indexes.size();
+
+  // Put operands of k multiplications into column of two (n, k) matrix,
+  // then one dot multiplication finishes all of them in one round.
+  sf64Matrix<Dbit> sh_lhs(val_count, batch);
+  sf64Matrix<Dbit> sh_rhs(val_count, batch);
+  for (u64 k = 0; k < batch; k++) {
+    const ExprNode &node = expr_nodes_[indexes[k]];
+    sf64Matrix<Dbit> sh_val1, sh_val2;
+    sf64Matrix<Dbit> *p_sh_val1 = nullptr;
+    sf64Matrix<Dbit> *p_sh_val2 = nullptr;
+    createFP64Shares(vals[node.lhs], sh_val1, p_sh_val1);
+    createFP64Shares(vals[node.rhs], sh_val2, p_sh_val2);
+    for (u64 i = 0; i < 2; i++) {
+      sh_lhs[i].col(k) = (*p_sh_val1)[i].col(0);
+      sh_rhs[i].col(k) = (*p_sh_val2)[i].col(0);
+    }
+  }
 
-      std::string new_token = "(" + a + "-" + b + ")";
-      AfterMPCRun(stk1, val_stk, new_token, res);
-    } else if (token == "*") {
-      std::string a, b;
-      TokenValue val1, val2, res;
-      BeforeMPCRun(stk1, val_stk, val1, val2, a, b);
+  sf64Matrix<Dbit> sh_prod = mpc_op_->MPC_Dot_Mul(sh_lhs, sh_rhs);
 
-      if (fp64_run_) {
-        LOG(INFO) << "Run FP64 Mul between '" << a << "' and '" << b << "'.";
-        runMPCMulFP64(val1, val2, res);
-        LOG(INFO) << "Run FP64 Mul finish.";
-      } else {
-        LOG(INFO) << "Run I64 Mul between '" << a << " and '" << b << "'.";
-        si64Matrix sh_sum;
-        runMPCMulI64(val1, val2, res);
-        LOG(INFO) << "Run I64 Mul finish.";
-      }
+  for (u64 k = 0; k < batch; k++) {
+    sf64Matrix<Dbit> *sh_res = new sf64Matrix<Dbit>(val_count, 1);
+    for (u64 i = 0; i < 2; i++)
+      (*sh_res)[i].col(0) = sh_prod[i].col(k);
 
-      std::string new_token = "(" + a + "*" + b + ")";
-      AfterMPCRun(stk1, val_stk, new_token, res);
-    } else if (token == "/") {
-      std::string a, b;
-      TokenValue val1, val2, res;
-      BeforeMPCRun(stk1, val_stk, val1, val2, a, b);
-      LOG(INFO) << "Run FP64 Div between '" << a << "' and '" << b << "'.";
-      runMPCDivFP64(val1, val2, res);
-      LOG(INFO) << "Run FP64 Div finish.";
-      std::string new_token = "(" + a + "/" + b + ")";
-      AfterMPCRun(stk1, val_stk, new_token, res);
+    const ExprNode &node = expr_nodes_[indexes[k]];
+    createTokenValue(sh_res, vals[indexes[k]]);
+    token_val_map_[node.name] = vals[indexes[k]];
+  }
+}
+
+template <Decimal Dbit>
+void MPCExpressExecutor<Dbit>::runMPCMulBatchI64(
+    const std::vector<int> &indexes, std::vector<TokenValue> &vals) {
+  uint32_t val_count = feed_dict_->getColumnValuesCount();
+  u64 batch = indexes.size();
+
+  si64Matrix sh_lhs(val_count, batch);
+  si64Matrix sh_rhs(val_count, batch);
+  for (u64 k = 0; k < batch; k++) {
+    const ExprNode &node = expr_nodes_[indexes[k]];
+    si64Matrix sh_val1, sh_val2;
+    si64Matrix *p_sh_val1 = nullptr;
+    si64Matrix *p_sh_val2 = nullptr;
+    createI64Shares(vals[node.lhs], sh_val1, p_sh_val1);
+    createI64Shares(vals[node.rhs], sh_val2, p_sh_val2);
+    for (u64 i = 0; i < 2; i++) {
+      sh_lhs[i].col(k) = (*p_sh_val1)[i].col(0);
+      sh_rhs[i].col(k) = (*p_sh_val2)[i].col(0);
+    }
+  }
+
+  si64Matrix sh_prod = mpc_op_->MPC_Dot_Mul(sh_lhs, sh_rhs);
+
+  for (u64 k = 0; k < batch; k++) {
+    si64Matrix *sh_res = new si64Matrix(val_count, 1);
+    for (u64 i = 0; i < 2; i++)
+      (*sh_res)[i].col(0) = sh_prod[i].col(k);
+
+    const ExprNode &node = expr_nodes_[indexes[k]];
+    createTokenValue(sh_res, vals[indexes[k]]);
+    token_val_map_[node.name] = vals[indexes[k]];
+  }
+}
+
+template <Decimal Dbit>
+int MPCExpressExecutor<Dbit>::runMPCNode(int index,
+                                         std::vector<TokenValue> &vals) {
+  const ExprNode &node = expr_nodes_[index];
+  TokenValue &val1 = vals[node.lhs];
+  TokenValue &val2 = vals[node.rhs];
+  TokenValue &res = vals[index];
+  const std::string &a = expr_nodes_[node.lhs].name;
+  const std::string &b = expr_nodes_[node.rhs].name;
+  std::string dtype = fp64_run_ ? "FP64" : "I64";
+
+  switch (node.op) {
+  case '+':
+    LOG(INFO) << "Run " << dtype << " Add between '" << a << "' and '" << b
+              << "'.";
+    if (fp64_run_)
+      runMPCAddFP64(val1, val2, res);
+    else
+      runMPCAddI64(val1, val2, res);
+    break;
+  case '-':
+    LOG(INFO) << "Run " << dtype << " Sub between '" << a << "' and '" << b
+              << "'.";
+    if (fp64_run_)
+      runMPCSubFP64(val1, val2, res);
+    else
+      runMPCSubI64(val1, val2, res);
+    break;
+  case '*':
+    LOG(INFO) << "Run " << dtype << " Mul between '" << a << "' and '" << b
+              << "'.";
+    if (fp64_run_)
+      runMPCMulFP64(val1, val2, res);
+    else
+      runMPCMulI64(val1, val2, res);
+    break;
+  case '/':
+    LOG(INFO) << "Run FP64 Div between '" << a << "' and '" << b << "'.";
+    runMPCDivFP64(val1, val2, res);
+    break;
+  default:
+    LOG(ERROR) << "Unknown operator '" << node.op << "' in express.";
+    return -1;
+  }
+
+  token_val_map_[node.name] = res;
+  return 0;
+}
+
+template <Decimal Dbit>
+void MPCExpressExecutor<Dbit>::shareColumnLeaves(
+    std::vector<TokenValue> &vals) {
+  uint32_t val_count = feed_dict_->getColumnValuesCount();
+  for (size_t i = 0; i < expr_nodes_.size(); i++) {
+    const ExprNode &node = expr_nodes_[i];
+    if (node.op != '\0')
+      continue;
+
+    TokenValue &val = vals[i];
+    if (fp64_run_ && (val.type == 0 || val.type == 4)) {
+      sf64Matrix<Dbit> *sh_val = new sf64Matrix<Dbit>(val_count, 1);
+      createFP64Shares(val, *sh_val);
+      createTokenValue(sh_val, val);
+    } else if (!fp64_run_ && (val.type == 1 || val.type == 4)) {
+      si64Matrix *sh_val = new si64Matrix(val_count, 1);
+      createI64Shares(val, *sh_val);
+      createTokenValue(sh_val, val);
     } else {
-      stk1.push(token);
-      suffix_stk_.pop();
+      continue;
+    }
 
-      TokenValue token_val;
-      if (createTokenValue(token, token_val)) {
-        LOG(ERROR) << "Construct token value for token '" << token
+    token_val_map_[node.name] = val;
+  }
+}
+
+template <Decimal Dbit> int MPCExpressExecutor<Dbit>::runMPCEvaluate(void) {
+  if (expr_nodes_.empty()) {
+    LOG(ERROR) << "No compiled express to evaluate.";
+    return -1;
+  }
+
+  // Depth of a node counts the communication rounds on its longest path,
+  // a node only depends on nodes of smaller depth or on non-interactive
+  // nodes of the same depth and smaller index.
+  std::vector<uint32_t> depth(expr_nodes_.size(), 0);
+  std::vector<TokenValue> vals(expr_nodes_.size());
+  uint32_t max_depth = 0;
+  uint32_t mul_count = 0;
+  for (size_t i = 0; i < expr_nodes_.size(); i++) {
+    const ExprNode &node = expr_nodes_[i];
+    if (node.op == '\0') {
+      if (createTokenValue(node.name, vals[i])) {
+        LOG(ERROR) << "Construct token value for token '" << node.name
                    << "' failed.";
         return -1;
       }
-
-      val_stk.push(token_val);
-      token_val_map_[token] = token_val;
+      token_val_map_[node.name] = vals[i];
+      continue;
     }
+
+    depth[i] = std::max(depth[node.lhs], depth[node.rhs]);
+    if (isInteractiveNode(node))
+      depth[i]++;
+    if (isShareMulNode(node))
+      mul_count++;
+    max_depth = std::max(max_depth, depth[i]);
   }
 
-  while (!stk1.empty()) {
-    suffix_stk_.push(stk1.top());
-    stk1.pop();
+  LOG(INFO) << "Express compiled into " << expr_nodes_.size() << " nodes, "
+            << mul_count << " share multiplications, depth " << max_depth
+            << ".";
+
+  shareColumnLeaves(vals);
+
+  for (uint32_t d = 0; d <= max_depth; d++) {
+    std::vector<int> mul_batch;
+    for (size_t i = 0; i < expr_nodes_.size(); i++) {
+      if (depth[i] == d && isShareMulNode(expr_nodes_[i]))
+        mul_batch.push_back(static_cast<int>(i));
+    }
+
+    if (mul_batch.size() > 1) {
+      LOG(INFO) << "Run " << mul_batch.size() << " "
+                << (fp64_run_ ? "FP64" : "I64") << " Mul of depth " << d
+                << " in one batch.";
+      if (fp64_run_)
+        runMPCMulBatchFP64(mul_batch, vals);
+      else
+        runMPCMulBatchI64(mul_batch, vals);
+    } else if (mul_batch.size() == 1) {
+      if (runMPCNode(mul_batch[0], vals))
+        return -1;
+    }
+
+    for (size_t i = 0; i < expr_nodes_.size(); i++) {
+      const ExprNode &node = expr_nodes_[i];
+      if (depth[i] != d || node.op == '\0' || isShareMulNode(node))
+        continue;
+      if (runMPCNode(static_cast<int>(i), vals))
+        return -1;
+    }
   }
 
+  // Leave the final token in suffix_stk_ for revealMPCResult.
+  while (!suffix_stk_.empty())
+    suffix_stk_.pop();
+  suffix_stk_.push(expr_nodes_.back().name);
+
   return 0;
 }
 
@@ -1392,6 +1620,7 @@ template <Decimal Dbit> void MPCExpressExecutor<Dbit>::Clean(void) {
   while (!suffix_stk_.empty())
     suffix_stk_.pop();
 
+  expr_nodes_.clear();
   token_val_map_.clear();
   token_type_map_.clear();
 }
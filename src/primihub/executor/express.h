@@ -22,6 +22,7 @@
 #include <map>
 #include <stack>
 #include <string>
+#include <vector>
 
 #include "src/primihub/operator/aby3_operator.h"
 
@@ -227,9 +228,45 @@ private:
                            std::stack<TokenValue> &val_stk, TokenValue &val1,
                            TokenValue &val2, std::string &a, std::string &b);
 
-  inline void AfterMPCRun(std::stack<std::string> &token_stk,
-                          std::stack<TokenValue> &val_stk,
-                          std::string &new_token, TokenValue &res);
+  // Node of the express DAG compiled from suffix express. A leaf node has
+  // op '\0' and its name is a column name or a constant, an inner node
+  // refers to its operands by index in expr_nodes_, which is a topological
+  // order. Same sub-express (a*b and b*a included) maps to one node.
+  struct ExprNode {
+    char op;
+    int lhs;
+    int rhs;
+    std::string name;
+  };
+
+  int compileExpress(void);
+
+  bool isConstNode(int index);
+
+  // Whether the node needs a communication round of its own.
+  bool isInteractiveNode(const ExprNode &node);
+
+  // Whether the node is a multiplication between two shares, such nodes of
+  // the same depth run in one batched multiplication.
+  bool isShareMulNode(const ExprNode &node);
+
+  int runMPCNode(int index, std::vector<TokenValue> &vals);
+
+  // Share every column leaf once before evaluation, a column used by
+  // several nodes or several multiplications of a batch is not reshared.
+  void shareColumnLeaves(std::vector<TokenValue> &vals);
+
+  void createFP64Shares(TokenValue &val, sf64Matrix<Dbit> &sh_val,
+                        sf64Matrix<Dbit> *&p_sh_val);
+
+  void createI64Shares(TokenValue &val, si64Matrix &sh_val,
+                       si64Matrix *&p_sh_val);
+
+  void runMPCMulBatchFP64(const std::vector<int> &indexes,
+                          std::vector<TokenValue> &vals);
+
+  void runMPCMulBatchI64(const std::vector<int> &indexes,
+                         std::vector<TokenValue> &vals);
 
   void runMPCAddFP64(TokenValue &val1, TokenValue &val2, TokenValue &res);
 
@@ -254,6 +291,7 @@ private:
   bool fp64_run_;
   std::string expr_;
   std::stack<std::string> suffix_stk_;
+  std::vector<ExprNode> expr_nodes_;
   ColumnConfig *col_config_;
   std::unique_ptr<MPCOperator> mpc_op_;
   FeedDict *feed_dict_;
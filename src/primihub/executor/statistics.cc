@@ -2,6 +2,10 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace primihub {
 #ifndef MPC_SOCKET_CHANNEL
 retcode MPCSumOrAvg::PlainTextDataCompute(
@@ -218,173 +222,6 @@ retcode MPCSumOrAvg::getResult(eMatrix<double> &col_avg) {
   return retcode::SUCCESS;
 }
 
-double MPCMinOrMax::minValueOfAllParty(double local_min) {
-  // Compare value from party 0 and party 1.
-  f64Matrix<D16> m(1, 1);
-  m(0, 0) = local_min;
-
-  sbMatrix sh_result;
-  if (party_id_ == 0)
-    mpc_op_->MPC_Compare(m, sh_result);
-  else if (party_id_ == 1)
-    mpc_op_->MPC_Compare(m, sh_result);
-  else
-    mpc_op_->MPC_Compare(sh_result);
-
-  i64Matrix cmp_result;
-  cmp_result.resize(1, 1);
-  cmp_result = mpc_op_->revealAll(sh_result);
-
-  uint8_t smaller_party = UINT8_MAX;
-  if (cmp_result(0, 0))
-    smaller_party = 0;
-  else
-    smaller_party = 1;
-
-  LOG(INFO) << "The min value of party 0 and party 1 is at party "
-            << std::to_string(smaller_party) << ".";
-
-  uint8_t smallest_party = UINT8_MAX;
-  if (smaller_party == 0) {
-    // Compare value from party 0 and party 2.
-    sbMatrix sh_result;
-    if (party_id_ == 0)
-      mpc_op_->MPC_Compare(m, sh_result);
-    else if (party_id_ == 2)
-      mpc_op_->MPC_Compare(m, sh_result);
-    else
-      mpc_op_->MPC_Compare(sh_result);
-
-    cmp_result(0, 0) = UINT8_MAX;
-    cmp_result = mpc_op_->revealAll(sh_result);
-
-  } else {
-    // Compare value from party 1 and party 2.
-    sbMatrix sh_result;
-    if (party_id_ == 1)
-      mpc_op_->MPC_Compare(m, sh_result);
-    else if (party_id_ == 2)
-      mpc_op_->MPC_Compare(m, sh_result);
-    else
-      mpc_op_->MPC_Compare(sh_result);
-
-    cmp_result(0, 0) = UINT8_MAX;
-    cmp_result = mpc_op_->revealAll(sh_result);
-  }
-
-  if (smaller_party == 0) {
-    if (cmp_result(0, 0))
-      smallest_party = 0;
-    else
-      smallest_party = 2;
-  } else {
-    if (cmp_result(0, 0))
-      smallest_party = 1;
-    else
-      smallest_party = 2;
-  }
-
-  LOG(INFO) << "The min value of three party is at party "
-            << std::to_string(smallest_party) << ".";
-
-  sf64Matrix<D16> sh_m(1, 1);
-
-  if (party_id_ == smallest_party) {
-    mpc_op_->createShares(m, sh_m);
-  } else
-    mpc_op_->createShares(sh_m);
-
-  eMatrix<double> min_val;
-  min_val = mpc_op_->revealAll(sh_m);
-  return min_val(0, 0);
-}
-double MPCMinOrMax::maxValueOfAllParty(double local_max) {
-  // Compare value from party 0 and party 1.
-  // P0:2 P1:3 P2:4  P0:-2 P1:-3 P2:-4
-  f64Matrix<D16> m(1, 1);  // to out
-  m(0, 0) = local_max;
-  f64Matrix<D16> m_negative(1, 1);
-  m_negative(0, 0) = (-1) * (local_max);  // to compare
-  sbMatrix sh_result;
-
-  // the same as min
-  if (party_id_ == 0)
-    mpc_op_->MPC_Compare(m_negative, sh_result);  // P0:2  -2
-  else if (party_id_ == 1)
-    mpc_op_->MPC_Compare(m_negative, sh_result);  // P1:3   -3
-  else
-    mpc_op_->MPC_Compare(sh_result);
-  // because origin is smaller，keep -3
-
-  i64Matrix cmp_result;
-  cmp_result.resize(1, 1);
-  cmp_result = mpc_op_->revealAll(sh_result);
-
-  uint8_t larger_party = UINT8_MAX;
-  if (cmp_result(0, 0))
-    larger_party = 0;  // notice:this larger is "larger"
-  else                 // to let P1(3)(-3) win
-    larger_party = 1;
-
-  LOG(INFO) << "The max value of party 0 and party 1 is at party "
-            << std::to_string(larger_party) << ".";
-
-  uint8_t largest_party = UINT8_MAX;
-  if (larger_party == 0) {
-    // Compare value from party 0 and party 2.
-    // P0:2 P1:3 P2:4  P0:-2 P1:-3 P2:-4
-    sbMatrix sh_result;
-    if (party_id_ == 0)  // P0:2  -2
-      mpc_op_->MPC_Compare(m_negative, sh_result);
-    else if (party_id_ == 2)  // P2:4   -4
-      mpc_op_->MPC_Compare(m_negative, sh_result);
-    else
-      mpc_op_->MPC_Compare(sh_result);
-    // because origin's alg is smaller，keep -4
-
-    cmp_result(0, 0) = UINT8_MAX;
-    cmp_result = mpc_op_->revealAll(sh_result);
-  } else {
-    // Compare value from party 1 and party 2.
-    sbMatrix sh_result;
-    if (party_id_ == 1)                             //  similar to the above
-      mpc_op_->MPC_Compare(m_negative, sh_result);  // P0:2 P1:3 P2:4
-    else if (party_id_ == 2)
-      mpc_op_->MPC_Compare(m_negative, sh_result);  //-3 -4
-    else
-      mpc_op_->MPC_Compare(sh_result);  // keep -4
-
-    cmp_result(0, 0) = UINT8_MAX;
-    cmp_result = mpc_op_->revealAll(sh_result);
-  }
-  // Because the algorithm at the beginning keeps the minimum value, it finally
-  // keeps -4
-  if (larger_party == 0) {
-    if (cmp_result(0, 0))
-      largest_party = 0;
-    else
-      largest_party = 2;
-  } else {
-    if (cmp_result(0, 0))
-      largest_party = 1;
-    else
-      largest_party = 2;  // notice:this largest is "largest"
-  }
-
-  LOG(INFO) << "The max value of three party is at party "
-            << std::to_string(largest_party) << ".";
-
-  sf64Matrix<D16> sh_m(1, 1);
-
-  if (party_id_ == largest_party)
-    mpc_op_->createShares(m, sh_m);
-  else
-    mpc_op_->createShares(sh_m);
-
-  eMatrix<double> max_val;
-  max_val = mpc_op_->revealAll(sh_m);
-  return max_val(0, 0);
-}
 retcode MPCMinOrMax::PlainTextDataCompute(
     std::shared_ptr<primihub::Dataset>& dataset,
     const std::vector<std::string>& columns,
@@ -409,6 +246,8 @@ retcode MPCMinOrMax::PlainTextDataCompute(
     }
     double col_result = 0;
     fillInitValue(col_result);
+    (*row_records)(col_index, 0) =
+        chunked_array->length() - chunked_array->null_count();
     // Get max or min of a column.
     for (int i = 0; i < chunked_array->num_chunks(); i++) {
       auto iter = col_dtype.find(col_name);
@@ -461,24 +300,48 @@ retcode MPCMinOrMax::PlainTextDataCompute(
 retcode MPCMinOrMax::CipherTextDataCompute(const eMatrix<double>& col_data,
     const std::vector<std::string>& col_names,
     const eMatrix<double>& row_records) {
-  mpc_result_.resize(col_data.rows(), 1);
-  if (type_ == MPCStatisticsType::MIN) {
-    for (uint64_t col_index = 0; col_index < col_data.rows(); col_index++) {
-      auto& col_name = col_names[col_index];
-      double col_result = col_data(col_index, 0);
-      col_result = minValueOfAllParty(col_result);
-      mpc_result_(col_index, 0) = col_result;
-      VLOG(3) << "Global min value of column " << col_name << " is "
-              << mpc_result_(col_index, 0) << ".";
+  constexpr double kBound = MPCOperator::kMaxOrMinBound;
+  eMatrix<double> local_value(col_data.rows(), 1);
+  bool is_max = (type_ == MPCStatisticsType::MAX);
+  bool out_of_bound{false};
+  for (int64_t i = 0; i < col_data.rows(); i++) {
+    double value = col_data(i, 0);
+    if (value >= -kBound && value <= kBound) {
+      local_value(i, 0) = value;
+    } else if (row_records(i, 0) <= 0) {
+      // initial value of a column without rows, it never wins
+      local_value(i, 0) = is_max ? -kBound : kBound;
+    } else {
+      LOG(ERROR) << "value: " << value << " of column " << col_names[i]
+                 << " is out of the range of secure "
+                 << (is_max ? "max" : "min")
+                 << ": [" << -kBound << ", " << kBound << "]";
+      out_of_bound = true;
     }
-  } else {
-    for (uint64_t col_index = 0; col_index < col_data.rows(); col_index++) {
-      auto& col_name = col_names[col_index];
-      double col_result = col_data(col_index, 0);
-      col_result = maxValueOfAllParty(col_result);
-      mpc_result_(col_index, 0) = col_result;
-      VLOG(3) << "Global max value of column " << col_name << " is "
-              << mpc_result_(col_index, 0) << ".";
+  }
+  // every party has to agree to stop before sharing
+  if (mpc_op_->MaxOrMinOutOfBound(out_of_bound)) {
+    LOG(ERROR) << "some party has a value out of the range of secure "
+               << (is_max ? "max" : "min");
+    return retcode::FAIL;
+  }
+  // all columns of all parties are compared together
+  std::vector<sf64Matrix<D16>> sh_values;
+  for (uint16_t pid = 0; pid < 3; pid++) {
+    sf64Matrix<D16> sh_value(local_value.rows(), 1);
+    if (party_id_ == pid) {
+      mpc_op_->createShares(local_value, sh_value);
+    } else {
+      mpc_op_->createShares(sh_value);
+    }
+    sh_values.emplace_back(std::move(sh_value));
+  }
+  auto sh_result = mpc_op_->MPC_MaxOrMin(std::move(sh_values), is_max);
+  mpc_result_ = mpc_op_->revealAll(sh_result);
+  if (VLOG_IS_ON(3)) {
+    for (size_t i = 0; i < col_names.size(); i++) {
+      VLOG(3) << "Global " << (is_max ? "max" : "min") << " value of column "
+              << col_names[i] << " is " << mpc_result_(i, 0) << ".";
     }
   }
   return retcode::SUCCESS;
@@ -151,9 +151,6 @@ public:
   retcode getResult(eMatrix<double> &result) override;
 
 private:
-  double minValueOfAllParty(double local_min);
-  double maxValueOfAllParty(double local_max);
-
   template <class T1, class T2>
   void minOrMax(std::shared_ptr<T1> &array, T2 &val) {
     if (type_ == MPCStatisticsType::MAX) {
@@ -188,7 +185,7 @@ private:
 
     if (std::is_same<T, double>::value) {
       if (type_ == MPCStatisticsType::MAX)
-        val = std::numeric_limits<double>::min();
+        val = std::numeric_limits<double>::lowest();
       else
         val = std::numeric_limits<double>::max();
       return;
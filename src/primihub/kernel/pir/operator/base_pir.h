@@ -33,6 +33,8 @@ struct Options {
   // offline task
   bool generate_db{false};
   std::string db_path;
+  // version of the server dataset, a cached db of another version is updated
+  std::string dataset_version;
   Node peer_node;
   Node proxy_node;
 };
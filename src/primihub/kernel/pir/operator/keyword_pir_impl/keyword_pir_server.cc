@@ -18,6 +18,9 @@
 #include <fstream>
 #include <algorithm>
 #include <unordered_map>
+#include <condition_variable>
+#include <future>
+#include <mutex>
 
 #include "src/primihub/common/value_check_util.h"
 #include "src/primihub/util/util.h"
@@ -50,9 +53,9 @@ retcode KeywordPirOperatorServer::OnExecute(const PirDataType& input,
     // generate db offline which can load when task execute
     auto db_data = CreateDb(input);
     CHECK_NULLPOINTER(db_data, retcode::FAIL);
-    auto ret = CreateDbDataCache(*db_data, std::move(params),
-                                 *(this->oprf_key_), 16, false);
-    if (ret != retcode::SUCCESS) {
+    auto sender_db = CreateDbDataCache(*db_data, std::move(params),
+                                       *(this->oprf_key_), 16, false);
+    if (sender_db == nullptr) {
       LOG(ERROR) << "CreateDbDataCache failed.";
       return retcode::FAIL;
     }
@@ -62,8 +65,14 @@ retcode KeywordPirOperatorServer::OnExecute(const PirDataType& input,
   auto ret = ProcessPSIParams();
   CHECK_RETCODE_WITH_RETVALUE(ret, retcode::FAIL);
   std::shared_ptr<SenderDB> sender_db{nullptr};
-  if (DbCacheAvailable(this->options_.db_path)) {
+  if (this->options_.use_cache) {
     sender_db = LoadDbFromCache(this->options_.db_path);
+  } else if (DbCacheAvailable(this->options_.db_path)) {
+    // the cache is built from another version of the dataset
+    auto db_data = CreateDb(input);
+    CHECK_NULLPOINTER(db_data, retcode::FAIL);
+    sender_db = CreateDbDataCache(*db_data, std::move(params),
+                                  *(this->oprf_key_), 16, false);
   } else {
     // std::unique_ptr<DBData>
     auto db_data = CreateDb(input);
@@ -97,22 +106,44 @@ retcode KeywordPirOperatorServer::OnExecute(const PirDataType& input,
   return retcode::SUCCESS;
 }
 
-retcode KeywordPirOperatorServer::CreateDbDataCache(const DBData& db_data,
+auto KeywordPirOperatorServer::CreateDbDataCache(const DBData& db_data,
     std::unique_ptr<apsi::PSIParams> psi_params,
     apsi::oprf::OPRFKey& oprf_key,
     size_t nonce_byte_count,
-    bool compress) {
-  auto sender_db = CreateSenderDb(db_data, std::move(psi_params),
-                                  oprf_key, nonce_byte_count, compress);
+    bool compress) -> std::shared_ptr<SenderDB> {
+  if (!holds_alternative<LabeledData>(db_data)) {
+    LOG(ERROR) << "keyword pir database is without label";
+    return nullptr;
+  }
+  auto& labeled_db_data = std::get<LabeledData>(db_data);
+  SenderDbCache db_cache(this->options_.db_path);
+  std::shared_ptr<SenderDB> sender_db{nullptr};
+  if (db_cache.Available()) {
+    sender_db = db_cache.Load();
+    if (sender_db != nullptr &&
+        db_cache.Update(labeled_db_data, sender_db.get()) == retcode::SUCCESS) {
+      oprf_key = sender_db->get_oprf_key();
+    } else {
+      LOG(WARNING) << "update db cache: " << this->options_.db_path
+                   << " failed, rebuild it";
+      sender_db = nullptr;
+    }
+  }
+  if (sender_db == nullptr) {
+    sender_db = CreateSenderDb(db_data, std::move(psi_params),
+                               oprf_key, nonce_byte_count, compress);
+  }
   if (sender_db == nullptr) {
     LOG(ERROR) << "create sender db failed";
-    return retcode::FAIL;
+    return nullptr;
   }
-  std::fstream fout(this->options_.db_path, std::ios::out);
-  size_t save_size = sender_db->save(fout);
-  VLOG(0) << "save_size: " << save_size
-          << " db path: " << this->options_.db_path;
-  return retcode::SUCCESS;
+  auto ret = db_cache.Save(*sender_db, labeled_db_data,
+                           this->options_.dataset_version);
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "save db cache: " << this->options_.db_path << " failed";
+    return nullptr;
+  }
+  return sender_db;
 }
 
 auto KeywordPirOperatorServer::CreateSenderDb(const DBData &db_data,
@@ -244,7 +275,6 @@ retcode KeywordPirOperatorServer::ProcessOprf() {
 retcode KeywordPirOperatorServer::ProcessQuery(
     std::shared_ptr<SenderDB> sender_db) {
   CHECK_TASK_STOPPED(retcode::FAIL);
-  CryptoContext crypto_context(sender_db->get_crypto_context());
   auto seal_context = sender_db->get_seal_context();
   auto query_request = std::make_unique<SenderOperationQuery>();
 
@@ -268,6 +298,47 @@ retcode KeywordPirOperatorServer::ProcessQuery(
     return retcode::FAIL;
   }
 
+  // The query response only tells
+  // how many ResultPackages to expect; send this first
+  auto package_count = safe_cast<uint32_t>(sender_db->get_bin_bundle_count());
+  // tell client how many package count need to receive
+  std::string_view send_data{reinterpret_cast<char*>(&package_count),
+                             sizeof(package_count)};
+  auto link_ctx = this->GetLinkContext();
+  std::string pkg_count_key = this->PackageCountKey(link_ctx->request_id());
+  ret = link_ctx->Send(pkg_count_key, ProxyNode(), send_data);
+  CHECK_RETCODE(ret);
+  VLOG(5) << "package_count: " << package_count;
+
+  size_t send_index = 0;
+  ret = RunQuery(sender_db, std::move(query_request),
+      [&, this](std::string&& package) -> retcode {
+        auto send_ret =
+            link_ctx->Send(this->response_key_, ProxyNode(), package);
+        if (send_ret != retcode::SUCCESS) {
+          LOG(ERROR) << "send result to client, index: " << send_index
+              << " data length: " << package.size() << " failed";
+          return send_ret;
+        }
+        VLOG(5) << "send result to client, index: " << send_index
+                << " data length: " << package.size();
+        send_index++;
+        return retcode::SUCCESS;
+      });
+  CHECK_RETCODE(ret);
+  link_ctx->CheckSendCompleteStatus(this->response_key_,
+                                    ProxyNode(), package_count);
+  VLOG(5) << "Finished processing query request";
+  return retcode::SUCCESS;
+}
+
+retcode KeywordPirOperatorServer::RunQuery(
+    const std::shared_ptr<SenderDB>& sender_db,
+    std::unique_ptr<SenderOperationQuery> query_request,
+    const PackageSender& send_package) {
+  CHECK_TASK_STOPPED(retcode::FAIL);
+  CryptoContext crypto_context(sender_db->get_crypto_context());
+  auto seal_context = sender_db->get_seal_context();
   auto compr_mode = query_request->compr_mode;
   std::unordered_map<std::uint32_t, std::vector<seal::Ciphertext>> data_;
   for (auto& q : query_request->data) {
@@ -285,18 +356,15 @@ retcode KeywordPirOperatorServer::ProcessQuery(
   }
   VLOG(5) << "Start processing query request on database with "
         << sender_db->get_item_count() << " items";
-  // auto& crypto_context = sender_db->get_crypto_context();
 
   seal::RelinKeys relin_keys_;
   apsi::PowersDag pd;
-  crypto_context.set_evaluator(relin_keys_);
   // Copy over the CryptoContext from SenderDB;
   // set the Evaluator for this local instance.
   // Relinearization keys may not have been included in the query. In that case
   // query.relin_keys() simply holds an empty seal::RelinKeys instance.
   // There is no problem with the below call to CryptoContext::set_evaluator.
-  // CryptoContext crypto_context(sender_db->get_crypto_context());
-  // crypto_context.set_evaluator(query.relin_keys());
+  crypto_context.set_evaluator(relin_keys_);
 
   // Get the PSIParams
   auto& params = sender_db->get_params();
@@ -310,17 +378,7 @@ retcode KeywordPirOperatorServer::ProcessQuery(
   // Create the PowersDag
   pd.configure(query_powers, target_powers);
 
-  // The query response only tells
-  // how many ResultPackages to expect; send this first
   auto package_count = safe_cast<uint32_t>(sender_db->get_bin_bundle_count());
-  // tell client how many package count need to receive
-  std::string_view send_data{reinterpret_cast<char*>(&package_count),
-                             sizeof(package_count)};
-  auto link_ctx = this->GetLinkContext();
-  std::string pkg_count_key = this->PackageCountKey(link_ctx->request_id());
-  ret = link_ctx->Send(pkg_count_key, ProxyNode(), send_data);
-  CHECK_RETCODE(ret);
-  VLOG(5) << "package_countpackage_countpackage_count: " << package_count;
   // For each bundle index i, we need a vector of powers of the query Qᵢ.
   // We need powers all the way up to Qᵢ^max_items_per_bin.
   // We don't store the zeroth power. If Paterson-Stockmeyer is used,
@@ -361,24 +419,79 @@ retcode KeywordPirOperatorServer::ProcessQuery(
 
   VLOG(5) << "Finished computing powers for all bundle indices";
   VLOG(5) << "Start processing bin bundle caches";
+  // bin bundle caches are evaluated on the APSI thread pool which is shared
+  // with ComputePowers. a cache is only submitted when fewer than
+  // max_pending packages are computed but not yet sent, so a slow link
+  // holds back the computation instead of buffering every package.
+  ThreadPoolMgr tpm;
+  size_t max_pending = std::max<size_t>(2 * ThreadPoolMgr::GetThreadCount(), 2);
+  std::mutex pending_mtx;
+  std::condition_variable pending_cv;
+  size_t pending_num = 0;
+  bool send_failed = false;
   primihub::ThreadSafeQueue<std::string> result_package_queue;
-  std::vector<future<void>> futures;
+  auto send_fut = std::async(
+    std::launch::async,
+    [&]() -> retcode {
+      auto ret = retcode::SUCCESS;
+      for (size_t i = 0; i < package_count; i++) {
+        std::string send_data;
+        result_package_queue.wait_and_pop(send_data);
+        // empty package means the computation of a bin bundle failed
+        if (send_data.empty()) {
+          ret = retcode::FAIL;
+        } else {
+          ret = send_package(std::move(send_data));
+        }
+        std::lock_guard<std::mutex> lck(pending_mtx);
+        pending_num--;
+        pending_cv.notify_one();
+        if (ret != retcode::SUCCESS) {
+          send_failed = true;
+          break;
+        }
+      }
+      return ret;
+    });
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(package_count);
   for (uint32_t bundle_idx = 0; bundle_idx < bundle_idx_count; bundle_idx++) {
     auto bundle_caches = sender_db->get_cache_at(bundle_idx);
     for (auto &cache : bundle_caches) {
-      futures.push_back(
-        std::async(
-          std::launch::async,
-          [&, bundle_idx, cache, this]() -> void {
+      {
+        std::unique_lock<std::mutex> lck(pending_mtx);
+        pending_cv.wait(lck, [&]() {
+          return send_failed || pending_num < max_pending;
+        });
+        if (send_failed) {
+          break;
+        }
+        pending_num++;
+      }
+      futures.push_back(tpm.thread_pool().enqueue(
+        [&, bundle_idx, cache, this]() -> void {
+          // the sender waits for exactly one package per submitted cache,
+          // so every exit path has to push one, an empty one on failure
+          auto mark_failed = [&]() {
+            {
+              std::lock_guard<std::mutex> lck(pending_mtx);
+              send_failed = true;
+            }
+            pending_cv.notify_one();
+            result_package_queue.push(std::string());
+          };
+          try {
             auto result_package =
                 ProcessBinBundleCache(sender_db,
                                       crypto_context,
                                       cache,
                                       all_powers,
-                                      static_cast<uint32_t>(bundle_idx),
+                                      bundle_idx,
                                       compr_mode,
                                       pool);
             if (result_package == nullptr) {
+              mark_failed();
               return;
             }
             // serialize and push into result package queue
@@ -391,39 +504,34 @@ retcode KeywordPirOperatorServer::ProcessQuery(
                     << "data length: " << data_len
                     << " label_result size: "
                     << result_package->label_result.size();
-          }));
+          } catch (const std::exception& e) {
+            LOG(ERROR) << "process bin bundle cache failed, "
+                       << "bundle index: " << bundle_idx << " "
+                       << "error: " << e.what();
+            mark_failed();
+          }
+        }));
+    }
+    {
+      std::lock_guard<std::mutex> lck(pending_mtx);
+      if (send_failed) {
+        break;
+      }
     }
   }
-
-  futures.push_back(
-    std::async(
-      std::launch::async,
-      [&, this]() -> void {
-        auto link_ctx = this->GetLinkContext();
-        VLOG(5) << "package_count: " << package_count;
-        for (size_t i = 0; i < package_count; i++) {
-          std::string send_data;
-          result_package_queue.wait_and_pop(send_data);
-          auto ret = link_ctx->Send(this->response_key_, ProxyNode(), send_data);
-          if (ret != retcode::SUCCESS) {
-            LOG(ERROR) << "send result to client, index: " << i
-                << " data length: " << send_data.size() << " failed";
-            return;
-          }
-          VLOG(5) << "send result to client, index: " << i
-                  << " data length: " << send_data.size();
-        }
-      }));
-  // Wait until all bin bundle caches have been processed
+  // Wait until all submitted bin bundle caches have been processed
   for (auto& f : futures) {
     f.get();
   }
-  link_ctx->CheckSendCompleteStatus(this->response_key_,
-                                    ProxyNode(), package_count);
-  VLOG(5) << "Finished processing query request";
+  auto ret = send_fut.get();
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "send query result failed";
+    return retcode::FAIL;
+  }
   return retcode::SUCCESS;
 }
 
+
 retcode KeywordPirOperatorServer::ComputePowers(
     const shared_ptr<SenderDB> &sender_db,
     const apsi::CryptoContext &crypto_context,
@@ -611,19 +719,19 @@ std::unique_ptr<apsi::PSIParams> KeywordPirOperatorServer::SetPsiParams() {
 }
 
 bool KeywordPirOperatorServer::DbCacheAvailable(const std::string& db_path) {
-  return FileExists(db_path);
+  return SenderDbCache(db_path).Available();
 }
 
 std::shared_ptr<apsi::sender::SenderDB>
 KeywordPirOperatorServer::LoadDbFromCache(const std::string& db_file_cache) {
-  SCopedTimer timer;
-  std::fstream fin(db_file_cache, std::ios::in);
-  auto db_info = SenderDB::Load(fin);
-  auto sender_db = std::make_shared<SenderDB>(std::move(std::get<0>(db_info)));
-  VLOG(0) << "load data from cache file, db_size: " << std::get<1>(db_info);
+  SenderDbCache db_cache(db_file_cache);
+  auto sender_db = db_cache.Load();
+  if (sender_db == nullptr) {
+    return nullptr;
+  }
+  VLOG(0) << "load data from cache file, item count: "
+          << sender_db->get_item_count();
   *(this->oprf_key_) = sender_db->get_oprf_key();
-  auto time_cost = timer.timeElapse();
-  VLOG(5) << "LoadDbFromCache cost time(ms): " << time_cost;
   return sender_db;
 }
 
@@ -17,6 +17,7 @@
 #ifndef SRC_PRIMIHUB_KERNEL_PIR_OPERATOR_KEYWORD_PIR_IMPL_KEYWORD_PIR_SERVER_H_
 #define SRC_PRIMIHUB_KERNEL_PIR_OPERATOR_KEYWORD_PIR_IMPL_KEYWORD_PIR_SERVER_H_
 
+#include <functional>
 #include <variant>
 #include <vector>
 #include <memory>
@@ -26,6 +27,7 @@
 #include "src/primihub/kernel/pir/operator/base_pir.h"
 #include "src/primihub/kernel/pir/common.h"
 #include "src/primihub/kernel/pir/operator/keyword_pir_impl/keyword_pir_common.h"
+#include "src/primihub/kernel/pir/operator/keyword_pir_impl/sender_db_cache.h"
 
 // APSI
 #include "apsi/thread_pool_mgr.h"
@@ -52,10 +54,6 @@ using namespace seal;           // NOLINT
 using namespace seal::util;     // NOLINT
 
 namespace primihub::pir {
-using UnlabeledData = std::vector<apsi::Item>;
-using LabeledData = std::vector<std::pair<apsi::Item, apsi::Label>>;
-using DBData = std::variant<UnlabeledData, LabeledData>;
-
 class KeywordPirOperatorServer : public BasePirOperator {
  public:
   explicit KeywordPirOperatorServer(const Options& options) :
@@ -63,6 +61,16 @@ class KeywordPirOperatorServer : public BasePirOperator {
 
   retcode OnExecute(const PirDataType& input, PirDataType* result) override;
 
+  using PackageSender = std::function<retcode(std::string&& package)>;
+  /**
+   * answer a loaded query on the shared APSI thread pool.
+   * serialized result packages are passed to send_package in completion
+   * order, only a bounded number of them is computed ahead of the sender
+  */
+  retcode RunQuery(const std::shared_ptr<apsi::sender::SenderDB>& sender_db,
+                   std::unique_ptr<SenderOperationQuery> query_request,
+                   const PackageSender& send_package);
+
  protected:
   // ------------------------Sender----------------------------
   std::unique_ptr<apsi::PSIParams> SetPsiParams();
@@ -97,11 +105,15 @@ class KeywordPirOperatorServer : public BasePirOperator {
       std::unique_ptr<apsi::network::ResultPackage>;
 
   std::unique_ptr<DBData> CreateDb(const PirDataType& input);
-  retcode CreateDbDataCache(const DBData& db_data,
-                            std::unique_ptr<apsi::PSIParams> psi_params,
-                            apsi::oprf::OPRFKey &oprf_key,
-                            size_t nonce_byte_count,
-                            bool compress);
+  /**
+   * build the SenderDB of db_data and save it to db_path,
+   * an existing cache is updated instead of rebuilt when possible
+  */
+  auto CreateDbDataCache(const DBData& db_data,
+                         std::unique_ptr<apsi::PSIParams> psi_params,
+                         apsi::oprf::OPRFKey &oprf_key,
+                         size_t nonce_byte_count,
+                         bool compress) -> std::shared_ptr<SenderDB>;
 
   auto CreateSenderDb(const DBData &db_data,
                       std::unique_ptr<PSIParams> psi_params,
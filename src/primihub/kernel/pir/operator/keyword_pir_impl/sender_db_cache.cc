@@ -0,0 +1,449 @@
+/*
+* Copyright (c) 2023 by PrimiHub
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      https://www.apache.org/licenses/
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "src/primihub/kernel/pir/operator/keyword_pir_impl/sender_db_cache.h"
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <streambuf>
+#include <nlohmann/json.hpp>
+
+#include "src/primihub/common/value_check_util.h"
+#include "src/primihub/util/file_util.h"
+#include "src/primihub/util/util.h"
+
+namespace primihub::pir {
+namespace {
+constexpr size_t kItemByteCount = sizeof(apsi::Item::value_type);
+
+/**
+ * read only stream buffer over a memory mapped file
+*/
+class MappedStreamBuf : public std::streambuf {
+ public:
+  MappedStreamBuf(char* data, size_t size) {
+    setg(data, data, data + size);
+  }
+
+ protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override {
+    char* pos = nullptr;
+    if (dir == std::ios_base::beg) {
+      pos = eback() + off;
+    } else if (dir == std::ios_base::cur) {
+      pos = gptr() + off;
+    } else {
+      pos = egptr() + off;
+    }
+    if (pos < eback() || pos > egptr()) {
+      return pos_type(off_type(-1));
+    }
+    setg(eback(), pos, egptr());
+    return pos_type(pos - eback());
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+};
+
+/**
+ * FNV-1a, stable across builds since digests are stored on disk
+*/
+uint64_t LabelDigest(const apsi::Label& label) {
+  uint64_t digest = 14695981039346656037ULL;
+  for (auto c : label) {
+    digest ^= static_cast<uint64_t>(c);
+    digest *= 1099511628211ULL;
+  }
+  return digest;
+}
+
+/**
+ * flock on a lock file, released when it goes out of scope
+*/
+class ScopedFileLock {
+ public:
+  ScopedFileLock(const std::string& lock_path, int operation) {
+    fd_ = open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+      LOG(ERROR) << "open lock file: " << lock_path << " failed";
+      return;
+    }
+    if (flock(fd_, operation) != 0) {
+      LOG(ERROR) << "lock file: " << lock_path << " failed";
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+  ~ScopedFileLock() {
+    if (fd_ >= 0) {
+      flock(fd_, LOCK_UN);
+      close(fd_);
+    }
+  }
+  bool Locked() const {return fd_ >= 0;}
+
+ private:
+  int fd_{-1};
+};
+
+uint64_t ItemIndexSize(uint64_t item_count) {
+  return sizeof(uint64_t) + item_count * (kItemByteCount + sizeof(uint64_t));
+}
+
+std::string ItemKey(const apsi::Item& item) {
+  const auto& value = item.value();
+  return std::string(reinterpret_cast<const char*>(value.data()),
+                     value.size());
+}
+}  // namespace
+
+bool SenderDbCache::Available() const {
+  return FileExists(MetaPath()) || FileExists(db_path_);
+}
+
+std::string SenderDbCache::CacheFilePath(const std::string& file_name) const {
+  auto pos = db_path_.rfind('/');
+  if (pos == std::string::npos) {
+    return file_name;
+  }
+  return db_path_.substr(0, pos + 1) + file_name;
+}
+
+retcode SenderDbCache::LoadMeta(DbCacheMeta* meta) const {
+  if (!FileExists(MetaPath())) {
+    VLOG(5) << "no meta found for db cache: " << db_path_;
+    return retcode::FAIL;
+  }
+  std::string meta_str;
+  auto ret = ReadFileContents(MetaPath(), &meta_str);
+  CHECK_RETCODE(ret);
+  try {
+    auto js = nlohmann::json::parse(meta_str);
+    meta->format_version = js["format_version"].get<uint32_t>();
+    meta->dataset_version = js["dataset_version"].get<std::string>();
+    meta->item_count = js["item_count"].get<uint64_t>();
+    if (meta->format_version == kFormatVersion) {
+      meta->generation = js["generation"].get<uint64_t>();
+      meta->db_file = js["db_file"].get<std::string>();
+      meta->db_size = js["db_size"].get<uint64_t>();
+      meta->items_file = js["items_file"].get<std::string>();
+      meta->items_size = js["items_size"].get<uint64_t>();
+    }
+  } catch (std::exception& e) {
+    LOG(ERROR) << "parse db cache meta: " << MetaPath()
+               << " failed, " << e.what();
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+retcode SenderDbCache::SaveMeta(const DbCacheMeta& meta) const {
+  nlohmann::json js;
+  js["format_version"] = meta.format_version;
+  js["dataset_version"] = meta.dataset_version;
+  js["item_count"] = meta.item_count;
+  js["generation"] = meta.generation;
+  js["db_file"] = meta.db_file;
+  js["db_size"] = meta.db_size;
+  js["items_file"] = meta.items_file;
+  js["items_size"] = meta.items_size;
+  std::string meta_tmp = MetaPath() + ".tmp";
+  {
+    std::ofstream fout(meta_tmp, std::ios::trunc);
+    fout << js.dump();
+    fout.close();
+    if (!fout) {
+      LOG(ERROR) << "write " << meta_tmp << " failed";
+      RemoveFile(meta_tmp);
+      return retcode::FAIL;
+    }
+  }
+  if (std::rename(meta_tmp.c_str(), MetaPath().c_str()) != 0) {
+    LOG(ERROR) << "rename " << meta_tmp << " failed";
+    RemoveFile(meta_tmp);
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+std::shared_ptr<apsi::sender::SenderDB> SenderDbCache::Load() {
+  SCopedTimer timer;
+  loaded_meta_ = DbCacheMeta();
+  DbCacheMeta meta;
+  std::string db_file = db_path_;
+  int fd = -1;
+  {
+    // the meta and the files it names are looked up under the lock, an open
+    // fd keeps the generation readable even if a save removes it later
+    ScopedFileLock lock(LockPath(), LOCK_SH);
+    if (!lock.Locked()) {
+      return nullptr;
+    }
+    if (LoadMeta(&meta) == retcode::SUCCESS &&
+        meta.format_version == kFormatVersion) {
+      db_file = CacheFilePath(meta.db_file);
+    } else {
+      VLOG(5) << "db cache: " << db_path_ << " has no valid meta, "
+              << "load it as legacy cache";
+      meta = DbCacheMeta();
+    }
+    fd = open(db_file.c_str(), O_RDONLY | O_CLOEXEC);
+  }
+  if (fd < 0) {
+    LOG(ERROR) << "open db cache: " << db_file << " failed";
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    LOG(ERROR) << "db cache: " << db_file << " is empty or unreadable";
+    close(fd);
+    return nullptr;
+  }
+  size_t file_size = static_cast<size_t>(file_stat.st_size);
+  if (meta.format_version == kFormatVersion && file_size != meta.db_size) {
+    LOG(ERROR) << "db cache: " << db_file << " size: " << file_size << " "
+               << "does not match meta: " << meta.db_size;
+    close(fd);
+    return nullptr;
+  }
+  void* addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    LOG(ERROR) << "mmap db cache: " << db_file << " failed";
+    return nullptr;
+  }
+  madvise(addr, file_size, MADV_SEQUENTIAL);
+  std::shared_ptr<apsi::sender::SenderDB> sender_db{nullptr};
+  try {
+    MappedStreamBuf buf(static_cast<char*>(addr), file_size);
+    std::istream in(&buf);
+    auto db_info = apsi::sender::SenderDB::Load(in);
+    sender_db = std::make_shared<apsi::sender::SenderDB>(
+        std::move(std::get<0>(db_info)));
+  } catch (std::exception& e) {
+    LOG(ERROR) << "load db cache: " << db_file << " failed, " << e.what();
+  }
+  munmap(addr, file_size);
+  if (sender_db != nullptr && meta.format_version == kFormatVersion &&
+      sender_db->get_item_count() != meta.item_count) {
+    LOG(ERROR) << "db cache: " << db_file << " "
+               << "item count: " << sender_db->get_item_count() << " "
+               << "does not match meta: " << meta.item_count;
+    return nullptr;
+  }
+  if (sender_db != nullptr) {
+    loaded_meta_ = std::move(meta);
+  }
+  auto time_cost = timer.timeElapse();
+  VLOG(5) << "load db cache: " << db_file << " size: " << file_size
+          << " time cost(ms): " << time_cost;
+  return sender_db;
+}
+
+retcode SenderDbCache::LoadItemIndex(const DbCacheMeta& meta,
+                                     ItemIndex* index) const {
+  if (meta.format_version != kFormatVersion) {
+    VLOG(5) << "no item index found for db cache: " << db_path_;
+    return retcode::FAIL;
+  }
+  std::string items_path = CacheFilePath(meta.items_file);
+  std::ifstream fin(items_path, std::ios::binary);
+  if (!fin.is_open()) {
+    LOG(ERROR) << "open item index: " << items_path << " failed";
+    return retcode::FAIL;
+  }
+  uint64_t item_count = 0;
+  fin.read(reinterpret_cast<char*>(&item_count), sizeof(item_count));
+  uint64_t file_size = static_cast<uint64_t>(FileSize(items_path));
+  if (!fin || item_count != meta.item_count ||
+      file_size != meta.items_size || file_size != ItemIndexSize(item_count)) {
+    LOG(ERROR) << "item index: " << items_path << " does not match meta, "
+               << "item count: " << item_count << " size: " << file_size;
+    return retcode::FAIL;
+  }
+  index->reserve(item_count);
+  std::string item_key(kItemByteCount, '\0');
+  uint64_t digest = 0;
+  for (uint64_t i = 0; i < item_count; i++) {
+    fin.read(&item_key[0], kItemByteCount);
+    fin.read(reinterpret_cast<char*>(&digest), sizeof(digest));
+    if (!fin) {
+      LOG(ERROR) << "item index: " << items_path << " is truncated";
+      return retcode::FAIL;
+    }
+    (*index)[item_key] = digest;
+  }
+  return retcode::SUCCESS;
+}
+
+retcode SenderDbCache::SaveItemIndex(const LabeledData& db_data,
+                                     const std::string& file_path) const {
+  std::ofstream fout(file_path, std::ios::binary | std::ios::trunc);
+  if (!fout.is_open()) {
+    LOG(ERROR) << "open " << file_path << " failed";
+    return retcode::FAIL;
+  }
+  uint64_t item_count = db_data.size();
+  fout.write(reinterpret_cast<char*>(&item_count), sizeof(item_count));
+  for (const auto& [item, label] : db_data) {
+    uint64_t digest = LabelDigest(label);
+    fout.write(reinterpret_cast<const char*>(item.value().data()),
+               kItemByteCount);
+    fout.write(reinterpret_cast<char*>(&digest), sizeof(digest));
+  }
+  fout.close();
+  if (!fout) {
+    LOG(ERROR) << "write " << file_path << " failed";
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+retcode SenderDbCache::Update(const LabeledData& db_data,
+                              apsi::sender::SenderDB* sender_db) const {
+  SCopedTimer timer;
+  ItemIndex index;
+  auto ret = LoadItemIndex(loaded_meta_, &index);
+  CHECK_RETCODE(ret);
+  LabeledData upsert_data;
+  for (const auto& [item, label] : db_data) {
+    auto it = index.find(ItemKey(item));
+    if (it == index.end()) {
+      upsert_data.emplace_back(item, label);
+      continue;
+    }
+    if (it->second != LabelDigest(label)) {
+      upsert_data.emplace_back(item, label);
+    }
+    // what is left in index is deleted from the dataset
+    index.erase(it);
+  }
+  std::vector<apsi::Item> remove_data;
+  remove_data.reserve(index.size());
+  for (const auto& [item_key, digest] : index) {
+    apsi::Item::value_type value;
+    std::copy(item_key.begin(), item_key.end(), value.begin());
+    remove_data.emplace_back(value);
+  }
+  try {
+    if (!upsert_data.empty()) {
+      sender_db->insert_or_assign(upsert_data);
+    }
+    if (!remove_data.empty()) {
+      sender_db->remove(remove_data);
+    }
+  } catch (std::exception& e) {
+    LOG(ERROR) << "update db cache: " << db_path_ << " failed, " << e.what();
+    return retcode::FAIL;
+  }
+  auto time_cost = timer.timeElapse();
+  VLOG(0) << "update db cache: " << db_path_ << " "
+          << "insert or assign: " << upsert_data.size() << " "
+          << "remove: " << remove_data.size() << " "
+          << "time cost(ms): " << time_cost;
+  return retcode::SUCCESS;
+}
+
+retcode SenderDbCache::Save(const apsi::sender::SenderDB& sender_db,
+                            const LabeledData& db_data,
+                            const std::string& dataset_version) const {
+  SCopedTimer timer;
+  ScopedFileLock lock(LockPath(), LOCK_EX);
+  if (!lock.Locked()) {
+    return retcode::FAIL;
+  }
+  DbCacheMeta prev_meta;
+  bool has_prev = LoadMeta(&prev_meta) == retcode::SUCCESS &&
+                  prev_meta.format_version == kFormatVersion;
+  DbCacheMeta meta;
+  meta.format_version = kFormatVersion;
+  meta.dataset_version = dataset_version;
+  meta.item_count = db_data.size();
+  meta.generation = has_prev ? prev_meta.generation + 1 : 1;
+  std::string file_prefix = db_path_.substr(db_path_.rfind('/') + 1) +
+                            "." + std::to_string(meta.generation);
+  meta.db_file = file_prefix + ".db";
+  meta.items_file = file_prefix + ".items";
+  std::string db_file = CacheFilePath(meta.db_file);
+  std::string items_file = CacheFilePath(meta.items_file);
+  auto clean_up = [&]() {
+    RemoveFile(db_file);
+    RemoveFile(items_file);
+  };
+  size_t save_size = 0;
+  {
+    std::ofstream fout(db_file, std::ios::binary | std::ios::trunc);
+    if (!fout.is_open()) {
+      LOG(ERROR) << "open " << db_file << " failed";
+      return retcode::FAIL;
+    }
+    try {
+      save_size = sender_db.save(fout);
+    } catch (std::exception& e) {
+      LOG(ERROR) << "save SenderDB failed, " << e.what();
+      fout.close();
+      clean_up();
+      return retcode::FAIL;
+    }
+    fout.close();
+    if (!fout) {
+      LOG(ERROR) << "write " << db_file << " failed";
+      clean_up();
+      return retcode::FAIL;
+    }
+  }
+  auto ret = SaveItemIndex(db_data, items_file);
+  if (ret != retcode::SUCCESS) {
+    clean_up();
+    return retcode::FAIL;
+  }
+  meta.db_size = static_cast<uint64_t>(FileSize(db_file));
+  meta.items_size = static_cast<uint64_t>(FileSize(items_file));
+  // the rename of the meta commits the new generation
+  ret = SaveMeta(meta);
+  if (ret != retcode::SUCCESS) {
+    clean_up();
+    return retcode::FAIL;
+  }
+  if (has_prev) {
+    RemoveFile(CacheFilePath(prev_meta.db_file));
+    RemoveFile(CacheFilePath(prev_meta.items_file));
+  }
+  // left by a former version, superseded by the meta
+  for (const auto& legacy_file : {db_path_, db_path_ + ".items"}) {
+    if (FileExists(legacy_file)) {
+      RemoveFile(legacy_file);
+    }
+  }
+  auto time_cost = timer.timeElapse();
+  VLOG(0) << "save_size: " << save_size << " db path: " << db_path_ << " "
+          << "generation: " << meta.generation << " "
+          << "dataset version: " << dataset_version << " "
+          << "time cost(ms): " << time_cost;
+  return retcode::SUCCESS;
+}
+}  // namespace primihub::pir
@@ -0,0 +1,123 @@
+/*
+* Copyright (c) 2023 by PrimiHub
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      https://www.apache.org/licenses/
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef SRC_PRIMIHUB_KERNEL_PIR_OPERATOR_KEYWORD_PIR_IMPL_SENDER_DB_CACHE_H_
+#define SRC_PRIMIHUB_KERNEL_PIR_OPERATOR_KEYWORD_PIR_IMPL_SENDER_DB_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "src/primihub/common/common.h"
+
+// APSI
+#include "apsi/item.h"
+#include "apsi/sender_db.h"
+
+namespace primihub::pir {
+using UnlabeledData = std::vector<apsi::Item>;
+using LabeledData = std::vector<std::pair<apsi::Item, apsi::Label>>;
+using DBData = std::variant<UnlabeledData, LabeledData>;
+
+struct DbCacheMeta {
+  uint32_t format_version{0};
+  /**
+   * version of the dataset the cache is built from,
+   * empty if it is not given by the task
+  */
+  std::string dataset_version;
+  uint64_t item_count{0};
+  /**
+   * the files of one save, named relative to the directory of db_path,
+   * and their sizes which are checked on load
+  */
+  uint64_t generation{0};
+  std::string db_file;
+  uint64_t db_size{0};
+  std::string items_file;
+  uint64_t items_size{0};
+};
+
+/**
+ * on disk cache of a keyword pir SenderDB. every save writes a new generation
+ *   <db_path>.<generation>.db     the SenderDB saved by SenderDB::save
+ *   <db_path>.<generation>.items  item and label digest of every record in
+ *                                 the SenderDB, used to find inserted,
+ *                                 changed and deleted records
+ * and then commits it by renaming <db_path>.meta, the DbCacheMeta in json
+ * naming the files of the generation, so a reader never sees a mix of two
+ * saves. saves and the lookup of the files hold a flock on <db_path>.lock.
+ * caches written by former versions only have <db_path>, they can still be
+ * loaded but are rebuilt instead of updated.
+*/
+class SenderDbCache {
+ public:
+  static constexpr uint32_t kFormatVersion = 2;
+  explicit SenderDbCache(const std::string& db_path) : db_path_(db_path) {}
+
+  bool Available() const;
+  /**
+   * return FAIL if the cache has no meta
+  */
+  retcode LoadMeta(DbCacheMeta* meta) const;
+  /**
+   * map the db file into memory and deserialize the SenderDB from the mapping,
+   * the file is not copied through a stream buffer first.
+   * return nullptr if the file size or item count differs from the meta
+  */
+  std::shared_ptr<apsi::sender::SenderDB> Load();
+  /**
+   * apply the difference between the cached records and db_data to sender_db
+   * by insert_or_assign and remove, sender_db must come from Load of this
+   * object. return FAIL if the loaded generation has no valid item index or
+   * sender_db rejects the update, e.g. a label grows beyond the label size
+   * of sender_db, then the SenderDB has to be rebuilt.
+  */
+  retcode Update(const LabeledData& db_data,
+                 apsi::sender::SenderDB* sender_db) const;
+  /**
+   * write the SenderDB and item index of a new generation, commit it by
+   * renaming the meta and remove the files of the previous generation
+  */
+  retcode Save(const apsi::sender::SenderDB& sender_db,
+               const LabeledData& db_data,
+               const std::string& dataset_version) const;
+
+  std::string MetaPath() const {return db_path_ + ".meta";}
+  std::string LockPath() const {return db_path_ + ".lock";}
+
+ private:
+  // item value -> digest of label
+  using ItemIndex = std::unordered_map<std::string, uint64_t>;
+  retcode LoadItemIndex(const DbCacheMeta& meta, ItemIndex* index) const;
+  retcode SaveItemIndex(const LabeledData& db_data,
+                        const std::string& file_path) const;
+  retcode SaveMeta(const DbCacheMeta& meta) const;
+  /**
+   * path of a file named in the meta
+  */
+  std::string CacheFilePath(const std::string& file_name) const;
+
+ private:
+  std::string db_path_;
+  // meta of the generation returned by Load, empty for a legacy cache
+  DbCacheMeta loaded_meta_;
+};
+}  // namespace primihub::pir
+#endif  // SRC_PRIMIHUB_KERNEL_PIR_OPERATOR_KEYWORD_PIR_IMPL_SENDER_DB_CACHE_H_
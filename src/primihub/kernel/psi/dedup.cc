@@ -0,0 +1,187 @@
+/*
+ Copyright 2023 PrimiHub
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+#include "src/primihub/kernel/psi/dedup.h"
+#include <glog/logging.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+namespace primihub::psi {
+namespace {
+constexpr int64_t kEmptySlot = -1;
+// below this size, partitioning costs more than it saves
+constexpr size_t kMinItemsPerThread = 1 << 16;
+
+struct Slot {
+  uint64_t hash;
+  int64_t index;
+};
+
+/**
+ * run fn(i) for i in [0, num) on num threads, the caller runs the last one
+*/
+void ParallelRun(size_t num, const std::function<void(size_t)>& fn) {
+  std::vector<std::future<void>> futs;
+  for (size_t i = 0; i + 1 < num; i++) {
+    futs.push_back(std::async(std::launch::async, fn, i));
+  }
+  fn(num - 1);
+  for (auto& fut : futs) {
+    fut.get();
+  }
+}
+
+size_t TableCapacity(size_t item_num) {
+  size_t capacity = 16;
+  while (capacity < item_num * 2) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+}  // namespace
+
+retcode DeduplicateInPlace(std::vector<std::string>* items,
+                           size_t thread_num,
+                           int64_t* duplicate_num,
+                           std::vector<DedupPartitionStat>* stats) {
+  auto& data = *items;
+  size_t item_num = data.size();
+  if (thread_num == 0) {
+    thread_num = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  thread_num = std::max<size_t>(
+      1, std::min(thread_num, item_num / kMinItemsPerThread));
+  // number of partitions is a power of 2, take the high bits of the hash
+  size_t partition_bits = 0;
+  while ((size_t{1} << partition_bits) < thread_num) {
+    partition_bits++;
+  }
+  size_t partition_num = size_t{1} << partition_bits;
+  auto partition_of = [partition_bits](uint64_t hash) -> size_t {
+    return partition_bits == 0 ? 0 : hash >> (64 - partition_bits);
+  };
+
+  // hash all items and count the size of each partition
+  std::vector<uint64_t> hashes(item_num);
+  std::vector<std::vector<int64_t>> range_counts(
+      thread_num, std::vector<int64_t>(partition_num, 0));
+  size_t range_size = (item_num + thread_num - 1) / thread_num;
+  ParallelRun(thread_num, [&](size_t t) {
+    size_t begin = std::min(item_num, t * range_size);
+    size_t end = std::min(item_num, begin + range_size);
+    std::hash<std::string_view> hasher;
+    for (size_t i = begin; i < end; i++) {
+      hashes[i] = hasher(data[i]);
+      range_counts[t][partition_of(hashes[i])]++;
+    }
+  });
+
+  // bucket item indices by partition, thread t writes the indices of its
+  // range right after those of ranges [0, t), so each bucket stays in
+  // input order and a partition only walks its own items
+  std::vector<size_t> partition_begin(partition_num + 1, 0);
+  std::vector<std::vector<size_t>> range_offsets(
+      thread_num, std::vector<size_t>(partition_num, 0));
+  size_t offset = 0;
+  for (size_t p = 0; p < partition_num; p++) {
+    partition_begin[p] = offset;
+    for (size_t t = 0; t < thread_num; t++) {
+      range_offsets[t][p] = offset;
+      offset += range_counts[t][p];
+    }
+  }
+  partition_begin[partition_num] = offset;
+  std::vector<size_t> bucketed(item_num);
+  ParallelRun(thread_num, [&](size_t t) {
+    size_t begin = std::min(item_num, t * range_size);
+    size_t end = std::min(item_num, begin + range_size);
+    auto& next = range_offsets[t];
+    for (size_t i = begin; i < end; i++) {
+      bucketed[next[partition_of(hashes[i])]++] = i;
+    }
+  });
+
+  // each partition is owned by one thread, so keep flags are written
+  // without lock, items are scanned in order to keep the first occurrence
+  std::vector<uint8_t> keep(item_num, 0);
+  std::vector<DedupPartitionStat> partition_stats(partition_num);
+  ParallelRun(partition_num, [&](size_t p) {
+    auto start = std::chrono::steady_clock::now();
+    auto& stat = partition_stats[p];
+    stat.item_num = partition_begin[p + 1] - partition_begin[p];
+    size_t capacity = TableCapacity(stat.item_num);
+    size_t mask = capacity - 1;
+    std::vector<Slot> table(capacity, Slot{0, kEmptySlot});
+    for (size_t k = partition_begin[p]; k < partition_begin[p + 1]; k++) {
+      size_t i = bucketed[k];
+      uint64_t hash = hashes[i];
+      // the low bits pick the slot, the high bits pick the partition
+      size_t pos = hash & mask;
+      bool duplicated = false;
+      while (table[pos].index != kEmptySlot) {
+        if (table[pos].hash == hash && data[table[pos].index] == data[i]) {
+          duplicated = true;
+          break;
+        }
+        pos = (pos + 1) & mask;
+      }
+      if (duplicated) {
+        stat.duplicate_num++;
+        continue;
+      }
+      table[pos] = Slot{hash, static_cast<int64_t>(i)};
+      keep[i] = 1;
+    }
+    auto end = std::chrono::steady_clock::now();
+    stat.time_cost_ms =
+        std::chrono::duration<double, std::milli>(end - start).count();
+  });
+
+  // compact kept items to the front
+  size_t kept_num = 0;
+  for (size_t i = 0; i < item_num; i++) {
+    if (!keep[i]) {
+      continue;
+    }
+    if (kept_num != i) {
+      data[kept_num] = std::move(data[i]);
+    }
+    kept_num++;
+  }
+  data.resize(kept_num);
+
+  int64_t total_duplicate = 0;
+  for (size_t p = 0; p < partition_num; p++) {
+    const auto& stat = partition_stats[p];
+    total_duplicate += stat.duplicate_num;
+    VLOG(5) << "dedup partition: " << p << " "
+            << "items: " << stat.item_num << " "
+            << "duplicates: " << stat.duplicate_num << " "
+            << "time cost(ms): " << stat.time_cost_ms;
+  }
+  if (duplicate_num != nullptr) {
+    *duplicate_num = total_duplicate;
+  }
+  if (stats != nullptr) {
+    *stats = std::move(partition_stats);
+  }
+  return retcode::SUCCESS;
+}
+}  // namespace primihub::psi
@@ -0,0 +1,44 @@
+/*
+ Copyright 2023 PrimiHub
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef SRC_PRIMIHUB_KERNEL_PSI_DEDUP_H_
+#define SRC_PRIMIHUB_KERNEL_PSI_DEDUP_H_
+#include <string>
+#include <vector>
+
+#include "src/primihub/common/common.h"
+
+namespace primihub::psi {
+struct DedupPartitionStat {
+  int64_t item_num{0};
+  int64_t duplicate_num{0};
+  double time_cost_ms{0};
+};
+
+/**
+ * remove duplicated items in place, the first occurrence of each item is
+ * kept and the order of kept items does not change.
+ * items are partitioned by hash, each partition is deduplicated by one
+ * thread with an open addressing table of item index, so no item is copied.
+ * thread_num = 0 means hardware concurrency.
+ * stats: optional, statistics of each partition
+*/
+retcode DeduplicateInPlace(std::vector<std::string>* items,
+                           size_t thread_num = 0,
+                           int64_t* duplicate_num = nullptr,
+                           std::vector<DedupPartitionStat>* stats = nullptr);
+}  // namespace primihub::psi
+#endif  // SRC_PRIMIHUB_KERNEL_PSI_DEDUP_H_
@@ -31,6 +31,12 @@ struct Options {
   PsiResultType psi_result_type{PsiResultType::INTERSECTION};
   std::string code;
   Node proxy_node;      // location to fecth recv data
+  int64_t batch_size{0};  // exchange data in batches of this size, 0: disable
+  int32_t thread_num{0};  // worker threads for operator, 0: hardware cores
+  // logical channels of MT_KKRT and CM20, 0: same as thread_num
+  int32_t channel_num{0};
+  // hash of KKRT input, must be the same for both parties
+  BlockHashType block_hash_type{BlockHashType::SHA1};
 };
 
 class BasePsiOperator {
@@ -0,0 +1,128 @@
+// "Copyright [2023] <PrimiHub>"
+#include "src/primihub/kernel/psi/operator/block_hasher.h"
+#include <glog/logging.h>
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <utility>
+
+#include "cryptoTools/Crypto/AES.h"
+#include "cryptoTools/Crypto/RandomOracle.h"
+#include "src/primihub/util/thread_pool.h"
+
+namespace primihub::psi {
+namespace {
+// chunks per thread, more chunks than threads balance uneven string length
+constexpr size_t kChunksPerThread = 4;
+// below this size the cost of scheduling exceeds the hashing itself
+constexpr size_t kMinChunkSize = 4096;
+// items hashed in lockstep by one ecbEncBlocks call
+constexpr size_t kAesBatchSize = 8;
+constexpr size_t kBlockBytes = sizeof(oc::block);
+}  // namespace
+
+BlockHasher::BlockHasher(BlockHashType hash_type, size_t thread_num)
+    : hash_type_(hash_type) {
+  thread_num_ = thread_num > 0 ? thread_num : ThreadPool::DefaultThreadNum();
+}
+
+retcode BlockHasher::Hash(const std::vector<std::string>& input,
+                          std::vector<oc::block>* result_ptr) {
+  if (result_ptr->size() != input.size()) {
+    result_ptr->resize(input.size());
+  }
+  auto result = result_ptr->data();
+  size_t data_size = input.size();
+  size_t chunk_size = (data_size + thread_num_ * kChunksPerThread - 1) /
+                      (thread_num_ * kChunksPerThread);
+  chunk_size = std::max(chunk_size, kMinChunkSize);
+  if (thread_num_ == 1 || data_size <= chunk_size) {
+    HashRange(input, 0, data_size, result);
+    return retcode::SUCCESS;
+  }
+  size_t chunk_num = (data_size + chunk_size - 1) / chunk_size;
+  ThreadPool pool(std::min(thread_num_, chunk_num));
+  std::vector<std::future<void>> futs;
+  futs.reserve(chunk_num);
+  for (size_t begin = 0; begin < data_size; begin += chunk_size) {
+    size_t end = std::min(begin + chunk_size, data_size);
+    futs.push_back(pool.enqueue(
+        [&input, result, begin, end, this]() {
+          this->HashRange(input, begin, end, result);
+        }));
+  }
+  for (auto&& fut : futs) {
+    fut.get();
+  }
+  VLOG(5) << "hash " << data_size << " items using " << pool.size() << " "
+          << "threads, chunk size: " << chunk_size;
+  return retcode::SUCCESS;
+}
+
+void BlockHasher::HashRange(const std::vector<std::string>& input,
+                            size_t begin, size_t end, oc::block* result) {
+  if (hash_type_ == BlockHashType::FIXED_KEY_AES) {
+    for (size_t i = begin; i < end; i += kAesBatchSize) {
+      size_t num = std::min(kAesBatchSize, end - i);
+      FixedKeyAesHash(&input[i], num, &result[i]);
+    }
+    return;
+  }
+  u8 hash_dest[kBlockBytes];
+  oc::RandomOracle sha1(kBlockBytes);
+  for (size_t i = begin; i < end; i++) {
+    sha1.Update(reinterpret_cast<const u8*>(input[i].data()), input[i].size());
+    sha1.Final(hash_dest);
+    result[i] = oc::toBlock(hash_dest);
+    sha1.Reset();
+  }
+}
+
+void BlockHasher::FixedKeyAesHash(const std::string* items, size_t num,
+                                  oc::block* result) {
+  oc::block state[kAesBatchSize];
+  oc::block input[kAesBatchSize];
+  oc::block cipher[kAesBatchSize];
+  size_t block_num[kAesBatchSize];
+  size_t max_block_num = 0;
+  num = std::min(num, kAesBatchSize);
+  for (size_t j = 0; j < num; j++) {
+    size_t len = items[j].size();
+    // the length is absorbed in the initial state, so zero padding
+    // of the last block is unambiguous
+    state[j] = oc::block(static_cast<uint64_t>(len), 0x5052494d49485542ULL);
+    block_num[j] = std::max<size_t>(1, (len + kBlockBytes - 1) / kBlockBytes);
+    max_block_num = std::max(max_block_num, block_num[j]);
+  }
+  for (size_t round = 0; round < max_block_num; round++) {
+    for (size_t j = 0; j < num; j++) {
+      oc::block message = oc::ZeroBlock;
+      if (round < block_num[j]) {
+        size_t offset = round * kBlockBytes;
+        size_t len = items[j].size();
+        if (offset < len) {
+          memcpy(&message, items[j].data() + offset,
+                 std::min(kBlockBytes, len - offset));
+        }
+      }
+      input[j] = state[j] ^ message;
+    }
+    oc::mAesFixedKey.ecbEncBlocks(input, num, cipher);
+    for (size_t j = 0; j < num; j++) {
+      if (round < block_num[j]) {
+        state[j] = cipher[j] ^ input[j];
+      }
+    }
+  }
+  for (size_t j = 0; j < num; j++) {
+    result[j] = state[j];
+  }
+}
+
+oc::block BlockHasher::FixedKeyAesHash(std::string_view item) {
+  std::string item_str(item);
+  oc::block result;
+  FixedKeyAesHash(&item_str, 1, &result);
+  return result;
+}
+}  // namespace primihub::psi
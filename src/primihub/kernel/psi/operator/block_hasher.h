@@ -0,0 +1,47 @@
+// "Copyright [2023] <PrimiHub>"
+#ifndef SRC_PRIMIHUB_KERNEL_PSI_OPERATOR_BLOCK_HASHER_H_
+#define SRC_PRIMIHUB_KERNEL_PSI_OPERATOR_BLOCK_HASHER_H_
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cryptoTools/Common/Defines.h"
+#include "src/primihub/common/common.h"
+#include "src/primihub/kernel/psi/operator/common.h"
+
+namespace primihub::psi {
+/**
+ * hash PSI input items into oc::block
+ * items are split into chunks which are hashed on all cores,
+ * the chunk size adapts to the input size and the number of threads.
+ * both parties of a protocol must use the same hash type
+*/
+class BlockHasher {
+ public:
+  explicit BlockHasher(BlockHashType hash_type = BlockHashType::SHA1,
+                       size_t thread_num = 0);
+  retcode Hash(const std::vector<std::string>& input,
+               std::vector<oc::block>* result);
+  /**
+   * hash input[begin, end) into result[begin, end) in the caller thread
+  */
+  void HashRange(const std::vector<std::string>& input,
+                 size_t begin, size_t end, oc::block* result);
+  /**
+   * items are hashed in lockstep batches by fixed-key AES in
+   * Matyas-Meyer-Oseas mode: h = pi(h ^ m) ^ (h ^ m) for each 16 bytes
+   * of the item, starting from a state which encodes the item length.
+   * not collision resistant against adversarially chosen items,
+   * use SHA1 when the input is controlled by an untrusted party
+  */
+  static void FixedKeyAesHash(const std::string* items, size_t num,
+                              oc::block* result);
+  static oc::block FixedKeyAesHash(std::string_view item);
+  size_t ThreadNum() const {return thread_num_;}
+
+ private:
+  BlockHashType hash_type_{BlockHashType::SHA1};
+  size_t thread_num_{1};
+};
+}  // namespace primihub::psi
+#endif  // SRC_PRIMIHUB_KERNEL_PSI_OPERATOR_BLOCK_HASHER_H_
@@ -0,0 +1,85 @@
+// "Copyright [2023] <PrimiHub>"
+#include "src/primihub/kernel/psi/operator/cm20_psi.h"
+#include <utility>
+
+#include "cryptoTools/Crypto/PRNG.h"
+#include "libPSI/PSI/Cm20/Cm20PsiReceiver.h"
+#include "libPSI/PSI/Cm20/Cm20PsiSender.h"
+
+#include "src/primihub/common/value_check_util.h"
+#include "src/primihub/util/util.h"
+
+namespace primihub::psi {
+namespace {
+// scale of the number of bins to the receiver set size
+constexpr double kBinScaler = 1.0;
+constexpr u64 kStatSecParam = 40;
+}  // namespace
+
+retcode Cm20PsiOperator::PsiRecv(std::vector<oc::Channel>& chls,
+                                 const std::vector<std::string>& input,
+                                 std::vector<uint64_t>* result_index) {
+  u8 dummy[1];
+  auto& chl = chls[0];
+  oc::PRNG prng(oc::sysRandomSeed());
+  u64 sendSize;
+  u64 recvSize = input.size();
+  auto ret = ExchangeValue(chl, recvSize, &sendSize);
+  CHECK_RETCODE(ret);
+  std::vector<oc::block> recvSet(recvSize);
+  SCopedTimer timer;
+  HashDataParallel(input, &recvSet);
+  auto time_cost = timer.timeElapse();
+  VLOG(5) << "encrypt data cost time(ms): " << time_cost;
+  oc::Cm20PsiReceiver recvPSIs;
+  chl.recv(dummy, 1);
+  chl.asyncSend(dummy, 1);
+  auto start_init_receiver = timer.timeElapse();
+  recvPSIs.init(sendSize, recvSize, kBinScaler, chls.size(), kStatSecParam,
+                chls, prng.get<oc::block>());
+  auto end_init_receiver = timer.timeElapse();
+  VLOG(5) << "init cm20 receiver cost(ms): "
+          << end_init_receiver - start_init_receiver;
+  recvPSIs.sendInput(recvSet, chls);
+  auto end_psi_protocol = timer.timeElapse();
+  VLOG(5) << "execute cm20 protocol cost(ms): "
+          << end_psi_protocol - end_init_receiver
+          << " channel num: " << chls.size();
+  *result_index = std::move(recvPSIs.mIntersection);
+  return retcode::SUCCESS;
+}
+
+retcode Cm20PsiOperator::PsiSend(std::vector<oc::Channel>& chls,
+                                 const std::vector<std::string>& input) {
+  u8 dummy[1];
+  auto& chl = chls[0];
+  oc::PRNG prng(oc::sysRandomSeed());
+  u64 sendSize = input.size();
+  u64 recvSize;
+  auto ret = ExchangeValue(chl, sendSize, &recvSize);
+  CHECK_RETCODE(ret);
+  SCopedTimer timer;
+  std::vector<oc::block> set(sendSize);
+  HashDataParallel(input, &set);
+  auto time_cost = timer.timeElapse();
+  VLOG(5) << "encrypt data cost time(ms): " << time_cost;
+  oc::Cm20PsiSender sendPSIs;
+  chl.asyncSend(dummy, 1);
+  chl.recv(dummy, 1);
+  auto start_init_sender = timer.timeElapse();
+  sendPSIs.init(sendSize, recvSize, kBinScaler, chls.size(), kStatSecParam,
+                chls, prng.get<oc::block>());
+  auto end_init_sender = timer.timeElapse();
+  VLOG(5) << "init cm20 sender cost(ms): "
+          << end_init_sender - start_init_sender;
+  sendPSIs.sendInput(set, chls);
+  auto end_psi_protocol = timer.timeElapse();
+  VLOG(5) << "execute cm20 protocol cost(ms): "
+          << end_psi_protocol - end_init_sender
+          << " channel num: " << chls.size();
+  for (auto& channel : chls) {
+    channel.resetStats();
+  }
+  return retcode::SUCCESS;
+}
+}  // namespace primihub::psi
@@ -0,0 +1,29 @@
+// "Copyright [2023] <PrimiHub>"
+#ifndef SRC_PRIMIHUB_KERNEL_PSI_OPERATOR_CM20_PSI_H_
+#define SRC_PRIMIHUB_KERNEL_PSI_OPERATOR_CM20_PSI_H_
+#include <vector>
+#include <string>
+
+#include "src/primihub/kernel/psi/operator/kkrt_psi.h"
+
+namespace primihub::psi {
+/**
+ * CM20 (Chase-Miao) PSI of libPSI over multiple logical channels.
+ * channel setup and input hashing are the same as KKRT
+*/
+class Cm20PsiOperator : public KkrtPsiOperator {
+ public:
+  explicit Cm20PsiOperator(const Options& options) :
+      KkrtPsiOperator(options) {}
+
+ protected:
+  bool MultiChannel() override {return true;}
+  size_t ChannelNum() override {return ParallelChannelNum();}
+  retcode PsiRecv(std::vector<oc::Channel>& chls,
+                  const std::vector<std::string>& input,
+                  std::vector<uint64_t>* result_index) override;
+  retcode PsiSend(std::vector<oc::Channel>& chls,
+                  const std::vector<std::string>& input) override;
+};
+}  // namespace primihub::psi
+#endif  // SRC_PRIMIHUB_KERNEL_PSI_OPERATOR_CM20_PSI_H_
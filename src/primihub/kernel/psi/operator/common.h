@@ -7,12 +7,19 @@ enum class PsiType {
   ECDH = 0,
   KKRT,
   TEE,
+  MT_KKRT,  // KKRT over multiple channels
+  CM20,
 };
 
 enum class PsiResultType {
   INTERSECTION = 0,
   DIFFERENCE = 1,
 };
+
+enum class BlockHashType {
+  SHA1 = 0,
+  FIXED_KEY_AES = 1,
+};
 }  // namespace primihub::psi
 
 #endif  // SRC_PRIMIHUB_KERNEL_PSI_OPERATOR_COMMON_H_
@@ -3,7 +3,13 @@
 
 #include <utility>
 #include <set>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <atomic>
 
+#include "absl/types/span.h"
 #include "private_set_intersection/cpp/psi_client.h"
 #include "private_set_intersection/cpp/psi_server.h"
 
@@ -11,8 +17,204 @@
 #include "src/primihub/common/value_check_util.h"
 #include "src/primihub/util/util.h"
 #include "src/primihub/util/endian_util.h"
+#include "src/primihub/util/threadsafe_queue.h"
 
 namespace primihub::psi {
+namespace {
+double PointsPerSecond(size_t num_points, double time_cost_ms) {
+  if (time_cost_ms <= 0) {
+    time_cost_ms = 1;
+  }
+  return num_points * 1000.0 / time_cost_ms;
+}
+}  // namespace
+
+// EcdhCryptoEngine
+std::unique_ptr<EcdhCryptoEngine> EcdhCryptoEngine::CreateForClient(
+    const std::string& key_bytes, bool reveal_intersection, ThreadPool* pool) {
+  std::unique_ptr<EcdhCryptoEngine> engine(
+      new EcdhCryptoEngine(reveal_intersection, pool));
+  for (size_t i = 0; i < pool->size(); i++) {
+    auto client = openminded_psi::PsiClient::CreateFromKey(
+        key_bytes, reveal_intersection);
+    if (!client.ok()) {
+      LOG(ERROR) << "create psi client from key failed, "
+                 << client.status().message();
+      return nullptr;
+    }
+    engine->clients_.push_back(std::move(client).value());
+  }
+  return engine;
+}
+
+std::unique_ptr<EcdhCryptoEngine> EcdhCryptoEngine::CreateForServer(
+    const std::string& key_bytes, bool reveal_intersection, ThreadPool* pool) {
+  std::unique_ptr<EcdhCryptoEngine> engine(
+      new EcdhCryptoEngine(reveal_intersection, pool));
+  for (size_t i = 0; i < pool->size(); i++) {
+    auto server = openminded_psi::PsiServer::CreateFromKey(
+        key_bytes, reveal_intersection);
+    if (!server.ok()) {
+      LOG(ERROR) << "create psi server from key failed, "
+                 << server.status().message();
+      return nullptr;
+    }
+    engine->servers_.push_back(std::move(server).value());
+  }
+  return engine;
+}
+
+void EcdhCryptoEngine::SplitRange(size_t total,
+    std::vector<std::pair<size_t, size_t>>* ranges) {
+  ranges->clear();
+  size_t worker_num = pool_->size();
+  size_t range_size = (total + worker_num - 1) / worker_num;
+  range_size = std::max(range_size, kMinRangeSize);
+  for (size_t start = 0; start < total; start += range_size) {
+    ranges->emplace_back(start, std::min(start + range_size, total));
+  }
+}
+
+retcode EcdhCryptoEngine::CreateRequest(absl::Span<const std::string> input,
+                                        psi_proto::Request* request) {
+  std::vector<std::pair<size_t, size_t>> ranges;
+  SplitRange(input.size(), &ranges);
+  std::vector<psi_proto::Request> sub_requests(ranges.size());
+  std::vector<std::future<retcode>> futs;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    futs.push_back(pool_->enqueue(
+      [&, i]() -> retcode {
+        auto [start, end] = ranges[i];
+        auto sub_input = input.subspan(start, end - start);
+        auto sub_request = clients_[i]->CreateRequest(sub_input);
+        if (!sub_request.ok()) {
+          LOG(ERROR) << "create request for range [" << start << ", "
+                     << end << ") failed, " << sub_request.status().message();
+          return retcode::FAIL;
+        }
+        sub_requests[i] = std::move(sub_request).value();
+        return retcode::SUCCESS;
+      }));
+  }
+  auto ret{retcode::SUCCESS};
+  for (auto&& fut : futs) {
+    if (fut.get() != retcode::SUCCESS) {
+      ret = retcode::FAIL;
+    }
+  }
+  CHECK_RETCODE(ret);
+  request->set_reveal_intersection(reveal_intersection_);
+  auto encrypted_elements = request->mutable_encrypted_elements();
+  encrypted_elements->Reserve(input.size());
+  for (auto& sub_request : sub_requests) {
+    for (auto& element : *(sub_request.mutable_encrypted_elements())) {
+      request->add_encrypted_elements(std::move(element));
+    }
+  }
+  return retcode::SUCCESS;
+}
+
+retcode EcdhCryptoEngine::GetIntersection(
+    const psi_proto::ServerSetup& server_setup,
+    psi_proto::Response&& response,
+    std::vector<int64_t>* intersection) {
+  size_t num_elements = response.encrypted_elements_size();
+  std::vector<std::pair<size_t, size_t>> ranges;
+  SplitRange(num_elements, &ranges);
+  std::vector<std::vector<int64_t>> sub_intersections(ranges.size());
+  std::vector<std::future<retcode>> futs;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    futs.push_back(pool_->enqueue(
+      [&, i]() -> retcode {
+        auto [start, end] = ranges[i];
+        psi_proto::Response sub_response;
+        auto sub_elements = sub_response.mutable_encrypted_elements();
+        sub_elements->Reserve(end - start);
+        for (size_t j = start; j < end; j++) {
+          sub_response.add_encrypted_elements(
+              std::move(*response.mutable_encrypted_elements(j)));
+        }
+        auto sub_intersection =
+            clients_[i]->GetIntersection(server_setup, sub_response);
+        if (!sub_intersection.ok()) {
+          LOG(ERROR) << "get intersection for range [" << start << ", "
+                     << end << ") failed, "
+                     << sub_intersection.status().message();
+          return retcode::FAIL;
+        }
+        auto& result = sub_intersections[i];
+        result = std::move(sub_intersection).value();
+        for (auto& index : result) {
+          index += start;
+        }
+        return retcode::SUCCESS;
+      }));
+  }
+  auto ret{retcode::SUCCESS};
+  for (auto&& fut : futs) {
+    if (fut.get() != retcode::SUCCESS) {
+      ret = retcode::FAIL;
+    }
+  }
+  CHECK_RETCODE(ret);
+  for (auto& sub_intersection : sub_intersections) {
+    intersection->insert(intersection->end(),
+                         sub_intersection.begin(), sub_intersection.end());
+  }
+  return retcode::SUCCESS;
+}
+
+retcode EcdhCryptoEngine::ProcessRequest(psi_proto::Request&& request,
+                                         psi_proto::Response* response) {
+  size_t num_elements = request.encrypted_elements_size();
+  std::vector<std::pair<size_t, size_t>> ranges;
+  SplitRange(num_elements, &ranges);
+  std::vector<psi_proto::Response> sub_responses(ranges.size());
+  std::vector<std::future<retcode>> futs;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    futs.push_back(pool_->enqueue(
+      [&, i]() -> retcode {
+        auto [start, end] = ranges[i];
+        psi_proto::Request sub_request;
+        sub_request.set_reveal_intersection(request.reveal_intersection());
+        auto sub_elements = sub_request.mutable_encrypted_elements();
+        sub_elements->Reserve(end - start);
+        for (size_t j = start; j < end; j++) {
+          sub_request.add_encrypted_elements(
+              std::move(*request.mutable_encrypted_elements(j)));
+        }
+        auto sub_response = servers_[i]->ProcessRequest(sub_request);
+        if (!sub_response.ok()) {
+          LOG(ERROR) << "process request for range [" << start << ", "
+                     << end << ") failed, " << sub_response.status().message();
+          return retcode::FAIL;
+        }
+        sub_responses[i] = std::move(sub_response).value();
+        return retcode::SUCCESS;
+      }));
+  }
+  auto ret{retcode::SUCCESS};
+  for (auto&& fut : futs) {
+    if (fut.get() != retcode::SUCCESS) {
+      ret = retcode::FAIL;
+    }
+  }
+  CHECK_RETCODE(ret);
+  auto encrypted_elements = response->mutable_encrypted_elements();
+  encrypted_elements->Reserve(num_elements);
+  for (auto& sub_response : sub_responses) {
+    for (auto& element : *(sub_response.mutable_encrypted_elements())) {
+      response->add_encrypted_elements(std::move(element));
+    }
+  }
+  if (!reveal_intersection_) {
+    // only cardinality is revealed, hide the order of the whole response
+    std::sort(encrypted_elements->begin(), encrypted_elements->end());
+  }
+  return retcode::SUCCESS;
+}
+
+// EcdhPsiOperator
 retcode EcdhPsiOperator::OnExecute(const std::vector<std::string>& input,
                                    std::vector<std::string>* result) {
   if (input.empty()) {
@@ -46,24 +248,33 @@ retcode EcdhPsiOperator::ExecuteAsClient(const std::vector<std::string>& input,
           << "content length: " << init_param_str.size();
   auto ret = SendInitParam(init_param_str);
   CHECK_RETCODE(ret);
+  if (UseBatchMode(input.size())) {
+    return ExecuteAsClientInBatch(input, result);
+  }
   VLOG(5) << "client begin to prepare psi request";
   // prepare psi data
   auto ts = timer.timeElapse();
   auto client = openminded_psi::PsiClient::CreateWithNewKey(
       reveal_intersection_).value();
-  // psi_proto::Request
-  auto client_request = client->CreateRequest(input).value();
-  // psi_proto::Response server_response;
+  auto crypto_engine = EcdhCryptoEngine::CreateForClient(
+      client->GetPrivateKeyBytes(), reveal_intersection_, pool_.get());
+  CHECK_NULLPOINTER_WITH_ERROR_MSG(crypto_engine, "create crypto engine failed");
+  psi_proto::Request client_request;
+  ret = crypto_engine->CreateRequest(input, &client_request);
+  CHECK_RETCODE_WITH_ERROR_MSG(ret, "client build request failed");
   auto build_req_ts = timer.timeElapse();
   auto build_req_time_cost = build_req_ts - ts;
-  VLOG(5) << "client build request time cost(ms): " << build_req_time_cost;
+  VLOG(5) << "client build request time cost(ms): " << build_req_time_cost
+          << " throughput(points/s): "
+          << PointsPerSecond(input.size(), build_req_time_cost);
   // send psi data to server
   rpc::PsiResponse task_response;
   ret = SendPSIRequestAndWaitResponse(std::move(client_request),
                                       &task_response);
   CHECK_RETCODE(ret);
   auto _start = timer.timeElapse();
-  ret = this->GetIntersection(input, client, task_response, result);
+  ret = this->GetIntersection(input, crypto_engine.get(),
+                              task_response, result);
   CHECK_RETCODE_WITH_ERROR_MSG(ret, "Node psi client get insection failed.");
   auto _end =  timer.timeElapse();
   auto get_intersection_time_cost = _end - _start;
@@ -73,16 +284,16 @@ retcode EcdhPsiOperator::ExecuteAsClient(const std::vector<std::string>& input,
 
 retcode EcdhPsiOperator::GetIntersection(
     const std::vector<std::string> origin_data,
-    const std::unique_ptr<openminded_psi::PsiClient>& client,
+    EcdhCryptoEngine* crypto_engine,
     rpc::PsiResponse& response,
     std::vector<std::string>* result) {
   CHECK_TASK_STOPPED(retcode::FAIL);
   SCopedTimer timer;
   psi_proto::Response entrpy_response;
   size_t num_response_elements = response.encrypted_elements().size();
-  for (size_t i = 0; i < num_response_elements; i++) {
-    entrpy_response.add_encrypted_elements(
-        response.encrypted_elements()[i]);
+  entrpy_response.mutable_encrypted_elements()->Reserve(num_response_elements);
+  for (auto& encrypted_element : *(response.mutable_encrypted_elements())) {
+    entrpy_response.add_encrypted_elements(std::move(encrypted_element));
   }
   psi_proto::ServerSetup server_setup;
   server_setup.set_bits(response.server_setup().bits());
@@ -103,11 +314,16 @@ retcode EcdhPsiOperator::GetIntersection(
   auto build_resp_time_cost = timer.timeElapse();
   VLOG(5) << "build_response_time_cost(ms): " << build_resp_time_cost;
 
-  std::vector<int64_t> intersection =
-      std::move(client->GetIntersection(server_setup, entrpy_response)).value();
+  std::vector<int64_t> intersection;
+  auto ret = crypto_engine->GetIntersection(server_setup,
+                                            std::move(entrpy_response),
+                                            &intersection);
+  CHECK_RETCODE_WITH_ERROR_MSG(ret, "client decrypt server response failed");
   auto get_intersection_ts = timer.timeElapse();
   auto get_intersection_time_cost = get_intersection_ts - build_resp_time_cost;
-  VLOG(5) << "get_intersection_time_cost: " << get_intersection_time_cost;
+  VLOG(5) << "get_intersection_time_cost: " << get_intersection_time_cost
+          << " throughput(points/s): "
+          << PointsPerSecond(num_response_elements, get_intersection_time_cost);
   size_t num_intersection = intersection.size();
 
   if (options_.psi_result_type == PsiResultType::DIFFERENCE) {
@@ -130,6 +346,149 @@ retcode EcdhPsiOperator::GetIntersection(
   return retcode::SUCCESS;
 }
 
+retcode EcdhPsiOperator::ExecuteAsClientInBatch(
+    const std::vector<std::string>& input,
+    std::vector<std::string>* result) {
+  CHECK_TASK_STOPPED(retcode::FAIL);
+  SCopedTimer timer;
+  size_t num_elements = input.size();
+  size_t batch_size = batch_size_;
+  size_t batch_num = num_elements / batch_size;
+  if (num_elements % batch_size) {
+    batch_num++;
+  }
+  VLOG(5) << "client begin to execute psi in batch mode, "
+          << "batch size: " << batch_size << " batch num: " << batch_num;
+  auto client = openminded_psi::PsiClient::CreateWithNewKey(
+      reveal_intersection_).value();
+  // sender and receiver run concurrently, each one owns its cipher instances
+  auto encrypt_engine = EcdhCryptoEngine::CreateForClient(
+      client->GetPrivateKeyBytes(), reveal_intersection_, pool_.get());
+  auto decrypt_engine = EcdhCryptoEngine::CreateForClient(
+      client->GetPrivateKeyBytes(), reveal_intersection_, pool_.get());
+  if (encrypt_engine == nullptr || decrypt_engine == nullptr) {
+    LOG(ERROR) << "create crypto engine failed";
+    return retcode::FAIL;
+  }
+  // limit the number of batches which are sent but not responded,
+  // so that client does not run too far ahead of server
+  std::mutex window_mtx;
+  std::condition_variable window_cv;
+  size_t inflight_batch{0};
+  bool abort_send{false};
+  auto send_fut = std::async(
+    std::launch::async,
+    [&]() -> retcode {
+      for (size_t i = 0; i < batch_num; i++) {
+        {
+          std::unique_lock<std::mutex> lck(window_mtx);
+          window_cv.wait(lck, [&]() {
+            return abort_send || inflight_batch < max_inflight_batch_;
+          });
+          if (abort_send) {
+            return retcode::FAIL;
+          }
+          inflight_batch++;
+        }
+        size_t start = i * batch_size;
+        size_t length = std::min(batch_size, num_elements - start);
+        auto batch_data = absl::MakeConstSpan(&input[start], length);
+        psi_proto::Request batch_request;
+        auto ret = encrypt_engine->CreateRequest(batch_data, &batch_request);
+        if (ret != retcode::SUCCESS) {
+          LOG(ERROR) << "create request for batch: " << i << " failed";
+          return retcode::FAIL;
+        }
+        std::string request_str;
+        batch_request.SerializeToString(&request_str);
+        ret = this->GetLinkContext()->Send(this->key_,
+                                                this->peer_node_, request_str);
+        if (ret != retcode::SUCCESS) {
+          LOG(ERROR) << "send request of batch: " << i << " to ["
+                     << this->peer_node_.to_string() << "] failed";
+          return retcode::FAIL;
+        }
+        VLOG(7) << "send request of batch: " << i << " success";
+      }
+      return retcode::SUCCESS;
+    });
+  auto abort_sender = [&]() {
+    {
+      std::lock_guard<std::mutex> lck(window_mtx);
+      abort_send = true;
+    }
+    window_cv.notify_all();
+    send_fut.get();
+  };
+
+  psi_proto::ServerSetup server_setup;
+  auto ret = RecvServerSetup(&server_setup);
+  if (ret != retcode::SUCCESS) {
+    abort_sender();
+    return retcode::FAIL;
+  }
+  std::vector<uint64_t> intersection_index;
+  for (size_t i = 0; i < batch_num; i++) {
+    std::string response_str;
+    ret = this->GetLinkContext()->Recv(this->key_,
+                                       this->ProxyServerNode(),
+                                       &response_str);
+    if (ret != retcode::SUCCESS) {
+      LOG(ERROR) << "recv response of batch: " << i << " failed";
+      abort_sender();
+      return retcode::FAIL;
+    }
+    {
+      std::lock_guard<std::mutex> lck(window_mtx);
+      inflight_batch--;
+    }
+    window_cv.notify_all();
+    psi_proto::Response batch_response;
+    if (!batch_response.ParseFromString(response_str)) {
+      LOG(ERROR) << "parse response of batch: " << i << " failed";
+      abort_sender();
+      return retcode::FAIL;
+    }
+    std::vector<int64_t> batch_intersection;
+    ret = decrypt_engine->GetIntersection(server_setup,
+                                          std::move(batch_response),
+                                          &batch_intersection);
+    if (ret != retcode::SUCCESS) {
+      LOG(ERROR) << "get intersection of batch: " << i << " failed";
+      abort_sender();
+      return retcode::FAIL;
+    }
+    uint64_t offset = i * batch_size;
+    for (const auto index : batch_intersection) {
+      intersection_index.push_back(offset + index);
+    }
+    VLOG(7) << "batch: " << i << " intersection size: "
+            << batch_intersection.size();
+  }
+  ret = send_fut.get();
+  CHECK_RETCODE_WITH_ERROR_MSG(ret, "send psi request in batch failed");
+  auto psi_time_cost = timer.timeElapse();
+  VLOG(5) << "execute psi in batch mode time cost(ms): " << psi_time_cost
+          << " throughput(points/s): "
+          << PointsPerSecond(2 * num_elements, psi_time_cost);
+  return this->GetResult(input, intersection_index, result);
+}
+
+retcode EcdhPsiOperator::RecvServerSetup(
+    psi_proto::ServerSetup* server_setup) {
+  CHECK_TASK_STOPPED(retcode::FAIL);
+  std::string setup_str;
+  auto ret = this->GetLinkContext()->Recv(this->key_,
+                                          this->ProxyServerNode(),
+                                          &setup_str);
+  CHECK_RETCODE_WITH_ERROR_MSG(ret, "receive server setup failed");
+  if (!server_setup->ParseFromString(setup_str)) {
+    LOG(ERROR) << "parse server setup failed";
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
 retcode EcdhPsiOperator::BuildInitParam(int64_t element_size,
                                         std::string* init_param) {
   CHECK_TASK_STOPPED(retcode::FAIL);
@@ -147,6 +506,12 @@ retcode EcdhPsiOperator::BuildInitParam(int64_t element_size,
   pv_intersection.set_value_int32(this->reveal_intersection_ ? 1 : 0);
   pv_intersection.set_is_array(false);
   (*param_map)["reveal_intersection"] = pv_intersection;
+  // batch size, 0 means the whole dataset is sent in one request
+  rpc::ParamValue pv_batch_size;
+  pv_batch_size.set_var_type(rpc::VarType::INT64);
+  pv_batch_size.set_value_int64(UseBatchMode(element_size) ? batch_size_ : 0);
+  pv_batch_size.set_is_array(false);
+  (*param_map)["batch_size"] = pv_batch_size;
   bool success = init_params.SerializeToString(init_param);
   if (!success) {
     LOG(ERROR) << "serialize init param failed";
@@ -245,36 +610,161 @@ retcode EcdhPsiOperator::ExecuteAsServer(
   SCopedTimer timer;
   size_t num_client_elements{0};
   bool reveal_intersection_flag{false};
-  auto ret = RecvInitParam(&num_client_elements, &reveal_intersection_flag);
+  size_t batch_size{0};
+  auto ret = RecvInitParam(&num_client_elements, &reveal_intersection_flag,
+                           &batch_size);
   CHECK_RETCODE(ret);
   // prepare for local computation
   VLOG(5) << "sever begin to SetupMessage";
   std::unique_ptr<openminded_psi::PsiServer> server =
       std::move(openminded_psi::PsiServer::CreateWithNewKey(
           reveal_intersection_flag)).value();
-  // std::int64_t num_client_elements =
-  //     static_cast<std::int64_t>(psi_request.encrypted_elements().size());
-  psi_proto::ServerSetup server_setup =
-      std::move(server->CreateSetupMessage(fpr_,
-                                           num_client_elements,
-                                           input)).value();
-  VLOG(5) << "sever end of SetupMessage";
+  auto crypto_engine = EcdhCryptoEngine::CreateForServer(
+      server->GetPrivateKeyBytes(), reveal_intersection_flag, pool_.get());
+  CHECK_NULLPOINTER_WITH_ERROR_MSG(crypto_engine, "create crypto engine failed");
+  // setup message is built over the whole server dataset inside openminded psi,
+  // overlap it with receiving and encrypting the request of client
+  auto setup_fut = std::async(
+    std::launch::async,
+    [&]() -> psi_proto::ServerSetup {
+      SCopedTimer setup_timer;
+      auto setup = std::move(server->CreateSetupMessage(fpr_,
+                                                        num_client_elements,
+                                                        input)).value();
+      auto setup_time_cost = setup_timer.timeElapse();
+      VLOG(5) << "sever end of SetupMessage, time cost(ms): "
+              << setup_time_cost << " throughput(points/s): "
+              << PointsPerSecond(input.size(), setup_time_cost);
+      return setup;
+    });
+  if (batch_size > 0) {
+    // client needs server setup before the first batch is responded
+    auto server_setup = setup_fut.get();
+    return ExecuteAsServerInBatch(crypto_engine.get(), std::move(server_setup),
+                                  num_client_elements, batch_size);
+  }
   // recv request from client
   VLOG(5) << "server begin to init reauest according to recv data from client";
   psi_proto::Request psi_request;
   ret = InitRequest(&psi_request);
-  CHECK_RETCODE(ret);
+  if (ret != retcode::SUCCESS) {
+    setup_fut.wait();
+    return retcode::FAIL;
+  }
   auto init_req_ts = timer.timeElapse();
   auto init_req_time_cost = init_req_ts;
   VLOG(5) << "init_req_time_cost(ms): " << init_req_time_cost;
-  psi_proto::Response server_response =
-      std::move(server->ProcessRequest(psi_request)).value();
+  size_t num_request_elements = psi_request.encrypted_elements_size();
+  psi_proto::Response server_response;
+  ret = crypto_engine->ProcessRequest(std::move(psi_request),
+                                      &server_response);
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "server process request failed";
+    setup_fut.wait();
+    return retcode::FAIL;
+  }
+  auto process_req_time_cost = timer.timeElapse() - init_req_ts;
+  VLOG(5) << "server process request time cost(ms): " << process_req_time_cost
+          << " throughput(points/s): "
+          << PointsPerSecond(num_request_elements, process_req_time_cost);
+  psi_proto::ServerSetup server_setup = setup_fut.get();
   VLOG(5) << "server end of process request, begin to build response";
   PreparePSIResponse(std::move(server_response), std::move(server_setup));
   VLOG(5) << "end of send psi response to client";
   return retcode::SUCCESS;
 }
 
+retcode EcdhPsiOperator::ExecuteAsServerInBatch(
+    EcdhCryptoEngine* crypto_engine,
+    psi_proto::ServerSetup&& server_setup,
+    size_t num_client_elements, size_t batch_size) {
+  CHECK_TASK_STOPPED(retcode::FAIL);
+  SCopedTimer timer;
+  size_t batch_num = num_client_elements / batch_size;
+  if (num_client_elements % batch_size) {
+    batch_num++;
+  }
+  VLOG(5) << "server begin to execute psi in batch mode, "
+          << "batch size: " << batch_size << " batch num: " << batch_num;
+  {
+    std::string setup_str;
+    server_setup.SerializeToString(&setup_str);
+    auto ret = this->GetLinkContext()->Send(this->key_,
+                                            this->peer_node_, setup_str);
+    CHECK_RETCODE_WITH_ERROR_MSG(ret, "send server setup to client failed");
+  }
+  // receive next batch request while processing the current one
+  ThreadSafeQueue<std::string> request_queue;
+  std::atomic<bool> abort_recv{false};
+  auto recv_fut = std::async(
+    std::launch::async,
+    [&]() -> retcode {
+      for (size_t i = 0; i < batch_num; i++) {
+        if (abort_recv.load()) {
+          return retcode::FAIL;
+        }
+        std::string request_str;
+        auto ret = this->GetLinkContext()->Recv(this->key_,
+                                                this->ProxyServerNode(),
+                                                &request_str);
+        if (ret != retcode::SUCCESS) {
+          LOG(ERROR) << "recv request of batch: " << i << " failed";
+          request_queue.push(std::string());
+          return retcode::FAIL;
+        }
+        request_queue.push(std::move(request_str));
+      }
+      return retcode::SUCCESS;
+    });
+  auto ret{retcode::SUCCESS};
+  for (size_t i = 0; i < batch_num; i++) {
+    std::string request_str;
+    request_queue.wait_and_pop(request_str);
+    if (request_str.empty()) {
+      ret = retcode::FAIL;
+      break;
+    }
+    psi_proto::Request batch_request;
+    if (!batch_request.ParseFromString(request_str)) {
+      LOG(ERROR) << "parse request of batch: " << i << " failed";
+      ret = retcode::FAIL;
+      break;
+    }
+    psi_proto::Response batch_response;
+    ret = crypto_engine->ProcessRequest(std::move(batch_request),
+                                        &batch_response);
+    if (ret != retcode::SUCCESS) {
+      LOG(ERROR) << "process request of batch: " << i << " failed";
+      break;
+    }
+    std::string response_str;
+    batch_response.SerializeToString(&response_str);
+    ret = this->GetLinkContext()->Send(this->key_,
+                                       this->peer_node_, response_str);
+    if (ret != retcode::SUCCESS) {
+      LOG(ERROR) << "send response of batch: " << i << " to ["
+                 << this->peer_node_.to_string() << "] failed";
+      break;
+    }
+    VLOG(7) << "send response of batch: " << i << " success";
+  }
+  if (ret != retcode::SUCCESS) {
+    // recv thread may be waiting for a request client never sends
+    abort_recv.store(true);
+    this->GetLinkContext()->CancelRecv(this->key_, this->ProxyServerNode());
+  }
+  auto recv_ret = recv_fut.get();
+  if (ret != retcode::SUCCESS || recv_ret != retcode::SUCCESS) {
+    LOG(ERROR) << "execute psi in batch mode failed";
+    return retcode::FAIL;
+  }
+  auto psi_time_cost = timer.timeElapse();
+  VLOG(5) << "server process batch request time cost(ms): " << psi_time_cost
+          << " throughput(points/s): "
+          << PointsPerSecond(num_client_elements, psi_time_cost);
+  return retcode::SUCCESS;
+}
+
 retcode EcdhPsiOperator::InitRequest(psi_proto::Request* psi_request) {
   CHECK_TASK_STOPPED(retcode::FAIL);
   std::string request_str;
@@ -324,7 +814,8 @@ retcode EcdhPsiOperator::PreparePSIResponse(psi_proto::Response&& psi_response,
 }
 
 retcode EcdhPsiOperator::RecvInitParam(size_t* client_dataset_size,
-                                       bool* reveal_intersection) {
+                                       bool* reveal_intersection,
+                                       size_t* batch_size) {
   CHECK_TASK_STOPPED(retcode::FAIL);
   VLOG(5) << "begin to recvInitParam ";
   std::string init_param_str;
@@ -350,6 +841,13 @@ retcode EcdhPsiOperator::RecvInitParam(size_t* client_dataset_size,
   }
   reveal_flag = it->second.value_int32() > 0;
   VLOG(5) << "reveal_intersection_: " << reveal_flag;
+  // optional, client with older version send whole dataset in one request
+  *batch_size = 0;
+  it = parm_map.find("batch_size");
+  if (it != parm_map.end()) {
+    *batch_size = it->second.value_int64();
+  }
+  VLOG(5) << "batch_size: " << *batch_size;
   VLOG(5) << "end of recvInitParam ";
   return retcode::SUCCESS;
 }
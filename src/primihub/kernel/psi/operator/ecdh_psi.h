@@ -21,18 +21,78 @@
 #include <string>
 #include <set>
 #include <vector>
+#include <utility>
 
+#include "absl/types/span.h"
 #include "src/primihub/kernel/psi/operator/base_psi.h"
 #include "private_set_intersection/cpp/psi_client.h"
+#include "private_set_intersection/cpp/psi_server.h"
 #include "src/primihub/protos/common.pb.h"
 #include "src/primihub/protos/psi.pb.h"
 #include "src/primihub/protos/worker.pb.h"
+#include "src/primihub/util/thread_pool.h"
 
 namespace primihub::psi {
 namespace openminded_psi = private_set_intersection;
+/**
+ * run EC point multiplication of ecdh psi on a worker pool,
+ * input is split into continuous ranges, each range is processed by
+ * a cipher instance which owns the same private key,
+ * the output keeps the order of input, so index mapping is not changed
+*/
+class EcdhCryptoEngine {
+ public:
+  static std::unique_ptr<EcdhCryptoEngine> CreateForClient(
+      const std::string& key_bytes, bool reveal_intersection,
+      ThreadPool* pool);
+  static std::unique_ptr<EcdhCryptoEngine> CreateForServer(
+      const std::string& key_bytes, bool reveal_intersection,
+      ThreadPool* pool);
+  /**
+   * client: encrypt input by client key
+  */
+  retcode CreateRequest(absl::Span<const std::string> input,
+                        psi_proto::Request* request);
+  /**
+   * client: decrypt server response and compute intersection index
+  */
+  retcode GetIntersection(const psi_proto::ServerSetup& server_setup,
+                          psi_proto::Response&& response,
+                          std::vector<int64_t>* intersection);
+  /**
+   * server: encrypt client request by server key
+  */
+  retcode ProcessRequest(psi_proto::Request&& request,
+                         psi_proto::Response* response);
+
+ protected:
+  EcdhCryptoEngine(bool reveal_intersection, ThreadPool* pool)
+      : reveal_intersection_(reveal_intersection), pool_(pool) {}
+  /**
+   * split [0, total) into continuous ranges, one range for one worker
+  */
+  void SplitRange(size_t total,
+                  std::vector<std::pair<size_t, size_t>>* ranges);
+
+ private:
+  bool reveal_intersection_{true};
+  ThreadPool* pool_{nullptr};
+  std::vector<std::unique_ptr<openminded_psi::PsiClient>> clients_;
+  std::vector<std::unique_ptr<openminded_psi::PsiServer>> servers_;
+  // minimum number of elements processed by a worker
+  static constexpr size_t kMinRangeSize = 1024;
+};
+
 class EcdhPsiOperator : public BasePsiOperator {
  public:
-  explicit EcdhPsiOperator(const Options& options) : BasePsiOperator(options) {}
+  explicit EcdhPsiOperator(const Options& options) : BasePsiOperator(options) {
+    if (options.batch_size > 0) {
+      batch_size_ = options.batch_size;
+    }
+    size_t thread_num = options.thread_num > 0 ?
+        options.thread_num : ThreadPool::DefaultThreadNum();
+    pool_ = std::make_unique<ThreadPool>(thread_num);
+  }
   retcode OnExecute(const std::vector<std::string>& input,
                     std::vector<std::string>* result) override;
 
@@ -49,20 +109,47 @@ class EcdhPsiOperator : public BasePsiOperator {
   retcode ParsePsiResponseFromeString(const std::string& res_str,
                                       rpc::PsiResponse* response);
   retcode GetIntersection(const std::vector<std::string> origin_data,
-    const std::unique_ptr<openminded_psi::PsiClient>& client,
+    EcdhCryptoEngine* crypto_engine,
     rpc::PsiResponse& response,
     std::vector<std::string>* result);
+  /**
+   * streaming mode for client,
+   * client dataset is encrypted and sent in batches of batch_size_,
+   * the intersection index of each batch is computed as soon as
+   * the response of the batch is received from server
+  */
+  retcode ExecuteAsClientInBatch(const std::vector<std::string>& input,
+                                 std::vector<std::string>* result);
+  retcode RecvServerSetup(psi_proto::ServerSetup* server_setup);
   // server method
   retcode ExecuteAsServer(const std::vector<std::string>& input);
+  /**
+   * streaming mode for server,
+   * server setup is sent once, then each batch request from client is
+   * processed and responded independently
+  */
+  retcode ExecuteAsServerInBatch(
+      EcdhCryptoEngine* crypto_engine,
+      psi_proto::ServerSetup&& server_setup,
+      size_t num_client_elements, size_t batch_size);
   retcode InitRequest(psi_proto::Request* psi_request);
   retcode PreparePSIResponse(psi_proto::Response&& psi_response,
                              psi_proto::ServerSetup&& setup);
-  retcode RecvInitParam(size_t* client_dataset_size, bool* reveal_intersection);
+  retcode RecvInitParam(size_t* client_dataset_size, bool* reveal_intersection,
+                        size_t* batch_size);
   void SetFpr(double fpr) {fpr_ = fpr;}
+  bool UseBatchMode(size_t element_size) {
+    return batch_size_ > 0 && element_size > batch_size_;
+  }
 
  private:
   bool reveal_intersection_{true};
   double fpr_{0.0001};
+  size_t batch_size_{0};
+  // max number of batches sent by client but not yet responded by server
+  size_t max_inflight_batch_{4};
+  // worker pool for EC point multiplication
+  std::unique_ptr<ThreadPool> pool_{nullptr};
 };
 }  // namespace primihub::psi
 
@@ -5,6 +5,7 @@
 #include "src/primihub/kernel/psi/operator/common.h"
 #include "src/primihub/kernel/psi/operator/base_psi.h"
 #include "src/primihub/kernel/psi/operator/kkrt_psi.h"
+#include "src/primihub/kernel/psi/operator/cm20_psi.h"
 #include "src/primihub/kernel/psi/operator/ecdh_psi.h"
 #ifdef SGX
 #include "src/primihub/kernel/psi/operator/tee_psi.h"
@@ -27,6 +28,12 @@ class Factory {
     case PsiType::TEE:
       operator_ptr = CreateTeeOperator(options, executor);
       break;
+    case PsiType::MT_KKRT:
+      operator_ptr = std::make_unique<MtKkrtPsiOperator>(options);
+      break;
+    case PsiType::CM20:
+      operator_ptr = std::make_unique<Cm20PsiOperator>(options);
+      break;
     default:
       LOG(ERROR) << "unknown psi operator: " << static_cast<int>(psi_type);
       break;
@@ -16,9 +16,11 @@
 #include "libOTe/NChooseOne/Kkrt/KkrtNcoOtSender.h"
 #include "libOTe/NChooseOne/NcoOtExt.h"
 
+#include "src/primihub/kernel/psi/operator/block_hasher.h"
 #include "src/primihub/util/endian_util.h"
 #include "src/primihub/common/value_check_util.h"
 #include "src/primihub/util/util.h"
+#include "src/primihub/util/thread_pool.h"
 
 namespace primihub::psi {
 retcode KkrtPsiOperator::OnExecute(const std::vector<std::string>& input,
@@ -28,24 +30,97 @@ retcode KkrtPsiOperator::OnExecute(const std::vector<std::string>& input,
     return retcode::FAIL;
   }
   oc::IOService ios;
-  auto msg_interface = BuildChannelInterface();
-  if (msg_interface == nullptr) {
-    LOG(ERROR) << "BuildChannelInterface failed";
+  std::vector<oc::Channel> chls;
+  auto ret = BuildChannels(&ios, &chls);
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "BuildChannels failed";
     return retcode::FAIL;
   }
-  oc::Channel chl(ios, msg_interface.release());
-  auto ret{retcode::SUCCESS};
+  // plain KKRT with the default hash keeps the message sequence of
+  // nodes without the exchange
+  if (MultiChannel() || options_.block_hash_type != BlockHashType::SHA1) {
+    ret = CheckHashType(chls[0]);
+    if (ret != retcode::SUCCESS) {
+      return retcode::FAIL;
+    }
+  }
   if (RoleValidation::IsClient(PartyName())) {
     std::vector<uint64_t> result_index;
-    ret = KkrtRecv(chl, input, &result_index);
+    ret = PsiRecv(chls, input, &result_index);
     this->GetResult(input, result_index, result);
   } else {
-    ret = KkrtSend(chl, input);
+    ret = PsiSend(chls, input);
   }
   return ret;
 }
 
-auto KkrtPsiOperator::BuildChannelInterface() ->
+retcode KkrtPsiOperator::BuildChannels(oc::IOService* ios,
+                                       std::vector<oc::Channel>* chls) {
+  auto msg_interface = BuildChannelInterface();
+  if (msg_interface == nullptr) {
+    LOG(ERROR) << "BuildChannelInterface failed";
+    return retcode::FAIL;
+  }
+  chls->clear();
+  chls->emplace_back(*ios, msg_interface.release());
+  if (!MultiChannel()) {
+    return retcode::SUCCESS;
+  }
+  size_t channel_num = ChannelNum();
+  auto ret = NegotiateChannelNum((*chls)[0], &channel_num);
+  CHECK_RETCODE(ret);
+  for (size_t i = 1; i < channel_num; i++) {
+    auto channel_interface = BuildChannelInterface("ch" + std::to_string(i));
+    if (channel_interface == nullptr) {
+      LOG(ERROR) << "BuildChannelInterface for channel: " << i << " failed";
+      return retcode::FAIL;
+    }
+    chls->emplace_back(*ios, channel_interface.release());
+  }
+  VLOG(5) << "open " << chls->size() << " channels for party: " << PartyName();
+  return retcode::SUCCESS;
+}
+
+retcode KkrtPsiOperator::NegotiateChannelNum(oc::Channel& chl,
+                                             size_t* channel_num) {
+  // both parties must open the same number of channels
+  u64 peer_channel_num = 0;
+  auto ret = ExchangeValue(chl, *channel_num, &peer_channel_num);
+  CHECK_RETCODE(ret);
+  *channel_num =
+      std::max<u64>(std::min<u64>(*channel_num, peer_channel_num), 1);
+  return retcode::SUCCESS;
+}
+
+retcode KkrtPsiOperator::ExchangeValue(oc::Channel& chl,
+                                       u64 self_value, u64* peer_value) {
+  std::vector<u64> data{self_value};
+  chl.asyncSend(std::move(data));
+  std::vector<u64> dest;
+  chl.recv(dest);
+  if (dest.empty()) {
+    LOG(ERROR) << "receive value from peer failed";
+    return retcode::FAIL;
+  }
+  *peer_value = dest[0];
+  return retcode::SUCCESS;
+}
+
+retcode KkrtPsiOperator::CheckHashType(oc::Channel& chl) {
+  u64 self_hash_type = static_cast<u64>(options_.block_hash_type);
+  u64 peer_hash_type = 0;
+  auto ret = ExchangeValue(chl, self_hash_type, &peer_hash_type);
+  CHECK_RETCODE(ret);
+  if (peer_hash_type != self_hash_type) {
+    LOG(ERROR) << "kkrt hash type mismatch, self: " << self_hash_type << " "
+               << "peer: " << peer_hash_type << ", "
+               << "both parties must set the same kkrtHashType";
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+auto KkrtPsiOperator::BuildChannelInterface(const std::string& channel_id) ->
     std::unique_ptr<TaskMessagePassInterface> {
 //
   std::string peer_party_name;
@@ -73,59 +148,42 @@ auto KkrtPsiOperator::BuildChannelInterface() ->
   // The 'osuCrypto::Channel' will consider it to be a unique_ptr and will
   // reset the unique_ptr, so the 'osuCrypto::Channel' will delete it.
   auto msg_interface = std::make_unique<TaskMessagePassInterface>(
-      this->PartyName(), peer_party_name, link_ctx, send_channel, recv_channel);
+      this->PartyName(), peer_party_name, link_ctx, send_channel, recv_channel,
+      channel_id);
   return msg_interface;
 }
 
-retcode KkrtPsiOperator::KkrtRecv(oc::Channel& chl,
-                                  const std::vector<std::string>& input,
-                                  std::vector<uint64_t>* result_index) {
+retcode KkrtPsiOperator::PsiRecv(std::vector<oc::Channel>& chls,
+                                 const std::vector<std::string>& input,
+                                 std::vector<uint64_t>* result_index) {
   u8 dummy[1];
-  // oc::PRNG prng(_mm_set_epi32(4253465, 3434565, 234435, 23987045));
-  oc::PRNG prng(oc::block(time(nullptr), time(nullptr)));
+  auto& chl = chls[0];
+  oc::PRNG prng(oc::sysRandomSeed());
   u64 sendSize;
-  // u64 recvSize = 10;
   u64 recvSize = input.size();
-
-  std::vector<u64> data{recvSize};
-  chl.asyncSend(std::move(data));
-  std::vector<u64> dest;
-  chl.recv(dest);
-
-  // LOG(INFO) << "send size:" << dest[0];
-  sendSize = dest[0];
-  std::vector<oc::block> sendSet(sendSize), recvSet(recvSize);
+  auto ret = ExchangeValue(chl, recvSize, &sendSize);
+  CHECK_RETCODE(ret);
+  std::vector<oc::block> recvSet(recvSize);
   SCopedTimer timer;
   HashDataParallel(input, &recvSet);
   auto time_cost = timer.timeElapse();
   VLOG(5) << "encrypt data cost time(ms): " << time_cost;
   oc::KkrtNcoOtReceiver otRecv;
   oc::KkrtPsiReceiver recvPSIs;
-  // LOG(INFO) << "client step 1";
-
-  // recvPSIs.setTimer(gTimer);
   chl.recv(dummy, 1);
-  // LOG(INFO) << "client step 2";
-  // gTimer.reset();
   chl.asyncSend(dummy, 1);
-  // LOG(INFO) << "client step 3";
-  // Timer timer;
-  // auto start = timer.setTimePoint("start");
   auto start_init_receiver = timer.timeElapse();
-  recvPSIs.init(sendSize, recvSize, 40, chl,
+  recvPSIs.init(sendSize, recvSize, 40, chls,
                 otRecv, prng.get<oc::block>());
   auto end_init_receiver = timer.timeElapse();
   auto init_receiver_cost = end_init_receiver - start_init_receiver;
   VLOG(5) << "init psi receiver cost(ms): " << init_receiver_cost;
-  // LOG(INFO) << "client step 4";
-  // auto mid = timer.setTimePoint("init");
   auto start_psi_protocol = timer.timeElapse();
-  recvPSIs.sendInput(recvSet, chl);
+  recvPSIs.sendInput(recvSet, chls);
   auto end_psi_protocol = timer.timeElapse();
   auto psi_protocol_time_cost = end_psi_protocol - start_psi_protocol;
-  VLOG(5) << "execute psi protocol cost(ms): " << psi_protocol_time_cost;
-  // LOG(INFO) << "client step 5";
-  // auto end = timer.setTimePoint("done");
+  VLOG(5) << "execute psi protocol cost(ms): " << psi_protocol_time_cost
+          << " channel num: " << chls.size();
 
   // GetIntsection index
   auto pos_start = timer.timeElapse();
@@ -138,21 +196,15 @@ retcode KkrtPsiOperator::KkrtRecv(oc::Channel& chl,
   return retcode::SUCCESS;
 }
 
-retcode KkrtPsiOperator::KkrtSend(oc::Channel& chl,
-                                  const std::vector<std::string>& input) {
+retcode KkrtPsiOperator::PsiSend(std::vector<oc::Channel>& chls,
+                                 const std::vector<std::string>& input) {
   u8 dummy[1];
-  // osuCrypto::PRNG prng(_mm_set_epi32(4253465, 3434565, 234435, 23987045));
-  oc::PRNG prng(oc::block(time(nullptr), time(nullptr)));
+  auto& chl = chls[0];
+  oc::PRNG prng(oc::sysRandomSeed());
   u64 sendSize = input.size();
   u64 recvSize;
-
-  std::vector<u64> data{sendSize};
-  chl.asyncSend(std::move(data));
-  std::vector<u64> dest;
-  chl.recv(dest);
-
-  // LOG(INFO) << "recv size:" << dest[0];
-  recvSize = dest[0];
+  auto ret = ExchangeValue(chl, sendSize, &recvSize);
+  CHECK_RETCODE(ret);
   SCopedTimer timer;
   std::vector<oc::block> set(sendSize);
   HashDataParallel(input, &set);
@@ -161,81 +213,39 @@ retcode KkrtPsiOperator::KkrtSend(oc::Channel& chl,
 
   oc::KkrtNcoOtSender otSend;
   oc::KkrtPsiSender sendPSIs;
-  // LOG(INFO) << "server step 1";
-
   sendPSIs.setTimer(oc::gTimer);
   chl.asyncSend(dummy, 1);
-  // LOG(INFO) << "server step 2";
   chl.recv(dummy, 1);
-  // LOG(INFO) << "server step 3";
   auto start_init_sender = timer.timeElapse();
-  sendPSIs.init(sendSize, recvSize, 40, chl,
+  sendPSIs.init(sendSize, recvSize, 40, chls,
                 otSend, prng.get<oc::block>());
   auto end_init_sender = timer.timeElapse();
   auto init_sender_cost = end_init_sender - start_init_sender;
   VLOG(5) << "init psi sender cost(ms): " << init_sender_cost;
-  // LOG(INFO) << "server step 4";
   auto start_psi_protocol = timer.timeElapse();
-  sendPSIs.sendInput(set, chl);
-  // LOG(INFO) << "server step 5";
+  sendPSIs.sendInput(set, chls);
   auto end_psi_protocol = timer.timeElapse();
   auto psi_protocol_time_cost = end_psi_protocol - start_psi_protocol;
-  VLOG(5) << "execute psi protocol cost(ms): " << psi_protocol_time_cost;
-  u64 dataSent = chl.getTotalDataSent();
-  // LOG(INFO) << "server step 6";
-
-  chl.resetStats();
-  // LOG(INFO) << "server step 7";
+  VLOG(5) << "execute psi protocol cost(ms): " << psi_protocol_time_cost
+          << " channel num: " << chls.size();
+  for (auto& channel : chls) {
+    channel.resetStats();
+  }
   return retcode::SUCCESS;
 }
 
 retcode KkrtPsiOperator::HashDataParallel(const std::vector<std::string>& input,
                                           std::vector<oc::block>* result_ptr) {
-  if (result_ptr->size() != input.size()) {
-    result_ptr->resize(input.size());
-  }
-  auto& result = *result_ptr;
-  uint64_t data_size = input.size();
-  uint64_t MAX_BLOCK_NUM = 10000000;  // 1000W
-  uint64_t block_num = data_size / MAX_BLOCK_NUM;
-  if (data_size % MAX_BLOCK_NUM) {
-    block_num++;
-  }
-  if (block_num == 1) {
-    u8 block_size = sizeof(oc::block);
-    oc::RandomOracle sha1(block_size);
-    u8 hash_dest[block_size];                                       // NOLINT
-    for (u64 i = 0; i < data_size; ++i) {
-      sha1.Update((u8 *)input[i].data(), input[i].size());          // NOLINT
-      sha1.Final((u8 *)hash_dest);                                  // NOLINT
-      result[i] = oc::toBlock(hash_dest);
-      sha1.Reset();
-    }
-  } else {
-    std::vector<std::future<void>> futs;
-    for (uint64_t i = 0; i < block_num; i++) {
-      uint64_t start_i = i * MAX_BLOCK_NUM;
-      uint64_t end_i = std::min((i+1) * MAX_BLOCK_NUM, data_size);
-      futs.push_back(
-        std::async(
-          std::launch::async,
-          [&, start_i, end_i]() {
-            u8 block_size = sizeof(oc::block);
-            oc::RandomOracle sha1(block_size);
-            u8 hash_dest[block_size];                               // NOLINT
-            for (u64 index = start_i; index < end_i; ++index) {
-              sha1.Update((u8 *)input[index].data(),                // NOLINT
-                          input[index].size());
-              sha1.Final((u8 *)hash_dest);                          // NOLINT
-              result[index] = oc::toBlock(hash_dest);
-              sha1.Reset();
-            }
-          }));
-    }
-    for (auto&& fut : futs) {
-      fut.get();
-    }
+  size_t thread_num = options_.thread_num > 0 ? options_.thread_num : 0;
+  BlockHasher hasher(options_.block_hash_type, thread_num);
+  return hasher.Hash(input, result_ptr);
+}
+
+size_t KkrtPsiOperator::ParallelChannelNum() {
+  if (options_.channel_num > 0) {
+    return options_.channel_num;
   }
-  return retcode::SUCCESS;
+  return options_.thread_num > 0 ?
+      options_.thread_num : ThreadPool::DefaultThreadNum();
 }
 }  // namespace primihub::psi
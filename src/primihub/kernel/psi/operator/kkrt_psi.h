@@ -9,6 +9,7 @@
 
 #include "src/primihub/kernel/psi/operator/base_psi.h"
 #include "cryptoTools/Network/Channel.h"
+#include "cryptoTools/Network/IOService.h"
 #include "cryptoTools/Common/Defines.h"
 #include "libPSI/PSI/Kkrt/KkrtPsiReceiver.h"
 #include "src/primihub/util/network/message_interface.h"
@@ -22,13 +23,62 @@ class KkrtPsiOperator : public BasePsiOperator {
                     std::vector<std::string>* result) override;
 
  protected:
-  auto BuildChannelInterface() -> std::unique_ptr<TaskMessagePassInterface>;
-  retcode KkrtRecv(oc::Channel& chl,
-                   const std::vector<std::string>& input,
-                   std::vector<uint64_t>* result_index);
-  retcode KkrtSend(oc::Channel& chl, const std::vector<std::string>& input);
+  /**
+   * multi-channel protocols always negotiate the channel number, even when
+   * one party wants a single channel, so the peer never waits for it
+  */
+  virtual bool MultiChannel() {return false;}
+  /**
+   * number of logical channels this party wants, KKRT uses a single one
+  */
+  virtual size_t ChannelNum() {return 1;}
+  /**
+   * open the logical channels, for the multi-channel protocols both
+   * parties agree on the smaller number over the first channel
+  */
+  retcode BuildChannels(oc::IOService* ios, std::vector<oc::Channel>* chls);
+  /**
+   * channel_num: input, number this party wants; output, the agreed number
+  */
+  retcode NegotiateChannelNum(oc::Channel& chl, size_t* channel_num);
+  auto BuildChannelInterface(const std::string& channel_id = "") ->
+      std::unique_ptr<TaskMessagePassInterface>;
+  virtual retcode PsiRecv(std::vector<oc::Channel>& chls,
+                          const std::vector<std::string>& input,
+                          std::vector<uint64_t>* result_index);
+  virtual retcode PsiSend(std::vector<oc::Channel>& chls,
+                          const std::vector<std::string>& input);
+  /**
+   * send self_value and receive the value of the peer
+  */
+  retcode ExchangeValue(oc::Channel& chl, u64 self_value, u64* peer_value);
+  /**
+   * input items hashed differently never intersect,
+   * fail early if the peer uses another block hash type.
+   * plain KKRT only exchanges it when kkrtHashType is not the default,
+   * a SHA1 party cannot detect a peer using another hash type
+  */
+  retcode CheckHashType(oc::Channel& chl);
+  /**
+   * channel number of the multi-channel protocols,
+   * psiChannelNum, or psiThreadNum if it is not set
+  */
+  size_t ParallelChannelNum();
   retcode HashDataParallel(const std::vector<std::string>& input,
                            std::vector<oc::block>* result);
 };
+
+/**
+ * KKRT over multiple logical channels, libPSI runs one thread per channel
+*/
+class MtKkrtPsiOperator : public KkrtPsiOperator {
+ public:
+  explicit MtKkrtPsiOperator(const Options& options) :
+      KkrtPsiOperator(options) {}
+
+ protected:
+  bool MultiChannel() override {return true;}
+  size_t ChannelNum() override {return ParallelChannelNum();}
+};
 }  // namespace primihub::psi
 #endif  // SRC_PRIMIHUB_KERNEL_PSI_OPERATOR_KKRT_PSI_H_
@@ -22,11 +22,101 @@
 #include <utility>
 #include <algorithm>
 #include <map>
+#include <charconv>
+#include <string_view>
+#include <unordered_set>
+#include "arrow/compute/api.h"
+#include "cryptoTools/Crypto/RandomOracle.h"
 #include "src/primihub/util/file_util.h"
 #include "src/primihub/util/util.h"
 #include "src/primihub/common/value_check_util.h"
 
 namespace primihub::psi {
+namespace {
+/**
+ * sequential reader of a key column, starting from any row
+*/
+class KeyColumnReader {
+ public:
+  KeyColumnReader(const arrow::ChunkedArray* column, int64_t row)
+      : column_(column) {
+    while (chunk_ < column_->num_chunks() &&
+           row >= column_->chunk(chunk_)->length()) {
+      row -= column_->chunk(chunk_)->length();
+      chunk_++;
+    }
+    offset_ = row;
+  }
+  /**
+   * append the value of current row to buf and move to next row
+  */
+  void AppendTo(std::string* buf) {
+    while (offset_ >= column_->chunk(chunk_)->length()) {
+      offset_ = 0;
+      chunk_++;
+    }
+    const auto& array = column_->chunk(chunk_);
+    if (!array->IsNull(offset_)) {
+      AppendValue(*array, offset_, buf);
+    }
+    offset_++;
+  }
+
+ private:
+  template <typename ArrowType>
+  static void AppendInteger(const arrow::Array& array, int64_t i,
+                            std::string* buf) {
+    using ArrayType = arrow::NumericArray<ArrowType>;
+    auto value = static_cast<const ArrayType&>(array).Value(i);
+    char str[24];
+    auto res = std::to_chars(str, str + sizeof(str), value);
+    buf->append(str, res.ptr - str);
+  }
+
+  static void AppendValue(const arrow::Array& array, int64_t i,
+                          std::string* buf) {
+    switch (array.type_id()) {
+    case arrow::Type::INT8:
+      return AppendInteger<arrow::Int8Type>(array, i, buf);
+    case arrow::Type::UINT8:
+      return AppendInteger<arrow::UInt8Type>(array, i, buf);
+    case arrow::Type::INT16:
+      return AppendInteger<arrow::Int16Type>(array, i, buf);
+    case arrow::Type::UINT16:
+      return AppendInteger<arrow::UInt16Type>(array, i, buf);
+    case arrow::Type::INT32:
+      return AppendInteger<arrow::Int32Type>(array, i, buf);
+    case arrow::Type::UINT32:
+      return AppendInteger<arrow::UInt32Type>(array, i, buf);
+    case arrow::Type::INT64:
+      return AppendInteger<arrow::Int64Type>(array, i, buf);
+    case arrow::Type::UINT64:
+      return AppendInteger<arrow::UInt64Type>(array, i, buf);
+    case arrow::Type::STRING:
+    case arrow::Type::BINARY: {
+      auto view = static_cast<const arrow::BinaryArray&>(array).GetView(i);
+      buf->append(view.data(), view.size());
+      return;
+    }
+    case arrow::Type::FIXED_SIZE_BINARY: {
+      auto view =
+          static_cast<const arrow::FixedSizeBinaryArray&>(array).GetView(i);
+      buf->append(view.data(), view.size());
+      return;
+    }
+    default: {
+      std::stringstream ss;
+      ss << "Unsupported data type for Psi: type: " << array.type()->name();
+      RaiseException(ss.str());
+    }
+    }
+  }
+
+  const arrow::ChunkedArray* column_;
+  int chunk_{0};
+  int64_t offset_{0};
+};
+}  // namespace
 
 bool PsiCommonUtil::isNumeric32Type(const arrow::Type::type& type_id) {
   static std::set<arrow::Type::type>
@@ -327,6 +417,158 @@ retcode PsiCommonUtil::SaveDataToCSVFile(
   return retcode::SUCCESS;
 }
 
+retcode PsiCommonUtil::LoadTableInternal(
+    std::shared_ptr<DataDriver>& driver,
+    const std::vector<int>& col_index,
+    std::shared_ptr<arrow::Table>* table) {
+  auto& schema = driver->dataSetAccessInfo()->Schema();
+  for (const auto index : col_index) {
+    auto type = static_cast<arrow::Type::type>(std::get<1>(schema[index]));
+    if (!IsValidDataType(type)) {
+      auto arrow_schema = driver->dataSetAccessInfo()->ArrowSchema();
+      std::stringstream ss;
+      ss << arrow_schema->field(index)->ToString()
+         << " is not supported for PSI";
+      RaiseException(ss.str());
+    }
+  }
+  auto cursor = driver->GetCursor(col_index);
+  if (cursor == nullptr) {
+    LOG(ERROR) << "get cursor for dataset failed";
+    return retcode::FAIL;
+  }
+  auto ds = cursor->read();
+  if (ds == nullptr) {
+    LOG(ERROR) << "get data failed";
+    return retcode::FAIL;
+  }
+  *table = std::get<std::shared_ptr<arrow::Table>>(ds->data);
+  if (!validationDataColum(col_index, (*table)->num_columns())) {
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+retcode PsiCommonUtil::HashKeyColumns(
+    const std::shared_ptr<arrow::Table>& table,
+    std::vector<std::string>* digests) {
+  SCopedTimer timer;
+  int num_cols = table->num_columns();
+  int64_t num_rows = table->num_rows();
+  if (num_cols == 0) {
+    LOG(ERROR) << "no column selected";
+    return retcode::FAIL;
+  }
+  for (int i = 0; i < num_cols; i++) {
+    auto type_id = table->column(i)->type()->id();
+    if (!IsValidDataType(type_id)) {
+      std::stringstream ss;
+      ss << "Unsupported data type for Psi: type: "
+         << table->column(i)->type()->name();
+      RaiseException(ss.str());
+    }
+  }
+  digests->resize(num_rows);
+  size_t cpu_core_num = std::thread::hardware_concurrency();
+  int64_t thread_num = std::max<int64_t>(cpu_core_num, 1);
+  if (num_rows < 100000) {
+    thread_num = 1;
+  }
+  int64_t rows_per_thread = (num_rows + thread_num - 1) / thread_num;
+  std::vector<std::future<void>> futs;
+  for (int64_t begin = 0; begin < num_rows; begin += rows_per_thread) {
+    int64_t end = std::min(num_rows, begin + rows_per_thread);
+    futs.push_back(std::async(
+        std::launch::async,
+        [&, begin, end]() {
+          std::vector<KeyColumnReader> readers;
+          readers.reserve(num_cols);
+          for (int i = 0; i < num_cols; i++) {
+            readers.emplace_back(table->column(i).get(), begin);
+          }
+          std::string buf;
+          oc::u8 digest[kKeyDigestSize];
+          oc::RandomOracle hasher(kKeyDigestSize);
+          auto& digests_ref = *digests;
+          for (int64_t row = begin; row < end; row++) {
+            buf.clear();
+            readers[0].AppendTo(&buf);
+            for (int i = 1; i < num_cols; i++) {
+              buf.append(DATA_RECORD_SEP);
+              readers[i].AppendTo(&buf);
+            }
+            hasher.Update(reinterpret_cast<const oc::u8*>(buf.data()),
+                          buf.size());
+            hasher.Final(digest);
+            hasher.Reset();
+            digests_ref[row].assign(reinterpret_cast<char*>(digest),
+                                    kKeyDigestSize);
+          }
+        }));
+  }
+  for (auto&& fut : futs) {
+    fut.get();
+  }
+  VLOG(5) << "HashKeyColumns time cost: " << timer.timeElapse();
+  VLOG(0) << "data records loaded number: " << digests->size();
+  return retcode::SUCCESS;
+}
+
+retcode PsiCommonUtil::MatchResultRows(
+    const std::vector<std::string>& digests,
+    const std::vector<std::string>& result,
+    bool unique,
+    std::vector<int64_t>* row_index) {
+  std::unordered_set<std::string_view> result_set(result.size());
+  for (const auto& item : result) {
+    result_set.insert(item);
+  }
+  row_index->clear();
+  row_index->reserve(result.size());
+  for (size_t i = 0; i < digests.size() && !result_set.empty(); i++) {
+    auto it = result_set.find(digests[i]);
+    if (it == result_set.end()) {
+      continue;
+    }
+    row_index->push_back(i);
+    if (unique) {
+      result_set.erase(it);
+    }
+  }
+  return retcode::SUCCESS;
+}
+
+retcode PsiCommonUtil::SaveTableRowsToCSVFile(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<int64_t>& row_index,
+    const std::string& file_path) {
+  arrow::Int64Builder builder;
+  builder.AppendValues(row_index);
+  std::shared_ptr<arrow::Array> indices;
+  builder.Finish(&indices);
+  auto result = arrow::compute::Take(table, indices);
+  if (!result.ok()) {
+    LOG(ERROR) << "take result rows failed, " << result.status();
+    return retcode::FAIL;
+  }
+  auto result_table = result.ValueOrDie().table();
+  auto driver = DataDirverFactory::getDriver("CSV", "test address");
+  auto csv_driver = std::dynamic_pointer_cast<CSVDriver>(driver);
+  if (ValidateDir(file_path)) {
+    std::stringstream ss;
+    ss << "Can't access file path: " << file_path;
+    RaiseException(ss.str());
+  }
+  int ret = csv_driver->write(result_table, file_path);
+  if (ret != 0) {
+    std::stringstream ss;
+    ss << "Save PSI result to file " << file_path << " failed.";
+    RaiseException(ss.str());
+  }
+  LOG(INFO) << "Save PSI result to " << file_path << ".";
+  return retcode::SUCCESS;
+}
+
 retcode PsiCommonUtil::saveDataToCSVFile(
     const std::vector<std::string>& data,
     const std::string& file_path, const std::string& col_title) {
@@ -27,6 +27,11 @@
 namespace primihub::psi {
 class PsiCommonUtil {
  public:
+  /**
+   * size of the digest of a key row, a digest fits in the local buffer of
+   * std::string, so no heap memory is allocated for it
+  */
+  static constexpr size_t kKeyDigestSize = 15;
   bool IsValidDataType(const arrow::Type::type& type_id);
   bool isNumeric(const arrow::Type::type& type_id);
   bool isNumeric64Type(const arrow::Type::type& type_id);
@@ -58,6 +63,32 @@ class PsiCommonUtil {
   retcode SaveDataToCSVFile(const std::vector<std::string>& data,
                             const std::string& file_path,
                             const std::vector<std::string>& col_title);
+  /**
+   * load the selected columns with the types of the dataset schema
+  */
+  retcode LoadTableInternal(std::shared_ptr<DataDriver>& driver,
+                            const std::vector<int>& col_index,
+                            std::shared_ptr<arrow::Table>* table);
+  /**
+   * hash the key columns of each row into a kKeyDigestSize bytes digest.
+   * columns are read from the arrow arrays directly, numbers are hashed
+   * in decimal and columns are separated by DATA_RECORD_SEP, so a key
+   * has the same digest as the key loaded by LoadDatasetInternal.
+   * digests[i] is the digest of row i
+  */
+  retcode HashKeyColumns(const std::shared_ptr<arrow::Table>& table,
+                         std::vector<std::string>* digests);
+  /**
+   * index of rows whose digest is in result, in the order of rows.
+   * each digest in result matches one row only if unique is set
+  */
+  retcode MatchResultRows(const std::vector<std::string>& digests,
+                          const std::vector<std::string>& result,
+                          bool unique,
+                          std::vector<int64_t>* row_index);
+  retcode SaveTableRowsToCSVFile(const std::shared_ptr<arrow::Table>& table,
+                                 const std::vector<int64_t>& row_index,
+                                 const std::string& file_path);
 
  protected:
   /**
@@ -23,6 +23,12 @@
 #include <thread>
 #include <future>
 #include <fstream>
+#include <cctype>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <string_view>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include "src/primihub/service/dataset/model.h"
 #include "src/primihub/util/util.h"
@@ -31,11 +37,67 @@
 #include "src/primihub/util/proto_log_helper.h"
 #include "src/primihub/common/config/server_config.h"
 #include "src/primihub/util/file_util.h"
+#include "src/primihub/util/compress_util.h"
 
 using DatasetMeta = primihub::service::DatasetMeta;
 using DataBlock = primihub::DataServiceImpl::DataBlock;
 namespace pb_util = primihub::proto::util;
 namespace primihub {
+namespace {
+/**
+ * mark a file as being uploaded until the guard is destroyed
+*/
+class UploadGuard {
+ public:
+  UploadGuard(std::mutex* mtx, std::set<std::string>* uploading_files)
+      : mtx_(mtx), uploading_files_(uploading_files) {}
+  ~UploadGuard() {
+    if (!file_path_.empty()) {
+      std::lock_guard<std::mutex> lck(*mtx_);
+      uploading_files_->erase(file_path_);
+    }
+  }
+  bool Acquire(const std::string& file_path) {
+    std::lock_guard<std::mutex> lck(*mtx_);
+    if (!uploading_files_->insert(file_path).second) {
+      return false;
+    }
+    file_path_ = file_path;
+    return true;
+  }
+
+ private:
+  std::mutex* mtx_;
+  std::set<std::string>* uploading_files_;
+  std::string file_path_;
+};
+}  // namespace
+
+bool IsValidUploadName(const std::string& file_name) {
+  if (file_name.empty() || file_name[0] == '/') {
+    return false;
+  }
+  for (char c : file_name) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) &&
+        c != '_' && c != '-' && c != '.' && c != '/') {
+      return false;
+    }
+  }
+  std::string_view name = file_name;
+  size_t pos = 0;
+  while (pos <= name.size()) {
+    size_t next = name.find('/', pos);
+    if (next == std::string_view::npos) {
+      next = name.size();
+    }
+    if (name.substr(pos, next - pos) == "..") {
+      return false;
+    }
+    pos = next + 1;
+  }
+  return true;
+}
+
 grpc::Status DataServiceImpl::NewDataset(grpc::ServerContext *context,
                                           const rpc::NewDatasetRequest *request,
                                           rpc::NewDatasetResponse *response) {
@@ -98,127 +160,309 @@ grpc::Status DataServiceImpl::DownloadData(grpc::ServerContext* context,
     writer->Write(resp);
     return grpc::Status::OK;
   }
-  // using pipeline mode to read and send data, make sure data sequence: fifo
-  ThreadSafeQueue<DataBlock> resp_queue;
+  // pipeline mode: readers fill a bounded queue and this thread writes it to
+  // the stream, readers block once the client stops draining the stream.
+  // with one reader, blocks keep the order of file_list
+  size_t parallel_num = std::max<size_t>(request->parallel_num(), 1);
+  parallel_num = std::min<size_t>(parallel_num, file_list.size());
+  BoundedThreadSafeQueue<DataBlock> resp_queue(kDownloadQueueSize);
+  std::atomic<size_t> next_file{0};
   std::atomic<bool> error{false};
+  std::mutex error_mtx;
   std::string error_msg;
-  auto read_fut = std::async(
-    std::launch::async,
-    [&]() -> retcode {
-      try {
-        auto ret = DownloadDataImpl(*request, &resp_queue);
-        if (ret != retcode::SUCCESS) {
-          LOG(ERROR) << "DownloadDataImpl encountes error";
-          error.store(true);
-          resp_queue.shutdown();
-          return retcode::FAIL;
-        } else {
-          return retcode::SUCCESS;
+  std::vector<std::future<void>> read_futs;
+  for (size_t i = 0; i < parallel_num; i++) {
+    read_futs.push_back(std::async(
+      std::launch::async,
+      [&]() {
+        while (!error.load(std::memory_order_relaxed)) {
+          size_t index = next_file.fetch_add(1);
+          if (index >= static_cast<size_t>(file_list.size())) {
+            break;
+          }
+          std::string err_msg;
+          auto ret = DownloadDataImpl(*request, file_list[index],
+                                      &resp_queue, &err_msg);
+          if (ret != retcode::SUCCESS) {
+            if (!err_msg.empty()) {
+              std::lock_guard<std::mutex> lck(error_mtx);
+              if (error_msg.empty()) {
+                error_msg = std::move(err_msg);
+              }
+            }
+            error.store(true);
+            resp_queue.shutdown();
+            return;
+          }
         }
-      } catch (std::exception& e) {
-        error_msg = e.what();
-        error.store(true);
-        resp_queue.shutdown();
-      }
-    });
-  // read data from
-  do {
+        // flag for end read
+        DataBlock data_block;
+        data_block.is_last_block = true;
+        resp_queue.push(std::move(data_block));
+      }));
+  }
+  size_t finished_reader{0};
+  bool stream_closed{false};
+  rpc::DownloadRespone resp;
+  while (finished_reader < parallel_num) {
     DataBlock data_block;
-    resp_queue.wait_and_pop(data_block);
-    if (data_block.is_last_block) {  // read end flag
+    if (!resp_queue.wait_and_pop(data_block)) {
       break;
     }
-    rpc::DownloadRespone resp;
-    if (error.load(std::memory_order::memory_order_relaxed)) {
-      resp.set_info(error_msg);
-      resp.set_code(rpc::Status::FAIL);
-      LOG(ERROR) << pb_util::TaskInfoToString(request_id) << error_msg;
-    } else {
-      resp.set_info("SUCCESS");
-      resp.set_code(rpc::Status::SUCCESS);
-      resp.set_file_name(data_block.file_name);
-      resp.set_data(data_block.data);
+    if (data_block.is_last_block) {
+      finished_reader++;
+      continue;
     }
-    writer->Write(resp);
-    if (error.load(std::memory_order::memory_order_relaxed)) {
+    resp.set_info("SUCCESS");
+    resp.set_code(rpc::Status::SUCCESS);
+    resp.set_file_name(data_block.file_name);
+    resp.set_data(std::move(data_block.data));
+    resp.set_offset(data_block.offset);
+    resp.set_raw_size(data_block.raw_size);
+    resp.set_is_end(data_block.is_end);
+    resp.set_file_size(data_block.file_size);
+    resp.set_mtime(data_block.mtime);
+    resp.set_compress_type(request->compress_type());
+    if (!writer->Write(resp)) {
+      LOG(WARNING) << pb_util::TaskInfoToString(request_id)
+                   << "stream is closed by client, stop download";
+      stream_closed = true;
+      resp_queue.shutdown();
       break;
     }
-  } while (true);
-  read_fut.get();
+  }
+  for (auto& fut : read_futs) {
+    fut.get();
+  }
+  if (error.load() && !stream_closed) {
+    if (error_msg.empty()) {
+      error_msg = "download data is interrupted";
+    }
+    LOG(ERROR) << pb_util::TaskInfoToString(request_id) << error_msg;
+    rpc::DownloadRespone err_resp;
+    err_resp.set_info(error_msg);
+    err_resp.set_code(rpc::Status::FAIL);
+    writer->Write(err_resp);
+  }
   return grpc::Status::OK;
 }
 
 grpc::Status DataServiceImpl::UploadData(grpc::ServerContext* context,
     grpc::ServerReader<rpc::UploadFileRequest>* reader,
     rpc::UploadFileResponse* response) {
-  response->set_code(rpc::Status::FAIL);
-  response->set_info("Unimplement");
+  auto ret = UploadDataImpl(reader, response);
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "upload data failed: " << response->info();
+    response->set_code(rpc::Status::FAIL);
+  } else {
+    response->set_code(rpc::Status::SUCCESS);
+    response->set_info("SUCCESS");
+  }
   return grpc::Status::OK;
 }
 
 retcode DataServiceImpl::DownloadDataImpl(const rpc::DownloadRequest& request,
-    ThreadSafeQueue<DataBlock>* data_queue) {
+    const std::string& file_name,
+    BoundedThreadSafeQueue<DataBlock>* data_queue,
+    std::string* err_msg) {
   const auto& request_id = request.request_id();
-  const auto& file_list = request.file_list();
-  for (const auto& file_info : file_list) {
-    std::string file_name = file_info;
-    std::string file_path = CompletePath(file_info);
-    LOG(INFO) << pb_util::TaskInfoToString(request_id)
-              << "begin to read data for " << file_name;
-    if (!FileExists(file_path)) {
-      std::string err_msg = "file: ";
-      err_msg.append(file_path).append(" is not exist");
-      LOG(ERROR) << pb_util::TaskInfoToString(request_id) << err_msg;
-      throw std::runtime_error(err_msg);
-      return retcode::FAIL;
+  std::string file_path = CompletePath(file_name);
+  LOG(INFO) << pb_util::TaskInfoToString(request_id)
+            << "begin to read data for " << file_name;
+  if (!FileExists(file_path)) {
+    err_msg->append("file: ").append(file_path).append(" is not exist");
+    return retcode::FAIL;
+  }
+  struct stat file_stat;
+  if (::stat(file_path.c_str(), &file_stat) != 0) {
+    err_msg->append("stat file: ").append(file_path).append(" failed");
+    return retcode::FAIL;
+  }
+  uint64_t filesize = file_stat.st_size;
+  uint64_t offset{0};
+  uint64_t end_pos = filesize;
+  for (const auto& range : request.file_range()) {
+    if (range.file_name() != file_name) {
+      continue;
+    }
+    offset = range.offset();
+    if (range.length() > 0) {
+      end_pos = std::min<uint64_t>(offset + range.length(), filesize);
     }
-    struct stat statbuf;
-    stat(file_path.c_str(), &statbuf);
-    size_t filesize = statbuf.st_size;
-    VLOG(5) << pb_util::TaskInfoToString(request_id)
-            << "file size: " << filesize;
+    break;
+  }
+  if (offset > filesize) {
+    err_msg->append("offset: ").append(std::to_string(offset))
+        .append(" is beyond the size of file: ").append(file_path)
+        .append(", file size: ").append(std::to_string(filesize));
+    return retcode::FAIL;
+  }
+  VLOG(5) << pb_util::TaskInfoToString(request_id)
+          << "file size: " << filesize << " "
+          << "read range: [" << offset << ", " << end_pos << ")";
 
-    std::ifstream fin(file_path, std::ios::binary);
-    if (fin) {
-      size_t block_size = LIMITED_PACKAGE_SIZE;
-      size_t block_bum = filesize / block_size;
-      for (size_t i = 0 ; i < block_bum; i++) {
-        DataBlock data_block;
-        data_block.file_name = file_name;
-        data_block.data.resize(block_size);
-        auto& buf = data_block.data;
-        fin.read(&buf[0], block_size);
-        data_queue->push(std::move(data_block));
+  std::ifstream fin(file_path, std::ios::binary);
+  if (!fin) {
+    err_msg->append("open file ").append(file_path).append(" failed");
+    return retcode::FAIL;
+  }
+  fin.seekg(offset);
+  bool compress = request.compress_type() == rpc::CompressType::ZLIB;
+  uint64_t pos = offset;
+  do {
+    size_t block_size = std::min<uint64_t>(LIMITED_PACKAGE_SIZE, end_pos - pos);
+    DataBlock data_block;
+    data_block.file_name = file_name;
+    data_block.offset = pos;
+    data_block.raw_size = block_size;
+    data_block.file_size = filesize;
+    data_block.mtime = file_stat.st_mtime;
+    auto& buf = data_block.data;
+    buf.resize(block_size);
+    if (block_size > 0) {
+      fin.read(&buf[0], block_size);
+      if (static_cast<size_t>(fin.gcount()) != block_size) {
+        err_msg->append("read file ").append(file_path)
+            .append(" failed at offset: ").append(std::to_string(pos));
+        return retcode::FAIL;
       }
-      size_t last_block_size = filesize % block_size;
-      LOG(INFO) << pb_util::TaskInfoToString(request_id)
-                << "last_block_size: " << last_block_size;
-      if (last_block_size) {
-        DataBlock data_block;
-        data_block.file_name = file_name;
-        data_block.data.resize(last_block_size);
-        auto& buf = data_block.data;
-        fin.read(&buf[0], last_block_size);
-        data_queue->push(std::move(data_block));
+    }
+    if (compress) {
+      std::string compressed;
+      auto ret = ZlibCompress(buf, &compressed);
+      if (ret != retcode::SUCCESS) {
+        err_msg->append("compress data of file ").append(file_path)
+            .append(" failed");
+        return retcode::FAIL;
       }
-      fin.close();
-      // flag for end read
-      DataBlock data_block;
-      data_block.is_last_block = true;
-      data_queue->push(std::move(data_block));
-    } else {
-      std::string err_msg;
-      err_msg.append("open file ").append(file_path).append(" failed");
-      LOG(ERROR) << pb_util::TaskInfoToString(request_id) << err_msg;
-      throw std::runtime_error(err_msg);
+      buf = std::move(compressed);
     }
-  }
+    pos += block_size;
+    // an empty range still sends one block, so the client sees the file end
+    data_block.is_end = pos >= end_pos;
+    if (!data_queue->push(std::move(data_block))) {
+      // queue is shutdown by writer or other reader
+      return retcode::FAIL;
+    }
+  } while (pos < end_pos);
   return retcode::SUCCESS;
 }
 
-retcode DataServiceImpl::UploadDataImpl(const rpc::DownloadRequest& request,
-    ThreadSafeQueue<DataBlock>* data_queue) {
-//
+retcode DataServiceImpl::UploadDataImpl(
+    grpc::ServerReader<rpc::UploadFileRequest>* reader,
+    rpc::UploadFileResponse* response) {
+  rpc::UploadFileRequest request;
+  std::string file_name;
+  std::string file_path;
+  std::string tmp_path;
+  std::ofstream fout;
+  uint64_t recv_size{0};
+  bool is_end{false};
+  std::string raw_data;
+  UploadGuard upload_guard(&upload_mtx_, &uploading_files_);
+  while (reader->Read(&request)) {
+    if (file_name.empty()) {
+      file_name = request.file_name();
+      if (!IsValidUploadName(file_name)) {
+        response->set_info("invalid file name: " + file_name);
+        return retcode::FAIL;
+      }
+      file_path = CompletePath(file_name);
+      tmp_path = file_path + ".uploading";
+      if (!upload_guard.Acquire(file_path)) {
+        response->set_info(file_path + " is being uploaded by another stream");
+        return retcode::FAIL;
+      }
+      if (ValidateDir(file_path)) {
+        response->set_info("check file path failed: " + file_path);
+        return retcode::FAIL;
+      }
+      recv_size = request.offset();
+      response->set_file_path(file_path);
+      if (recv_size > 0) {
+        // resume an interrupted upload
+        uint64_t uploaded_size = FileSize(tmp_path);
+        if (uploaded_size != recv_size) {
+          response->set_size(uploaded_size);
+          response->set_info("offset: " + std::to_string(recv_size) +
+              " mismatches the uploaded size: " +
+              std::to_string(uploaded_size));
+          return retcode::FAIL;
+        }
+        fout.open(tmp_path, std::ios::binary | std::ios::app);
+      } else {
+        fout.open(tmp_path, std::ios::binary | std::ios::trunc);
+      }
+      if (!fout) {
+        response->set_info("open file: " + tmp_path + " failed");
+        return retcode::FAIL;
+      }
+      LOG(INFO) << "begin to receive data for " << file_path << " "
+                << "from offset: " << recv_size;
+    } else if (!request.file_name().empty() &&
+               request.file_name() != file_name) {
+      response->set_size(recv_size);
+      response->set_info("only one file is allowed in an upload, "
+                         "expected: " + file_name + " "
+                         "received: " + request.file_name());
+      return retcode::FAIL;
+    }
+    if (request.offset() != recv_size) {
+      response->set_size(recv_size);
+      response->set_info("unexpected offset: " +
+          std::to_string(request.offset()) + " expected: " +
+          std::to_string(recv_size));
+      return retcode::FAIL;
+    }
+    std::string_view data = request.data();
+    if (request.compress_type() == rpc::CompressType::ZLIB) {
+      // raw_size comes from the peer, bound it before allocating
+      if (request.raw_size() > LIMITED_PACKAGE_SIZE) {
+        response->set_size(recv_size);
+        response->set_info("raw size: " + std::to_string(request.raw_size()) +
+            " exceeds the block limit: " +
+            std::to_string(LIMITED_PACKAGE_SIZE));
+        return retcode::FAIL;
+      }
+      auto ret = ZlibUncompress(data, request.raw_size(), &raw_data);
+      if (ret != retcode::SUCCESS) {
+        response->set_size(recv_size);
+        response->set_info("uncompress data at offset: " +
+            std::to_string(recv_size) + " failed");
+        return retcode::FAIL;
+      }
+      data = raw_data;
+    }
+    fout.write(data.data(), data.size());
+    if (!fout) {
+      response->set_size(recv_size);
+      response->set_info("write file: " + tmp_path + " failed");
+      return retcode::FAIL;
+    }
+    recv_size += data.size();
+    if (request.is_end()) {
+      is_end = true;
+      break;
+    }
+  }
+  if (file_name.empty()) {
+    response->set_info("no data is received");
+    return retcode::FAIL;
+  }
+  fout.close();
+  response->set_size(recv_size);
+  if (!is_end) {
+    // keep the temporary file, the client can resume from recv_size
+    response->set_info("upload of " + file_name + " is interrupted at " +
+                       std::to_string(recv_size));
+    return retcode::FAIL;
+  }
+  if (std::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+    response->set_info("rename " + tmp_path + " to " + file_path + " failed");
+    return retcode::FAIL;
+  }
+  LOG(INFO) << "receive data for " << file_path << " finished, "
+            << "size: " << recv_size;
   return retcode::SUCCESS;
 }
 
@@ -300,6 +544,8 @@ retcode DataServiceImpl::RegisterDatasetProcess(
 retcode DataServiceImpl::UnRegisterDatasetProcess(
     const DatasetMetaInfo& meta_info,
     rpc::NewDatasetResponse* reply) {
+  // drop the driver and the cached meta of the deleted dataset
+  this->GetDatasetService()->unRegisterDriver(meta_info.id);
   reply->set_ret_code(rpc::NewDatasetResponse::SUCCESS);
   return retcode::SUCCESS;
 }
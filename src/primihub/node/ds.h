@@ -25,6 +25,8 @@
 #include <grpcpp/server_context.h>
 
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 
 #include "src/primihub/protos/service.grpc.pb.h"
@@ -35,6 +37,12 @@
 #include "src/primihub/util/threadsafe_queue.h"
 
 namespace primihub {
+/**
+ * uploaded files stay under the storage path, and the name is passed to
+ * a shell by ValidateDir, so only plain relative paths are accepted
+*/
+bool IsValidUploadName(const std::string& file_name);
+
 class DataServiceImpl final: public rpc::DataSetService::Service {
  public:
   explicit DataServiceImpl(service::DatasetService* service) :
@@ -45,9 +53,16 @@ class DataServiceImpl final: public rpc::DataSetService::Service {
   }
   struct DataBlock {
     std::string data;
-    bool is_last_block{false};
+    bool is_last_block{false};    // no more file from the reader
     std::string file_name;
+    uint64_t offset{0};           // position of data in file
+    uint64_t raw_size{0};         // size of data before compression
+    bool is_end{false};           // last block of file
+    uint64_t file_size{0};
+    int64_t mtime{0};
   };
+  // blocks buffered between readers and the stream writer
+  static constexpr size_t kDownloadQueueSize = 16;
 
   grpc::Status NewDataset(grpc::ServerContext *context,
                           const rpc::NewDatasetRequest *request,
@@ -63,10 +78,23 @@ class DataServiceImpl final: public rpc::DataSetService::Service {
                           rpc::UploadFileResponse* response);
 
  protected:
+  /**
+   * read the requested range of file_name block by block into data_queue,
+   * push blocks until the queue is full, so reading never runs ahead of
+   * the stream by more than kDownloadQueueSize blocks
+  */
   retcode DownloadDataImpl(const rpc::DownloadRequest& request,
-                           ThreadSafeQueue<DataBlock>* data_queue);
-  retcode UploadDataImpl(const rpc::DownloadRequest& request,
-                         ThreadSafeQueue<DataBlock>* data_queue);
+                           const std::string& file_name,
+                           BoundedThreadSafeQueue<DataBlock>* data_queue,
+                           std::string* err_msg);
+  /**
+   * write the stream into <file_path>.uploading and rename it when the last
+   * block is received. an upload with a nonzero offset resumes the
+   * temporary file left by an interrupted one. an upload of a file which is
+   * being uploaded by another stream is rejected
+  */
+  retcode UploadDataImpl(grpc::ServerReader<rpc::UploadFileRequest>* reader,
+                         rpc::UploadFileResponse* response);
   retcode QueryResultImpl(const rpc::QueryResultRequest& request,
                           rpc::QueryResultResponse* response);
 
@@ -93,6 +121,9 @@ class DataServiceImpl final: public rpc::DataSetService::Service {
  private:
   service::DatasetService* dataset_service_ref_{nullptr};
   std::string location_info_;
+  std::mutex upload_mtx_;
+  // path of files being uploaded
+  std::set<std::string> uploading_files_;
 };
 
 }  // namespace primihub
@@ -43,6 +43,7 @@ VMNodeImpl::VMNodeImpl(const std::string& config_file,
 
 VMNodeImpl::~VMNodeImpl() {
   stop_.store(true);
+  NotifyWorkerStatusChanged();
   fininished_workers_.shutdown();
   fininished_scheduler_workers_.shutdown();
   finished_worker_fut_.get();
@@ -248,6 +249,9 @@ void VMNodeImpl::ManageTaskOperatorThread() {
           default:
             break;
         }
+        // waiters may have observed write_flag_ during the operation,
+        // wake them up to recheck after task_executor_mtx_ is released
+        NotifyWorkerStatusChanged();
       }
     });
 }
@@ -594,6 +598,14 @@ retcode VMNodeImpl::FetchTaskStatus(const rpc::TaskContext& task_info,
                                     rpc::TaskStatusReply* response) {
   auto worker_ptr = GetSchedulerWorker(task_info);
   if (worker_ptr == nullptr) {
+    std::vector<rpc::TaskStatus> final_status;
+    if (GetFinishedSchedulerStatus(task_info, &final_status) ==
+        retcode::SUCCESS) {
+      for (const auto& status : final_status) {
+        response->add_task_status()->CopyFrom(status);
+      }
+      return retcode::SUCCESS;
+    }
     auto task_status = response->add_task_status();
     task_status->set_status(rpc::TaskStatus::NONEXIST);
     task_status->set_message("No shecudler found for task");
@@ -612,6 +624,70 @@ retcode VMNodeImpl::FetchTaskStatus(const rpc::TaskContext& task_info,
   return retcode::SUCCESS;
 }
 
+retcode VMNodeImpl::WatchTaskStatus(const rpc::TaskContext& task_info,
+                                    const std::function<bool()>& is_cancelled,
+                                    const TaskStatusWriter& writer) {
+  auto worker_ptr = GetSchedulerWorker(task_info);
+  if (worker_ptr == nullptr) {
+    // the worker is erased a while after the task has finished
+    std::vector<rpc::TaskStatus> final_status;
+    if (GetFinishedSchedulerStatus(task_info, &final_status) ==
+        retcode::SUCCESS) {
+      for (const auto& status : final_status) {
+        if (!writer(status)) {
+          return retcode::FAIL;
+        }
+      }
+      return retcode::SUCCESS;
+    }
+    rpc::TaskStatus task_status;
+    task_status.set_status(rpc::TaskStatus::NONEXIST);
+    task_status.set_message("No shecudler found for task");
+    writer(task_status);
+    return retcode::SUCCESS;
+  }
+  auto TASK_INFO_STR = pb_util::TaskInfoToString(task_info);
+  if (task_status_watcher_num_.fetch_add(1) >= MAX_TASK_STATUS_WATCHERS) {
+    task_status_watcher_num_.fetch_sub(1);
+    PH_LOG(WARNING, LogType::kScheduler)
+        << TASK_INFO_STR << "too many task status watchers, "
+        << "max: " << MAX_TASK_STATUS_WATCHERS;
+    return retcode::FAIL;
+  }
+  // interval to check whether the watcher has gone while no status arrives
+  constexpr auto kCheckInterval = std::chrono::milliseconds(100);
+  auto ret = retcode::SUCCESS;
+  size_t cursor = 0;
+  rpc::TaskStatus task_status;
+  while (!is_cancelled()) {
+    if (worker_ptr->waitTaskStatus(&cursor, &task_status, kCheckInterval) ==
+        retcode::SUCCESS) {
+      if (!writer(task_status)) {
+        PH_LOG(WARNING, LogType::kScheduler)
+            << TASK_INFO_STR << "write task status to watcher failed";
+        ret = retcode::FAIL;
+        break;
+      }
+      continue;
+    }
+    if (worker_ptr->isSchedulerFinished()) {
+      // statuses are recorded before the finished flag is set
+      while (worker_ptr->waitTaskStatus(&cursor, &task_status,
+                 std::chrono::milliseconds(0)) == retcode::SUCCESS) {
+        if (!writer(task_status)) {
+          ret = retcode::FAIL;
+          break;
+        }
+      }
+      break;
+    }
+  }
+  task_status_watcher_num_.fetch_sub(1);
+  PH_VLOG(5, LogType::kScheduler)
+      << TASK_INFO_STR << "end of VMNodeImpl::WatchTaskStatus";
+  return ret;
+}
+
 retcode VMNodeImpl::NotifyTaskStatus(const PushTaskRequest& request,
                                      const rpc::TaskStatus::StatusCode status,
                                      const std::string& message) {
@@ -736,6 +812,18 @@ auto VMNodeImpl::IsFinishedTask(const std::string& worker_id) ->
   }
 }
 
+retcode VMNodeImpl::GetFinishedSchedulerStatus(
+    const rpc::TaskContext& task_info, std::vector<rpc::TaskStatus>* status) {
+  std::string worker_id = this->GetWorkerId(task_info);
+  std::shared_lock<std::shared_mutex> lck(finished_scheduler_status_mtx_);
+  auto it = finished_scheduler_status_.find(worker_id);
+  if (it == finished_scheduler_status_.end()) {
+    return retcode::FAIL;
+  }
+  *status = std::get<0>(it->second);
+  return retcode::SUCCESS;
+}
+
 void VMNodeImpl::CleanFinishedTaskThread() {
   // clean finished task
   finished_worker_fut_ = std::async(
@@ -785,11 +873,26 @@ void VMNodeImpl::CleanTimeoutCachedTaskStatusThread() {
           PH_VLOG(2, LogType::kScheduler)
               << "number of timeout task status need to earse: "
               << timeout_worker_id.size();
-          shared_lock_t lck(this->finished_task_status_mtx_);
+          std::unique_lock<std::shared_mutex> lck(
+              this->finished_task_status_mtx_);
           for (const auto& worker_id : timeout_worker_id) {
             finished_task_status_.erase(worker_id);
           }
         }
+        {
+          time_t now_ = ::time(nullptr);
+          std::unique_lock<std::shared_mutex> lck(
+              this->finished_scheduler_status_mtx_);
+          for (auto it = finished_scheduler_status_.begin();
+              it != finished_scheduler_status_.end();) {
+            auto& timestamp = std::get<1>(it->second);
+            if (now_ - timestamp > this->scheduler_worker_timeout_s_) {
+              it = finished_scheduler_status_.erase(it);
+            } else {
+              ++it;
+            }
+          }
+        }
         std::this_thread::sleep_for(
             std::chrono::seconds(this->cached_task_status_timeout_/2));
       }
@@ -834,13 +937,22 @@ void VMNodeImpl::CleanFinishedSchedulerWorkerThread() {
           PH_VLOG(3, LogType::kScheduler)
               << "cleanSchedulerTask size of need to clean task: "
               << timeouted_shceduler.size();
-          std::lock_guard<std::shared_mutex> lck(this->task_executor_mtx_);
+          time_t now_ = ::time(nullptr);
+          std::lock_guard<std::shared_mutex> lck(this->task_scheduler_mtx_);
           for (const auto& scheduler_worker_id : timeouted_shceduler) {
             auto it = task_scheduler_map_.find(scheduler_worker_id);
             if (it != task_scheduler_map_.end()) {
               PH_VLOG(5, LogType::kScheduler)
                   << "scheduler worker id : " << scheduler_worker_id << " "
                   << "has timeouted, begin to erase";
+              // keep the final status readable for late watchers
+              auto& worker = std::get<0>(it->second);
+              if (worker != nullptr) {
+                std::unique_lock<std::shared_mutex> status_lck(
+                    this->finished_scheduler_status_mtx_);
+                finished_scheduler_status_[scheduler_worker_id] =
+                    std::make_tuple(worker->finalTaskStatus(), now_);
+              }
               task_scheduler_map_.erase(scheduler_worker_id);
               PH_VLOG(5, LogType::kScheduler)
                   << "erase scheduler worker id : "
@@ -945,6 +1057,22 @@ retcode VMNodeImpl::ProcessSendData(const rpc::TaskContext& task_info,
 retcode VMNodeImpl::ProcessForwardData(const rpc::TaskContext& task_info,
                                        const std::string& key,
                                        std::string* data_buffer) {
+  std::shared_ptr<Worker> worker_ptr;
+  network::LinkContext* link_ctx{nullptr};
+  auto ret = GetTaskLinkContext(task_info, &worker_ptr, &link_ctx);
+  if (ret != retcode::SUCCESS) {
+    return retcode::FAIL;
+  }
+  auto& recv_queue = link_ctx->GetRecvQueue(key);
+  recv_queue.wait_and_pop(*data_buffer);
+  auto& complete_queue = link_ctx->GetCompleteQueue(key);
+  complete_queue.push(retcode::SUCCESS);
+  return retcode::SUCCESS;
+}
+
+retcode VMNodeImpl::GetTaskLinkContext(const rpc::TaskContext& task_info,
+                                       std::shared_ptr<Worker>* worker_ptr,
+                                       network::LinkContext** link_ctx) {
   std::string worker_id = this->GetWorkerId(task_info);
   auto TASK_INFO_STR = pb_util::TaskInfoToString(task_info);
   auto finished_task = this->IsFinishedTask(worker_id);
@@ -962,25 +1090,23 @@ retcode VMNodeImpl::ProcessForwardData(const rpc::TaskContext& task_info,
         << TASK_INFO_STR << ", wati worker ready is timeout";
     return retcode::FAIL;
   }
-  auto worker_ptr = this->GetWorker(task_info);
-  if (worker_ptr == nullptr) {
+  *worker_ptr = this->GetWorker(task_info);
+  if (*worker_ptr == nullptr) {
     std::string err_msg;
     err_msg.append(TASK_INFO_STR)
            .append("Task worker is not found");
     PH_LOG(ERROR, LogType::kTask) << err_msg;
     return retcode::FAIL;
   }
-  auto& link_ctx = worker_ptr->getTask()->getTaskContext().getLinkContext();
-  if (link_ctx == nullptr) {
+  auto& task_link_ctx =
+      (*worker_ptr)->getTask()->getTaskContext().getLinkContext();
+  if (task_link_ctx == nullptr) {
     std::string err_msg;
     err_msg.append(TASK_INFO_STR).append("LinkContext is empty");
     PH_LOG(ERROR, LogType::kTask) << err_msg;
     return retcode::FAIL;
   }
-  auto& recv_queue = link_ctx->GetRecvQueue(key);
-  recv_queue.wait_and_pop(*data_buffer);
-  auto& complete_queue = link_ctx->GetCompleteQueue(key);
-  complete_queue.push(retcode::SUCCESS);
+  *link_ctx = task_link_ctx.get();
   return retcode::SUCCESS;
 }
 
@@ -1038,32 +1164,70 @@ retcode VMNodeImpl::ProcessCompleteStatus(const rpc::TaskContext& task_info,
 
 retcode VMNodeImpl::WaitUntilWorkerReady(const std::string& worker_id,
                                          int timeout_ms) {
+  if (IsTaskWorkerReady(worker_id)) {
+    return retcode::SUCCESS;
+  }
   SCopedTimer timer;
   auto TASK_INFO_STR = pb_util::TaskInfoToString(worker_id);
-  do {
-    // try to get lock
-    if (IsTaskWorkerReady(worker_id)) {
-      break;
-    }
-    PH_VLOG(5, LogType::kTask)
+  PH_VLOG(5, LogType::kTask)
+      << TASK_INFO_STR
+      << "wait for worker ready ........";
+  bool is_ready = WaitWorkerReadyFor(worker_id, timeout_ms);
+  auto wait_time_us =
+      static_cast<uint64_t>(timer.timeElapse<std::chrono::microseconds>());
+  RecordWorkerReadyWaitTime(wait_time_us);
+  if (!is_ready) {
+    PH_LOG(ERROR, LogType::kScheduler)
         << TASK_INFO_STR
-        << "sleep and wait for worker ready ........";
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
-    if (timeout_ms == -1) {
-      continue;
-    }
-    auto time_elapse_ms = timer.timeElapse();
-    if (time_elapse_ms > timeout_ms) {
-      PH_LOG(ERROR, LogType::kScheduler)
-          << TASK_INFO_STR
-          << "wait for worker ready is timeout, wait time(ms): " << timeout_ms;
-      return retcode::FAIL;
-    }
-  } while (true);
-
+        << "wait for worker ready is timeout, wait time(ms): " << timeout_ms;
+    return retcode::FAIL;
+  }
   return retcode::SUCCESS;
 }
 
+bool VMNodeImpl::WaitWorkerReadyFor(const std::string& worker_id,
+                                    int wait_ms) {
+  // predicate is checked with worker_ready_mtx_ held, and notifier takes the
+  // same lock after task_executor_map_ is changed, so no wakeup is lost
+  auto worker_ready = [&]() -> bool {
+    return stop_.load() ||
+        IsTaskWorkerReady(worker_id);
+  };
+  std::unique_lock<std::mutex> lck(worker_ready_mtx_);
+  if (wait_ms < 0) {
+    worker_ready_cv_.wait(lck, worker_ready);
+  } else {
+    worker_ready_cv_.wait_for(lck, std::chrono::milliseconds(wait_ms),
+                              worker_ready);
+  }
+  if (stop_.load()) {
+    return false;
+  }
+  return IsTaskWorkerReady(worker_id);
+}
+
+void VMNodeImpl::NotifyWorkerStatusChanged() {
+  {
+    std::lock_guard<std::mutex> lck(worker_ready_mtx_);
+  }
+  worker_ready_cv_.notify_all();
+}
+
+void VMNodeImpl::RecordWorkerReadyWaitTime(uint64_t wait_time_us) {
+  auto wait_count = ++worker_ready_wait_count_;
+  auto total_us = worker_ready_wait_total_us_.fetch_add(wait_time_us) +
+                  wait_time_us;
+  auto max_us = worker_ready_wait_max_us_.load();
+  while (wait_time_us > max_us &&
+         !worker_ready_wait_max_us_.compare_exchange_weak(max_us,
+                                                          wait_time_us)) {}
+  PH_VLOG(5, LogType::kTask)
+      << "wait worker ready time cost(us): " << wait_time_us << " "
+      << "count: " << wait_count << " "
+      << "avg(us): " << total_us / wait_count << " "
+      << "max(us): " << std::max<uint64_t>(max_us, wait_time_us);
+}
+
 void VMNodeImpl::CleanDuplicateTaskIdFilter() {
   SCopedTimer timer;
   std::map<std::string, int8_t> timeouted_task_id;
@@ -24,10 +24,12 @@
 #include <set>
 #include <future>
 #include <atomic>
+#include <condition_variable>
 #include <tuple>
 #include <string>
 #include <queue>
 #include <vector>
+#include <functional>
 
 #include "src/primihub/common/common.h"
 #include "src/primihub/util/threadsafe_queue.h"
@@ -65,6 +67,17 @@ class VMNodeImpl {
                            Node* scheduler_node);
   retcode FetchTaskStatus(const rpc::TaskContext& request,
                           rpc::TaskStatusReply* response);
+  using TaskStatusWriter = std::function<bool(const rpc::TaskStatus&)>;
+  /**
+   * write each status of the task as soon as it is updated until the task
+   * has finished, stop early if writer fails or is_cancelled returns true.
+   * every watch holds a sync grpc server thread while the task runs, so at
+   * most MAX_TASK_STATUS_WATCHERS run at once, the rest get FAIL and the
+   * client falls back to FetchTaskStatus
+  */
+  retcode WatchTaskStatus(const rpc::TaskContext& request,
+                          const std::function<bool()>& is_cancelled,
+                          const TaskStatusWriter& writer);
   retcode NotifyTaskStatus(const rpc::PushTaskRequest& request,
                            const rpc::TaskStatus::StatusCode status,
                            const std::string& message);
@@ -99,6 +112,12 @@ class VMNodeImpl {
   */
   auto IsFinishedTask(const std::string& worker_id) ->
       std::tuple<bool, rpc::TaskStatus::StatusCode>;
+  /**
+   * final statuses of a task whose scheduler worker has been erased,
+   * return FAIL if they are unknown or have expired
+  */
+  retcode GetFinishedSchedulerStatus(const rpc::TaskContext& task_info,
+                                     std::vector<rpc::TaskStatus>* status);
 
   void CleanFinishedTaskThread();
   void CleanTimeoutCachedTaskStatusThread();
@@ -121,12 +140,28 @@ class VMNodeImpl {
   retcode ProcessForwardData(const rpc::TaskContext& task_info,
                              const std::string& key,
                              std::string* data_buffer);
+  /**
+   * get link context of the running task,
+   * worker_ptr keeps the task and its link context alive
+  */
+  retcode GetTaskLinkContext(const rpc::TaskContext& task_info,
+                             std::shared_ptr<Worker>* worker_ptr,
+                             network::LinkContext** link_ctx);
   retcode ProcessCompleteStatus(const rpc::TaskContext& task_info,
                              const std::string& key,
                              uint64_t expected_complete_num);
 
+  /**
+   * block until worker is registered by task setup or timeout,
+   * waiters are woken up when task operation is applied, no polling
+   * timeout_ms: -1 wait until worker is ready
+  */
   retcode WaitUntilWorkerReady(const std::string& worker_id,
                                int timeout_ms = -1);
+  /**
+   * wait for at most wait_ms, return true if worker is ready
+  */
+  bool WaitWorkerReadyFor(const std::string& worker_id, int wait_ms);
   std::shared_ptr<Nodelet> GetNodelet() { return this->nodelet_;}
 
  protected:
@@ -143,6 +178,12 @@ class VMNodeImpl {
   retcode ExecuteDelTaskOperation(task_manage_t&& task_detail);
   retcode ExecuteKillTaskOperation(task_manage_t&& task_detail);
   std::string GenerateUUID();
+  /**
+   * wake up all waiters of worker ready,
+   * called after task_executor_map_ is changed
+  */
+  void NotifyWorkerStatusChanged();
+  void RecordWorkerReadyWaitTime(uint64_t wait_time_us);
   auto GetDeviceInfo() -> std::tuple<std::string, std::string>;
 
  private:
@@ -172,6 +213,13 @@ class VMNodeImpl {
   std::unique_ptr<primihub::network::LinkContext> link_ctx_{nullptr};
   std::shared_mutex task_scheduler_mtx_;
   std::map<std::string, task_executor_t> task_scheduler_map_;
+  std::shared_mutex finished_scheduler_status_mtx_;
+  // key: worker id
+  // value: final statuses of an erased scheduler worker, erase timestamp
+  using scheduler_status_info_t =
+      std::tuple<std::vector<rpc::TaskStatus>, time_t>;
+  std::map<std::string, scheduler_status_info_t> finished_scheduler_status_;
+  std::atomic<int> task_status_watcher_num_{0};
   ThreadSafeQueue<std::string> fininished_scheduler_workers_;
   std::future<void> finished_scheduler_worker_fut_;
   int scheduler_worker_timeout_s_{SCHEDULE_WORKER_TIMEOUT_S};
@@ -180,6 +228,12 @@ class VMNodeImpl {
 
   ThreadSafeQueue<task_manage_t> task_manage_queue_;
   std::atomic<bool> write_flag_{false};
+  std::mutex worker_ready_mtx_;
+  std::condition_variable worker_ready_cv_;
+  // latency of waiting for worker ready, in microseconds
+  std::atomic<uint64_t> worker_ready_wait_count_{0};
+  std::atomic<uint64_t> worker_ready_wait_total_us_{0};
+  std::atomic<uint64_t> worker_ready_wait_max_us_{0};
   ThreadSafeQueue<task_executor_container_t> finished_task_queue_;
   ThreadSafeQueue<task_executor_container_t> kill_task_queue_;
   std::future<void> kill_task_queue_fut_;
@@ -17,6 +17,9 @@
 #include "src/primihub/node/node_interface.h"
 #include <glog/logging.h>
 #include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <mutex>
 #include <utility>
 
 #include "src/primihub/util/util.h"
@@ -112,6 +115,23 @@ Status VMNodeInterface::FetchTaskStatus(ServerContext* context,
   return Status::OK;
 }
 
+Status VMNodeInterface::WatchTaskStatus(ServerContext* context,
+    const rpc::TaskContext* request, ServerWriter<rpc::TaskStatus>* writer) {
+  auto ret = ServerImpl()->WatchTaskStatus(
+      *request,
+      [context]() -> bool {return context->IsCancelled();},
+      [writer](const rpc::TaskStatus& task_status) -> bool {
+        return writer->Write(task_status);
+      });
+  if (ret != retcode::SUCCESS) {
+    std::string TASK_INFO_STR = proto::util::TaskInfoToString(*request);
+    PH_LOG(ERROR, LogType::kScheduler)
+        << TASK_INFO_STR
+        << "WatchTaskStatus encountes error";
+  }
+  return Status::OK;
+}
+
 Status VMNodeInterface::UpdateTaskStatus(ServerContext* context,
                                          const rpc::TaskStatus* request,
                                          rpc::Empty* response) {
@@ -336,6 +356,139 @@ Status VMNodeInterface::ForwardRecv(ServerContext* context,
   return grpc::Status::OK;
 }
 
+Status VMNodeInterface::ForwardRecvStream(ServerContext* context,
+    ServerReaderWriter<rpc::TaskRequest, rpc::RecvStreamRequest>* stream) {
+  rpc::RecvStreamRequest request;
+  if (!stream->Read(&request)) {
+    return Status(grpc::StatusCode::INVALID_ARGUMENT,
+                  "no recv stream request is received");
+  }
+  const auto task_info = request.task_info();
+  const std::string key = request.role();
+  std::string TASK_INFO_STR = proto::util::TaskInfoToString(task_info);
+  std::shared_ptr<Worker> worker_ptr;
+  network::LinkContext* link_ctx{nullptr};
+  auto ret = ServerImpl()->GetTaskLinkContext(task_info,
+                                              &worker_ptr, &link_ctx);
+  if (ret != retcode::SUCCESS) {
+    return Status(grpc::StatusCode::NOT_FOUND,
+                  "no task is available for key: " + key);
+  }
+  // credit granted by receiver, each message consumes one credit.
+  // a message stays in the forward window until the receiver reports it,
+  // a broken stream loses nothing, the next one re-sends it
+  auto& window = link_ctx->GetForwardWindow(key);
+  uint64_t stream_id = window.Restart(request.received());
+  std::mutex credit_mtx;
+  std::condition_variable credit_cv;
+  uint64_t credit = request.credit();
+  bool peer_closed{false};
+  auto credit_fut = std::async(std::launch::async, [&]() {
+    rpc::RecvStreamRequest credit_request;
+    while (stream->Read(&credit_request)) {
+      {
+        std::lock_guard<std::mutex> lck(credit_mtx);
+        credit += credit_request.credit();
+      }
+      credit_cv.notify_one();
+      window.Ack(credit_request.received());
+    }
+    {
+      std::lock_guard<std::mutex> lck(credit_mtx);
+      peer_closed = true;
+    }
+    credit_cv.notify_one();
+  });
+
+  auto& recv_queue = link_ctx->GetRecvQueue(key);
+  auto& complete_queue = link_ctx->GetCompleteQueue(key);
+  std::string worker_id = ServerImpl()->GetWorkerId(task_info);
+  // interval to check whether the task is finished while no data arrives
+  constexpr auto kCheckInterval = std::chrono::milliseconds(100);
+  Status status = Status::OK;
+  uint64_t forward_count{0};
+  uint64_t resend_count{0};
+  rpc::TaskRequest forward_data;
+  forward_data.mutable_task_info()->CopyFrom(task_info);
+  forward_data.set_role(key);
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lck(credit_mtx);
+      credit_cv.wait(lck, [&]() { return credit > 0 || peer_closed; });
+      if (peer_closed) {
+        break;
+      }
+    }
+    bool resent{false};
+    auto data_ptr = window.Next(stream_id, &recv_queue, kCheckInterval,
+                                &resent);
+    if (data_ptr == nullptr) {
+      if (window.IsStale(stream_id)) {
+        status = Status(grpc::StatusCode::ABORTED,
+                        "recv stream is replaced by a new one");
+        break;
+      }
+      if (context->IsCancelled() ||
+          std::get<0>(ServerImpl()->IsFinishedTask(worker_id))) {
+        status = Status(grpc::StatusCode::ABORTED, "task is finished");
+        break;
+      }
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> lck(credit_mtx);
+      credit--;
+    }
+    // message is split into packages, data_len is the message length
+    const auto& data = *data_ptr;
+    size_t total_length = data.size();
+    size_t sended_size = 0;
+    bool write_success{true};
+    forward_data.set_data_len(total_length);
+    do {
+      size_t data_len = std::min<size_t>(LIMITED_PACKAGE_SIZE,
+                                         total_length - sended_size);
+      forward_data.set_data(data.data() + sended_size, data_len);
+      sended_size += data_len;
+      if (!stream->Write(forward_data)) {
+        write_success = false;
+        break;
+      }
+    } while (sended_size < total_length);
+    if (!write_success) {
+      PH_LOG(WARNING, LogType::kTask)
+          << TASK_INFO_STR
+          << "recv stream is closed by peer, key: " << key << " "
+          << "unacknowledged messages are kept for the next stream: "
+          << window.UnackedNum();
+      status = Status(grpc::StatusCode::UNAVAILABLE, "write data failed");
+      break;
+    }
+    if (resent) {
+      resend_count++;
+    } else {
+      complete_queue.push(retcode::SUCCESS);
+    }
+    forward_count++;
+  }
+  bool need_cancel{false};
+  {
+    std::lock_guard<std::mutex> lck(credit_mtx);
+    need_cancel = !peer_closed;
+  }
+  if (need_cancel) {
+    // unblock the credit reader
+    context->TryCancel();
+  }
+  credit_fut.get();
+  PH_VLOG(5, LogType::kTask)
+      << TASK_INFO_STR
+      << "recv stream for key: " << key << " is closed, "
+      << "forward message count: " << forward_count << " "
+      << "resend count: " << resend_count;
+  return status;
+}
+
 Status VMNodeInterface::CompleteStatus(ServerContext* context,
                                        const rpc::CompleteStatusRequest* request,
                                        rpc::Empty* response) {
@@ -358,11 +511,22 @@ retcode VMNodeInterface::WaitUntilWorkerReady(const std::string& worker_id,
         << TASK_INFO_STR << "context is cancelled by client";
     return retcode::FAIL;
   }
-  auto _start = std::chrono::high_resolution_clock::now();
+  // wake up on worker status change, wait in slices to observe cancellation
+  constexpr int kWaitSliceMs = 200;
   SCopedTimer timer;
   do {
-    // try to get lock
-    if (ServerImpl()->IsTaskWorkerReady(worker_id)) {
+    int wait_ms = kWaitSliceMs;
+    if (timeout_ms != -1) {
+      auto remain_ms = timeout_ms - static_cast<int>(timer.timeElapse());
+      if (remain_ms <= 0) {
+        PH_LOG(ERROR, LogType::kTask)
+            << TASK_INFO_STR
+            << "wait for worker ready is timeout";
+        return retcode::FAIL;
+      }
+      wait_ms = std::min(wait_ms, remain_ms);
+    }
+    if (ServerImpl()->WaitWorkerReadyFor(worker_id, wait_ms)) {
       break;
     }
     if (context->IsCancelled()) {
@@ -372,18 +536,7 @@ retcode VMNodeInterface::WaitUntilWorkerReady(const std::string& worker_id,
     }
     PH_VLOG(5, LogType::kTask)
         << TASK_INFO_STR
-        << "sleep and wait for worker ready ......";
-    std::this_thread::sleep_for(std::chrono::seconds(1));
-    if (timeout_ms == -1) {
-      continue;
-    }
-    auto time_elapse_ms = timer.timeElapse();
-    if (time_elapse_ms > timeout_ms) {
-      PH_LOG(ERROR, LogType::kTask)
-          << TASK_INFO_STR
-          << "wait for worker ready is timeout";
-      return retcode::FAIL;
-    }
+        << "wait for worker ready ......";
   } while (true);
   return retcode::SUCCESS;
 }
@@ -72,6 +72,13 @@ class VMNodeInterface final : public rpc::VMNode::Service {
                          const rpc::TaskContext* request,
                          rpc::TaskStatusReply* response) override;
 
+  /**
+   * stream status of the task to client until the task has finished
+  */
+  Status WatchTaskStatus(ServerContext* context,
+                         const rpc::TaskContext* request,
+                         ServerWriter<rpc::TaskStatus>* writer) override;
+
   Status UpdateTaskStatus(ServerContext* context,
                           const rpc::TaskStatus* request,
                           rpc::Empty* response) override;
@@ -100,6 +107,15 @@ class VMNodeInterface final : public rpc::VMNode::Service {
   Status ForwardRecv(ServerContext* context,
                      const rpc::TaskRequest* request,
                      ServerWriter<rpc::TaskRequest>* writer) override;
+  /**
+   * long-lived receive stream for one key,
+   * data is pushed as soon as it arrives at the proxy and the receiver has
+   * granted credit, so no rpc setup is paid for each message
+  */
+  Status ForwardRecvStream(ServerContext* context,
+                           ServerReaderWriter<rpc::TaskRequest,
+                                              rpc::RecvStreamRequest>* stream)
+                                                                    override;
   /**
    * wait until complete queue has filled expected number of complete status
   */
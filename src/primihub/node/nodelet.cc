@@ -25,6 +25,11 @@ Nodelet::Nodelet(const std::string &config_file_path,
   auto& service_cfg = server_cfg.getServiceConfig();
   nodelet_addr_ = service_cfg.to_string();
   loadConifg(config_file_path, 20);
+  auto& pool_cfg = server_cfg.getNodeConfig().task_process_pool;
+  if (pool_cfg.size > 0) {
+    task_process_pool_ = std::make_shared<TaskProcessPool>(
+        service_cfg.id(), config_file_path, pool_cfg.size);
+  }
 #ifdef SGX
   auto& cfg = server_cfg.getNodeConfig();
   auto& sgx_config = cfg.tee_conf;
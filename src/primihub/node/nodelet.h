@@ -24,6 +24,7 @@
 #include "src/primihub/service/dataset/service.h"
 #include "src/primihub/common/common.h"
 #include "src/primihub/common/config/server_config.h"
+#include "src/primihub/node/worker/task_process_pool.h"
 #ifdef SGX
 #include "sgx/ra/service.h"
 #include "sgx/engine/sgx_engine.h"
@@ -46,6 +47,12 @@ class Nodelet {
   std::shared_ptr<service::DatasetService>& getDataService() {
     return dataset_service_;
   }
+  /**
+   * nullptr if task process pool is disabled
+  */
+  std::shared_ptr<TaskProcessPool>& GetTaskProcessPool() {
+    return task_process_pool_;
+  }
 
 #ifdef SGX
   std::shared_ptr<sgx::RaTlsService>& GetRaService() {return ra_service_;}
@@ -59,6 +66,7 @@ class Nodelet {
   std::string nodelet_addr_;
   std::string config_file_path_;
   std::shared_ptr<service::DatasetService> dataset_service_{nullptr};
+  std::shared_ptr<TaskProcessPool> task_process_pool_{nullptr};
 #ifdef SGX
   std::shared_ptr<sgx::RaTlsService> ra_service_{nullptr};
   std::shared_ptr<sgx::TeeEngine> tee_executor_{nullptr};
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2023 by PrimiHub
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      https://www.apache.org/licenses/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "src/primihub/node/worker/task_process_pool.h"
+#include <glog/logging.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#include <chrono>
+#include <sstream>
+#include <utility>
+
+#include "src/primihub/task_engine/task_process_protocol.h"
+#include "src/primihub/util/util.h"
+
+namespace primihub {
+using task_engine::kTaskStartedMarker;
+using task_engine::ParseFinishedMarker;
+
+namespace {
+// time a process is given to exit after its task is finished
+constexpr int64_t kExitTimeoutMs = 5000;
+constexpr int64_t kExitCheckIntervalMs = 10;
+
+/**
+ * block SIGPIPE in the calling thread while writing to a process which
+ * may have exited, the write fails with EPIPE instead of killing the node.
+ * a SIGPIPE raised in the scope is consumed before the mask is restored,
+ * signal disposition of the node is left untouched
+*/
+class ScopedSigpipeBlock {
+ public:
+  ScopedSigpipeBlock() {
+    sigemptyset(&sigpipe_set_);
+    sigaddset(&sigpipe_set_, SIGPIPE);
+    sigset_t pending;
+    sigpending(&pending);
+    sigpipe_pending_ = sigismember(&pending, SIGPIPE) == 1;
+    pthread_sigmask(SIG_BLOCK, &sigpipe_set_, &old_set_);
+  }
+  ~ScopedSigpipeBlock() {
+    if (!sigpipe_pending_) {
+      sigset_t pending;
+      sigpending(&pending);
+      if (sigismember(&pending, SIGPIPE) == 1) {
+        struct timespec no_wait{0, 0};
+        sigtimedwait(&sigpipe_set_, nullptr, &no_wait);
+      }
+    }
+    pthread_sigmask(SIG_SETMASK, &old_set_, nullptr);
+  }
+
+ private:
+  sigset_t sigpipe_set_;
+  sigset_t old_set_;
+  bool sigpipe_pending_{false};
+};
+}  // namespace
+
+// ---------------------------- TaskProcess ---------------------------------
+std::unique_ptr<TaskProcess> TaskProcess::Spawn(
+    const std::string& execute_app, const std::vector<std::string>& args) {
+  Poco::Pipe in_pipe;
+  Poco::Pipe marker_pipe;
+  Poco::Pipe log_pipe;
+  try {
+    auto handle = Poco::Process::launch(execute_app, args,
+                                        &in_pipe, &marker_pipe, &log_pipe);
+    return std::unique_ptr<TaskProcess>(
+        new TaskProcess(handle, in_pipe, marker_pipe, log_pipe));
+  } catch (std::exception& e) {
+    LOG(ERROR) << "launch task process: " << execute_app << " failed, "
+               << e.what();
+    return nullptr;
+  }
+}
+
+TaskProcess::TaskProcess(Poco::ProcessHandle handle, Poco::Pipe in_pipe,
+                         Poco::Pipe marker_pipe, Poco::Pipe log_pipe)
+    : handle_(std::make_unique<Poco::ProcessHandle>(handle)),
+      in_pipe_(in_pipe), marker_pipe_(marker_pipe), log_pipe_(log_pipe),
+      marker_stream_(marker_pipe_) {
+  // log must be drained while the process warms up, or it blocks on write
+  log_thread_ = std::thread(&TaskProcess::ReadLog, this);
+}
+
+TaskProcess::~TaskProcess() {
+  CloseInput();
+  // an idle process exits when it sees EOF on stdin
+  WaitExit(kExitTimeoutMs);
+}
+
+void TaskProcess::ReadLog() {
+  Poco::PipeInputStream log_stream(log_pipe_);
+  std::string line;
+  while (std::getline(log_stream, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lck(log_mtx_);
+    if (log_handler_) {
+      log_handler_(line);
+    } else {
+      VLOG(5) << "[task process " << handle_->id() << "] " << line;
+    }
+  }
+}
+
+bool TaskProcess::IsAlive() {
+  if (exited_) {
+    return false;
+  }
+  int status{0};
+  // unlike isRunning, waitpid does not take an unreaped child as alive
+  pid_t pid = waitpid(handle_->id(), &status, WNOHANG);
+  if (pid == 0) {
+    return true;
+  }
+  exited_ = true;
+  return false;
+}
+
+void TaskProcess::CloseInput() {
+  if (input_closed_) {
+    return;
+  }
+  input_closed_ = true;
+  try {
+    in_pipe_.close(Poco::Pipe::CLOSE_WRITE);
+  } catch (std::exception& e) {
+    LOG(WARNING) << "close task process stdin failed, " << e.what();
+  }
+}
+
+void TaskProcess::WaitExit(int64_t timeout_ms) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_ms);
+  while (IsAlive() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kExitCheckIntervalMs));
+  }
+  if (!exited_) {
+    if (timeout_ms > 0) {
+      LOG(WARNING) << "task process " << handle_->id() << " does not exit "
+                   << "in " << timeout_ms << "ms, kill it";
+    }
+    kill(handle_->id(), SIGKILL);
+    int status{0};
+    waitpid(handle_->id(), &status, 0);
+    exited_ = true;
+  }
+  if (log_thread_.joinable()) {
+    log_thread_.join();
+  }
+}
+
+retcode TaskProcess::WriteRequest(const std::string& request_base64_str) {
+  std::string line = request_base64_str + "\n";
+  ScopedSigpipeBlock sigpipe_block;
+  try {
+    size_t written = 0;
+    while (written < line.size()) {
+      written += in_pipe_.writeBytes(line.data() + written,
+                                     static_cast<int>(line.size() - written));
+    }
+  } catch (std::exception& e) {
+    LOG(ERROR) << "send request to task process failed, " << e.what();
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+retcode TaskProcess::Run(const std::string& request_base64_str,
+                         const LogHandler& log_handler,
+                         double* startup_ms) {
+  used_ = true;
+  SCopedTimer timer;
+  {
+    std::lock_guard<std::mutex> lck(log_mtx_);
+    log_handler_ = log_handler;
+  }
+  retcode ret{retcode::FAIL};
+  bool finished{false};
+  if (WriteRequest(request_base64_str) == retcode::SUCCESS) {
+    CloseInput();
+    std::string line;
+    while (std::getline(marker_stream_, line)) {
+      if (line == kTaskStartedMarker) {
+        *startup_ms = timer.timeElapse();
+        continue;
+      }
+      int code{0};
+      if (!ParseFinishedMarker(line, &code)) {
+        LOG(ERROR) << "malformed marker from task process: " << line;
+        break;
+      }
+      finished = true;
+      ret = code == 0 ? retcode::SUCCESS : retcode::FAIL;
+      break;
+    }
+    if (!finished && !marker_stream_) {
+      // process exits or is killed during the task
+      LOG(ERROR) << "task process exits before the task finished";
+    }
+  }
+  // the process exits after its task, a broken one is killed at once.
+  // waiting for the end of the log keeps all task log in log_handler
+  WaitExit(finished ? kExitTimeoutMs : 0);
+  {
+    std::lock_guard<std::mutex> lck(log_mtx_);
+    log_handler_ = nullptr;
+  }
+  return ret;
+}
+
+// ---------------------------- TaskProcessPool -----------------------------
+TaskProcessPool::TaskProcessPool(const std::string& node_id,
+                                 const std::string& config_file,
+                                 size_t pool_size)
+    : pool_size_(pool_size) {
+  execute_app_ = getCurrentProcessDir() + "/task_main";
+  args_.push_back("--node_id=" + node_id);
+  args_.push_back("--config_file=" + config_file);
+  args_.push_back("--serve=true");
+  Init();
+}
+
+TaskProcessPool::TaskProcessPool(const std::string& execute_app,
+                                 const std::vector<std::string>& args,
+                                 size_t pool_size)
+    : execute_app_(execute_app), args_(args), pool_size_(pool_size) {
+  Init();
+}
+
+void TaskProcessPool::Init() {
+  for (size_t i = 0; i < pool_size_; i++) {
+    auto process = Spawn();
+    if (process == nullptr) {
+      break;
+    }
+    idle_processes_.push_back(std::move(process));
+  }
+  LOG(INFO) << "task process pool size: " << idle_processes_.size();
+}
+
+TaskProcessPool::~TaskProcessPool() {
+  std::lock_guard<std::mutex> lck(mtx_);
+  idle_processes_.clear();
+}
+
+std::unique_ptr<TaskProcess> TaskProcessPool::Spawn() {
+  return TaskProcess::Spawn(execute_app_, args_);
+}
+
+std::unique_ptr<TaskProcess> TaskProcessPool::Acquire() {
+  std::unique_ptr<TaskProcess> process{nullptr};
+  std::vector<std::unique_ptr<TaskProcess>> dead_processes;
+  {
+    std::lock_guard<std::mutex> lck(mtx_);
+    while (!idle_processes_.empty()) {
+      process = std::move(idle_processes_.front());
+      idle_processes_.pop_front();
+      if (process->IsAlive()) {
+        break;
+      }
+      dead_processes.push_back(std::move(process));
+    }
+  }
+  // health check failed, replace the dead ones
+  for (size_t i = 0; i < dead_processes.size(); i++) {
+    LOG(WARNING) << "task process is not alive, spawn a new one";
+    auto new_process = Spawn();
+    if (new_process == nullptr) {
+      break;
+    }
+    std::lock_guard<std::mutex> lck(mtx_);
+    idle_processes_.push_back(std::move(new_process));
+  }
+  return process;
+}
+
+void TaskProcessPool::Release(std::unique_ptr<TaskProcess> process) {
+  if (process == nullptr) {
+    return;
+  }
+  if (!process->Used() && process->IsAlive()) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    idle_processes_.push_back(std::move(process));
+    return;
+  }
+  process.reset();
+  auto new_process = Spawn();
+  if (new_process != nullptr) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    idle_processes_.push_back(std::move(new_process));
+  }
+}
+
+size_t TaskProcessPool::IdleNum() {
+  std::lock_guard<std::mutex> lck(mtx_);
+  return idle_processes_.size();
+}
+
+void TaskProcessPool::RecordStartupLatency(bool reused, double startup_ms) {
+  auto startup_us = static_cast<uint64_t>(startup_ms * 1000);
+  if (reused) {
+    reuse_count_++;
+    reuse_startup_us_ += startup_us;
+  } else {
+    spawn_count_++;
+    spawn_startup_us_ += startup_us;
+  }
+}
+
+std::string TaskProcessPool::LatencyReport() {
+  uint64_t reuse_count = reuse_count_.load();
+  uint64_t spawn_count = spawn_count_.load();
+  double reuse_avg_ms = reuse_count == 0 ? 0 :
+      reuse_startup_us_.load() / 1000.0 / reuse_count;
+  double spawn_avg_ms = spawn_count == 0 ? 0 :
+      spawn_startup_us_.load() / 1000.0 / spawn_count;
+  std::stringstream ss;
+  ss << "task startup latency, "
+     << "reuse: " << reuse_count << " avg(ms): " << reuse_avg_ms << " "
+     << "spawn: " << spawn_count << " avg(ms): " << spawn_avg_ms;
+  return ss.str();
+}
+}  // namespace primihub
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023 by PrimiHub
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      https://www.apache.org/licenses/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SRC_PRIMIHUB_NODE_WORKER_TASK_PROCESS_POOL_H_
+#define SRC_PRIMIHUB_NODE_WORKER_TASK_PROCESS_POOL_H_
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Poco/Pipe.h"
+#include "Poco/PipeStream.h"
+#include "Poco/Process.h"
+#include "src/primihub/common/common.h"
+
+namespace primihub {
+/**
+ * warm task_main process running in --serve mode,
+ * the request is written to its stdin, markers are read from its stdout
+ * and logs from its stderr, see task_engine/task_process_protocol.h.
+ * a process runs one task only and exits after it
+*/
+class TaskProcess {
+ public:
+  using LogHandler = std::function<void(const std::string& log_line)>;
+  static std::unique_ptr<TaskProcess> Spawn(
+      const std::string& execute_app, const std::vector<std::string>& args);
+  ~TaskProcess();
+  /**
+   * run the task and forward its log to log_handler until it finishes
+   * startup_ms: time from dispatching the request to the task starting
+  */
+  retcode Run(const std::string& request_base64_str,
+              const LogHandler& log_handler,
+              double* startup_ms);
+  bool IsAlive();
+  /**
+   * a process is not reusable once Run is called
+  */
+  bool Used() const {return used_;}
+  Poco::ProcessHandle& Handle() {return *handle_;}
+
+ private:
+  TaskProcess(Poco::ProcessHandle handle, Poco::Pipe in_pipe,
+              Poco::Pipe marker_pipe, Poco::Pipe log_pipe);
+  retcode WriteRequest(const std::string& request_base64_str);
+  /**
+   * close stdin, an idle process exits when it sees EOF
+  */
+  void CloseInput();
+  /**
+   * wait until the process exits, kill it after timeout_ms,
+   * then wait for the end of its log
+  */
+  void WaitExit(int64_t timeout_ms);
+  void ReadLog();
+
+ private:
+  std::unique_ptr<Poco::ProcessHandle> handle_{nullptr};
+  Poco::Pipe in_pipe_;
+  Poco::Pipe marker_pipe_;
+  Poco::Pipe log_pipe_;
+  Poco::PipeInputStream marker_stream_;
+  std::thread log_thread_;
+  std::mutex log_mtx_;
+  LogHandler log_handler_{nullptr};
+  bool input_closed_{false};
+  bool used_{false};
+  bool exited_{false};
+};
+
+/**
+ * pool of pre-initialized task_main processes for PROCESS run mode,
+ * config and dataset service are initialized when the process starts,
+ * so a task dispatched to a warm process skips the startup of task_main.
+ * each process runs a single task, it is replaced after the task or when
+ * it is found dead, so no global state is shared between tasks
+*/
+class TaskProcessPool {
+ public:
+  TaskProcessPool(const std::string& node_id, const std::string& config_file,
+                  size_t pool_size);
+  /**
+   * pool of processes launched by execute_app with args
+  */
+  TaskProcessPool(const std::string& execute_app,
+                  const std::vector<std::string>& args, size_t pool_size);
+  ~TaskProcessPool();
+  /**
+   * take an idle process, nullptr if none is available,
+   * caller should launch a fresh process in this case
+  */
+  std::unique_ptr<TaskProcess> Acquire();
+  /**
+   * give the process back after running a task,
+   * a used process is dropped and a new one is spawned in its place
+  */
+  void Release(std::unique_ptr<TaskProcess> process);
+  size_t IdleNum();
+  /**
+   * record time from dispatch to task start for latency report
+  */
+  void RecordStartupLatency(bool reused, double startup_ms);
+  std::string LatencyReport();
+
+ private:
+  void Init();
+  std::unique_ptr<TaskProcess> Spawn();
+
+ private:
+  std::string execute_app_;
+  std::vector<std::string> args_;
+  size_t pool_size_{0};
+  std::mutex mtx_;
+  std::deque<std::unique_ptr<TaskProcess>> idle_processes_;
+  std::atomic<uint64_t> reuse_count_{0};
+  std::atomic<uint64_t> spawn_count_{0};
+  std::atomic<uint64_t> reuse_startup_us_{0};
+  std::atomic<uint64_t> spawn_startup_us_{0};
+};
+}  // namespace primihub
+#endif  // SRC_PRIMIHUB_NODE_WORKER_TASK_PROCESS_POOL_H_
@@ -24,6 +24,7 @@
 #include "src/primihub/util/proto_log_helper.h"
 #include "Poco/PipeStream.h"
 #include "Poco/StreamCopier.h"
+#include "src/primihub/task_engine/task_process_protocol.h"
 
 using TaskFactory = primihub::task::TaskFactory;
 using Process = Poco::Process;
@@ -157,6 +158,18 @@ retcode Worker::ExecuteTaskByProcess(const PushTaskRequest* task_request) {
   }
   std::string request_base64_str = base64_encode(task_config_str);
 
+  auto& pool = nodelet->GetTaskProcessPool();
+  // python interpreter can not be reinitialized in the same process
+  if (pool != nullptr &&
+      send_request.task().language() != rpc::Language::PYTHON) {
+    auto process = pool->Acquire();
+    if (process != nullptr) {
+      return ExecuteTaskByPooledProcess(request_base64_str, task_info,
+                                        std::move(process));
+    }
+    VLOG(2) << TASK_INFO_STR << "no idle task process, launch a new one";
+  }
+
   // std::future<std::string> data;
   std::string current_process_dir = getCurrentProcessDir();
   VLOG(5) << TASK_INFO_STR << "current_process_dir: " << current_process_dir;
@@ -168,6 +181,7 @@ retcode Worker::ExecuteTaskByProcess(const PushTaskRequest* task_request) {
   args.push_back("--request=" + request_base64_str);
   args.push_back("--request_id=" + task_info.request_id());
   // using POCO process
+  SCopedTimer timer;
   Poco::Pipe outPipe;
   auto handle_ = Process::launch(execute_app, args, 0, &outPipe, &outPipe);
   Poco::PipeInputStream istr(outPipe);
@@ -180,22 +194,12 @@ retcode Worker::ExecuteTaskByProcess(const PushTaskRequest* task_request) {
     if (log_content.empty()) {
       continue;
     }
-    const char* log_data = log_content.data();
-    size_t log_length = log_content.size();
-    auto log_sv = std::string_view(log_data, log_length);
-    char first_ch = log_sv[0];
-    if ((first_ch == 'I' ||
-         first_ch == 'W' || first_ch == 'E')) {    // glog format
-      size_t name_pos = log_sv.find(']');
-      auto prefix_content =
-          std::string_view(log_data, name_pos+1);
-      auto output_log =
-          std::string_view(log_data + name_pos + 1, log_length-name_pos);
-      std::cout << prefix_content << " "
-                << TASK_INFO_STR << output_log << std::endl;
-    } else {
-      LOG(INFO) << TASK_INFO_STR << log_content;
+    if (task_engine::IsTaskMarker(log_content,
+                                  task_engine::kTaskStartedMarker)) {
+      ReportStartupLatency(TASK_INFO_STR, false, timer.timeElapse());
+      continue;
     }
+    ForwardTaskLog(TASK_INFO_STR, log_content);
   }
   try {
     int ret = handle_.wait();
@@ -212,6 +216,62 @@ retcode Worker::ExecuteTaskByProcess(const PushTaskRequest* task_request) {
   return retcode::SUCCESS;
 }
 
+retcode Worker::ExecuteTaskByPooledProcess(
+    const std::string& request_base64_str,
+    const rpc::TaskContext& task_info,
+    std::unique_ptr<TaskProcess> process) {
+  std::string TASK_INFO_STR = pb_util::TaskInfoToString(task_info);
+  process_handler_ = std::make_unique<ProcessHandle>(process->Handle());
+  task_ready_promise_.set_value(true);
+  LOG(INFO) << TASK_INFO_STR << "Worker start execute task in warm process";
+  double startup_ms{0};
+  auto ret = process->Run(
+      request_base64_str,
+      [&](const std::string& log_content) {
+        ForwardTaskLog(TASK_INFO_STR, log_content);
+      },
+      &startup_ms);
+  process_handler_.reset();
+  ReportStartupLatency(TASK_INFO_STR, true, startup_ms);
+  nodelet->GetTaskProcessPool()->Release(std::move(process));
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << TASK_INFO_STR << "run task in warm process failed";
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+void Worker::ForwardTaskLog(const std::string& TASK_INFO_STR,
+                            const std::string& log_content) {
+  const char* log_data = log_content.data();
+  size_t log_length = log_content.size();
+  auto log_sv = std::string_view(log_data, log_length);
+  char first_ch = log_sv[0];
+  if ((first_ch == 'I' ||
+       first_ch == 'W' || first_ch == 'E')) {    // glog format
+    size_t name_pos = log_sv.find(']');
+    auto prefix_content =
+        std::string_view(log_data, name_pos+1);
+    auto output_log =
+        std::string_view(log_data + name_pos + 1, log_length-name_pos);
+    std::cout << prefix_content << " "
+              << TASK_INFO_STR << output_log << std::endl;
+  } else {
+    LOG(INFO) << TASK_INFO_STR << log_content;
+  }
+}
+
+void Worker::ReportStartupLatency(const std::string& TASK_INFO_STR,
+                                  bool reused, double startup_ms) {
+  LOG(INFO) << TASK_INFO_STR << "task startup cost(ms): " << startup_ms << " "
+            << "mode: " << (reused ? "reuse" : "spawn");
+  auto& pool = nodelet->GetTaskProcessPool();
+  if (pool != nullptr) {
+    pool->RecordStartupLatency(reused, startup_ms);
+    VLOG(2) << pool->LatencyReport();
+  }
+}
+
 // kill task which is running in the worker
 void Worker::kill_task() {
   if (task_ptr) {
@@ -234,12 +294,54 @@ retcode Worker::fetchTaskStatus(rpc::TaskStatus* task_status) {
   return retcode::FAIL;
 }
 
+retcode Worker::waitTaskStatus(size_t* cursor, rpc::TaskStatus* task_status,
+                               std::chrono::milliseconds timeout) {
+  {
+    std::unique_lock<std::mutex> lck(status_history_mtx_);
+    bool has_new_status = status_history_cv_.wait_for(lck, timeout, [&]() {
+      return *cursor < status_history_.size();
+    });
+    if (!has_new_status) {
+      return retcode::FAIL;
+    }
+    *task_status = status_history_[*cursor];
+    (*cursor)++;
+  }
+  const auto& task_info = task_status->task_info();
+  auto TASK_INFO_STR = pb_util::TaskInfoToString(task_info);
+  VLOG(2) << TASK_INFO_STR << " "
+          << "New Status: " << pb_util::TaskStatusToString(*task_status);
+  return retcode::SUCCESS;
+}
+
+std::vector<rpc::TaskStatus> Worker::finalTaskStatus() {
+  std::vector<rpc::TaskStatus> final_status;
+  std::lock_guard<std::mutex> lck(status_history_mtx_);
+  for (const auto& task_status : status_history_) {
+    if (task_status.status() == rpc::TaskStatus::SUCCESS ||
+        task_status.status() == rpc::TaskStatus::FAIL) {
+      final_status.push_back(task_status);
+    }
+  }
+  return final_status;
+}
+
 retcode Worker::updateTaskStatus(const rpc::TaskStatus& task_status) {
   const auto& status_code = task_status.status();
   const auto& party = task_status.party();
   const auto& status_msg = task_status.message();
   const auto& task_info = task_status.task_info();
   auto TASK_INFO_STR = pb_util::TaskInfoToString(task_info);
+  VLOG(0) << TASK_INFO_STR
+          << "Update " << pb_util::TaskStatusToString(task_status);
+  // queue the status before marking the scheduler finished,
+  // so watchers see it once they observe the finished flag
+  task_status_.push(task_status);
+  {
+    std::lock_guard<std::mutex> lck(status_history_mtx_);
+    status_history_.push_back(task_status);
+  }
+  status_history_cv_.notify_all();
   if (status_code == rpc::TaskStatus::SUCCESS ||
       status_code == rpc::TaskStatus::FAIL) {
     std::unique_lock<std::shared_mutex> lck(final_status_mtx_);
@@ -262,9 +364,6 @@ retcode Worker::updateTaskStatus(const rpc::TaskStatus& task_status) {
     VLOG(0) << TASK_INFO_STR
             << "collected finished party count: " << final_status_.size();
   }
-  VLOG(0) << TASK_INFO_STR
-          << "Update " << pb_util::TaskStatusToString(task_status);
-  task_status_.push(task_status);
   return retcode::SUCCESS;
 }
 
@@ -27,8 +27,10 @@
 #include <unordered_map>
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <numeric>
 #include <thread>
@@ -89,6 +91,22 @@ class Worker {
 
   // scheduler method
   retcode fetchTaskStatus(rpc::TaskStatus* task_status);
+  /**
+   * wait at most timeout for the status at *cursor of the status history and
+   * advance the cursor, each watcher keeps its own cursor so statuses are
+   * not consumed. return FAIL if no new status arrives in time
+  */
+  retcode waitTaskStatus(size_t* cursor, rpc::TaskStatus* task_status,
+                         std::chrono::milliseconds timeout);
+  /**
+   * SUCCESS or FAIL status of each party which has finished
+  */
+  std::vector<rpc::TaskStatus> finalTaskStatus();
+  /**
+   * all parties have reported final status or one of them failed,
+   * statuses which lead to it have been queued already
+  */
+  bool isSchedulerFinished() {return scheduler_finished.load();}
   retcode updateTaskStatus(const rpc::TaskStatus& task_status);
   retcode waitUntilTaskFinish();
   void setPartyCount(size_t party_count) {party_count_ = party_count;}
@@ -97,6 +115,16 @@ class Worker {
 
  protected:
   TaskRunMode ExecuteMode(const PushTaskRequest& request);
+  /**
+   * run task in a warm process taken from the task process pool
+  */
+  retcode ExecuteTaskByPooledProcess(const std::string& request_base64_str,
+                                     const rpc::TaskContext& task_info,
+                                     std::unique_ptr<TaskProcess> process);
+  void ForwardTaskLog(const std::string& TASK_INFO_STR,
+                      const std::string& log_content);
+  void ReportStartupLatency(const std::string& TASK_INFO_STR,
+                            bool reused, double startup_ms);
 
  private:
   std::unordered_map<std::string, std::shared_ptr<Worker>> workers_
@@ -112,7 +140,12 @@ class Worker {
   std::future<bool> task_ready_future_;
 
   // scheduler data
+  // consumed by FetchTaskStatus
   ThreadSafeQueue<rpc::TaskStatus> task_status_;
+  // every status in arrival order, read by watchers through their cursor
+  std::mutex status_history_mtx_;
+  std::condition_variable status_history_cv_;
+  std::vector<rpc::TaskStatus> status_history_;
   std::shared_mutex final_status_mtx_;
   std::map<std::string, std::string> final_status_;
   std::promise<retcode> task_finish_promise_;
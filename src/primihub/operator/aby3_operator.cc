@@ -278,6 +278,60 @@ si64Matrix MPCOperator::MPC_Mul_Const(const i64 &constInt,
   return ret;
 }
 
+bool MPCOperator::MaxOrMinOutOfBound(bool local_out_of_bound) {
+  i64Matrix flag(1, 1);
+  flag(0, 0) = local_out_of_bound ? 1 : 0;
+  si64Matrix count(1, 1);
+  for (u64 pid = 0; pid < 3; pid++) {
+    si64Matrix sh_flag(1, 1);
+    if (pid == partyIdx) {
+      createShares(flag, sh_flag);
+    } else {
+      createShares(sh_flag);
+    }
+    if (pid == 0) {
+      count = sh_flag;
+    } else {
+      count = count + sh_flag;
+    }
+  }
+  return revealAll(count)(0, 0) != 0;
+}
+
+sbMatrix MPCOperator::MPC_SignBit(const si64Matrix& x) {
+  // party i holds x_i and x_{i-1}
+  u64 num_elem = x.rows() * x.cols();
+  i64Matrix local(num_elem, 1);
+  sbMatrix sh_lhs(num_elem, VAL_BITCOUNT);
+  if (partyIdx == 0) {
+    for (u64 i = 0; i < num_elem; i++) {
+      local(i, 0) = x.mShares[0](i) + x.mShares[1](i);
+    }
+    enc.localBinMatrix(runtime.noDependencies(), local, sh_lhs).get();
+  } else {
+    enc.remoteBinMatrix(runtime.noDependencies(), sh_lhs).get();
+  }
+  sbMatrix sh_rhs(num_elem, VAL_BITCOUNT);
+  if (partyIdx == 1) {
+    for (u64 i = 0; i < num_elem; i++) {
+      local(i, 0) = x.mShares[0](i);
+    }
+    enc.localBinMatrix(runtime.noDependencies(), local, sh_rhs).get();
+  } else {
+    enc.remoteBinMatrix(runtime.noDependencies(), sh_rhs).get();
+  }
+
+  KoggeStoneLibrary lib;
+  BetaCircuit *cir = lib.int_int_add_msb(VAL_BITCOUNT);
+  cir->levelByAndDepth();
+  sbMatrix sign(num_elem, 1);
+  std::vector<const sbMatrix *> input = {&sh_lhs, &sh_rhs};
+  std::vector<sbMatrix *> output = {&sign};
+  binEval.asyncEvaluate(runtime.noDependencies(), cir, gen, input, output)
+      .get();
+  return sign;
+}
+
 void MPCOperator::MPC_Compare(i64Matrix &m, sbMatrix &sh_res) {
   // Get matrix shape of all party.
   std::vector<std::array<uint64_t, 2>> all_party_shape;
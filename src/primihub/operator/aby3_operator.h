@@ -495,6 +495,90 @@ class MPCOperator {
     mdivision.eval<D>(runtime.noDependencies(), Y, out, eval);
     return out;
   }
+  /**
+   * inputs of MPC_MaxOrMin must be inside [-kMaxOrMinBound, kMaxOrMinBound],
+   * so the difference of two inputs is at most 2^46 and its D16 fixed point
+   * 2^62 keeps the sign bit. +-kMaxOrMinBound is also the sentinel of
+   * parties without data
+   */
+  static constexpr double kMaxOrMinBound = 35184372088832.0;  // 2^45
+  /**
+   * whether any party has an input out of the bound of MPC_MaxOrMin,
+   * only the number of such parties is revealed.
+   * all parties have to call it, so they reject the inputs together
+   */
+  bool MaxOrMinOutOfBound(bool local_out_of_bound);
+  /**
+   * shared sign bits of x, 1 if x < 0.
+   * party 0 holds x0 + x2 and party 1 holds x1 of x = x0 + x1 + x2,
+   * both are shared in binary and added by a msb circuit
+   */
+  sbMatrix MPC_SignBit(const si64Matrix& x);
+  /**
+   * element-wise max (is_max) or min of shared matrices of the same shape.
+   * values are compared pairwise in a tournament, each level evaluates the
+   * comparisons of all pairs and all elements in one msb circuit, so the
+   * rounds grow with log2(values.size()) only. the winner is selected by
+   * multiplying the comparison bit with the difference (bit injection),
+   * which needs no truncation.
+   * neither the comparison results nor the winners are revealed
+   */
+  template <Decimal D>
+  sf64Matrix<D> MPC_MaxOrMin(std::vector<sf64Matrix<D>> values, bool is_max) {
+    if (values.empty()) {
+      RaiseException("no value for MPC_MaxOrMin");
+    }
+    u64 rows = values[0].rows();
+    u64 cols = values[0].cols();
+    for (const auto& value : values) {
+      if (value.rows() != rows || value.cols() != cols) {
+        RaiseException("sf64Matrix, Shape does not match in MPC_MaxOrMin");
+      }
+    }
+    u64 elem_num = rows * cols;
+    while (values.size() > 1) {
+      u64 pair_num = values.size() / 2;
+      // stack lhs - rhs of all pairs of this level into one column
+      si64Matrix diff(pair_num * elem_num, 1);
+      for (u64 i = 0; i < pair_num; i++) {
+        for (u64 k = 0; k < 2; k++) {
+          const auto& lhs = values[2 * i][k];
+          const auto& rhs = values[2 * i + 1][k];
+          for (u64 j = 0; j < elem_num; j++) {
+            diff.mShares[k](i * elem_num + j, 0) = lhs(j) - rhs(j);
+          }
+        }
+      }
+      // lhs < rhs ? 1 : 0
+      sbMatrix lt = MPC_SignBit(diff);
+      si64Matrix delta(diff.rows(), 1);
+      eval.asyncMul(runtime.noDependencies(), diff, lt, delta).get();
+      // max: lhs - lt * (lhs - rhs), min: rhs + lt * (lhs - rhs)
+      std::vector<sf64Matrix<D>> winners;
+      winners.reserve(pair_num + 1);
+      for (u64 i = 0; i < pair_num; i++) {
+        sf64Matrix<D> winner(rows, cols);
+        for (u64 k = 0; k < 2; k++) {
+          winner[k] = is_max ? values[2 * i][k] : values[2 * i + 1][k];
+          for (u64 j = 0; j < elem_num; j++) {
+            auto delta_j = delta.mShares[k](i * elem_num + j, 0);
+            if (is_max) {
+              winner[k](j) -= delta_j;
+            } else {
+              winner[k](j) += delta_j;
+            }
+          }
+        }
+        winners.emplace_back(std::move(winner));
+      }
+      if (values.size() % 2 == 1) {
+        winners.emplace_back(std::move(values.back()));
+      }
+      values = std::move(winners);
+    }
+    return std::move(values[0]);
+  }
+
   // >0.5
   template <Decimal D>
   eMatrix<i64> MPC_Pow(const sf64Matrix<D> &Y) {
@@ -483,6 +483,127 @@ void opt_paillier_pack_add_warpper(
     opt_paillier_freepubkey(pub);
 }
 
+namespace native = primihub::opt_paillier;
+using Int64Array = py::array_t<int64_t, py::array::c_style | py::array::forcecast>;
+
+std::vector<int64_t> int64_array_2_vector(const Int64Array& py_array) {
+    auto buf = py_array.request();
+    const int64_t* data = static_cast<const int64_t*>(buf.ptr);
+    return std::vector<int64_t>(data, data + buf.size);
+}
+
+py::tuple opt_paillier_keygen_native(int k_sec) {
+    native::PublicKeyPtr pub;
+    native::SecretKeyPtr prv;
+    {
+        py::gil_scoped_release release;
+        native::KeyGen(k_sec, &pub, &prv);
+    }
+    return py::make_tuple(pub, prv);
+}
+
+std::unique_ptr<native::CiphertextVector> opt_paillier_encrypt_batch(
+    const native::PublicKey& pub,
+    const Int64Array& py_plain_texts,
+    const native::SecretKey* prv) {
+    auto plain_texts = int64_array_2_vector(py_plain_texts);
+    py::gil_scoped_release release;
+    return native::EncryptBatch(pub, prv, plain_texts.data(), plain_texts.size());
+}
+
+Int64Array opt_paillier_decrypt_batch(
+    const native::PublicKey& pub,
+    const native::SecretKey& prv,
+    const native::CiphertextVector& cipher_texts) {
+    std::vector<int64_t> result(cipher_texts.size());
+    {
+        py::gil_scoped_release release;
+        native::DecryptBatch(pub, prv, cipher_texts, result.data());
+    }
+    return Int64Array(result.size(), result.data());
+}
+
+std::unique_ptr<native::CiphertextVector> opt_paillier_add_batch(
+    const native::PublicKey& pub,
+    const native::CiphertextVector& op1,
+    const native::CiphertextVector& op2) {
+    py::gil_scoped_release release;
+    return native::AddBatch(pub, op1, op2);
+}
+
+std::unique_ptr<native::CiphertextVector> opt_paillier_cons_mul_batch(
+    const native::PublicKey& pub,
+    const native::CiphertextVector& cipher_texts,
+    const Int64Array& py_cons_values) {
+    auto cons_values = int64_array_2_vector(py_cons_values);
+    py::gil_scoped_release release;
+    return native::ConstMulBatch(pub, cipher_texts,
+                                 cons_values.data(), cons_values.size());
+}
+
+void bind_opt_paillier_native(py::module_& m) {
+    py::class_<native::PublicKey, native::PublicKeyPtr>(m, "OptPaillierPublicKey")
+        .def_static("from_legacy",
+             [](const py::object& py_pub) {
+                 return std::make_shared<native::PublicKey>(py_pub_2_cpp_pub(py_pub));
+             },
+             "convert a public key returned by opt_paillier_keygen_warpper")
+        .def_property_readonly("nbits",
+             [](const native::PublicKey& pub) { return pub.get()->nbits; })
+        .def_property_readonly("n",
+             [](const native::PublicKey& pub) {
+                 char* n = mpz_get_str(nullptr, BASE, pub.get()->n);
+                 std::string res(n);
+                 free(n);
+                 return res;
+             });
+
+    py::class_<native::SecretKey, native::SecretKeyPtr>(m, "OptPaillierSecretKey")
+        .def_static("from_legacy",
+             [](const py::object& py_prv) {
+                 return std::make_shared<native::SecretKey>(py_prv_2_cpp_prv(py_prv));
+             },
+             "convert a secret key returned by opt_paillier_keygen_warpper");
+
+    py::class_<native::CiphertextVector>(m, "OptPaillierCiphertextVector")
+        .def("__len__", &native::CiphertextVector::size)
+        .def("to_strings",
+             [](const native::CiphertextVector& self) {
+                 std::vector<std::string> res;
+                 {
+                     py::gil_scoped_release release;
+                     res = self.ToStrings();
+                 }
+                 return res;
+             },
+             "ciphertexts as decimal strings, for serialization")
+        .def_static("from_strings",
+             &native::CiphertextVector::FromStrings,
+             "rebuild ciphertexts from decimal strings");
+
+    m.def("opt_paillier_keygen_native",
+         &opt_paillier_keygen_native,
+         "generate opt paillier keys as native handles",
+         py::arg("k_sec") = 112);
+
+    m.def("opt_paillier_encrypt_batch",
+         &opt_paillier_encrypt_batch,
+         "encrypt an int64 array, use CRT and fixed-base if prv is given",
+         py::arg("pub"), py::arg("plain_texts"), py::arg("prv") = nullptr);
+
+    m.def("opt_paillier_decrypt_batch",
+         &opt_paillier_decrypt_batch,
+         "decrypt a ciphertext vector into an int64 array");
+
+    m.def("opt_paillier_add_batch",
+         &opt_paillier_add_batch,
+         "add two ciphertext vectors element-wise");
+
+    m.def("opt_paillier_cons_mul_batch",
+         &opt_paillier_cons_mul_batch,
+         "multiply ciphertexts with an int64 array or a single int64 constant");
+}
+
 PYBIND11_MODULE(opt_paillier_c2py, m) {
     m.doc() = "opt paillier cpp to python plugin"; // optional module docstring
 
@@ -525,4 +646,6 @@ PYBIND11_MODULE(opt_paillier_c2py, m) {
     m.def("opt_paillier_pack_add_warpper",
          &opt_paillier_pack_add_warpper,
          "A opt paillier add function that add two pack ciphertext");
+
+    bind_opt_paillier_native(m);
 }
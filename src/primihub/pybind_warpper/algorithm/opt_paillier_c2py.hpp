@@ -1,7 +1,10 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 #include <iostream>
 #include "src/primihub/algorithm/opt_paillier/include/paillier.h"
 #include "src/primihub/algorithm/opt_paillier/include/crt_datapack.h"
+#include "src/primihub/pybind_warpper/algorithm/opt_paillier_native.h"
 #include <string>
 
 #define BASE 10
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2023 by PrimiHub
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      https://www.apache.org/licenses/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "src/primihub/pybind_warpper/algorithm/opt_paillier_native.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "src/primihub/algorithm/opt_paillier/include/paillier_batch.h"
+
+namespace primihub::opt_paillier {
+namespace {
+opt_paillier_batch& BatchEngine() {
+  static opt_paillier_batch engine;
+  return engine;
+}
+
+/**
+ * x or n - |x| for negative x
+*/
+std::unique_ptr<CiphertextVector> EncodePlaintexts(
+    const opt_public_key_t* pub, const int64_t* plain_texts, size_t num) {
+  auto result = std::make_unique<CiphertextVector>(num);
+  ParallelFor(num, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      mpz_set_si(result->at(i), plain_texts[i]);
+      if (plain_texts[i] < 0) {
+        mpz_add(result->at(i), result->at(i), pub->n);
+      }
+    }
+  });
+  return result;
+}
+}  // namespace
+
+PublicKey::~PublicKey() {
+  if (pub_ != nullptr) {
+    opt_paillier_freepubkey(pub_);
+  }
+}
+
+SecretKey::~SecretKey() {
+  if (prv_ != nullptr) {
+    opt_paillier_freeprvkey(prv_);
+  }
+}
+
+CiphertextVector::CiphertextVector(size_t size) : data_(size) {
+  for (auto& item : data_) {
+    mpz_init(&item);
+  }
+}
+
+CiphertextVector::~CiphertextVector() {
+  for (auto& item : data_) {
+    mpz_clear(&item);
+  }
+}
+
+std::vector<std::string> CiphertextVector::ToStrings() const {
+  std::vector<std::string> result(size());
+  ParallelFor(size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      char* str = mpz_get_str(nullptr, 10, at(i));
+      result[i] = str;
+      void (*free_func)(void*, size_t);
+      mp_get_memory_functions(nullptr, nullptr, &free_func);
+      free_func(str, result[i].size() + 1);
+    }
+  });
+  return result;
+}
+
+std::unique_ptr<CiphertextVector> CiphertextVector::FromStrings(
+    const std::vector<std::string>& cipher_texts) {
+  auto result = std::make_unique<CiphertextVector>(cipher_texts.size());
+  for (size_t i = 0; i < cipher_texts.size(); i++) {
+    if (mpz_set_str(result->at(i), cipher_texts[i].c_str(), 10) != 0) {
+      throw std::invalid_argument(
+          "invalid ciphertext at index " + std::to_string(i));
+    }
+  }
+  return result;
+}
+
+void KeyGen(uint32_t k_sec, PublicKeyPtr* pub, SecretKeyPtr* prv) {
+  opt_public_key_t* cpp_pub{nullptr};
+  opt_secret_key_t* cpp_prv{nullptr};
+  opt_paillier_keygen(k_sec, &cpp_pub, &cpp_prv);
+  *pub = std::make_shared<PublicKey>(cpp_pub);
+  *prv = std::make_shared<SecretKey>(cpp_prv);
+}
+
+void ParallelFor(size_t num,
+                 const std::function<void(size_t begin, size_t end)>& fn) {
+  BatchEngine().parallel_for(num, fn);
+}
+
+std::unique_ptr<CiphertextVector> EncryptBatch(
+    const PublicKey& pub, const SecretKey* prv,
+    const int64_t* plain_texts, size_t num) {
+  auto result = EncodePlaintexts(pub.get(), plain_texts, num);
+  if (prv != nullptr) {
+    BatchEngine().encrypt_crt_fb(result->data(), result->data(), num,
+                                 pub.get(), prv->get());
+  } else {
+    BatchEngine().encrypt(result->data(), result->data(), num, pub.get());
+  }
+  return result;
+}
+
+void DecryptBatch(const PublicKey& pub, const SecretKey& prv,
+                  const CiphertextVector& cipher_texts, int64_t* result) {
+  CiphertextVector plain_texts(cipher_texts.size());
+  BatchEngine().decrypt_crt(plain_texts.data(), cipher_texts.data(),
+                            cipher_texts.size(), pub.get(), prv.get());
+  ParallelFor(plain_texts.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      mpz_ptr plain_text = plain_texts.at(i);
+      if (mpz_cmp(plain_text, pub.get()->half_n) >= 0) {
+        mpz_sub(plain_text, plain_text, pub.get()->n);
+      }
+      if (!mpz_fits_slong_p(plain_text)) {
+        throw std::overflow_error(
+            "plaintext at index " + std::to_string(i) + " exceeds int64");
+      }
+      result[i] = mpz_get_si(plain_text);
+    }
+  });
+}
+
+std::unique_ptr<CiphertextVector> AddBatch(
+    const PublicKey& pub,
+    const CiphertextVector& op1, const CiphertextVector& op2) {
+  if (op1.size() != op2.size()) {
+    throw std::invalid_argument(
+        "size mismatch: " + std::to_string(op1.size()) + " vs " +
+        std::to_string(op2.size()));
+  }
+  auto result = std::make_unique<CiphertextVector>(op1.size());
+  BatchEngine().add(result->data(), op1.data(), op2.data(), op1.size(),
+                    pub.get());
+  return result;
+}
+
+std::unique_ptr<CiphertextVector> ConstMulBatch(
+    const PublicKey& pub, const CiphertextVector& cipher_texts,
+    const int64_t* consts, size_t const_num) {
+  size_t num = cipher_texts.size();
+  if (const_num != 1 && const_num != num) {
+    throw std::invalid_argument(
+        "size mismatch: " + std::to_string(num) + " vs " +
+        std::to_string(const_num));
+  }
+  std::vector<int64_t> broadcast;
+  if (const_num == 1 && num != 1) {
+    broadcast.assign(num, consts[0]);
+    consts = broadcast.data();
+  }
+  auto result = EncodePlaintexts(pub.get(), consts, num);
+  BatchEngine().constant_mul(result->data(), cipher_texts.data(),
+                             result->data(), num, pub.get());
+  return result;
+}
+}  // namespace primihub::opt_paillier
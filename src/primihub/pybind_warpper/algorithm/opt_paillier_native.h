@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023 by PrimiHub
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      https://www.apache.org/licenses/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SRC_PRIMIHUB_PYBIND_WARPPER_ALGORITHM_OPT_PAILLIER_NATIVE_H_
+#define SRC_PRIMIHUB_PYBIND_WARPPER_ALGORITHM_OPT_PAILLIER_NATIVE_H_
+#include <gmp.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/primihub/algorithm/opt_paillier/include/paillier.h"
+
+namespace primihub::opt_paillier {
+/**
+ * public key kept in GMP form on the native side,
+ * python only holds an opaque handle of it
+*/
+class PublicKey {
+ public:
+  explicit PublicKey(opt_public_key_t* pub) : pub_(pub) {}
+  ~PublicKey();
+  PublicKey(const PublicKey&) = delete;
+  PublicKey& operator=(const PublicKey&) = delete;
+  const opt_public_key_t* get() const {return pub_;}
+
+ private:
+  opt_public_key_t* pub_{nullptr};
+};
+
+class SecretKey {
+ public:
+  explicit SecretKey(opt_secret_key_t* prv) : prv_(prv) {}
+  ~SecretKey();
+  SecretKey(const SecretKey&) = delete;
+  SecretKey& operator=(const SecretKey&) = delete;
+  const opt_secret_key_t* get() const {return prv_;}
+
+ private:
+  opt_secret_key_t* prv_{nullptr};
+};
+
+/**
+ * fixed size vector of ciphertexts, elements are initialized to 0.
+ * also used for encoded plaintexts passed to the batch engine
+*/
+class CiphertextVector {
+ public:
+  explicit CiphertextVector(size_t size);
+  ~CiphertextVector();
+  CiphertextVector(const CiphertextVector&) = delete;
+  CiphertextVector& operator=(const CiphertextVector&) = delete;
+  size_t size() const {return data_.size();}
+  mpz_ptr at(size_t i) {return &data_[i];}
+  mpz_srcptr at(size_t i) const {return &data_[i];}
+  mpz_t* data() {return reinterpret_cast<mpz_t*>(data_.data());}
+  const mpz_t* data() const {
+    return reinterpret_cast<const mpz_t*>(data_.data());
+  }
+  /**
+   * decimal strings, compatible with the legacy ciphertext object
+  */
+  std::vector<std::string> ToStrings() const;
+  static std::unique_ptr<CiphertextVector> FromStrings(
+      const std::vector<std::string>& cipher_texts);
+
+ private:
+  std::vector<__mpz_struct> data_;
+};
+
+using PublicKeyPtr = std::shared_ptr<PublicKey>;
+using SecretKeyPtr = std::shared_ptr<SecretKey>;
+
+void KeyGen(uint32_t k_sec, PublicKeyPtr* pub, SecretKeyPtr* prv);
+
+/**
+ * batch operations below run on a process wide opt_paillier_batch and do not
+ * touch any python object, so the caller can release the GIL.
+ * encryption uses CRT and fixed-base precomputation if prv is given.
+ * negative plaintexts and constants are mapped to n - |x|
+*/
+std::unique_ptr<CiphertextVector> EncryptBatch(
+    const PublicKey& pub, const SecretKey* prv,
+    const int64_t* plain_texts, size_t num);
+/**
+ * throw std::overflow_error if a plaintext does not fit in int64
+*/
+void DecryptBatch(const PublicKey& pub, const SecretKey& prv,
+                  const CiphertextVector& cipher_texts, int64_t* result);
+std::unique_ptr<CiphertextVector> AddBatch(
+    const PublicKey& pub,
+    const CiphertextVector& op1, const CiphertextVector& op2);
+/**
+ * multiply each ciphertext with the constant of the same position,
+ * a single constant is broadcast to all ciphertexts
+*/
+std::unique_ptr<CiphertextVector> ConstMulBatch(
+    const PublicKey& pub, const CiphertextVector& cipher_texts,
+    const int64_t* consts, size_t const_num);
+
+/**
+ * run fn(begin, end) on chunks of [0, num) and wait for all of them
+*/
+void ParallelFor(size_t num,
+                 const std::function<void(size_t begin, size_t end)>& fn);
+}  // namespace primihub::opt_paillier
+#endif  // SRC_PRIMIHUB_PYBIND_WARPPER_ALGORITHM_OPT_PAILLIER_NATIVE_H_
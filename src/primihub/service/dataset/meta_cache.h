@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2023 by PrimiHub
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      https://www.apache.org/licenses/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_PRIMIHUB_SERVICE_DATASET_META_CACHE_H_
+#define SRC_PRIMIHUB_SERVICE_DATASET_META_CACHE_H_
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "src/primihub/common/common.h"
+
+namespace primihub::service {
+/**
+ * LRU cache of dataset meta info resolved from meta service.
+ * entries expire after ttl, because the meta may be updated by other nodes.
+ * every invalidation bumps the version, a meta resolved before that
+ * is rejected by Put, so a stale meta never overwrites the invalidation
+*/
+class DatasetMetaCache {
+ public:
+  using Clock = std::chrono::steady_clock;
+  static constexpr size_t kDefaultCapacity = 1024;
+  static constexpr int64_t kDefaultTtlMs = 60 * 1000;
+
+  explicit DatasetMetaCache(size_t capacity = kDefaultCapacity,
+                            int64_t ttl_ms = kDefaultTtlMs)
+      : capacity_(capacity), ttl_(std::chrono::milliseconds(ttl_ms)) {}
+
+  /**
+   * capture the version before resolving a meta which will be put later
+  */
+  uint64_t Version() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return version_;
+  }
+
+  bool Get(const std::string& dataset_id, DatasetMetaInfo* meta_info) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    auto it = index_.find(dataset_id);
+    if (it == index_.end()) {
+      miss_count_++;
+      return false;
+    }
+    auto entry_it = it->second;
+    if (Clock::now() - entry_it->update_time >= ttl_) {
+      entries_.erase(entry_it);
+      index_.erase(it);
+      miss_count_++;
+      return false;
+    }
+    // move to the front as the most recently used
+    entries_.splice(entries_.begin(), entries_, entry_it);
+    *meta_info = entry_it->meta_info;
+    hit_count_++;
+    return true;
+  }
+
+  /**
+   * return false if the cache is invalidated after version is captured
+  */
+  bool Put(const std::string& dataset_id, const DatasetMetaInfo& meta_info,
+           uint64_t version) {
+    if (capacity_ == 0) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lck(mtx_);
+    if (version != version_ || ttl_ == Clock::duration::zero()) {
+      return false;
+    }
+    auto it = index_.find(dataset_id);
+    if (it != index_.end()) {
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+    entries_.push_front(Entry{dataset_id, meta_info, Clock::now()});
+    index_[dataset_id] = entries_.begin();
+    while (entries_.size() > capacity_) {
+      index_.erase(entries_.back().dataset_id);
+      entries_.pop_back();
+    }
+    return true;
+  }
+
+  void Invalidate(const std::string& dataset_id) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    version_++;
+    auto it = index_.find(dataset_id);
+    if (it != index_.end()) {
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    version_++;
+    entries_.clear();
+    index_.clear();
+  }
+
+  size_t Size() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return entries_.size();
+  }
+
+  /**
+   * ttl_ms <= 0 disables caching, entries already cached expire at once
+  */
+  void SetTtl(int64_t ttl_ms) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    ttl_ = std::chrono::milliseconds(ttl_ms > 0 ? ttl_ms : 0);
+  }
+
+  uint64_t HitCount() const {return hit_count_.load();}
+  uint64_t MissCount() const {return miss_count_.load();}
+
+ private:
+  struct Entry {
+    std::string dataset_id;
+    DatasetMetaInfo meta_info;
+    Clock::time_point update_time;
+  };
+  using EntryList = std::list<Entry>;
+
+  size_t capacity_{kDefaultCapacity};
+  Clock::duration ttl_;
+  std::mutex mtx_;
+  uint64_t version_{0};
+  EntryList entries_;
+  std::unordered_map<std::string, EntryList::iterator> index_;
+  std::atomic<uint64_t> hit_count_{0};
+  std::atomic<uint64_t> miss_count_{0};
+};
+}  // namespace primihub::service
+#endif  // SRC_PRIMIHUB_SERVICE_DATASET_META_CACHE_H_
@@ -45,6 +45,7 @@ retcode DatasetService::Init() {
   auto& node_cfg = ins.getNodeConfig();
 
   nodelet_addr_ = node_cfg.server_config.to_string();
+  meta_cache_.SetTtl(node_cfg.meta_cache_ttl_ms);
   return retcode::SUCCESS;
 }
 
@@ -66,6 +67,8 @@ DatasetService::newDataset(std::shared_ptr<primihub::DataDriver> driver,
                           const std::string& dataset_id,
                           const std::string& dataset_access_info,
                           DatasetMeta* meta) {
+  // the dataset is being replaced, do not serve the former meta any more
+  meta_cache_.Invalidate(dataset_id);
   // Read data using driver for get dataset & datameta
   // just get meta info from dataset
   // auto dataset = driver->getCursor()->read();
@@ -85,7 +88,7 @@ DatasetService::newDataset(std::shared_ptr<primihub::DataDriver> driver,
                       DatasetVisbility::PUBLIC,
                       dataset_access_info);
   // Save datameta in local storage.& Publish dataset meta on libp2p network.
-  auto ret = MetaService()->PutMeta(*meta);
+  auto ret = PutMeta(*meta);
   if (ret != retcode::SUCCESS) {
     LOG(ERROR) << "Put Meta data to meta service failed";
     return nullptr;
@@ -107,7 +110,7 @@ void DatasetService::writeDataset(const std::shared_ptr<primihub::Dataset> &data
     // dataset.write();
     // dataset->getDataDriver()->getCursor()->write(dataset);     // TODO(fix in future)
     meta = DatasetMeta(dataset, description, DatasetVisbility::PUBLIC, dataset_access_info);
-    MetaService()->PutMeta(meta);
+    PutMeta(meta);
 }
 
 
@@ -117,7 +120,7 @@ void DatasetService::writeDataset(const std::shared_ptr<primihub::Dataset> &data
  * @param meta [input]: Dataset meta
  */
 void DatasetService::regDataset(const DatasetMeta& meta) {
-    MetaService()->PutMeta(meta);
+    PutMeta(meta);
 }
 
 /**
@@ -164,6 +167,7 @@ retcode DatasetService::findDataset(const DatasetId& id,
  * @return int
  */
 retcode DatasetService::deleteDataset(const DatasetId& id) {
+  meta_cache_.Invalidate(id);
   return retcode::SUCCESS;
 }
 
@@ -234,7 +238,7 @@ void DatasetService::restoreDatasetFromLocalStorage() {
       // meta.setDataURL(nodelet_addr_ + ":" + dataset_path);
       meta.setServerInfo(nodelet_addr_);
       // Publish dataset meta on public network.
-      MetaService()->PutMeta(meta);
+      PutMeta(meta);
     } catch (std::exception& e) {
       LOG(ERROR) << e.what();
     }
@@ -249,6 +253,12 @@ std::string DatasetService::getNodeletAddr(void) {
   return nodelet_addr_;
 }
 
+retcode DatasetService::PutMeta(const DatasetMeta& meta) {
+  auto ret = MetaService()->PutMeta(meta);
+  meta_cache_.Invalidate(meta.id);
+  return ret;
+}
+
 primihub::retcode DatasetService::registerDriver(
     const std::string& dataset_id,
     std::shared_ptr<primihub::DataDriver> driver) {
@@ -260,19 +270,13 @@ primihub::retcode DatasetService::registerDriver(
   } else {
       driver_manager_.insert({dataset_id, std::move(driver)});
   }
+  meta_cache_.Invalidate(dataset_id);
   VLOG(5) << "dataset uid: " << dataset_id << " regiseter success";
   return primihub::retcode::SUCCESS;
 }
 
 std::shared_ptr<primihub::DataDriver>
 DatasetService::getDriver(const std::string& dataset_id, bool is_acces_info) {
-  // {
-  //   std::shared_lock<std::shared_mutex> lck(driver_mtx_);
-  //   auto it = driver_manager_.find(dataset_id);
-  //   if (it != driver_manager_.end()) {
-  //     return it->second;
-  //   }
-  // }
   if (is_acces_info) {
     DatasetMetaInfo meta_info;
     VLOG(5) << dataset_id;
@@ -299,12 +303,19 @@ DatasetService::getDriver(const std::string& dataset_id, bool is_acces_info) {
     }
   }
 
+  DatasetMetaInfo meta_info;
+  if (meta_cache_.Get(dataset_id, &meta_info)) {
+    VLOG(5) << "dataset: " << dataset_id << " meta cache hit, "
+            << "hit: " << meta_cache_.HitCount() << " "
+            << "miss: " << meta_cache_.MissCount();
+    return MakeDriver(meta_info);
+  }
   // get Meta using meta service
-  std::shared_ptr<primihub::DataDriver> driver{nullptr};
+  auto cache_version = meta_cache_.Version();
+  bool meta_found{false};
   MetaService()->GetMeta(dataset_id,
                         [&](std::shared_ptr<DatasetMeta> meta) -> retcode {
     if (meta) {
-      DatasetMetaInfo meta_info;
       meta_info.id = meta->id;
       meta_info.driver_type = meta->getDriverType();
       meta_info.access_info = meta->getAccessInfo();
@@ -317,24 +328,36 @@ DatasetService::getDriver(const std::string& dataset_id, bool is_acces_info) {
       }
       VLOG(5) << "driver_type: " << meta_info.driver_type << " "
           << "access_info: " << meta_info.access_info;
-      try {
-        auto access_info = createAccessInfo(meta_info.driver_type, meta_info);
-        driver = DataDirverFactory::getDriver(meta_info.driver_type,
-                                            DatasetLocation(),
-                                            std::move(access_info));
-      } catch (std::exception& e) {
-        LOG(ERROR) << e.what();
-        return retcode::FAIL;
-      }
+      meta_found = true;
       return retcode::SUCCESS;
     } else {
       LOG(ERROR) << "get dataset meta failed";
       return retcode::FAIL;
     }
   });
+  if (!meta_found) {
+    return nullptr;
+  }
+  auto driver = MakeDriver(meta_info);
+  if (driver != nullptr) {
+    meta_cache_.Put(dataset_id, meta_info, cache_version);
+  }
   return driver;
 }
 
+std::shared_ptr<DataDriver> DatasetService::MakeDriver(
+    const DatasetMetaInfo& meta_info) {
+  try {
+    auto access_info = createAccessInfo(meta_info.driver_type, meta_info);
+    return DataDirverFactory::getDriver(meta_info.driver_type,
+                                        DatasetLocation(),
+                                        std::move(access_info));
+  } catch (std::exception& e) {
+    LOG(ERROR) << e.what();
+    return nullptr;
+  }
+}
+
 primihub::retcode DatasetService::unRegisterDriver(
     const std::string& dataset_id) {
     std::lock_guard<std::shared_mutex> lck(driver_mtx_);
@@ -344,6 +367,7 @@ primihub::retcode DatasetService::unRegisterDriver(
       driver_manager_.erase(dataset_id);
   } else {  // do nothing
   }
+  meta_cache_.Invalidate(dataset_id);
   return primihub::retcode::SUCCESS;
 }
 
@@ -32,6 +32,7 @@
 #include "src/primihub/data_store/driver.h"
 #include "src/primihub/data_store/factory.h"
 #include "src/primihub/service/dataset/model.h"
+#include "src/primihub/service/dataset/meta_cache.h"
 #include "src/primihub/service/dataset/meta_service/interface.h"
 
 namespace primihub::service {
@@ -70,6 +71,10 @@ class DatasetService  {
   */
   const std::string& DatasetLocation() const {return nodelet_addr_;}
   DatasetMetaService* MetaService() {return meta_service_.get();}
+  /**
+   * meta info resolved by getDriver, hit/miss counters are exposed here
+  */
+  DatasetMetaCache* MetaCache() {return &meta_cache_;}
 
   // void listDataset() {}
 
@@ -94,6 +99,11 @@ class DatasetService  {
    * parameter initialization
   */
   retcode Init();
+  /**
+   * put meta to meta service and drop the cached one
+  */
+  retcode PutMeta(const DatasetMeta& meta);
+  std::shared_ptr<DataDriver> MakeDriver(const DatasetMetaInfo& meta_info);
 
  private:
   std::unique_ptr<DatasetMetaService> meta_service_{nullptr};
@@ -101,6 +111,8 @@ class DatasetService  {
   // use cache or not, maybe support in future
   std::shared_mutex driver_mtx_;
   std::unordered_map<std::string, std::shared_ptr<DataDriver>> driver_manager_;
+  // driver is not shared between tasks, only the resolved meta is cached
+  DatasetMetaCache meta_cache_;
 };
 
 }  // namespace primihub::service
@@ -15,6 +15,7 @@
 */
 #include "src/primihub/task/pybind_wrapper/mpc_task_wrapper.h"
 #include <glog/logging.h>
+#include <map>
 #include <random>
 #include <utility>
 #include "src/primihub/common/common.h"
@@ -44,6 +45,7 @@ MPCExecutor::MPCExecutor(const std::string& task_req_str,
 }
 
 MPCExecutor::~MPCExecutor() {
+  CloseSession();
 }
 
 void MPCExecutor::StopTask() {
@@ -98,6 +100,9 @@ retcode MPCExecutor::Max(const std::vector<double>& input,
   std::vector<int64_t> col_rows;
   col_rows.reserve(input.size());
   col_rows.assign(input.size(), 0);
+  if (InSession()) {
+    return ExecuteInSession(rpc::Algorithm::MAX, input, col_rows, result);
+  }
   return ExecuteStatisticsTask(rpc::Algorithm::MAX,
                                input, col_rows, result);
 }
@@ -107,6 +112,9 @@ retcode MPCExecutor::Min(const std::vector<double>& input,
   std::vector<int64_t> col_rows;
   col_rows.reserve(input.size());
   col_rows.assign(input.size(), 0);
+  if (InSession()) {
+    return ExecuteInSession(rpc::Algorithm::MIN, input, col_rows, result);
+  }
   return ExecuteStatisticsTask(rpc::Algorithm::MIN,
                                input, col_rows, result);
 }
@@ -114,6 +122,9 @@ retcode MPCExecutor::Min(const std::vector<double>& input,
 retcode MPCExecutor::Avg(const std::vector<double>& input,
                          const std::vector<int64_t>& col_rows,
                          std::vector<double>* result) {
+  if (InSession()) {
+    return ExecuteInSession(rpc::Algorithm::AVG, input, col_rows, result);
+  }
   return ExecuteStatisticsTask(rpc::Algorithm::AVG,
                                input, col_rows, result);
 }
@@ -123,6 +134,9 @@ retcode MPCExecutor::Sum(const std::vector<double>& input,
   std::vector<int64_t> col_rows;
   col_rows.reserve(input.size());
   col_rows.assign(input.size(), 0);
+  if (InSession()) {
+    return ExecuteInSession(rpc::Algorithm::SUM, input, col_rows, result);
+  }
   return ExecuteStatisticsTask(rpc::Algorithm::SUM,
                                input, col_rows, result);
 }
@@ -375,6 +389,172 @@ retcode MPCExecutor::ExecuteStatisticsTask(
   return retcode::SUCCESS;
 }
 
+retcode MPCExecutor::OpenSession() {
+  if (InSession()) {
+    return retcode::SUCCESS;
+  }
+  auto task_config = this->task_req_ptr_->mutable_task();
+  bool need_aux_server = NeedAuxiliaryServer(*task_config);
+  if (need_aux_server) {
+    std::string sub_task_id;
+    NegotiateSubTaskId(&sub_task_id);
+    task_config->mutable_task_info()->set_sub_task_id(sub_task_id);
+    // auxiliary server serves the session instead of a single statistics,
+    // the op type of each round is sent with the plan of the round
+    SetStatisticsOperation(rpc::Algorithm::MAX, task_config);
+    auto param_map = task_config->mutable_params()->mutable_param_map();
+    rpc::ParamValue pv;
+    pv.set_var_type(rpc::STRING);
+    pv.set_value_string("1");
+    (*param_map)[MPCTask::kSessionParamKey] = std::move(pv);
+    auto ret = InviteAuxiliaryServerToTask();
+    param_map->erase(MPCTask::kSessionParamKey);
+    if (ret != retcode::SUCCESS) {
+      LOG(ERROR) << "InviteAuxiliaryServerToTask failed";
+      return retcode::FAIL;
+    }
+  }
+  auto session_task = std::make_unique<MPCTask>(this->func_name_,
+                                                &(task_req_ptr_->task()));
+  auto ret = session_task->OpenSession();
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "open mpc session failed";
+    if (need_aux_server && IsLauncher(*task_config)) {
+      SendSessionPlan({});
+    }
+    return retcode::FAIL;
+  }
+  session_task_ = std::move(session_task);
+  session_round_ = 0;
+  return retcode::SUCCESS;
+}
+
+retcode MPCExecutor::ExecuteBatch(
+    const std::vector<StatisticsRequest>& requests,
+    std::vector<double>* result) {
+  // nothing to compute, every party returns before anything is sent.
+  // an empty plan would close the session of the auxiliary server
+  if (requests.empty()) {
+    result->clear();
+    return retcode::SUCCESS;
+  }
+  if (!InSession()) {
+    LOG(ERROR) << "session is not opened";
+    return retcode::FAIL;
+  }
+  // group requests by op type in the order of first appearance
+  std::vector<rpc::Algorithm::StatisticsOpType> op_types;
+  std::map<int, std::vector<size_t>> op_index;
+  for (size_t i = 0; i < requests.size(); i++) {
+    auto op_type = requests[i].op_type;
+    auto& index = op_index[op_type];
+    if (index.empty()) {
+      op_types.push_back(op_type);
+    }
+    index.push_back(i);
+  }
+  std::vector<int64_t> plan;
+  for (const auto op_type : op_types) {
+    plan.push_back(op_type);
+    plan.push_back(op_index[op_type].size());
+  }
+  if (NeedAuxiliaryServer(task_req_ptr_->task()) &&
+      IsLauncher(task_req_ptr_->task())) {
+    auto ret = SendSessionPlan(plan);
+    if (ret != retcode::SUCCESS) {
+      return retcode::FAIL;
+    }
+  }
+  session_round_++;
+  result->resize(requests.size());
+  for (const auto op_type : op_types) {
+    const auto& index = op_index[op_type];
+    std::vector<double> input;
+    std::vector<int64_t> col_rows;
+    input.reserve(index.size());
+    col_rows.reserve(index.size());
+    for (const auto i : index) {
+      input.push_back(requests[i].value);
+      col_rows.push_back(requests[i].rows);
+    }
+    std::vector<double> op_result;
+    auto ret = session_task_->ExecuteInSession(op_type, input, col_rows,
+                                               &op_result);
+    if (ret != retcode::SUCCESS || op_result.size() != index.size()) {
+      LOG(ERROR) << "run statistics op: " << op_type << " failed";
+      return retcode::FAIL;
+    }
+    for (size_t j = 0; j < index.size(); j++) {
+      (*result)[index[j]] = op_result[j];
+    }
+  }
+  return retcode::SUCCESS;
+}
+
+retcode MPCExecutor::ExecuteInSession(rpc::Algorithm::StatisticsOpType op_type,
+                                      const std::vector<double>& input,
+                                      const std::vector<int64_t>& col_rows,
+                                      std::vector<double>* result) {
+  std::vector<StatisticsRequest> requests;
+  requests.reserve(input.size());
+  for (size_t i = 0; i < input.size(); i++) {
+    requests.push_back(StatisticsRequest{op_type, input[i], col_rows[i]});
+  }
+  return ExecuteBatch(requests, result);
+}
+
+retcode MPCExecutor::CloseSession() {
+  if (!InSession()) {
+    return retcode::SUCCESS;
+  }
+  if (NeedAuxiliaryServer(task_req_ptr_->task()) &&
+      IsLauncher(task_req_ptr_->task())) {
+    SendSessionPlan({});
+  }
+  session_task_->CloseSession();
+  session_task_.reset();
+  return retcode::SUCCESS;
+}
+
+retcode MPCExecutor::SendSessionPlan(const std::vector<int64_t>& plan) {
+  const auto& task_config = this->task_req_ptr_->task();
+  const auto& party_access_info = task_config.party_access_info();
+  auto it = party_access_info.find(AUX_COMPUTE_NODE);
+  if (it == party_access_info.end()) {
+    LOG(ERROR) << AUX_COMPUTE_NODE << " access info is not found";
+    return retcode::FAIL;
+  }
+  Node aux_node;
+  pbNode2Node(it->second, &aux_node);
+  rpc::ParamValue pv;
+  pv.set_var_type(rpc::INT64);
+  pv.set_is_array(true);
+  auto arr = pv.mutable_value_int64_array();
+  for (const auto item : plan) {
+    arr->add_value_int64_array(item);
+  }
+  std::string plan_str;
+  pv.SerializeToString(&plan_str);
+  auto& link_ctx = this->task_ptr_->getTaskContext().getLinkContext();
+  auto key = MPCTask::SessionPlanKey(task_config.task_info(), session_round_);
+  auto ret = link_ctx->Send(key, aux_node, plan_str);
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "send plan of session round: " << session_round_
+               << " failed";
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+bool MPCExecutor::IsLauncher(const rpc::Task& task_config) {
+  const auto& party_access_info = task_config.party_access_info();
+  auto it = party_access_info.find(task_config.party_name());
+  if (it == party_access_info.end()) {
+    return false;
+  }
+  return it->second.party_id() == 0;
+}
+
 retcode MPCExecutor::GetSyncFlagKey(const rpc::TaskContext& task_info,
                                     std::string* sync_key) {
   *sync_key = task_info.sub_task_id() + "_SyncFlag";
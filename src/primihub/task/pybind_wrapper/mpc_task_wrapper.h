@@ -31,6 +31,11 @@
 namespace primihub::task {
 class MPCExecutor {
  public:
+  struct StatisticsRequest {
+    rpc::Algorithm::StatisticsOpType op_type;
+    double value;
+    int64_t rows{0};
+  };
   MPCExecutor(const std::string& task_req,
               const std::string& protocol = "ABY3");
   ~MPCExecutor();
@@ -41,6 +46,21 @@ class MPCExecutor {
               std::vector<double>* result);
   retcode Sum(const std::vector<double>& input, std::vector<double>* result);
   void StopTask();
+  /**
+   * negotiate a sub task, invite the auxiliary server and set up channels
+   * once, Max/Min/Avg/Sum and ExecuteBatch reuse them until CloseSession
+  */
+  retcode OpenSession();
+  /**
+   * requests of the same op type are computed together,
+   * result[i] is the result of requests[i].
+   * all parties must send the same sequence of op types,
+   * an empty batch returns at once without any communication
+  */
+  retcode ExecuteBatch(const std::vector<StatisticsRequest>& requests,
+                       std::vector<double>* result);
+  retcode CloseSession();
+  bool InSession() const {return session_task_ != nullptr;}
 
  protected:
   /**
@@ -83,10 +103,22 @@ class MPCExecutor {
   retcode GetShapeKey(const rpc::TaskContext& task_info,
                       std::string* shape_key);
   bool NeedAuxiliaryServer(const rpc::Task& task_config);
+  bool IsLauncher(const rpc::Task& task_config);
+  /**
+   * party 0 sends the (op type, column num) pairs of a round to
+   * the auxiliary server, an empty plan closes the session
+  */
+  retcode SendSessionPlan(const std::vector<int64_t>& plan);
+  retcode ExecuteInSession(rpc::Algorithm::StatisticsOpType op_type,
+                           const std::vector<double>& input,
+                           const std::vector<int64_t>& col_rows,
+                           std::vector<double>* result);
 
  private:
   std::unique_ptr<rpc::PushTaskRequest> task_req_ptr_{nullptr};
   std::unique_ptr<MPCTask> task_ptr_{nullptr};
+  std::unique_ptr<MPCTask> session_task_{nullptr};
+  size_t session_round_{0};
   std::string func_name_{"mpc_statistics"};
   std::string sync_flag_content_{"SyncFlag"};
 };
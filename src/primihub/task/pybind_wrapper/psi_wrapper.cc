@@ -118,6 +118,10 @@ auto PsiExecutor::BuildPsiTaskRequest(const std::vector<std::string>& parties,
     psi_type.set_value_int32(static_cast<int>(rpc::KKRT));
   } else if (protocol == std::string("ECDH")) {
     psi_type.set_value_int32(static_cast<int>(rpc::ECDH));
+  } else if (protocol == std::string("MT_KKRT")) {
+    psi_type.set_value_int32(static_cast<int>(rpc::MT_KKRT));
+  } else if (protocol == std::string("CM20")) {
+    psi_type.set_value_int32(static_cast<int>(rpc::CM20));
   } else {
     std::stringstream ss;
     ss << "Unknown PSI protocol: " << protocol;
@@ -15,6 +15,10 @@
 */
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
 #include "src/primihub/common/common.h"
 #include "src/primihub/common/config/config.h"
 #include "src/primihub/task/pybind_wrapper/psi_wrapper.h"
@@ -75,7 +79,46 @@ PYBIND11_MODULE(ph_secure_lib, m) {
         }
         return result;})
     .def("stop_task",
-         &MPCExecutor::StopTask, py::call_guard<py::gil_scoped_release>());
+         &MPCExecutor::StopTask, py::call_guard<py::gil_scoped_release>())
+    .def("open_session", [](MPCExecutor& self) {
+        primihub::retcode ret;
+        {
+          py::gil_scoped_release release;
+          ret = self.OpenSession();
+        }
+        if (ret != primihub::retcode::SUCCESS) {
+          throw pybind11::value_error("open mpc session failed");
+        }})
+    .def("close_session",
+         &MPCExecutor::CloseSession, py::call_guard<py::gil_scoped_release>())
+    .def("execute_batch", [](MPCExecutor& self,
+        const std::vector<std::tuple<std::string, double, int64_t>>& items) {
+        static const std::map<std::string,
+            primihub::rpc::Algorithm::StatisticsOpType> op_types = {
+          {"max", primihub::rpc::Algorithm::MAX},
+          {"min", primihub::rpc::Algorithm::MIN},
+          {"avg", primihub::rpc::Algorithm::AVG},
+          {"sum", primihub::rpc::Algorithm::SUM},
+        };
+        std::vector<MPCExecutor::StatisticsRequest> requests;
+        requests.reserve(items.size());
+        for (const auto& [op_name, value, rows] : items) {
+          auto it = op_types.find(op_name);
+          if (it == op_types.end()) {
+            throw pybind11::value_error("unsupported statistics: " + op_name);
+          }
+          requests.push_back({it->second, value, rows});
+        }
+        std::vector<double> result;
+        primihub::retcode ret;
+        {
+          py::gil_scoped_release release;
+          ret = self.ExecuteBatch(requests, &result);
+        }
+        if (ret != primihub::retcode::SUCCESS) {
+          throw pybind11::value_error("receive data encountes error");
+        }
+        return result;});
 
   py::class_<PSIExecutor>(m, "PSIExecutor")
     .def(py::init<const std::string&>())
@@ -129,6 +129,10 @@ int MPCTask::execute() {
     LOG(ERROR) << "Algorithm is not initialized";
     return -1;
   }
+  if (RoleValidation::IsAuxiliaryCompute(this->party_name()) &&
+      IsSessionTask()) {
+    return ServeSession() == retcode::SUCCESS ? 0 : -1;
+  }
   if (RoleValidation::IsAuxiliaryCompute(this->party_name())) {
     int retcode{0};
     std::vector<int64_t> shape;
@@ -255,7 +259,137 @@ std::shared_ptr<Dataset> MPCTask::MakeDataset(
   return std::make_shared<Dataset>(table, nullptr);
 }
 
+retcode MPCTask::OpenSession() {
+  if (algorithm_ == nullptr) {
+    LOG(ERROR) << "Algorithm is not initialized";
+    return retcode::FAIL;
+  }
+  if (dynamic_cast<MPCStatisticsExecutor*>(algorithm_.get()) == nullptr) {
+    LOG(ERROR) << "session is only supported by mpc statistics";
+    return retcode::FAIL;
+  }
+  try {
+    algorithm_->InitTaskConfig(task_param_);
+    auto ret = algorithm_->ExtractProxyNode(task_param_);
+    if (ret != retcode::SUCCESS) {
+      LOG(ERROR) << "ExtractProxyNode from task config failed";
+      return retcode::FAIL;
+    }
+    if (algorithm_->initPartyComm()) {
+      LOG(ERROR) << "Initialize party communicate failed.";
+      return retcode::FAIL;
+    }
+  } catch (std::exception& e) {
+    LOG(ERROR) << e.what();
+    return retcode::FAIL;
+  }
+  in_session_ = true;
+  return retcode::SUCCESS;
+}
+
+retcode MPCTask::ExecuteInSession(rpc::Algorithm::StatisticsOpType op_type,
+                                  const std::vector<double>& input_data,
+                                  const std::vector<int64_t>& col_rows,
+                                  std::vector<double>* result) {
+  if (!in_session_) {
+    LOG(ERROR) << "session is not opened";
+    return retcode::FAIL;
+  }
+  auto executor = dynamic_cast<MPCStatisticsExecutor*>(algorithm_.get());
+  MPCStatisticsType type;
+  auto ret = MPCStatisticsExecutor::StatisticsType(op_type, &type);
+  if (ret != retcode::SUCCESS) {
+    return retcode::FAIL;
+  }
+  eMatrix<double> input_data_info;
+  input_data_info.resize(input_data.size(), 2);
+  std::vector<std::string> col_names;
+  col_names.reserve(input_data.size());
+  for (size_t i = 0; i < input_data.size(); i++) {
+    input_data_info(i, 0) = input_data[i];
+    input_data_info(i, 1) = col_rows[i];
+    col_names.push_back("COL_" + std::to_string(i));
+  }
+  try {
+    ret = executor->execute(type, input_data_info, col_names, result);
+  } catch (std::exception& e) {
+    LOG(ERROR) << e.what();
+    return retcode::FAIL;
+  }
+  return ret;
+}
+
+retcode MPCTask::CloseSession() {
+  if (!in_session_) {
+    return retcode::SUCCESS;
+  }
+  in_session_ = false;
+  algorithm_->finishPartyComm();
+  return retcode::SUCCESS;
+}
+
+std::string MPCTask::SessionPlanKey(const rpc::TaskContext& task_info,
+                                    size_t round) {
+  return task_info.sub_task_id() + "_mpc_session_plan_" +
+         std::to_string(round);
+}
+
+bool MPCTask::IsSessionTask() {
+  const auto& param_map = this->getTaskParam()->params().param_map();
+  auto it = param_map.find(kSessionParamKey);
+  if (it == param_map.end()) {
+    return false;
+  }
+  return it->second.value_string() == "1";
+}
+
+retcode MPCTask::ServeSession() {
+  auto ret = OpenSession();
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "open session as auxiliary server failed";
+    return retcode::FAIL;
+  }
+  auto task_info = this->getTaskParam()->task_info();
+  for (size_t round = 0; ; round++) {
+    std::vector<int64_t> plan;
+    ret = RecvInt64Array(SessionPlanKey(task_info, round), &plan);
+    if (ret != retcode::SUCCESS || plan.size() % 2 != 0) {
+      LOG(ERROR) << "invalid plan of session round: " << round;
+      break;
+    }
+    if (plan.empty()) {
+      VLOG(3) << "session is closed after " << round << " rounds";
+      break;
+    }
+    for (size_t i = 0; i < plan.size() && ret == retcode::SUCCESS; i += 2) {
+      auto op_type = static_cast<rpc::Algorithm::StatisticsOpType>(plan[i]);
+      std::vector<double> input;
+      std::vector<int64_t> col_rows;
+      std::vector<double> result;
+      ret = MakeAuxiliaryComputeData(op_type, plan[i+1], &input, &col_rows);
+      if (ret == retcode::SUCCESS) {
+        ret = ExecuteInSession(op_type, input, col_rows, &result);
+      }
+    }
+    if (ret != retcode::SUCCESS) {
+      LOG(ERROR) << "run session round: " << round << " failed";
+      break;
+    }
+  }
+  CloseSession();
+  return ret;
+}
+
 retcode MPCTask::RecvShapeFromLauncher(std::vector<int64_t>* shape) {
+  auto task_info = this->getTaskParam()->task_info();
+  std::string shape_key = task_info.sub_task_id() + "_mpc_shape";
+  auto ret = RecvInt64Array(shape_key, shape);
+  VLOG(7) << "end of RecvShapeFromLauncher";
+  return ret;
+}
+
+retcode MPCTask::RecvInt64Array(const std::string& key,
+                                std::vector<int64_t>* value) {
   auto& link_ctx = this->getTaskContext().getLinkContext();
   Node proxy_node;
   const auto& auxiliary_server = this->getTaskParam()->auxiliary_server();
@@ -267,16 +401,20 @@ retcode MPCTask::RecvShapeFromLauncher(std::vector<int64_t>* shape) {
   const auto& pb_proxy_node = it->second;
   pbNode2Node(pb_proxy_node, &proxy_node);
   std::string recv_buf;
-  auto task_info = this->getTaskParam()->task_info();
-  std::string shape_key = task_info.sub_task_id() + "_mpc_shape";
-  link_ctx->Recv(shape_key, proxy_node, &recv_buf);
-  rpc::ParamValue pb_shape;
-  pb_shape.ParseFromString(recv_buf);
-  auto& int64_arr = pb_shape.value_int64_array().value_int64_array();
+  auto ret = link_ctx->Recv(key, proxy_node, &recv_buf);
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "recv " << key << " failed";
+    return retcode::FAIL;
+  }
+  rpc::ParamValue pb_value;
+  if (!pb_value.ParseFromString(recv_buf)) {
+    LOG(ERROR) << "parse " << key << " failed";
+    return retcode::FAIL;
+  }
+  auto& int64_arr = pb_value.value_int64_array().value_int64_array();
   for (const auto item : int64_arr) {
-    shape->push_back(item);
+    value->push_back(item);
   }
-  VLOG(7) << "end of RecvShapeFromLauncher";
   return retcode::SUCCESS;
 }
 
@@ -288,27 +426,33 @@ retcode MPCTask::MakeAuxiliaryComputeData(const std::vector<int64_t>& shape,
                << " but get: " << shape.size();
     return retcode::FAIL;
   }
-  int64_t col_size = shape[1];
+  auto task_config = this->getTaskParam();
+  auto algorithm = task_config->algorithm();
+  return MakeAuxiliaryComputeData(algorithm.statistics_op_type(), shape[1],
+                                  input, col_rows);
+}
+
+retcode MPCTask::MakeAuxiliaryComputeData(
+    rpc::Algorithm::StatisticsOpType op_type, int64_t col_size,
+    std::vector<double>* input, std::vector<int64_t>* col_rows) {
   col_rows->reserve(col_size);
   col_rows->assign(col_size, 0);
 
   input->reserve(col_size);
-  auto task_config = this->getTaskParam();
-  auto algorithm = task_config->algorithm();
-  switch (algorithm.statistics_op_type()) {
+  switch (op_type) {
+    // sentinels stay inside the input range of MPC_MaxOrMin
     case rpc::Algorithm::MAX:
-      input->assign(col_size, std::numeric_limits<double>::min());
+      input->assign(col_size, -MPCOperator::kMaxOrMinBound);
       break;
     case rpc::Algorithm::MIN:
-      input->assign(col_size, std::numeric_limits<double>::max());
+      input->assign(col_size, MPCOperator::kMaxOrMinBound);
       break;
     case rpc::Algorithm::AVG:
     case rpc::Algorithm::SUM:
       input->assign(col_size, 0);
       break;
     default:
-      LOG(WARNING) << "unknown op type for statistics: "
-                   << algorithm.statistics_op_type();
+      LOG(WARNING) << "unknown op type for statistics: " << op_type;
       return retcode::FAIL;
   }
   return retcode::SUCCESS;
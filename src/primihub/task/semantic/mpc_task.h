@@ -40,6 +40,26 @@ class MPCTask : public TaskBase {
                       const std::vector<int64_t>& col_rows,
                       std::vector<double>* result);
   retcode ExecuteImpl();
+  /**
+   * statistics session: party channels and mpc runtime are set up once
+   * by OpenSession and reused by every ExecuteInSession until CloseSession.
+   * all parties must run the same sequence of ExecuteInSession
+  */
+  retcode OpenSession();
+  retcode ExecuteInSession(rpc::Algorithm::StatisticsOpType op_type,
+                           const std::vector<double>& input_data,
+                           const std::vector<int64_t>& col_rows,
+                           std::vector<double>* result);
+  retcode CloseSession();
+  bool InSession() const {return in_session_;}
+  /**
+   * key of the plan of round sent by party 0 to the auxiliary compute party,
+   * the plan is an int64 array of (op type, column num) pairs,
+   * an empty plan closes the session
+  */
+  static std::string SessionPlanKey(const rpc::TaskContext& task_info,
+                                    size_t round);
+  static constexpr const char* kSessionParamKey = "MPCSession";
 
  protected:
   std::shared_ptr<Dataset> MakeDataset(const std::vector<double>& input_data,
@@ -48,10 +68,21 @@ class MPCTask : public TaskBase {
   retcode MakeAuxiliaryComputeData(const std::vector<int64_t>& shape,
                                    std::vector<double>* input,
                                    std::vector<int64_t>* col_rows);
+  retcode MakeAuxiliaryComputeData(rpc::Algorithm::StatisticsOpType op_type,
+                                   int64_t col_size,
+                                   std::vector<double>* input,
+                                   std::vector<int64_t>* col_rows);
   retcode RecvShapeFromLauncher(std::vector<int64_t>* shape);
+  retcode RecvInt64Array(const std::string& key, std::vector<int64_t>* value);
+  bool IsSessionTask();
+  /**
+   * auxiliary compute party runs the plans of a session until it is closed
+  */
+  retcode ServeSession();
 
  private:
     std::shared_ptr<AlgorithmBase> algorithm_{nullptr};
+    bool in_session_{false};
 };
 
 } // namespace primihub::task
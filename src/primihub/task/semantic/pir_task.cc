@@ -25,6 +25,7 @@
 
 #include "src/primihub/kernel/pir/operator/base_pir.h"
 #include "src/primihub/kernel/pir/operator/factory.h"
+#include "src/primihub/kernel/pir/operator/keyword_pir_impl/sender_db_cache.h"
 #include "src/primihub/common/config/server_config.h"
 #include "src/primihub/util/file_util.h"
 #include "src/primihub/common/value_check_util.h"
@@ -51,6 +52,10 @@ retcode PirTask::BuildOptions(const rpc::Task& task, pir::Options* options) {
   if (RoleValidation::IsServer(this->party_name())) {
     // parameter for offline generate db info
     const auto& param_map = task.params().param_map();
+    auto version_it = param_map.find("DatasetVersion");
+    if (version_it != param_map.end()) {
+      options->dataset_version = version_it->second.value_string();
+    }
     auto iter = param_map.find("DbInfo");
     if (iter != param_map.end()) {
       options->db_path = iter->second.value_string();
@@ -85,7 +90,7 @@ retcode PirTask::BuildOptions(const rpc::Task& task, pir::Options* options) {
         options->db_path.append("_").append(std::to_string(key_index));
       }
 
-      if (DbCacheAvailable(options->db_path)) {
+      if (DbCacheAvailable(options->db_path, options->dataset_version)) {
         options->use_cache = true;
       }
     }
@@ -356,6 +361,25 @@ retcode PirTask::ClientLoadDataset() {
   return retcode::SUCCESS;
 }
 
+bool PirTask::DbCacheAvailable(const std::string& db_file_cache,
+                               const std::string& dataset_version) {
+  pir::SenderDbCache db_cache(db_file_cache);
+  if (!db_cache.Available()) {
+    return false;
+  }
+  if (dataset_version.empty()) {
+    return true;
+  }
+  pir::DbCacheMeta meta;
+  auto ret = db_cache.LoadMeta(&meta);
+  if (ret != retcode::SUCCESS || meta.dataset_version != dataset_version) {
+    LOG(INFO) << "db cache: " << db_file_cache << " is out of date, "
+              << "dataset version: " << dataset_version;
+    return false;
+  }
+  return true;
+}
+
 retcode PirTask::ServerLoadDataset() {
   if (this->options_.use_cache) {
     VLOG(0) << "using cache data for party: " << party_name();
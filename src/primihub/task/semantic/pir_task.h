@@ -40,9 +40,12 @@ class PirTask : public TaskBase {
   retcode ClientLoadDataset();
   retcode ServerLoadDataset();
   std::shared_ptr<Dataset> LoadDataSetInternal(const std::string& dataset_id);
-  bool DbCacheAvailable(const std::string& db_file_cache) {
-    return FileExists(db_file_cache);
-  }
+  /**
+   * cache is usable if no dataset version is given
+   * or it is built from the same version
+  */
+  bool DbCacheAvailable(const std::string& db_file_cache,
+                        const std::string& dataset_version);
   std::vector<std::string> GetSelectedContent(
       std::shared_ptr<arrow::Table>& data_tbl,
       const std::vector<int>& selected_col);
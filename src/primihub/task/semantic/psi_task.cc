@@ -26,6 +26,7 @@
 #include "src/primihub/util/endian_util.h"
 #include "src/primihub/common/value_check_util.h"
 #include "src/primihub/kernel/psi/operator/factory.h"
+#include "src/primihub/kernel/psi/dedup.h"
 #include "src/primihub/common/config/server_config.h"
 
 using arrow::Table;
@@ -77,6 +78,34 @@ retcode PsiTask::BuildOptions(const rpc::Task& task, psi::Options* options) {
     options->psi_result_type =
         static_cast<psi::PsiResultType>(it->second.value_int32());
   }
+  // streaming mode, input is exchanged in batches of ecdhBatchSize elements
+  it = param_map.find("ecdhBatchSize");
+  if (it != param_map.end()) {
+    options->batch_size = it->second.value_int32();
+    VLOG(5) << "ecdh batch size: " << options->batch_size;
+  }
+  it = param_map.find("psiThreadNum");
+  if (it != param_map.end()) {
+    options->thread_num = it->second.value_int32();
+    VLOG(5) << "psi thread num: " << options->thread_num;
+  }
+  it = param_map.find("psiChannelNum");
+  if (it != param_map.end()) {
+    options->channel_num = it->second.value_int32();
+    VLOG(5) << "psi channel num: " << options->channel_num;
+  }
+  // both parties must choose the same kkrt input hash
+  it = param_map.find("kkrtHashType");
+  if (it != param_map.end()) {
+    int32_t hash_type = it->second.value_int32();
+    if (hash_type != static_cast<int32_t>(psi::BlockHashType::SHA1) &&
+        hash_type != static_cast<int32_t>(psi::BlockHashType::FIXED_KEY_AES)) {
+      LOG(ERROR) << "unknown kkrt hash type: " << hash_type;
+      return retcode::FAIL;
+    }
+    options->block_hash_type = static_cast<psi::BlockHashType>(hash_type);
+    VLOG(5) << "kkrt hash type: " << hash_type;
+  }
   // end of build Options
   return retcode::SUCCESS;
 }
@@ -110,6 +139,19 @@ retcode PsiTask::LoadParams(const rpc::Task& task) {
     }
   }
 
+  // hash typed key columns instead of loading them as strings
+  {
+    auto it = param_map.find("ColumnarKey");
+    if (it != param_map.end()) {
+      columnar_key_ = it->second.value_int32() > 0;
+      VLOG(0) << "columnar_key_: " << columnar_key_;
+    }
+    if (columnar_key_ && psi_type_ == rpc::PsiTag::TEE) {
+      LOG(WARNING) << "columnar key is not supported by TEE psi, disable it";
+      columnar_key_ = false;
+    }
+  }
+
   // broadcast result flag
   auto iter = param_map.find("sync_result_to_server");
   if (iter != param_map.end()) {
@@ -194,8 +236,13 @@ retcode PsiTask::LoadDataset(void) {
     LOG(ERROR) << "get driver for data set: " << this->dataset_id_ << " failed";
     return retcode::FAIL;
   }
-  auto ret = LoadDatasetInternal(driver, data_index_,
-                                 &elements_, &data_colums_name_);
+  retcode ret{retcode::SUCCESS};
+  if (columnar_key_) {
+    ret = LoadKeyDigests(driver);
+  } else {
+    ret = LoadDatasetInternal(driver, data_index_,
+                              &elements_, &data_colums_name_);
+  }
   if (ret != retcode::SUCCESS) {
     LOG(ERROR) << "Load dataset for psi server failed.";
     return retcode::FAIL;
@@ -203,28 +250,39 @@ retcode PsiTask::LoadDataset(void) {
   // filter duplicated data
   if (unique_values_) {
     SCopedTimer timer;
-    std::vector<std::string> filtered_data;
-    filtered_data.reserve(elements_.size());
-    std::unordered_set<std::string> dup(elements_.size());
     int64_t duplicate_num = 0;
-    for (auto& item : elements_) {
-      if (dup.find(item) != dup.end()) {
-        duplicate_num++;
-        continue;
-      }
-      dup.insert(item);
-      filtered_data.push_back(item);
+    ret = psi::DeduplicateInPlace(&elements_, options_.thread_num,
+                                  &duplicate_num);
+    if (ret != retcode::SUCCESS) {
+      LOG(ERROR) << "filter duplicated data failed";
+      return retcode::FAIL;
     }
     if (duplicate_num != 0) {
       LOG(WARNING) << "item has duplicated time, count: " << duplicate_num;
     }
-    elements_ = std::move(filtered_data);
     auto time_cost = timer.timeElapse();
     VLOG(3) << "filter data time cost: " << time_cost;
   }
   return retcode::SUCCESS;
 }
 
+retcode PsiTask::LoadKeyDigests(std::shared_ptr<DataDriver>& driver) {
+  auto ret = LoadTableInternal(driver, data_index_, &key_table_);
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "load key columns failed";
+    return retcode::FAIL;
+  }
+  data_colums_name_ = key_table_->ColumnNames();
+  ret = HashKeyColumns(key_table_, &row_digests_);
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "hash key columns failed";
+    return retcode::FAIL;
+  }
+  // rows are matched by row_digests_, elements_ may be deduplicated
+  elements_ = row_digests_;
+  return retcode::SUCCESS;
+}
+
 retcode PsiTask::InitOperator() {
   auto type = static_cast<primihub::psi::PsiType>(psi_type_);
   this->psi_operator_ =
@@ -244,7 +302,14 @@ retcode PsiTask::SaveResult() {
   if (!NeedSaveResult()) {
     return retcode::SUCCESS;
   }
-  auto ret = SaveDataToCSVFile(result_, result_file_path_, data_colums_name_);
+  retcode ret{retcode::SUCCESS};
+  if (columnar_key_ && key_table_ != nullptr) {
+    std::vector<int64_t> row_index;
+    MatchResultRows(row_digests_, result_, unique_values_, &row_index);
+    ret = SaveTableRowsToCSVFile(key_table_, row_index, result_file_path_);
+  } else {
+    ret = SaveDataToCSVFile(result_, result_file_path_, data_colums_name_);
+  }
   if (ret != retcode::SUCCESS) {
     LOG(ERROR) << "save result to " << result_file_path_ << " failed";
     return retcode::FAIL;
@@ -51,6 +51,7 @@ class PsiTask : public TaskBase, public primihub::psi::PsiCommonUtil {
  protected:
   retcode LoadParams(const rpc::Task& task);
   retcode LoadDataset();
+  retcode LoadKeyDigests(std::shared_ptr<DataDriver>& driver);
   retcode SaveResult();
   retcode InitOperator();
   retcode ExecuteOperator();
@@ -75,6 +76,14 @@ class PsiTask : public TaskBase, public primihub::psi::PsiCommonUtil {
   primihub::psi::Options options_;
   bool unique_values_{true};
   bool load_dataset_{true};
+  /**
+   * key rows are hashed from typed arrow columns into fixed size digests,
+   * the result is saved by taking the matched rows from key_table_.
+   * both parties must enable it
+  */
+  bool columnar_key_{false};
+  std::shared_ptr<arrow::Table> key_table_{nullptr};
+  std::vector<std::string> row_digests_;
   // for TEE
   void* ra_server_{nullptr};
   void* tee_executor_{nullptr};
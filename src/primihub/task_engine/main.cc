@@ -16,9 +16,12 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <Python.h>
+#include <unistd.h>
+#include <cerrno>
 #include <iostream>
 #include <string>
 #include "src/primihub/task_engine/task_executor.h"
+#include "src/primihub/task_engine/task_process_protocol.h"
 #include "src/primihub/common/config/server_config.h"
 
 DEFINE_string(node_id, "node0", "unique node_id");
@@ -27,6 +30,86 @@ DEFINE_string(config_file, "./config/node1.yaml", "server config file");
 DEFINE_string(request, "", "task request, serialized by rpc::Task");
 DEFINE_string(request_id, "", "task request, serialized by rpc::Task");
 DEFINE_string(log_path, "", "log path");
+DEFINE_bool(serve, false,
+            "warm up and execute one request read from stdin");
+
+namespace primihub::task_engine {
+/**
+ * marker_fd: fd of the marker channel, STDOUT_FILENO for a fresh process
+*/
+void WriteMarker(int marker_fd, const std::string& marker) {
+  if (marker_fd == STDOUT_FILENO) {
+    std::cout << marker << std::endl;
+    return;
+  }
+  std::string line = marker + "\n";
+  size_t written = 0;
+  while (written < line.size()) {
+    auto n = write(marker_fd, line.data() + written, line.size() - written);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << "write marker failed, errno: " << errno;
+      return;
+    }
+    written += n;
+  }
+}
+
+retcode RunTask(const std::string& node_id,
+                const std::string& config_file,
+                const std::string& task_request_str,
+                DatasetServicePtr dataset_service,
+                int marker_fd = STDOUT_FILENO) {
+  auto task_engine = std::make_unique<TaskEngine>();
+  auto ret = task_engine->Init(node_id, config_file, task_request_str,
+                               std::move(dataset_service));
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "init py executor failed";
+    return retcode::FAIL;
+  }
+  WriteMarker(marker_fd, std::string(kTaskStartedMarker));
+  ret = task_engine->Execute();
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << "task executor encoutes error when executing task";
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+/**
+ * warm process of worker task process pool,
+ * config and dataset service are initialized before the request arrives.
+ * only one task is executed, global state of a task never leaks into
+ * the next one, the worker spawns a new warm process instead
+*/
+int ServeTask(const std::string& node_id, const std::string& config_file) {
+  // keep the original stdout for markers only, anything else the task
+  // writes to stdout goes to stderr, so it can not be taken as a marker
+  int marker_fd = dup(STDOUT_FILENO);
+  if (marker_fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+    LOG(ERROR) << "redirect stdout failed, errno: " << errno;
+    return -1;
+  }
+  auto dataset_service = TaskEngine::CreateDatasetService(config_file);
+  if (dataset_service == nullptr) {
+    LOG(ERROR) << "create dataset service failed";
+    return -1;
+  }
+  std::string task_request_str;
+  if (!std::getline(std::cin, task_request_str) || task_request_str.empty()) {
+    VLOG(0) << "stdin is closed, exit task process";
+    return 0;
+  }
+  auto ret = RunTask(node_id, config_file, task_request_str,
+                     std::move(dataset_service), marker_fd);
+  int code = ret == retcode::SUCCESS ? 0 : -1;
+  WriteMarker(marker_fd, MakeFinishedMarker(code));
+  close(marker_fd);
+  return 0;
+}
+}  // namespace primihub::task_engine
 
 int main(int argc, char **argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
@@ -44,6 +127,16 @@ int main(int argc, char **argv) {
     FLAGS_log_dir = log_path.c_str();
   }
 
+  if (FLAGS_serve) {
+    auto& server_cfg = primihub::ServerConfig::getInstance();
+    auto ret = server_cfg.initServerConfig(config_file);
+    if (ret != primihub::retcode::SUCCESS) {
+      LOG(ERROR) << "init Server config failed";
+      return -1;
+    }
+    auto& service_cfg = server_cfg.getServiceConfig();
+    return primihub::task_engine::ServeTask(service_cfg.id(), config_file);
+  }
   if (task_request_str.empty()) {
     LOG(ERROR) << "task request empty is not allowed";
     return -1;
@@ -57,15 +150,9 @@ int main(int argc, char **argv) {
     return -1;
   }
   auto& service_cfg = server_cfg.getServiceConfig();
-  auto task_engine = std::make_unique<primihub::task_engine::TaskEngine>();
-  ret = task_engine->Init(service_cfg.id(), config_file, task_request_str);
+  ret = primihub::task_engine::RunTask(service_cfg.id(), config_file,
+                                       task_request_str, nullptr);
   if (ret != primihub::retcode::SUCCESS) {
-    LOG(ERROR) << "init py executor failed";
-    return -1;
-  }
-  ret = task_engine->Execute();
-  if (ret != primihub::retcode::SUCCESS) {
-    LOG(ERROR) << "task executor encoutes error when executing task";
     return -1;
   }
   return 0;
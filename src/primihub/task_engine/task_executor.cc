@@ -23,7 +23,8 @@
 namespace primihub::task_engine {
 retcode TaskEngine::Init(const std::string& server_id,
                          const std::string& config_file,
-                         const std::string& request) {
+                         const std::string& request,
+                         DatasetServicePtr dataset_service) {
   this->node_id_ = server_id;
   this->config_file_ = config_file;
   VLOG(5) << "ParseTaskRequest";
@@ -36,11 +37,15 @@ retcode TaskEngine::Init(const std::string& server_id,
   ret = GetScheduleNode();
   VLOG(5) << "InitCommunication";
   ret = InitCommunication();
-  VLOG(5) << "InitDatasetSerivce";
-  ret = InitDatasetSerivce();
-  if (ret != retcode::SUCCESS) {
-    LOG(ERROR) << "InitDatasetSerivce failed";
-    return retcode::FAIL;
+  if (dataset_service != nullptr) {
+    dataset_service_ = std::move(dataset_service);
+  } else {
+    VLOG(5) << "InitDatasetSerivce";
+    ret = InitDatasetSerivce();
+    if (ret != retcode::SUCCESS) {
+      LOG(ERROR) << "InitDatasetSerivce failed";
+      return retcode::FAIL;
+    }
   }
   VLOG(5) << "CreateTask";
   ret = CreateTask();
@@ -69,11 +74,20 @@ retcode TaskEngine::InitCommunication() {
 }
 
 retcode TaskEngine::InitDatasetSerivce() {
+  dataset_service_ = CreateDatasetService(this->config_file_);
+  if (dataset_service_ == nullptr) {
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+DatasetServicePtr TaskEngine::CreateDatasetService(
+    const std::string& config_file) {
   auto& server_config = primihub::ServerConfig::getInstance();
-  auto ret = server_config.initServerConfig(this->config_file_);
+  auto ret = server_config.initServerConfig(config_file);
   if (ret != primihub::retcode::SUCCESS) {
     LOG(ERROR) << "init server config failed";
-    return retcode::FAIL;
+    return nullptr;
   }
   // service for dataset meta control
   auto& node_cfg = server_config.getNodeConfig();
@@ -81,8 +95,7 @@ retcode TaskEngine::InitDatasetSerivce() {
   using MetaServiceFactory = primihub::service::MetaServiceFactory;
   auto meta_service = MetaServiceFactory::Create(meta_service_cfg.mode,
                                                  meta_service_cfg.host_info);
-  dataset_service_ = std::make_shared<DatasetService>(std::move(meta_service));
-  return retcode::SUCCESS;
+  return std::make_shared<DatasetService>(std::move(meta_service));
 }
 
 retcode TaskEngine::GetScheduleNode() {
@@ -36,9 +36,15 @@ class TaskEngine {
  public:
   TaskEngine() = default;
   ~TaskEngine() = default;
+  /**
+   * dataset_service: shared by tasks which run in the same process,
+   * created from server config if it is nullptr
+  */
   retcode Init(const std::string& server_id,
                const std::string& server_config_file,
-               const std::string& request);
+               const std::string& request,
+               DatasetServicePtr dataset_service = nullptr);
+  static DatasetServicePtr CreateDatasetService(const std::string& config_file);
   retcode Execute();
 
   retcode GetScheduleNode();
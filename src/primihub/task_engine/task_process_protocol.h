@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 by PrimiHub
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      https://www.apache.org/licenses/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SRC_PRIMIHUB_TASK_ENGINE_TASK_PROCESS_PROTOCOL_H_
+#define SRC_PRIMIHUB_TASK_ENGINE_TASK_PROCESS_PROTOCOL_H_
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <system_error>
+/**
+ * line protocol between worker and task_main.
+ * worker -> task_main (--serve mode only): one base64 encoded
+ *   PushTaskRequest on stdin, task_main exits after running it.
+ * task_main -> worker: marker lines below.
+ *   in --serve mode markers go to stdout and nothing else does,
+ *   task_main redirects its own stdout to stderr, which carries the log.
+ *   a fresh task_main writes the started marker among its log lines
+*/
+namespace primihub::task_engine {
+// task is initialized and starts to execute
+inline constexpr std::string_view kTaskStartedMarker = "#PRIMIHUB_TASK_STARTED";
+// task is finished, followed by " <code>", 0 means success
+inline constexpr std::string_view kTaskFinishedMarker = "#PRIMIHUB_TASK_FINISHED";
+
+inline bool IsTaskMarker(std::string_view line, std::string_view marker) {
+  return line.substr(0, marker.size()) == marker;
+}
+
+inline std::string MakeFinishedMarker(int code) {
+  std::string marker(kTaskFinishedMarker);
+  marker.append(" ").append(std::to_string(code));
+  return marker;
+}
+
+/**
+ * false if line is not a well formed finished marker
+*/
+inline bool ParseFinishedMarker(std::string_view line, int* code) {
+  if (!IsTaskMarker(line, kTaskFinishedMarker)) {
+    return false;
+  }
+  auto code_str = line.substr(kTaskFinishedMarker.size());
+  if (code_str.size() < 2 || code_str[0] != ' ') {
+    return false;
+  }
+  code_str.remove_prefix(1);
+  const char* end = code_str.data() + code_str.size();
+  int value{0};
+  auto res = std::from_chars(code_str.data(), end, value);
+  if (res.ec != std::errc() || res.ptr != end) {
+    return false;
+  }
+  *code = value;
+  return true;
+}
+}  // namespace primihub::task_engine
+#endif  // SRC_PRIMIHUB_TASK_ENGINE_TASK_PROCESS_PROTOCOL_H_
@@ -0,0 +1,53 @@
+/*
+* Copyright (c) 2023 by PrimiHub
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      https://www.apache.org/licenses/
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "src/primihub/util/compress_util.h"
+#include <glog/logging.h>
+#include <zlib.h>
+
+namespace primihub {
+retcode ZlibCompress(std::string_view src, std::string* dst) {
+  uLongf dst_len = compressBound(src.size());
+  dst->resize(dst_len);
+  int ret = compress2(reinterpret_cast<Bytef*>(&(*dst)[0]), &dst_len,
+                      reinterpret_cast<const Bytef*>(src.data()), src.size(),
+                      Z_DEFAULT_COMPRESSION);
+  if (ret != Z_OK) {
+    LOG(ERROR) << "zlib compress failed, error code: " << ret;
+    return retcode::FAIL;
+  }
+  dst->resize(dst_len);
+  return retcode::SUCCESS;
+}
+
+retcode ZlibUncompress(std::string_view src, size_t raw_size,
+                       std::string* dst) {
+  dst->resize(raw_size);
+  if (raw_size == 0) {
+    return retcode::SUCCESS;
+  }
+  uLongf dst_len = raw_size;
+  int ret = uncompress(reinterpret_cast<Bytef*>(&(*dst)[0]), &dst_len,
+                       reinterpret_cast<const Bytef*>(src.data()), src.size());
+  if (ret != Z_OK || dst_len != raw_size) {
+    LOG(ERROR) << "zlib uncompress failed, error code: " << ret << " "
+               << "expected size: " << raw_size << " "
+               << "uncompressed size: " << dst_len;
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+}  // namespace primihub
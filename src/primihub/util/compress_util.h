@@ -0,0 +1,36 @@
+/*
+* Copyright (c) 2023 by PrimiHub
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      https://www.apache.org/licenses/
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef SRC_PRIMIHUB_UTIL_COMPRESS_UTIL_H_
+#define SRC_PRIMIHUB_UTIL_COMPRESS_UTIL_H_
+
+#include <string>
+#include <string_view>
+#include "src/primihub/common/common.h"
+
+namespace primihub {
+/**
+ * deflate src into dst by zlib, the size of src is not stored in dst,
+ * it has to be passed to ZlibUncompress by the caller
+*/
+retcode ZlibCompress(std::string_view src, std::string* dst);
+/**
+ * inflate src into dst, raw_size is the size of data before compression
+*/
+retcode ZlibUncompress(std::string_view src, size_t raw_size,
+                       std::string* dst);
+}  // namespace primihub
+#endif  // SRC_PRIMIHUB_UTIL_COMPRESS_UTIL_H_
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023 by PrimiHub
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      https://www.apache.org/licenses/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_PRIMIHUB_UTIL_NETWORK_FORWARD_WINDOW_H_
+#define SRC_PRIMIHUB_UTIL_NETWORK_FORWARD_WINDOW_H_
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "src/primihub/util/threadsafe_queue.h"
+
+namespace primihub::network {
+/**
+ * messages of a key forwarded through recv streams, a message popped from
+ * the recv queue is kept until the receiver acknowledges it. if a stream
+ * breaks in the middle of a transfer, the next stream of the key re-sends
+ * the unacknowledged messages first, so nothing is lost or duplicated.
+ * receiver counts the messages it has got over all streams of the key.
+*/
+class ForwardWindow {
+ public:
+  using Message = std::shared_ptr<const std::string>;
+
+  /**
+   * start a new stream whose receiver has got received messages in total,
+   * a former stream of the key is stale from now on. return id of the stream
+  */
+  uint64_t Restart(uint64_t received) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    AckLocked(received);
+    resend_pos_ = 0;
+    return ++stream_id_;
+  }
+
+  /**
+   * receiver has got received messages in total
+  */
+  void Ack(uint64_t received) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    AckLocked(received);
+  }
+
+  /**
+   * next message to write on stream, an unacknowledged message not yet
+   * re-sent on the stream comes first, then one popped from queue.
+   * return nullptr if no message arrives within timeout or the stream is
+   * stale, resent is true if the message was written by a former stream
+  */
+  template<typename Rep, typename Period>
+  Message Next(uint64_t stream_id, ThreadSafeQueue<std::string>* queue,
+               const std::chrono::duration<Rep, Period>& timeout,
+               bool* resent) {
+    // pop and append are serialized by pop_mtx_, so messages are kept in
+    // queue order. mtx_ is not held while waiting on queue, Ack, Restart
+    // and IsStale are not blocked by an idle stream
+    std::lock_guard<std::mutex> pop_lck(pop_mtx_);
+    {
+      std::lock_guard<std::mutex> lck(mtx_);
+      if (stream_id != stream_id_) {
+        return nullptr;
+      }
+      if (resend_pos_ < unacked_.size()) {
+        // a message popped by a stale stream was never written
+        *resent = resend_pos_ < written_num_;
+        resend_pos_++;
+        written_num_ = std::max(written_num_, resend_pos_);
+        return unacked_[resend_pos_ - 1];
+      }
+    }
+    std::string data;
+    if (!queue->wait_and_pop_for(data, timeout)) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lck(mtx_);
+    // kept even if the stream went stale while waiting,
+    // the current stream re-sends it
+    unacked_.push_back(std::make_shared<const std::string>(std::move(data)));
+    if (stream_id != stream_id_) {
+      return nullptr;
+    }
+    *resent = false;
+    resend_pos_ = unacked_.size();
+    written_num_ = resend_pos_;
+    return unacked_.back();
+  }
+
+  bool IsStale(uint64_t stream_id) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return stream_id != stream_id_;
+  }
+
+  size_t UnackedNum() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return unacked_.size();
+  }
+
+ private:
+  void AckLocked(uint64_t received) {
+    // a receiver starting from 0 again, e.g. a new channel, acks nothing
+    while (acked_ < received && !unacked_.empty()) {
+      unacked_.pop_front();
+      acked_++;
+      if (resend_pos_ > 0) {
+        resend_pos_--;
+      }
+      if (written_num_ > 0) {
+        written_num_--;
+      }
+    }
+  }
+
+ private:
+  std::mutex pop_mtx_;
+  std::mutex mtx_;
+  uint64_t stream_id_{0};
+  uint64_t acked_{0};          // messages acknowledged by receiver
+  std::deque<Message> unacked_;
+  size_t resend_pos_{0};       // unacked messages written on current stream
+  size_t written_num_{0};      // unacked messages written on any stream
+};
+}  // namespace primihub::network
+#endif  // SRC_PRIMIHUB_UTIL_NETWORK_FORWARD_WINDOW_H_
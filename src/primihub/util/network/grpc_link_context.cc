@@ -3,12 +3,15 @@
 #include <glog/logging.h>
 #include <vector>
 #include <algorithm>
+#include <fstream>
 #include <utility>
 #include <memory>
+#include <thread>
 
 #include "src/primihub/util/util.h"
 #include "src/primihub/util/log.h"
 #include "src/primihub/util/proto_log_helper.h"
+#include "src/primihub/util/compress_util.h"
 
 namespace pb_util = primihub::proto::util;
 namespace primihub::network {
@@ -21,6 +24,16 @@ GrpcChannel::GrpcChannel(const primihub::Node& node, LinkContext* link_ctx) :
   dataset_stub_ = rpc::DataSetService::NewStub(channel);
 }
 
+GrpcChannel::~GrpcChannel() {
+  std::lock_guard<std::mutex> lck(recv_stream_mtx_);
+  for (auto& [role, recv_stream] : recv_streams_) {
+    recv_stream->context.TryCancel();
+    std::lock_guard<std::mutex> stream_lck(recv_stream->mtx);
+    recv_stream->stream->Finish();
+  }
+  recv_streams_.clear();
+}
+
 retcode GrpcChannel::BuildTaskInfo(rpc::TaskContext* task_info) {
   auto link_ctx = this->getLinkContext();
   if (link_ctx == nullptr) {
@@ -67,15 +80,13 @@ retcode GrpcChannel::sendRecv(const std::string& role,
   using reader_writer_t =
       grpc::ClientReaderWriter<rpc::TaskRequest, rpc::TaskResponse>;
   std::shared_ptr<reader_writer_t> client_stream(stub_->SendRecv(&context));
-  std::vector<rpc::TaskRequest> send_requests;
-  buildTaskRequest(role, send_data, &send_requests);
-  std::string TASK_INFO_STR;
-  if (!send_requests.empty()) {
-    auto& task_info = send_requests[0].task_info();
-    TASK_INFO_STR = pb_util::TaskInfoToString(task_info);
-  }
-  for (const auto& request : send_requests) {
-    client_stream->Write(request);
+  rpc::TaskContext task_info;
+  BuildTaskInfo(&task_info);
+  std::string TASK_INFO_STR = pb_util::TaskInfoToString(task_info);
+  if (!WriteTaskRequest(role, send_data, client_stream.get())) {
+    PH_LOG(WARNING, LogType::kTask)
+        << TASK_INFO_STR
+        << "stream is closed before all data is sent";
   }
   client_stream->WritesDone();
   // waiting for response
@@ -137,15 +148,11 @@ retcode GrpcChannel::send(const std::string& role, const std::string& data) {
 
 retcode GrpcChannel::send(const std::string& role, std::string_view data_sv) {
   // VLOG(5) << "GrpcChannel::send begin to send, use key: " << role;
-  std::vector<rpc::TaskRequest> send_requests;
-  buildTaskRequest(role, data_sv, &send_requests);
   auto send_tiemout_ms = this->getLinkContext()->sendTimeout();
   int retry_time{0};
-  std::string TASK_INFO_STR;
-  if (!send_requests.empty()) {
-    const auto& task_info = send_requests[0].task_info();
-    TASK_INFO_STR = pb_util::TaskInfoToString(task_info);
-  }
+  rpc::TaskContext task_info;
+  BuildTaskInfo(&task_info);
+  std::string TASK_INFO_STR = pb_util::TaskInfoToString(task_info);
   do {
     grpc::ClientContext context;
     if (send_tiemout_ms > 0) {
@@ -156,9 +163,9 @@ retcode GrpcChannel::send(const std::string& role, std::string_view data_sv) {
     rpc::TaskResponse task_response;
     using writer_t = grpc::ClientWriter<rpc::TaskRequest>;
     std::unique_ptr<writer_t> writer(stub_->Send(&context, &task_response));
-    for (const auto& request : send_requests) {
-      writer->Write(request);
-    }
+    // data is split and written package by package,
+    // on failure, the reason is reported by Finish
+    WriteTaskRequest(role, data_sv, writer.get());
     writer->WritesDone();
     grpc::Status status = writer->Finish();
     if (status.ok()) {
@@ -193,46 +200,145 @@ retcode GrpcChannel::send(const std::string& role, std::string_view data_sv) {
   return retcode::SUCCESS;
 }
 
-retcode GrpcChannel::buildTaskRequest(const std::string& role,
-    const std::string& data, std::vector<rpc::TaskRequest>* send_pb_data) {
-  std::string_view data_sv(data.c_str(), data.length());
-  return buildTaskRequest(role, data_sv, send_pb_data);
+std::string GrpcChannel::forwardRecv(const std::string& role) {
+  if (IsRecvCancelled(role)) {
+    return std::string("");
+  }
+  if (!recv_stream_enabled_.load()) {
+    return forwardRecvOnce(role);
+  }
+  SCopedTimer timer;
+  for (int retry = 0; ; retry++) {
+    auto recv_stream = GetRecvStream(role);
+    std::string recv_data;
+    auto ret = ReadFromRecvStream(recv_stream.get(), &recv_data);
+    if (ret == retcode::SUCCESS) {
+      PH_VLOG(5, LogType::kTask)
+          << "forwardRecv from stream time cost(ms): " << timer.timeElapse();
+      return recv_data;
+    }
+    // a message read in part is dropped, proxy re-sends it on the next stream
+    uint64_t received = recv_stream->received_base + recv_stream->recv_count;
+    grpc::Status status;
+    {
+      std::lock_guard<std::mutex> lck(recv_stream->mtx);
+      status = recv_stream->stream->Finish();
+    }
+    CloseRecvStream(role);
+    if (IsRecvCancelled(role)) {
+      PH_LOG(WARNING, LogType::kTask)
+          << "recv of key: " << role << " is cancelled";
+      return std::string("");
+    }
+    auto error_code = status.error_code();
+    if (error_code == grpc::StatusCode::UNIMPLEMENTED && received == 0) {
+      PH_LOG(WARNING, LogType::kTask)
+          << "peer [" << dest_node_.to_string() << "] "
+          << "does not support recv stream, use ForwardRecv for each message";
+      recv_stream_enabled_.store(false);
+      return forwardRecvOnce(role);
+    }
+    bool retriable = error_code == grpc::StatusCode::UNAVAILABLE ||
+                     error_code == grpc::StatusCode::INTERNAL ||
+                     error_code == grpc::StatusCode::UNKNOWN;
+    if (retriable && retry < kMaxRecvStreamRetry) {
+      PH_LOG(WARNING, LogType::kTask)
+          << "recv stream of key: " << role << " is broken, "
+          << "detail: " << error_code << ": " << status.error_message()
+          << ", reopen it after received: " << received;
+      auto backoff = std::chrono::milliseconds(100 * (retry + 1));
+      std::this_thread::sleep_for(backoff);
+      continue;
+    }
+    PH_LOG(ERROR, LogType::kTask)
+        << "recv data from stream encountes error, key: " << role << " "
+        << "detail: " << error_code << ": " << status.error_message();
+    return std::string("");
+  }
+}
+
+auto GrpcChannel::GetRecvStream(const std::string& role) ->
+    std::shared_ptr<RecvStream> {
+  std::lock_guard<std::mutex> lck(recv_stream_mtx_);
+  auto it = recv_streams_.find(role);
+  if (it != recv_streams_.end()) {
+    return it->second;
+  }
+  // stream lives as long as the channel, no deadline is set on it,
+  // it is cancelled when the task finished or the channel is destroyed
+  auto recv_stream = std::make_shared<RecvStream>();
+  recv_stream->received_base = recv_received_[role];
+  recv_stream->stream = stub_->ForwardRecvStream(&recv_stream->context);
+  rpc::RecvStreamRequest request;
+  BuildTaskInfo(request.mutable_task_info());
+  request.set_role(role);
+  request.set_credit(kRecvStreamWindow);
+  request.set_received(recv_stream->received_base);
+  recv_stream->stream->Write(request);
+  recv_streams_[role] = recv_stream;
+  return recv_stream;
+}
+
+void GrpcChannel::CloseRecvStream(const std::string& role) {
+  std::lock_guard<std::mutex> lck(recv_stream_mtx_);
+  auto it = recv_streams_.find(role);
+  if (it == recv_streams_.end()) {
+    return;
+  }
+  auto& recv_stream = it->second;
+  recv_received_[role] = recv_stream->received_base + recv_stream->recv_count;
+  recv_streams_.erase(it);
+}
+
+void GrpcChannel::cancelRecv(const std::string& role) {
+  std::lock_guard<std::mutex> lck(recv_stream_mtx_);
+  recv_cancelled_.insert(role);
+  auto it = recv_streams_.find(role);
+  if (it != recv_streams_.end()) {
+    it->second->context.TryCancel();
+  }
+  auto ctx_it = recv_once_ctx_.find(role);
+  if (ctx_it != recv_once_ctx_.end()) {
+    ctx_it->second->TryCancel();
+  }
+}
+
+bool GrpcChannel::IsRecvCancelled(const std::string& role) {
+  std::lock_guard<std::mutex> lck(recv_stream_mtx_);
+  return recv_cancelled_.find(role) != recv_cancelled_.end();
 }
 
-retcode GrpcChannel::buildTaskRequest(const std::string& role,
-    std::string_view data_sv, std::vector<rpc::TaskRequest>* send_pb_data) {
-  size_t sended_size = 0;
-  size_t max_package_size = LIMITED_PACKAGE_SIZE;  // limit data size 4M
-  size_t total_length = data_sv.size();
-  char* send_buf = const_cast<char*>(data_sv.data());
-  // VLOG(5) << "job_id: " << job_id << " "
-  //     << "task_id: " << task_id << " "
-  //     << "request id: " << request_id << " "
-  //     << "key: " << role << " "
-  //     << "send data length: " << total_length;
+retcode GrpcChannel::ReadFromRecvStream(RecvStream* recv_stream,
+                                        std::string* data) {
+  std::lock_guard<std::mutex> lck(recv_stream->mtx);
+  rpc::TaskRequest package;
+  bool init_flag{false};
+  size_t data_len{0};
   do {
-    rpc::TaskRequest task_request;
-    auto task_info = task_request.mutable_task_info();
-    BuildTaskInfo(task_info);
-    task_request.set_role(role);
-    task_request.set_data_len(total_length);
-    auto data_ptr = task_request.mutable_data();
-    data_ptr->reserve(max_package_size);
-    size_t data_len = std::min(max_package_size, total_length - sended_size);
-    data_ptr->append(send_buf + sended_size, data_len);
-    sended_size += data_len;
-    // VLOG(5) << "sended_size: " << sended_size << " data_len: " << data_len;
-    send_pb_data->emplace_back(std::move(task_request));
-    if (sended_size < total_length) {
-      continue;
-    } else {
-      break;
+    if (!recv_stream->stream->Read(&package)) {
+      return retcode::FAIL;
     }
-  } while (true);
+    if (!init_flag) {
+      data_len = package.data_len();
+      data->reserve(data_len);
+      init_flag = true;
+    }
+    data->append(package.data());
+  } while (data->size() < data_len);
+  recv_stream->recv_count++;
+  recv_stream->consumed++;
+  // grant credit in batch to reduce the number of writes
+  if (recv_stream->consumed >= kRecvStreamWindow / 2) {
+    rpc::RecvStreamRequest request;
+    request.set_credit(recv_stream->consumed);
+    request.set_received(recv_stream->received_base + recv_stream->recv_count);
+    recv_stream->stream->Write(request);
+    recv_stream->consumed = 0;
+  }
   return retcode::SUCCESS;
 }
 
-std::string GrpcChannel::forwardRecv(const std::string& role) {
+std::string GrpcChannel::forwardRecvOnce(const std::string& role) {
   SCopedTimer timer;
   grpc::ClientContext context;
   auto send_tiemout_ms = this->getLinkContext()->sendTimeout();
@@ -252,6 +358,13 @@ std::string GrpcChannel::forwardRecv(const std::string& role) {
   //         << " recv key: " << role
   //         << " nodeinfo: " << this->dest_node_.to_string();
   // using reader_t = grpc::ClientReader<rpc::TaskRequest>;
+  {
+    std::lock_guard<std::mutex> lck(recv_stream_mtx_);
+    if (recv_cancelled_.find(role) != recv_cancelled_.end()) {
+      return std::string("");
+    }
+    recv_once_ctx_[role] = &context;
+  }
   auto client_reader = this->stub_->ForwardRecv(&context, send_request);
 
   // waiting for response
@@ -272,6 +385,10 @@ std::string GrpcChannel::forwardRecv(const std::string& role) {
   }
 
   grpc::Status status = client_reader->Finish();
+  {
+    std::lock_guard<std::mutex> lck(recv_stream_mtx_);
+    recv_once_ctx_.erase(role);
+  }
   if (!status.ok()) {
     PH_LOG(ERROR, LogType::kTask)
         << "recv data encountes error, detail: "
@@ -525,6 +642,40 @@ retcode GrpcChannel::fetchTaskStatus(const rpc::TaskContext& request,
   return retcode::SUCCESS;
 }
 
+retcode GrpcChannel::watchTaskStatus(
+    const rpc::TaskContext& request,
+    const std::function<bool(const rpc::TaskStatus&)>& handler) {
+  std::string TASK_INFO_STR = pb_util::TaskInfoToString(request);
+  // no deadline is set, the stream lasts as long as the task runs
+  grpc::ClientContext context;
+  auto reader = stub_->WatchTaskStatus(&context, request);
+  rpc::TaskStatus task_status;
+  bool stopped_by_handler{false};
+  while (reader->Read(&task_status)) {
+    if (!handler(task_status)) {
+      stopped_by_handler = true;
+      context.TryCancel();
+      // drain the stream before Finish
+      while (reader->Read(&task_status)) {}
+      break;
+    }
+  }
+  grpc::Status status = reader->Finish();
+  if (stopped_by_handler || status.ok()) {
+    PH_VLOG(5, LogType::kTask)
+        << TASK_INFO_STR
+        << "WatchTaskStatus from node: ["
+        << dest_node_.to_string() << "] finished.";
+    return retcode::SUCCESS;
+  }
+  PH_LOG(WARNING, LogType::kTask)
+      << TASK_INFO_STR
+      << "WatchTaskStatus from Node ["
+      << dest_node_.to_string() << "] rpc failed. "
+      << status.error_code() << ": " << status.error_message();
+  return retcode::FAIL;
+}
+
 std::shared_ptr<IChannel> GrpcLinkContext::buildChannel(
     const primihub::Node& node,
     LinkContext* link_ctx) {
@@ -553,10 +704,18 @@ std::shared_ptr<IChannel> GrpcLinkContext::getChannel(
 // dataset related operation
 retcode GrpcChannel::DownloadData(const rpc::DownloadRequest& request,
                                   std::vector<std::string>* data) {
+  return DownloadData(request,
+      [&](const rpc::DownloadRespone& block,
+          std::string&& block_data) -> retcode {
+        data->push_back(std::move(block_data));
+        return retcode::SUCCESS;
+      });
+}
+
+retcode GrpcChannel::DownloadData(const rpc::DownloadRequest& request,
+                                  const DownloadHandler& handler) {
+  // no deadline, the stream lasts as long as the files are transferred
   grpc::ClientContext context;
-  auto deadline = std::chrono::system_clock::now() +
-      std::chrono::seconds(CONTROL_CMD_TIMEOUT_S);
-  context.set_deadline(deadline);
   auto client_reader = this->dataset_stub_->DownloadData(&context, request);
 
   const auto& request_id = request.request_id();
@@ -564,25 +723,124 @@ retcode GrpcChannel::DownloadData(const rpc::DownloadRequest& request,
   std::string TASK_INFO_STR = pb_util::TaskInfoToString(request_id);
   bool has_error{false};
   std::string err_msg;
+  std::string raw_data;
   while (client_reader->Read(&response)) {
     if (response.code() != rpc::Status::SUCCESS) {
       has_error = true;
       err_msg = response.info();
       break;
     }
-    auto block_data = response.mutable_data();
-    data->push_back(std::move(*block_data));
+    std::string block_data = std::move(*response.mutable_data());
+    response.clear_data();
+    if (response.compress_type() == rpc::CompressType::ZLIB) {
+      // raw_size comes from the peer, bound it before allocating
+      if (response.raw_size() > LIMITED_PACKAGE_SIZE) {
+        has_error = true;
+        err_msg = "raw size: " + std::to_string(response.raw_size()) +
+                  " of " + response.file_name() + " exceeds the block "
+                  "limit: " + std::to_string(LIMITED_PACKAGE_SIZE);
+        break;
+      }
+      auto ret = ZlibUncompress(block_data, response.raw_size(), &raw_data);
+      if (ret != retcode::SUCCESS) {
+        has_error = true;
+        err_msg = "uncompress data of " + response.file_name() +
+                  " at offset " + std::to_string(response.offset()) +
+                  " failed";
+        break;
+      }
+      block_data.swap(raw_data);
+    }
+    auto ret = handler(response, std::move(block_data));
+    if (ret != retcode::SUCCESS) {
+      has_error = true;
+      err_msg = "handle data of " + response.file_name() +
+                " at offset " + std::to_string(response.offset()) +
+                " failed";
+      break;
+    }
+  }
+  if (has_error) {
+    context.TryCancel();
+    while (client_reader->Read(&response)) {}
   }
 
   grpc::Status status = client_reader->Finish();
+  if (has_error) {
+    LOG(ERROR) << TASK_INFO_STR
+               << "download data encountes error: " << err_msg;
+    return retcode::FAIL;
+  }
   if (!status.ok()) {
     LOG(ERROR) << TASK_INFO_STR
                << "recv data encountes error, detail: "
                << status.error_code() << ": " << status.error_message();
     return retcode::FAIL;
   }
-  if (has_error) {
-    LOG(ERROR) << "download data encountes error: " << err_msg;
+  return retcode::SUCCESS;
+}
+
+retcode GrpcChannel::UploadData(const std::string& local_file,
+                                const std::string& remote_file,
+                                uint64_t offset,
+                                rpc::UploadFileResponse* reply) {
+  std::ifstream fin(local_file, std::ios::binary);
+  if (!fin) {
+    LOG(ERROR) << "open file: " << local_file << " failed";
+    return retcode::FAIL;
+  }
+  fin.seekg(0, std::ios::end);
+  uint64_t file_size = fin.tellg();
+  if (offset > file_size) {
+    LOG(ERROR) << "offset: " << offset << " is beyond the size of "
+               << local_file << ": " << file_size;
+    return retcode::FAIL;
+  }
+  fin.seekg(offset);
+  grpc::ClientContext context;
+  auto writer = this->dataset_stub_->UploadData(&context, reply);
+  rpc::UploadFileRequest request;
+  request.set_file_name(remote_file);
+  request.set_compress_type(rpc::CompressType::ZLIB);
+  std::string buf;
+  uint64_t pos = offset;
+  do {
+    size_t block_size = std::min<uint64_t>(LIMITED_PACKAGE_SIZE,
+                                           file_size - pos);
+    buf.resize(block_size);
+    if (block_size > 0) {
+      fin.read(&buf[0], block_size);
+      if (static_cast<size_t>(fin.gcount()) != block_size) {
+        LOG(ERROR) << "read file: " << local_file << " failed "
+                   << "at offset: " << pos;
+        context.TryCancel();
+        break;
+      }
+    }
+    auto ret = ZlibCompress(buf, request.mutable_data());
+    if (ret != retcode::SUCCESS) {
+      context.TryCancel();
+      break;
+    }
+    request.set_offset(pos);
+    request.set_raw_size(block_size);
+    pos += block_size;
+    request.set_is_end(pos >= file_size);
+    // a failed write means the server has finished the stream
+    if (!writer->Write(request)) {
+      break;
+    }
+  } while (pos < file_size);
+  writer->WritesDone();
+  grpc::Status status = writer->Finish();
+  if (!status.ok()) {
+    LOG(ERROR) << "upload " << local_file << " to node: ["
+               << dest_node_.to_string() << "] failed, "
+               << status.error_code() << ": " << status.error_message();
+    return retcode::FAIL;
+  }
+  if (reply->code() != rpc::Status::SUCCESS) {
+    LOG(ERROR) << "upload " << local_file << " failed: " << reply->info();
     return retcode::FAIL;
   }
   return retcode::SUCCESS;
@@ -5,9 +5,13 @@
 #include <grpcpp/channel.h>
 #include <grpcpp/create_channel.h>
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <string_view>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <memory>
 
@@ -21,7 +25,7 @@ namespace rpc = primihub::rpc;
 class GrpcChannel : public IChannel {
  public:
   GrpcChannel(const primihub::Node& node, LinkContext* link_ctx);
-  virtual ~GrpcChannel() = default;
+  virtual ~GrpcChannel();
   retcode send(const std::string& role, const std::string& data) override;
   retcode send(const std::string& role, std::string_view sv_data) override;
   bool send_wrapper(const std::string& role, const std::string& data) override;
@@ -44,18 +48,43 @@ class GrpcChannel : public IChannel {
                            rpc::Empty* reply) override;
   retcode fetchTaskStatus(const rpc::TaskContext& request,
                           rpc::TaskStatusReply* reply) override;
+  /**
+   * return FAIL without calling handler if the server does not support
+   * WatchTaskStatus, the caller falls back to fetchTaskStatus
+  */
+  retcode watchTaskStatus(
+      const rpc::TaskContext& request,
+      const std::function<bool(const rpc::TaskStatus&)>& handler) override;
+  /**
+   * receive next message of key from proxy,
+   * messages are pushed through a long-lived ForwardRecvStream for each key,
+   * a broken stream is reopened and proxy re-sends what was not received,
+   * fall back to one ForwardRecv rpc per message if peer does not support it
+  */
   std::string forwardRecv(const std::string& role) override;
-  retcode buildTaskRequest(const std::string& role,
-                           const std::string& data,
-                           std::vector<rpc::TaskRequest>* send_pb_data);
-  retcode buildTaskRequest(const std::string& role,
-                           std::string_view sv_data,
-                           std::vector<rpc::TaskRequest>* send_pb_data);
+  void cancelRecv(const std::string& role) override;
+  /**
+   * split data into packages of LIMITED_PACKAGE_SIZE and write them to stream
+   * one by one, the same request is reused for all packages,
+   * so the extra memory is bounded by one package.
+   * Write blocks until the package is accepted by grpc flow control,
+   * which provides back-pressure when the peer is slower than the sender
+  */
+  template<typename StreamWriter>
+  bool WriteTaskRequest(const std::string& role,
+                        std::string_view sv_data,
+                        StreamWriter* writer);
   std::shared_ptr<grpc::Channel> buildChannel(std::string& server_addr,
                                               bool use_tls);
   // data set related operation
   retcode DownloadData(const rpc::DownloadRequest& request,
                        std::vector<std::string>* data) override;
+  retcode DownloadData(const rpc::DownloadRequest& request,
+                       const DownloadHandler& handler) override;
+  retcode UploadData(const std::string& local_file,
+                     const std::string& remote_file,
+                     uint64_t offset,
+                     rpc::UploadFileResponse* reply) override;
   retcode CheckSendCompleteStatus(
       const std::string& key, uint64_t expected_complete_num) override;
   retcode NewDataset(const rpc::NewDatasetRequest& request,
@@ -65,6 +94,35 @@ class GrpcChannel : public IChannel {
   retcode BuildTaskInfo(rpc::TaskContext* task_info);
 
  private:
+  using RecvStreamRW =
+      grpc::ClientReaderWriter<rpc::RecvStreamRequest, rpc::TaskRequest>;
+  struct RecvStream {
+    grpc::ClientContext context;
+    std::unique_ptr<RecvStreamRW> stream{nullptr};
+    std::mutex mtx;
+    uint64_t received_base{0};  // messages received by former streams
+    uint64_t recv_count{0};
+    uint64_t consumed{0};  // messages consumed since last credit grant
+  };
+  // messages in flight for each recv stream
+  static constexpr uint64_t kRecvStreamWindow = 16;
+  // times to reopen a broken recv stream for one message
+  static constexpr int kMaxRecvStreamRetry = 3;
+  std::string forwardRecvOnce(const std::string& role);
+  std::shared_ptr<RecvStream> GetRecvStream(const std::string& role);
+  void CloseRecvStream(const std::string& role);
+  bool IsRecvCancelled(const std::string& role);
+  retcode ReadFromRecvStream(RecvStream* recv_stream, std::string* data);
+
+ private:
+  std::mutex recv_stream_mtx_;
+  std::unordered_map<std::string, std::shared_ptr<RecvStream>> recv_streams_;
+  // messages received for each key over all of its streams
+  std::unordered_map<std::string, uint64_t> recv_received_;
+  // keys cancelled by cancelRecv and running ForwardRecv calls
+  std::unordered_set<std::string> recv_cancelled_;
+  std::unordered_map<std::string, grpc::ClientContext*> recv_once_ctx_;
+  std::atomic<bool> recv_stream_enabled_{true};
   std::unique_ptr<rpc::VMNode::Stub> stub_{nullptr};
   std::unique_ptr<rpc::DataSetService::Stub> dataset_stub_{nullptr};
   std::shared_ptr<grpc::Channel> grpc_channel_{nullptr};
@@ -72,6 +130,28 @@ class GrpcChannel : public IChannel {
   int retry_max_times_{3};
 };
 
+template<typename StreamWriter>
+bool GrpcChannel::WriteTaskRequest(const std::string& role,
+                                   std::string_view sv_data,
+                                   StreamWriter* writer) {
+  size_t max_package_size = LIMITED_PACKAGE_SIZE;
+  size_t total_length = sv_data.size();
+  size_t sended_size = 0;
+  rpc::TaskRequest task_request;
+  BuildTaskInfo(task_request.mutable_task_info());
+  task_request.set_role(role);
+  task_request.set_data_len(total_length);
+  do {
+    size_t data_len = std::min(max_package_size, total_length - sended_size);
+    task_request.set_data(sv_data.data() + sended_size, data_len);
+    sended_size += data_len;
+    if (!writer->Write(task_request, grpc::WriteOptions())) {
+      return false;
+    }
+  } while (sended_size < total_length);
+  return true;
+}
+
 class GrpcLinkContext : public LinkContext {
  public:
   GrpcLinkContext() = default;
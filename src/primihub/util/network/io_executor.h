@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2023 by PrimiHub
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      https://www.apache.org/licenses/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_PRIMIHUB_UTIL_NETWORK_IO_EXECUTOR_H_
+#define SRC_PRIMIHUB_UTIL_NETWORK_IO_EXECUTOR_H_
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace primihub::network {
+/**
+ * executor for blocking channel I/O operations
+ * operations are posted to a strand, operations of the same strand run
+ * one by one in the order of posting, different strands run concurrently.
+ * worker threads are created on demand and reused, so a blocked recv does
+ * not cost a new OS thread for each message.
+ * a strand created as blocking, e.g. recv which waits for data sent by
+ * another strand, runs on its own group of workers which is not capped:
+ * if blocked recvs could take all of the max_thread_num workers, the sends
+ * they wait for would never be scheduled. other strands share at most
+ * max_thread_num workers.
+*/
+class IoExecutor {
+ public:
+  using StrandId = uint64_t;
+  /**
+   * task is called with cancelled = true if it is dropped by CancelStrand
+   * before running, the task is expected to report the cancellation to
+   * its completion handler
+  */
+  using Task = std::function<void(bool cancelled)>;
+
+  explicit IoExecutor(size_t max_thread_num = 0) {
+    if (max_thread_num == 0) {
+      max_thread_num = DefaultMaxThreadNum();
+    }
+    max_thread_num_ = max_thread_num;
+    lanes_[kBoundedLane].max_thread_num = max_thread_num;
+    lanes_[kBlockingLane].max_thread_num = SIZE_MAX;
+  }
+
+  ~IoExecutor() {
+    {
+      std::lock_guard<std::mutex> lck(mtx_);
+      stop_ = true;
+    }
+    for (auto& lane : lanes_) {
+      lane.cv.notify_all();
+    }
+    for (auto& lane : lanes_) {
+      for (auto& worker : lane.workers) {
+        if (worker.joinable()) {
+          worker.join();
+        }
+      }
+    }
+  }
+
+  IoExecutor(const IoExecutor&) = delete;
+  IoExecutor& operator=(const IoExecutor&) = delete;
+
+  /**
+   * executor shared by all message interfaces of the process
+  */
+  static IoExecutor& Global() {
+    // never destroyed, worker may still be blocked in recv at process exit
+    static auto* executor = new IoExecutor();
+    return *executor;
+  }
+
+  static size_t DefaultMaxThreadNum() {
+    size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+    return std::max<size_t>(64, 4 * cores);
+  }
+
+  /**
+   * blocking: tasks of the strand may wait for tasks of other strands
+  */
+  StrandId NewStrand(bool blocking = false) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    // the lowest bit of the id tells the lane of the strand
+    return (++strand_id_seq_ << 1) | (blocking ? kBlockingLane : kBoundedLane);
+  }
+
+  /**
+   * run task after all tasks posted before on the same strand
+  */
+  void Post(StrandId strand_id, Task task) {
+    bool cancelled{false};
+    auto& lane = LaneOf(strand_id);
+    {
+      std::lock_guard<std::mutex> lck(mtx_);
+      if (stop_) {
+        cancelled = true;
+      } else {
+        auto& strand = strands_[strand_id];
+        strand.tasks.emplace_back(std::move(task));
+        // running strand is requeued by its worker when the task finishes
+        if (!strand.scheduled && !strand.running) {
+          strand.scheduled = true;
+          lane.ready_strands.push_back(strand_id);
+          SpawnWorkerIfNeeded(&lane);
+        }
+      }
+    }
+    if (cancelled) {
+      task(true);
+      return;
+    }
+    lane.cv.notify_one();
+  }
+
+  /**
+   * drop tasks of strand which are not started yet,
+   * dropped tasks are called with cancelled = true in the caller thread,
+   * running task is not interrupted.
+   * wait: block until the running task of the strand returns, so that
+   * the owner of the strand can be destroyed safely. not waited if called
+   * from the running task itself
+  */
+  void CancelStrand(StrandId strand_id, bool wait = false) {
+    std::deque<Task> dropped;
+    {
+      std::lock_guard<std::mutex> lck(mtx_);
+      auto it = strands_.find(strand_id);
+      if (it == strands_.end()) {
+        return;
+      }
+      dropped.swap(it->second.tasks);
+      if (!it->second.scheduled && !it->second.running) {
+        strands_.erase(it);
+      }
+    }
+    for (auto& task : dropped) {
+      task(true);
+    }
+    if (!wait) {
+      return;
+    }
+    std::unique_lock<std::mutex> lck(mtx_);
+    idle_cv_.wait(lck, [this, strand_id]() {
+      auto it = strands_.find(strand_id);
+      return it == strands_.end() || !it->second.running ||
+             it->second.runner == std::this_thread::get_id();
+    });
+  }
+
+  /**
+   * number of workers of all strands
+  */
+  size_t ThreadNum() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return lanes_[kBoundedLane].workers.size() +
+           lanes_[kBlockingLane].workers.size();
+  }
+
+  /**
+   * number of workers of non-blocking strands
+  */
+  size_t BoundedThreadNum() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return lanes_[kBoundedLane].workers.size();
+  }
+
+  size_t MaxThreadNum() const {return max_thread_num_;}
+
+ private:
+  static constexpr StrandId kBoundedLane = 0;
+  static constexpr StrandId kBlockingLane = 1;
+  struct Strand {
+    std::deque<Task> tasks;
+    bool scheduled{false};  // in ready_strands of its lane
+    bool running{false};    // a task of this strand is running
+    std::thread::id runner;  // worker running the task
+  };
+  /**
+   * workers and ready strands of a lane, a worker runs strands of its
+   * own lane only
+  */
+  struct Lane {
+    std::vector<std::thread> workers;
+    std::deque<StrandId> ready_strands;
+    size_t idle_thread_num{0};
+    size_t max_thread_num{0};
+    std::condition_variable cv;
+  };
+
+  Lane& LaneOf(StrandId strand_id) {
+    return lanes_[strand_id & 1];
+  }
+
+  /**
+   * every ready strand should have a worker to pick it up,
+   * otherwise it may wait behind a blocked recv. call with mtx_ held
+  */
+  void SpawnWorkerIfNeeded(Lane* lane) {
+    if (lane->ready_strands.size() > lane->idle_thread_num &&
+        lane->workers.size() < lane->max_thread_num) {
+      lane->workers.emplace_back([this, lane]() { this->WorkerLoop(lane); });
+    }
+  }
+
+  void WorkerLoop(Lane* lane) {
+    std::unique_lock<std::mutex> lck(mtx_);
+    while (true) {
+      lane->idle_thread_num++;
+      lane->cv.wait(lck,
+          [this, lane]() { return stop_ || !lane->ready_strands.empty(); });
+      lane->idle_thread_num--;
+      if (lane->ready_strands.empty()) {  // stopped
+        return;
+      }
+      StrandId strand_id = lane->ready_strands.front();
+      lane->ready_strands.pop_front();
+      auto& strand = strands_[strand_id];
+      strand.scheduled = false;
+      if (strand.tasks.empty()) {  // cancelled before running
+        strands_.erase(strand_id);
+        continue;
+      }
+      Task task = std::move(strand.tasks.front());
+      strand.tasks.pop_front();
+      strand.running = true;
+      strand.runner = std::this_thread::get_id();
+      lck.unlock();
+      task(false);
+      lck.lock();
+      // strands_ may be rehashed while unlocked, look it up again
+      auto& finished = strands_[strand_id];
+      finished.running = false;
+      finished.runner = std::thread::id();
+      idle_cv_.notify_all();
+      if (finished.tasks.empty()) {
+        strands_.erase(strand_id);
+      } else {
+        // requeue at the back so that busy strands do not starve others
+        finished.scheduled = true;
+        lane->ready_strands.push_back(strand_id);
+        SpawnWorkerIfNeeded(lane);
+        lane->cv.notify_one();
+      }
+    }
+  }
+
+ private:
+  size_t max_thread_num_{0};
+  Lane lanes_[2];
+  std::unordered_map<StrandId, Strand> strands_;
+  StrandId strand_id_seq_{0};
+  std::mutex mtx_;
+  // notified when a task finishes, waited by CancelStrand
+  std::condition_variable idle_cv_;
+  bool stop_{false};
+};
+}  // namespace primihub::network
+#endif  // SRC_PRIMIHUB_UTIL_NETWORK_IO_EXECUTOR_H_
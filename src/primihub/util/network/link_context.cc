@@ -80,6 +80,11 @@ LinkContext::StatusDataQueue& LinkContext::GetCompleteQueue(
   }
 }
 
+ForwardWindow& LinkContext::GetForwardWindow(const std::string& key) {
+  std::lock_guard<std::mutex> lck(this->forward_window_mtx);
+  return forward_windows[key];
+}
+
 retcode LinkContext::Send(const std::string& key,
                           const Node& dest_node,
                           const std::string& send_buf) {
@@ -152,6 +157,11 @@ retcode LinkContext::Recv(const std::string& key,
   return retcode::SUCCESS;
 }
 
+void LinkContext::CancelRecv(const std::string& key, const Node& dest_node) {
+  auto ch = getChannel(dest_node);
+  ch->cancelRecv(key);
+}
+
 retcode LinkContext::SendRecv(const std::string& key,
                               const Node& dest_node,
                               std::string_view send_buf,
@@ -6,12 +6,14 @@
 #include <unordered_map>
 #include <shared_mutex>
 #include <memory>
+#include <functional>
 
 #include "src/primihub/common/common.h"
 #include "src/primihub/common/config/config.h"
 #include "src/primihub/protos/worker.pb.h"
 #include "src/primihub/protos/service.pb.h"
 #include "src/primihub/util/threadsafe_queue.h"
+#include "src/primihub/util/network/forward_window.h"
 
 namespace primihub::network {
 namespace rpc = primihub::rpc;
@@ -88,6 +90,11 @@ class LinkContext {
   StringDataQueue& GetRecvQueue(const std::string& key = "default");
   StringDataQueue& GetSendQueue(const std::string& key = "default");
   StatusDataQueue& GetCompleteQueue(const std::string& role = "default");
+  /**
+   * messages of key forwarded through recv streams but not yet
+   * acknowledged by the receiver
+  */
+  ForwardWindow& GetForwardWindow(const std::string& key);
 
   void Clean();
   retcode Send(const std::string& key,
@@ -127,6 +134,11 @@ class LinkContext {
   retcode CheckSendCompleteStatus(const std::string& key,
                                   const Node& dest_node,
                                   uint64_t expected_complete_num);
+  /**
+   * unblock Recv of key from dest_node and fail later ones,
+   * used to stop a receiving thread when the task fails
+  */
+  void CancelRecv(const std::string& key, const Node& dest_node);
 
  protected:
   bool HasStopped() {
@@ -150,6 +162,9 @@ class LinkContext {
 
   std::mutex complete_queue_mtx;
   StatusDataContainer complete_queue;
+
+  std::mutex forward_window_mtx;
+  std::unordered_map<std::string, ForwardWindow> forward_windows;
   std::atomic<bool> stop_{false};
 };
 
@@ -180,13 +195,42 @@ class IChannel {
                                    rpc::Empty* reply) = 0;
   virtual retcode fetchTaskStatus(const rpc::TaskContext& request,
                                   rpc::TaskStatusReply* reply) = 0;
+  /**
+   * call handler for each status of the task as soon as the server has it,
+   * until the task has finished or handler returns false
+  */
+  virtual retcode watchTaskStatus(
+      const rpc::TaskContext& request,
+      const std::function<bool(const rpc::TaskStatus&)>& handler) = 0;
   virtual retcode StopTask(const rpc::TaskContext& request,
                            rpc::Empty* reply) = 0;
   virtual retcode DownloadData(const rpc::DownloadRequest& request,
                                std::vector<std::string>* data) = 0;
+  /**
+   * call handler with each uncompressed block as soon as it is received,
+   * the data of block is moved into data.
+   * stop downloading if handler does not return SUCCESS
+  */
+  using DownloadHandler = std::function<retcode(
+      const rpc::DownloadRespone& block, std::string&& data)>;
+  virtual retcode DownloadData(const rpc::DownloadRequest& request,
+                               const DownloadHandler& handler) = 0;
+  /**
+   * upload local_file as remote_file from offset,
+   * reply has the size received by the server when it fails
+  */
+  virtual retcode UploadData(const std::string& local_file,
+                             const std::string& remote_file,
+                             uint64_t offset,
+                             rpc::UploadFileResponse* reply) = 0;
   virtual retcode NewDataset(const rpc::NewDatasetRequest& request,
                              rpc::NewDatasetResponse* reply) = 0;
   virtual std::string forwardRecv(const std::string& key) = 0;
+  /**
+   * forwardRecv of key waiting on the channel returns empty data,
+   * so do later ones
+  */
+  virtual void cancelRecv(const std::string& key) = 0;
   virtual retcode CheckSendCompleteStatus(
       const std::string& key, uint64_t expected_complete_num) = 0;
 
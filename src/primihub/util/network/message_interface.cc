@@ -62,6 +62,7 @@ void TaskMessagePassInterface::_channelSend(
     }
   }
 
+  send_count_.fetch_sub(1);
   if (cancel_) {
     errcode = boost::system::errc::make_error_code(
         boost::system::errc::operation_canceled);
@@ -77,8 +78,6 @@ void TaskMessagePassInterface::_channelSend(
   }
 
   fn(errcode, bytes_send);
-
-  send_count_.fetch_sub(1);
   return;
 }
 
@@ -86,16 +85,7 @@ void TaskMessagePassInterface::_channelRecv(
     const std::string recv_key, ThreadSafeQueue<std::string> &queue,
     osuCrypto::span<boost::asio::mutable_buffer> buffers,
     io_completion_handle &&fn) {
-  std::shared_ptr<WaitLock> wait_lock(new WaitLock());
-  {
-    std::lock_guard<std::mutex> lock(recv_queue_mu_);
-    if (!recv_wait_queue_.empty()) {
-      recv_wait_queue_.push(wait_lock);
-      wait_lock->wait();
-    }
-  }
-
-  if (recv_count_.fetch_add(1) > 1)
+  if (recv_count_.fetch_add(1) > 0)
     LOG(WARNING) << "Parallel recv detected, current recv count is "
                  << recv_count_.load() << ".";
 
@@ -162,16 +152,6 @@ void TaskMessagePassInterface::_channelRecv(
   fn(errcode, bytes_recv);
 
   recv_count_.fetch_sub(1);
-  {
-    std::shared_ptr<WaitLock> wait_lock;
-    std::lock_guard<std::mutex> lock(recv_queue_mu_);
-    if (!recv_wait_queue_.empty()) {
-      wait_lock = recv_wait_queue_.front();
-      recv_wait_queue_.pop();
-      wait_lock->notify();
-    }
-  }
-
   return;
 }
 
@@ -179,13 +159,14 @@ void TaskMessagePassInterface::async_send(
     osuCrypto::span<boost::asio::mutable_buffer> buffers,
     io_completion_handle &&fn) {
   std::string send_key = SendKey();
-  auto send_fn = std::bind(&TaskMessagePassInterface::_channelSend, this,
-                           std::placeholders::_1, std::placeholders::_2,
-                           std::placeholders::_3);
-
-  auto send_thread = std::thread(send_fn, send_key, buffers, std::move(fn));
-  send_thread.detach();
-  // _channelSend(send_key, buffers, std::move(fn));
+  IoExecutor::Global().Post(send_strand_,
+      [this, send_key, buffers, fn = std::move(fn)](bool cancelled) mutable {
+        if (cancelled || cancel_) {
+          CompleteCancelled(&fn);
+          return;
+        }
+        _channelSend(send_key, buffers, std::move(fn));
+      });
 }
 
 void TaskMessagePassInterface::async_recv(
@@ -193,17 +174,26 @@ void TaskMessagePassInterface::async_recv(
     io_completion_handle &&fn) {
   std::string recv_key = RecvKey();
   auto &recv_queue = link_context_->GetRecvQueue(recv_key);
-  // _channelRecv(recv_key, recv_queue, buffers, std::move(fn));
-  auto recv_fn = std::bind(&TaskMessagePassInterface::_channelRecv, this,
-                           std::placeholders::_1, std::placeholders::_2,
-                           std::placeholders::_3, std::placeholders::_4);
-
-  auto recv_thread = std::thread(recv_fn, recv_key,
-                                 std::ref(recv_queue), buffers, std::move(fn));
-  recv_thread.detach();
+  IoExecutor::Global().Post(recv_strand_,
+      [this, recv_key, &recv_queue, buffers, fn = std::move(fn)](
+          bool cancelled) mutable {
+        if (cancelled || cancel_) {
+          CompleteCancelled(&fn);
+          return;
+        }
+        _channelRecv(recv_key, recv_queue, buffers, std::move(fn));
+      });
 }
 
-void TaskMessagePassInterface::cancel() {
+void TaskMessagePassInterface::cancel(bool wait) {
   this->cancel_.store(true);
+  IoExecutor::Global().CancelStrand(send_strand_, wait);
+  IoExecutor::Global().CancelStrand(recv_strand_, wait);
+}
+
+void TaskMessagePassInterface::CompleteCancelled(io_completion_handle* fn) {
+  auto errcode = boost::system::errc::make_error_code(
+      boost::system::errc::operation_canceled);
+  (*fn)(errcode, 0);
 }
 }  // namespace primihub::network
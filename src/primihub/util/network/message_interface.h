@@ -10,6 +10,7 @@
 #include "cryptoTools/Common/Defines.h"
 #include "cryptoTools/Network/SocketAdapter.h"
 #include "src/primihub/util/network/grpc_link_context.h"
+#include "src/primihub/util/network/io_executor.h"
 #include "src/primihub/util/network/link_context.h"
 #include "src/primihub/util/threadsafe_queue.h"
 
@@ -56,15 +57,22 @@ class TaskMessagePassInterface : public SocketInterface {
                            const std::string &peer_node_id,
                            LinkContext *link_context,
                            std::shared_ptr<network::IChannel> send_channel,
-                           std::shared_ptr<network::IChannel> recv_channel) {
-    Init(local_node_id, peer_node_id, link_context, send_channel, recv_channel);
+                           std::shared_ptr<network::IChannel> recv_channel,
+                           const std::string& channel_id = "") {
+    Init(local_node_id, peer_node_id, link_context, send_channel, recv_channel,
+         channel_id);
   }
 
+  /**
+   * channel_id separates parallel logical channels between the same parties,
+   * the keys of the default empty id are unchanged
+  */
   void Init(const std::string& local_party,
             const std::string remote_party,
             LinkContext* link_context,
             std::shared_ptr<network::IChannel> send_channel,
-            std::shared_ptr<network::IChannel> recv_channel = nullptr) {
+            std::shared_ptr<network::IChannel> recv_channel = nullptr,
+            const std::string& channel_id = "") {
     job_id_ = link_context->job_id();
     task_id_ = link_context->task_id();
     request_id_ = link_context->request_id();
@@ -80,21 +88,33 @@ class TaskMessagePassInterface : public SocketInterface {
             << sub_task_id_ << "_"
             << local_node_id_ << "_"
             << peer_node_id_;
+    if (!channel_id.empty()) {
+      ss_send << "_" << channel_id;
+    }
     send_key_ = ss_send.str();
     std::stringstream ss_recv;
     ss_recv << request_id_ << "_"
             << sub_task_id_ << "_"
             << peer_node_id_ << "_"
             << local_node_id_;
+    if (!channel_id.empty()) {
+      ss_recv << "_" << channel_id;
+    }
     recv_key_ = ss_recv.str();
     send_count_.store(0);
     recv_count_.store(0);
+    // one strand for each direction keeps send/recv order of the key,
+    // recv waits for the peer and must not hold a worker of the sends
+    send_strand_ = IoExecutor::Global().NewStrand();
+    recv_strand_ = IoExecutor::Global().NewStrand(true);
     VLOG(3) << "job_id " << job_id_ << ", task_id " << task_id_
             << ", request_id " << request_id_
             << ", local_node " << local_node_id_ << ", peer node "
             << peer_node_id_;
   }
-  ~TaskMessagePassInterface() {}
+  ~TaskMessagePassInterface() {
+    cancel(/*wait=*/true);
+  }
 
   void async_recv(osuCrypto::span<boost::asio::mutable_buffer> buffers,
                   io_completion_handle &&fn) override;
@@ -102,24 +122,19 @@ class TaskMessagePassInterface : public SocketInterface {
   void async_send(osuCrypto::span<boost::asio::mutable_buffer> buffers,
                   io_completion_handle &&fn) override;
 
-  void cancel();
+  /**
+   * stop running operation at the next buffer boundary and complete
+   * the queued operations with operation_canceled
+  */
+  void cancel() override {cancel(/*wait=*/false);}
+  /**
+   * wait: also block until the running operations return,
+   * they use members of this object
+  */
+  void cancel(bool wait);
 
  private:
-  class WaitLock {
-   public:
-      void wait(void) {
-        std::unique_lock<std::mutex> lock(mu_);
-        cv_.wait(lock);
-      }
-
-      void notify(void) {
-        cv_.notify_all();
-      }
-
-   private:
-      std::mutex mu_;
-      std::condition_variable cv_;
-  };
+  static void CompleteCancelled(io_completion_handle* fn);
 
   void _channelSend(const std::string send_key,
                     osuCrypto::span<boost::asio::mutable_buffer> buffers,
@@ -145,10 +160,10 @@ class TaskMessagePassInterface : public SocketInterface {
   std::shared_ptr<network::IChannel> send_channel_;
   std::shared_ptr<network::IChannel> recv_channel_;
   network::LinkContext* link_context_{nullptr};
-  // All receive threads must get a message in the order in which they start,
-  // the queue and the mutex guarantee it.
-  std::queue<std::shared_ptr<WaitLock>> recv_wait_queue_;
-  std::mutex recv_queue_mu_;
+  // operations are run by the shared io executor, receive operations get
+  // messages in the order in which they are posted, the strand guarantees it.
+  IoExecutor::StrandId send_strand_{0};
+  IoExecutor::StrandId recv_strand_{0};
   std::atomic_int send_count_{0};
   std::atomic_int recv_count_{0};
   std::string send_key_;
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2023 by PrimiHub
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      https://www.apache.org/licenses/
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_PRIMIHUB_UTIL_THREAD_POOL_H_
+#define SRC_PRIMIHUB_UTIL_THREAD_POOL_H_
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace primihub {
+/**
+ * fixed size thread pool,
+ * tasks are executed in FIFO order by the first idle worker
+*/
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t thread_num = 0) {
+    if (thread_num == 0) {
+      thread_num = DefaultThreadNum();
+    }
+    workers_.reserve(thread_num);
+    for (size_t i = 0; i < thread_num; i++) {
+      workers_.emplace_back([this]() { this->WorkerLoop(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lck(mtx_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  template<typename F, typename... Args>
+  auto enqueue(F&& f, Args&&... args)
+      -> std::future<std::invoke_result_t<F, Args...>> {
+    using return_type = std::invoke_result_t<F, Args...>;
+    auto task = std::make_shared<std::packaged_task<return_type()>>(
+        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    std::future<return_type> fut = task->get_future();
+    {
+      std::lock_guard<std::mutex> lck(mtx_);
+      if (stop_) {
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+      }
+      tasks_.emplace([task]() { (*task)(); });
+    }
+    cv_.notify_one();
+    return fut;
+  }
+
+  size_t size() const {return workers_.size();}
+
+  static size_t DefaultThreadNum() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+
+ private:
+  void WorkerLoop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lck(mtx_);
+        cv_.wait(lck, [this]() { return stop_ || !tasks_.empty(); });
+        if (stop_ && tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop();
+      }
+      task();
+    }
+  }
+
+ private:
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  bool stop_{false};
+};
+}  // namespace primihub
+#endif  // SRC_PRIMIHUB_UTIL_THREAD_POOL_H_
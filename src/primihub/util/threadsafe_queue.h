@@ -2,10 +2,12 @@
 #ifndef SRC_PRIMIHUB_UTIL_THREADSAFE_QUEUE_H_
 #define SRC_PRIMIHUB_UTIL_THREADSAFE_QUEUE_H_
 
+#include <algorithm>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <chrono>
 
 namespace primihub {
 template<typename T>
@@ -56,6 +58,23 @@ class ThreadSafeQueue {
     m_queue.pop();
   }
 
+  /**
+   * return false if no item is available within timeout or queue is shutdown
+  */
+  template<typename Rep, typename Period>
+  bool wait_and_pop_for(T& popped_value,
+                        const std::chrono::duration<Rep, Period>& timeout) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool ready = m_cv.wait_for(lock, timeout,
+        [&]() {return stop_.load() || !m_queue.empty();});
+    if (!ready || stop_.load()) {
+      return false;
+    }
+    popped_value = std::move(m_queue.front());
+    m_queue.pop();
+    return true;
+  }
+
   // Provides only basic exception safety guarantee when RVO is not applied.
   T pop() {
     std::unique_lock<std::mutex> lock(m_mutex);
@@ -82,5 +101,73 @@ class ThreadSafeQueue {
   std::condition_variable m_cv;
   std::atomic<bool> stop_{false};
 };
+
+/**
+ * queue holds at most capacity items, push blocks while it is full,
+ * so a producer faster than the consumer is throttled instead of
+ * buffering without limit. shutdown wakes up both sides
+*/
+template<typename T>
+class BoundedThreadSafeQueue {
+ public:
+  explicit BoundedThreadSafeQueue(size_t capacity) :
+      capacity_(std::max<size_t>(capacity, 1)) {}
+
+  /**
+   * return false if the queue is shutdown, item is dropped
+  */
+  bool push(T&& item) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    not_full_cv_.wait(lock,
+        [&]() {return stop_ || m_queue.size() < capacity_;});
+    if (stop_) {
+      return false;
+    }
+    m_queue.push(std::move(item));
+    lock.unlock();
+    not_empty_cv_.notify_one();
+    return true;
+  }
+
+  /**
+   * return false if the queue is shutdown
+  */
+  bool wait_and_pop(T& popped_value) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    not_empty_cv_.wait(lock, [&]() {return stop_ || !m_queue.empty();});
+    if (stop_) {
+      return false;
+    }
+    popped_value = std::move(m_queue.front());
+    m_queue.pop();
+    lock.unlock();
+    not_full_cv_.notify_one();
+    return true;
+  }
+
+  size_t size() const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_queue.size();
+  }
+
+  size_t capacity() const {return capacity_;}
+
+  void shutdown() {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      stop_ = true;
+    }
+    not_full_cv_.notify_all();
+    not_empty_cv_.notify_all();
+  }
+
+ private:
+  std::queue<T> m_queue;
+  const size_t capacity_;
+  mutable std::mutex m_mutex;
+  std::condition_variable not_full_cv_;
+  std::condition_variable not_empty_cv_;
+  bool stop_{false};
+};
 }  // namespace primihub
 #endif  // SRC_PRIMIHUB_UTIL_THREADSAFE_QUEUE_H_
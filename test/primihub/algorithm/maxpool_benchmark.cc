@@ -0,0 +1,150 @@
+// Copyright [2023] <primihub.com>
+// rows/s of the cryptflow2 maxpool executor with 1, 2, 4, ... threads
+// two parties run in a parent and a forked child process on localhost,
+// each party reads a csv of random shares with num_rows x num_cols values
+// usage: maxpool_benchmark [num_rows] [num_cols] [max_threads]
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/primihub/algorithm/cryptflow2_maxpool.h"
+#include "src/primihub/service/dataset/meta_service/factory.h"
+
+namespace primihub {
+void WriteShareFile(const std::string& file_path, int num_rows, int num_cols,
+                    uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::ofstream fout(file_path, std::ios::trunc);
+  for (int c = 0; c < num_cols; c++) {
+    fout << "c" << c << (c == num_cols - 1 ? "\n" : ",");
+  }
+  for (int i = 0; i < num_rows; i++) {
+    for (int c = 0; c < num_cols; c++) {
+      fout << gen() << (c == num_cols - 1 ? "\n" : ",");
+    }
+  }
+}
+
+std::shared_ptr<DatasetService> BuildDatasetService(
+    const std::string& dataset_id, const std::string& file_path) {
+  primihub::Node node;
+  auto meta_service = service::MetaServiceFactory::Create(
+      service::MetaServiceMode::MODE_MEMORY, node);
+  auto service = std::make_shared<DatasetService>(std::move(meta_service));
+  DatasetMetaInfo meta{dataset_id, "csv", file_path};
+  auto access_info = service->createAccessInfo(meta.driver_type, meta);
+  std::string access_meta = access_info->toString();
+  auto driver = DataDirverFactory::getDriver(meta.driver_type, "bench addr",
+                                             std::move(access_info));
+  service->registerDriver(dataset_id, driver);
+  service::DatasetMeta meta_;
+  service->newDataset(driver, dataset_id, access_meta, &meta_);
+  return service;
+}
+
+void BuildTask(const std::string& role, const std::vector<rpc::Node>& nodes,
+               const std::string& dataset_id, int num_threads,
+               rpc::Task* task) {
+  task->set_party_name(role);
+  auto party_access_info = task->mutable_party_access_info();
+  (*party_access_info)["PARTY0"].CopyFrom(nodes[0]);
+  (*party_access_info)["PARTY1"].CopyFrom(nodes[1]);
+  auto task_info = task->mutable_task_info();
+  task_info->set_task_id("maxpool_benchmark");
+  task_info->set_job_id("maxpool_benchmark");
+  task_info->set_request_id("maxpool_benchmark");
+  auto datasets = (*task->mutable_party_datasets())[role].mutable_data();
+  (*datasets)[role] = dataset_id;
+  rpc::ParamValue pv_num_threads;
+  pv_num_threads.set_var_type(rpc::VarType::INT32);
+  pv_num_threads.set_value_int32(num_threads);
+  auto param_map = task->mutable_params()->mutable_param_map();
+  (*param_map)["NumThreads"] = pv_num_threads;
+}
+
+std::vector<rpc::Node> BuildNodes(uint32_t port) {
+  std::vector<rpc::Node> nodes(2);
+  for (int i = 0; i < 2; i++) {
+    nodes[i].set_node_id("node" + std::to_string(i));
+    nodes[i].set_ip("127.0.0.1");
+    auto vm = nodes[i].add_vm();
+    vm->set_party_id(i);
+    auto next = vm->mutable_next();
+    next->set_ip("127.0.0.1");
+    next->set_port(port);
+    next->set_link_type(i == 0 ? rpc::LinkType::SERVER :
+                                 rpc::LinkType::CLIENT);
+  }
+  return nodes;
+}
+
+/**
+ * return seconds cost by execute or -1 on failure,
+ * setup of io and base ots is not included
+*/
+double RunParty(const std::string& role, const std::vector<rpc::Node>& nodes,
+                const std::string& file_path, int num_threads) {
+  std::string dataset_id = role + "_share";
+  auto service = BuildDatasetService(dataset_id, file_path);
+  rpc::Task task;
+  BuildTask(role, nodes, dataset_id, num_threads, &task);
+  PartyConfig config(role == "PARTY0" ? "node0" : "node1", task);
+  cryptflow2::MaxPoolExecutor exec(config, service);
+  if (exec.loadParams(task) != 0 || exec.initPartyComm() != 0 ||
+      exec.loadDataset() != 0) {
+    return -1;
+  }
+  auto start = std::chrono::high_resolution_clock::now();
+  int ret = exec.execute();
+  auto end = std::chrono::high_resolution_clock::now();
+  exec.finishPartyComm();
+  if (ret != 0) {
+    return -1;
+  }
+  return std::chrono::duration<double>(end - start).count();
+}
+}  // namespace primihub
+
+int main(int argc, char** argv) {
+  int num_rows = argc > 1 ? std::stoi(argv[1]) : 1 << 16;
+  int num_cols = argc > 2 ? std::stoi(argv[2]) : 9;
+  int max_threads = argc > 3 ? std::stoi(argv[3]) :
+      static_cast<int>(std::thread::hardware_concurrency());
+  std::string party0_file = "/tmp/maxpool_benchmark_party0.csv";
+  std::string party1_file = "/tmp/maxpool_benchmark_party1.csv";
+  primihub::WriteShareFile(party0_file, num_rows, num_cols, 1);
+  primihub::WriteShareFile(party1_file, num_rows, num_cols, 2);
+
+  uint32_t port = 32000;
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    auto nodes = primihub::BuildNodes(port);
+    pid_t pid = fork();
+    if (pid == 0) {
+      primihub::RunParty("PARTY1", nodes, party1_file, num_threads);
+      return 0;
+    }
+    double cost_s = primihub::RunParty("PARTY0", nodes, party0_file,
+                                       num_threads);
+    waitpid(pid, nullptr, 0);
+    if (cost_s < 0) {
+      std::cerr << "maxpool failed with threads: " << num_threads
+                << std::endl;
+      return -1;
+    }
+    std::cout << "rows: " << num_rows << " "
+              << "cols: " << num_cols << " "
+              << "threads: " << num_threads << " "
+              << "cost(ms): " << cost_s * 1000 << " "
+              << "rows/s: " << num_rows / cost_s << std::endl;
+    // each thread listens on a port of its own
+    port += num_threads;
+  }
+  return 0;
+}
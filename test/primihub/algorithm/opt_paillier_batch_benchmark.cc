@@ -0,0 +1,111 @@
+// Copyright [2023] <primihub.com>
+// ops/s of the batch paillier engine
+// key sizes: 1024(k_sec 80), 2048(k_sec 112), 3072(k_sec 128) bits
+// threads: 1, 2, 4, ... up to max_threads
+// single: the former one item at a time functions in the caller thread
+// usage: opt_paillier_batch_benchmark [item_num] [max_threads]
+#include <gmp.h>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/primihub/algorithm/opt_paillier/include/paillier_batch.h"
+
+namespace primihub {
+class MpzArray {
+ public:
+  explicit MpzArray(size_t num) : data_(num) {
+    for (auto& item : data_) {
+      mpz_init(&item);
+    }
+  }
+  ~MpzArray() {
+    for (auto& item : data_) {
+      mpz_clear(&item);
+    }
+  }
+  mpz_t* data() {return reinterpret_cast<mpz_t*>(data_.data());}
+  mpz_ptr at(size_t i) {return &data_[i];}
+
+ private:
+  std::vector<__mpz_struct> data_;
+};
+
+void Report(ui nbits, const std::string& op, const std::string& threads,
+            size_t item_num, const std::function<void()>& fn) {
+  auto start = std::chrono::high_resolution_clock::now();
+  fn();
+  auto end = std::chrono::high_resolution_clock::now();
+  double cost_ms =
+      std::chrono::duration<double, std::milli>(end - start).count();
+  std::cout << "key: " << nbits << " "
+            << "op: " << op << " "
+            << "threads: " << threads << " "
+            << "items: " << item_num << " "
+            << "cost(ms): " << cost_ms << " "
+            << "ops/s: " << item_num * 1000.0 / cost_ms << std::endl;
+}
+
+void RunKeySize(ui k_sec, size_t item_num, size_t max_threads) {
+  opt_public_key_t* pub;
+  opt_secret_key_t* prv;
+  opt_paillier_keygen(k_sec, &pub, &prv);
+  ui nbits = pub->nbits;
+  MpzArray plain(item_num);
+  MpzArray cipher(item_num);
+  MpzArray result(item_num);
+  for (size_t i = 0; i < item_num; i++) {
+    mpz_set_ui(plain.at(i), i * 7919);
+  }
+
+  Report(nbits, "encrypt_crt_fb", "single", item_num, [&]() {
+    for (size_t i = 0; i < item_num; i++) {
+      opt_paillier_encrypt_crt_fb(cipher.at(i), pub, prv, plain.at(i));
+    }
+  });
+  Report(nbits, "decrypt_crt", "single", item_num, [&]() {
+    for (size_t i = 0; i < item_num; i++) {
+      opt_paillier_decrypt_crt(result.at(i), pub, prv, cipher.at(i));
+    }
+  });
+
+  for (size_t thread_num = 1; thread_num <= max_threads; thread_num *= 2) {
+    opt_paillier_batch batch(thread_num);
+    auto threads = std::to_string(thread_num);
+    Report(nbits, "encrypt", threads, item_num, [&]() {
+      batch.encrypt(cipher.data(), plain.data(), item_num, pub);
+    });
+    Report(nbits, "encrypt_crt_fb", threads, item_num, [&]() {
+      batch.encrypt_crt_fb(cipher.data(), plain.data(), item_num, pub, prv);
+    });
+    Report(nbits, "decrypt_crt", threads, item_num, [&]() {
+      batch.decrypt_crt(result.data(), cipher.data(), item_num, pub, prv);
+    });
+    Report(nbits, "add", threads, item_num, [&]() {
+      batch.add(result.data(), cipher.data(), cipher.data(), item_num, pub);
+    });
+    Report(nbits, "constant_mul", threads, item_num, [&]() {
+      batch.constant_mul(result.data(), cipher.data(), plain.data(),
+                         item_num, pub);
+    });
+  }
+  opt_paillier_freepubkey(pub);
+  opt_paillier_freeprvkey(prv);
+}
+}  // namespace primihub
+
+int main(int argc, char* argv[]) {
+  size_t item_num = argc > 1 ? std::stoul(argv[1]) : 2000;
+  size_t max_threads = argc > 2 ? std::stoul(argv[2]) :
+      std::max<size_t>(1, std::thread::hardware_concurrency());
+  // 1024 bit key is too weak for production, it is only registered here
+  mapTo_nbits_lbits[80] = {1024, 320};
+  for (ui k_sec : {80, 112, 128}) {
+    primihub::RunKeySize(k_sec, item_num, max_threads);
+  }
+  return 0;
+}
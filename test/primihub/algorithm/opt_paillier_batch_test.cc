@@ -0,0 +1,127 @@
+// Copyright [2023] <primihub.com>
+#include <gmp.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/primihub/algorithm/opt_paillier/include/paillier_batch.h"
+
+namespace primihub {
+class OptPaillierBatchTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    // 1024 bit key keeps the test fast, too weak to be offered in production
+    mapTo_nbits_lbits[kTestKsec] = {1024, 320};
+    opt_paillier_keygen(kTestKsec, &pub_, &prv_);
+  }
+  static void TearDownTestSuite() {
+    opt_paillier_freepubkey(pub_);
+    opt_paillier_freeprvkey(prv_);
+  }
+  void SetUp() override {
+    for (auto* vec : {&plain_, &cipher_, &result_}) {
+      vec->resize(kNum);
+      for (auto& item : *vec) {
+        mpz_init(&item);
+      }
+    }
+    for (size_t i = 0; i < kNum; i++) {
+      opt_paillier_set_plaintext(at(&plain_, i),
+                                 std::to_string(i * 37 - 500).c_str(), pub_);
+    }
+  }
+  void TearDown() override {
+    for (auto* vec : {&plain_, &cipher_, &result_}) {
+      for (auto& item : *vec) {
+        mpz_clear(&item);
+      }
+    }
+  }
+  static mpz_t* data(std::vector<__mpz_struct>* vec) {
+    return reinterpret_cast<mpz_t*>(vec->data());
+  }
+  static mpz_ptr at(std::vector<__mpz_struct>* vec, size_t i) {
+    return &(*vec)[i];
+  }
+
+  static constexpr size_t kNum = 100;
+  static constexpr ui kTestKsec = 80;
+  static opt_public_key_t* pub_;
+  static opt_secret_key_t* prv_;
+  std::vector<__mpz_struct> plain_;
+  std::vector<__mpz_struct> cipher_;
+  std::vector<__mpz_struct> result_;
+  opt_paillier_batch batch_{4};
+};
+opt_public_key_t* OptPaillierBatchTest::pub_ = nullptr;
+opt_secret_key_t* OptPaillierBatchTest::prv_ = nullptr;
+
+TEST_F(OptPaillierBatchTest, encrypt_decrypt) {
+  batch_.encrypt(data(&cipher_), data(&plain_), kNum, pub_);
+  batch_.decrypt_crt(data(&result_), data(&cipher_), kNum, pub_, prv_);
+  for (size_t i = 0; i < kNum; i++) {
+    EXPECT_EQ(mpz_cmp(at(&result_, i), at(&plain_, i)), 0);
+  }
+}
+
+TEST_F(OptPaillierBatchTest, encrypt_crt_fb_matches_single) {
+  batch_.encrypt_crt_fb(data(&cipher_), data(&plain_), kNum, pub_, prv_);
+  for (size_t i = 0; i < kNum; i++) {
+    opt_paillier_decrypt_crt(at(&result_, i), pub_, prv_, at(&cipher_, i));
+    EXPECT_EQ(mpz_cmp(at(&result_, i), at(&plain_, i)), 0);
+  }
+}
+
+TEST_F(OptPaillierBatchTest, add_and_constant_mul) {
+  batch_.encrypt_crt_fb(data(&cipher_), data(&plain_), kNum, pub_, prv_);
+  // in place: c = c * c = Enc(2m), then c^3 = Enc(6m)
+  batch_.add(data(&cipher_), data(&cipher_), data(&cipher_), kNum, pub_);
+  std::vector<__mpz_struct> consts(kNum);
+  for (auto& item : consts) {
+    mpz_init_set_ui(&item, 3);
+  }
+  batch_.constant_mul(data(&cipher_), data(&cipher_), data(&consts), kNum,
+                      pub_);
+  batch_.decrypt_crt(data(&result_), data(&cipher_), kNum, pub_, prv_);
+  mpz_t expected;
+  mpz_init(expected);
+  for (size_t i = 0; i < kNum; i++) {
+    mpz_mul_ui(expected, at(&plain_, i), 6);
+    mpz_mod(expected, expected, pub_->n);
+    EXPECT_EQ(mpz_cmp(at(&result_, i), expected), 0);
+  }
+  mpz_clear(expected);
+  for (auto& item : consts) {
+    mpz_clear(&item);
+  }
+}
+
+TEST_F(OptPaillierBatchTest, packing_roundtrip) {
+  CrtMod* crtmod;
+  init_crt(&crtmod, 28, 70);
+  constexpr size_t kSeqSize = 60;
+  std::vector<std::string> values;
+  std::vector<char*> seq;
+  for (size_t i = 0; i < kSeqSize; i++) {
+    values.push_back(std::to_string(static_cast<int64_t>(i) * 1001 - 30000));
+  }
+  for (auto& value : values) {
+    seq.push_back(value.data());
+  }
+  batch_.data_packing_crt(data(&cipher_), seq.data(), kSeqSize, crtmod);
+  std::vector<char*> retrieved(kSeqSize, nullptr);
+  batch_.data_retrieve_crt(retrieved.data(), data(&cipher_), kSeqSize, crtmod);
+  for (size_t i = 0; i < kSeqSize; i++) {
+    EXPECT_EQ(values[i], std::string(retrieved[i]));
+    free(retrieved[i]);
+  }
+  free_crt(crtmod);
+}
+
+TEST_F(OptPaillierBatchTest, empty_input) {
+  batch_.encrypt(data(&cipher_), data(&plain_), 0, pub_);
+  batch_.decrypt_crt(data(&result_), data(&cipher_), 0, pub_, prv_);
+}
+}  // namespace primihub
@@ -0,0 +1,267 @@
+// Copyright [2023] <primihub.com>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <nlohmann/json.hpp>
+#include "gtest/gtest.h"
+
+#include "src/primihub/common/common.h"
+#include "src/primihub/data_store/csv/csv_driver.h"
+
+namespace primihub {
+namespace {
+const char kCsvContent[] = "id,value\n1,1.5\n2,2.5\n3,3.5\n";
+
+std::string MakeTempDir() {
+  char dir_template[] = "/tmp/csv_driver_test_XXXXXX";
+  char* dir = mkdtemp(dir_template);
+  EXPECT_NE(dir, nullptr);
+  return std::string(dir);
+}
+
+void WriteFile(const std::string& file_path, const std::string& content) {
+  std::ofstream fout(file_path, std::ios::out | std::ios::trunc);
+  fout << content;
+}
+
+std::vector<int64_t> ColumnOfInt64(const std::shared_ptr<arrow::Table>& table,
+                                   int col_index) {
+  std::vector<int64_t> values;
+  for (const auto& chunk : table->column(col_index)->chunks()) {
+    auto array = std::static_pointer_cast<arrow::Int64Array>(chunk);
+    for (int64_t i = 0; i < array->length(); i++) {
+      values.push_back(array->Value(i));
+    }
+  }
+  return values;
+}
+
+std::vector<std::string> ListCacheFiles(const std::string& cache_dir) {
+  std::vector<std::string> cache_files;
+  DIR* dir = opendir(cache_dir.c_str());
+  if (dir == nullptr) {
+    return cache_files;
+  }
+  for (dirent* entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+    std::string name{entry->d_name};
+    if (name.rfind("csv_", 0) == 0 &&
+        name.size() > 6 && name.substr(name.size() - 6) == ".arrow") {
+      cache_files.push_back(cache_dir + "/" + name);
+    }
+  }
+  closedir(dir);
+  return cache_files;
+}
+
+std::string MakeAccessInfo(const std::string& data_path,
+                           const std::string& cache_dir) {
+  nlohmann::json js_access_info;
+  js_access_info["data_path"] = data_path;
+  js_access_info["cacheDir"] = cache_dir;
+  return js_access_info.dump();
+}
+
+std::shared_ptr<CSVDriver> MakeDriver(const std::string& access_info) {
+  DatasetMetaInfo meta_info;
+  meta_info.id = "csv_driver_test";
+  meta_info.driver_type = "CSV";
+  meta_info.access_info = access_info;
+  meta_info.schema.emplace_back("id", arrow::Type::INT64);
+  meta_info.schema.emplace_back("value", arrow::Type::DOUBLE);
+  auto csv_access_info = std::make_unique<CSVAccessInfo>();
+  auto ret = csv_access_info->FromMetaInfo(meta_info);
+  EXPECT_EQ(ret, retcode::SUCCESS);
+  return std::make_shared<CSVDriver>("test", std::move(csv_access_info));
+}
+
+std::shared_ptr<arrow::Table> ReadTable(std::unique_ptr<Cursor> cursor) {
+  auto dataset = cursor->read();
+  EXPECT_NE(dataset, nullptr);
+  if (dataset == nullptr) {
+    return nullptr;
+  }
+  return std::get<std::shared_ptr<arrow::Table>>(dataset->data);
+}
+
+void CheckTable(const std::shared_ptr<arrow::Table>& table,
+                const std::vector<int64_t>& expected_id) {
+  ASSERT_NE(table, nullptr);
+  ASSERT_EQ(table->num_columns(), 2);
+  ASSERT_EQ(table->num_rows(), static_cast<int64_t>(expected_id.size()));
+  auto id_col = table->column(0)->chunk(0);
+  auto id_array = std::static_pointer_cast<arrow::Int64Array>(id_col);
+  for (size_t i = 0; i < expected_id.size(); i++) {
+    EXPECT_EQ(id_array->Value(i), expected_id[i]);
+  }
+}
+
+struct stat StatFile(const std::string& file_path) {
+  struct stat file_stat;
+  EXPECT_EQ(stat(file_path.c_str(), &file_stat), 0);
+  return file_stat;
+}
+}  // namespace
+
+TEST(csv_driver, option_of_wrong_type_is_rejected) {
+  std::string data_dir = MakeTempDir();
+  std::string data_path = data_dir + "/data.csv";
+  WriteFile(data_path, kCsvContent);
+  nlohmann::json js_access_info;
+  js_access_info["data_path"] = data_path;
+  js_access_info["blockSize"] = "1M";
+  DatasetMetaInfo meta_info;
+  meta_info.id = "csv_driver_test";
+  meta_info.access_info = js_access_info.dump();
+  CSVAccessInfo csv_access_info;
+  auto ret = csv_access_info.FromMetaInfo(meta_info);
+  EXPECT_EQ(ret, retcode::FAIL);
+  // the raw access info must never be taken as the data path
+  EXPECT_EQ(csv_access_info.file_path_, data_path);
+}
+
+TEST(csv_driver, cache_hit) {
+  std::string data_dir = MakeTempDir();
+  std::string data_path = data_dir + "/data.csv";
+  std::string cache_dir = data_dir + "/cache";
+  WriteFile(data_path, kCsvContent);
+  auto driver = MakeDriver(MakeAccessInfo(data_path, cache_dir));
+  auto table = ReadTable(driver->read());
+  CheckTable(table, {1, 2, 3});
+  auto cache_files = ListCacheFiles(cache_dir);
+  ASSERT_EQ(cache_files.size(), 1u);
+  // age the cache file, a hit refreshes its mtime and keeps the same file
+  struct utimbuf old_time{1000, 1000};
+  ASSERT_EQ(utime(cache_files[0].c_str(), &old_time), 0);
+  auto stat_before = StatFile(cache_files[0]);
+
+  auto cached_table = ReadTable(driver->read());
+  CheckTable(cached_table, {1, 2, 3});
+  EXPECT_TRUE(cached_table->Equals(*table));
+  auto stat_after = StatFile(cache_files[0]);
+  EXPECT_EQ(stat_after.st_ino, stat_before.st_ino);
+  EXPECT_GT(stat_after.st_mtime, 1000);
+  EXPECT_EQ(ListCacheFiles(cache_dir).size(), 1u);
+}
+
+TEST(csv_driver, option_change_invalidates_cache) {
+  std::string data_dir = MakeTempDir();
+  std::string data_path = data_dir + "/data.csv";
+  std::string cache_dir = data_dir + "/cache";
+  WriteFile(data_path, kCsvContent);
+  auto driver = MakeDriver(MakeAccessInfo(data_path, cache_dir));
+  CheckTable(ReadTable(driver->read()), {1, 2, 3});
+  ASSERT_EQ(ListCacheFiles(cache_dir).size(), 1u);
+
+  // selecting columns changes the convert options
+  auto table = ReadTable(driver->GetCursor(std::vector<int>{1}));
+  ASSERT_NE(table, nullptr);
+  EXPECT_EQ(table->num_columns(), 1);
+  EXPECT_EQ(table->num_rows(), 3);
+  EXPECT_EQ(ListCacheFiles(cache_dir).size(), 2u);
+
+  // changing the data file must not return the stale table
+  WriteFile(data_path, "id,value\n4,4.5\n5,5.5\n");
+  CheckTable(ReadTable(driver->read()), {4, 5});
+  EXPECT_EQ(ListCacheFiles(cache_dir).size(), 3u);
+}
+
+TEST(csv_driver, corrupt_cache_file_is_rebuilt) {
+  std::string data_dir = MakeTempDir();
+  std::string data_path = data_dir + "/data.csv";
+  std::string cache_dir = data_dir + "/cache";
+  WriteFile(data_path, kCsvContent);
+  auto driver = MakeDriver(MakeAccessInfo(data_path, cache_dir));
+  CheckTable(ReadTable(driver->read()), {1, 2, 3});
+  auto cache_files = ListCacheFiles(cache_dir);
+  ASSERT_EQ(cache_files.size(), 1u);
+
+  std::string garbage = "this is not an arrow ipc file";
+  WriteFile(cache_files[0], garbage);
+  CheckTable(ReadTable(driver->read()), {1, 2, 3});
+  // the broken file is replaced by a valid one
+  auto rebuilt_stat = StatFile(cache_files[0]);
+  EXPECT_NE(rebuilt_stat.st_size, static_cast<off_t>(garbage.size()));
+  CheckTable(ReadTable(driver->read()), {1, 2, 3});
+  EXPECT_EQ(StatFile(cache_files[0]).st_ino, rebuilt_stat.st_ino);
+  EXPECT_EQ(ListCacheFiles(cache_dir).size(), 1u);
+}
+
+TEST(csv_driver, cache_is_evicted_by_lru) {
+  std::string data_dir = MakeTempDir();
+  std::string data_path = data_dir + "/data.csv";
+  std::string cache_dir = data_dir + "/cache";
+  WriteFile(data_path, kCsvContent);
+  nlohmann::json js_access_info;
+  js_access_info["data_path"] = data_path;
+  js_access_info["cacheDir"] = cache_dir;
+  js_access_info["cacheMaxFiles"] = 1;
+  auto driver = MakeDriver(js_access_info.dump());
+  CheckTable(ReadTable(driver->read()), {1, 2, 3});
+  auto first_cache = ListCacheFiles(cache_dir);
+  ASSERT_EQ(first_cache.size(), 1u);
+  struct utimbuf old_time{1000, 1000};
+  ASSERT_EQ(utime(first_cache[0].c_str(), &old_time), 0);
+
+  auto table = ReadTable(driver->GetCursor(std::vector<int>{1}));
+  ASSERT_NE(table, nullptr);
+  auto cache_files = ListCacheFiles(cache_dir);
+  ASSERT_EQ(cache_files.size(), 1u);
+  EXPECT_NE(cache_files[0], first_cache[0]);
+}
+
+TEST(csv_driver, paged_read) {
+  std::string data_dir = MakeTempDir();
+  std::string data_path = data_dir + "/data.csv";
+  const int64_t num_rows = 100;
+  std::string content = "id,value\n";
+  std::vector<int64_t> expected_id;
+  for (int64_t i = 0; i < num_rows; i++) {
+    content.append(std::to_string(i)).append(",").append(std::to_string(i))
+           .append(".5\n");
+    expected_id.push_back(i);
+  }
+  WriteFile(data_path, content);
+  // small block, so that pages cross the batches of streaming reader
+  nlohmann::json js_access_info;
+  js_access_info["data_path"] = data_path;
+  js_access_info["blockSize"] = 64;
+  auto driver = MakeDriver(js_access_info.dump());
+  auto cursor = driver->read();
+  std::vector<int64_t> paged_id;
+  const int64_t page_size = 7;
+  for (int64_t offset = 0; offset < num_rows; offset += page_size) {
+    auto dataset = cursor->read(offset, page_size);
+    ASSERT_NE(dataset, nullptr);
+    auto table = std::get<std::shared_ptr<arrow::Table>>(dataset->data);
+    EXPECT_EQ(table->num_rows(), std::min(page_size, num_rows - offset));
+    auto page_id = ColumnOfInt64(table, 0);
+    paged_id.insert(paged_id.end(), page_id.begin(), page_id.end());
+  }
+  EXPECT_EQ(paged_id, expected_id);
+  // page beyond the end is empty
+  auto dataset = cursor->read(num_rows, page_size);
+  ASSERT_NE(dataset, nullptr);
+  EXPECT_EQ(
+      std::get<std::shared_ptr<arrow::Table>>(dataset->data)->num_rows(), 0);
+
+  // iterating by next gives the same rows
+  std::vector<int64_t> batch_id;
+  while (auto batch = cursor->next(page_size)) {
+    EXPECT_LE(batch->num_rows(), page_size);
+    auto array = std::static_pointer_cast<arrow::Int64Array>(batch->column(0));
+    for (int64_t i = 0; i < array->length(); i++) {
+      batch_id.push_back(array->Value(i));
+    }
+  }
+  EXPECT_EQ(batch_id, expected_id);
+}
+}  // namespace primihub
@@ -0,0 +1,104 @@
+// Copyright [2023] <primihub.com>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include "gtest/gtest.h"
+
+#include "src/primihub/data_store/mysql/column_builder.h"
+
+namespace primihub {
+namespace {
+using mysql::ColumnBuilder;
+
+void AppendText(ColumnBuilder* builder, const char* text) {
+  unsigned long length = text == nullptr ? 0 : strlen(text);  // NOLINT
+  ASSERT_TRUE(builder->AppendText(text, length).ok());
+}
+
+std::shared_ptr<arrow::Array> Finish(ColumnBuilder* builder) {
+  std::shared_ptr<arrow::Array> array;
+  EXPECT_TRUE(builder->Finish(&array).ok());
+  return array;
+}
+}  // namespace
+
+TEST(mysql_column_builder, int32_from_text) {
+  ColumnBuilder builder(arrow::Type::INT32);
+  EXPECT_EQ(builder.kind(), ColumnBuilder::Kind::kInt32);
+  AppendText(&builder, nullptr);        // NULL
+  AppendText(&builder, "");             // empty
+  AppendText(&builder, "12abc");        // partial number
+  AppendText(&builder, "3000000000");   // out of int32 range
+  AppendText(&builder, "-3000000000");  // out of int32 range
+  AppendText(&builder, "-42");
+  AppendText(&builder, "2147483647");
+  auto array = std::static_pointer_cast<arrow::Int32Array>(Finish(&builder));
+  ASSERT_EQ(array->length(), 7);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(array->IsNull(i)) << "row: " << i;
+  }
+  EXPECT_EQ(array->Value(5), -42);
+  EXPECT_EQ(array->Value(6), std::numeric_limits<int32_t>::max());
+}
+
+TEST(mysql_column_builder, int64_from_text) {
+  ColumnBuilder builder(arrow::Type::INT64);
+  EXPECT_EQ(builder.kind(), ColumnBuilder::Kind::kInt64);
+  AppendText(&builder, nullptr);
+  AppendText(&builder, "");
+  AppendText(&builder, " 12");
+  AppendText(&builder, "18446744073709551615");  // out of int64 range
+  AppendText(&builder, "3000000000");
+  auto array = std::static_pointer_cast<arrow::Int64Array>(Finish(&builder));
+  ASSERT_EQ(array->length(), 5);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(array->IsNull(i)) << "row: " << i;
+  }
+  EXPECT_EQ(array->Value(4), 3000000000LL);
+}
+
+TEST(mysql_column_builder, unsigned_int64_beyond_range_is_null) {
+  ColumnBuilder builder(arrow::Type::UINT64);
+  ASSERT_TRUE(builder.AppendUInt64(std::numeric_limits<uint64_t>::max()).ok());
+  ASSERT_TRUE(builder.AppendUInt64(
+      static_cast<uint64_t>(std::numeric_limits<int64_t>::max())).ok());
+  auto array = std::static_pointer_cast<arrow::Int64Array>(Finish(&builder));
+  ASSERT_EQ(array->length(), 2);
+  EXPECT_TRUE(array->IsNull(0));
+  EXPECT_EQ(array->Value(1), std::numeric_limits<int64_t>::max());
+}
+
+TEST(mysql_column_builder, double_from_text) {
+  ColumnBuilder builder(arrow::Type::DOUBLE);
+  EXPECT_EQ(builder.kind(), ColumnBuilder::Kind::kDouble);
+  AppendText(&builder, nullptr);
+  AppendText(&builder, "");
+  AppendText(&builder, "1.5x");
+  AppendText(&builder, "-2.25");
+  auto array = std::static_pointer_cast<arrow::DoubleArray>(Finish(&builder));
+  ASSERT_EQ(array->length(), 4);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(array->IsNull(i)) << "row: " << i;
+  }
+  EXPECT_DOUBLE_EQ(array->Value(3), -2.25);
+}
+
+TEST(mysql_column_builder, string_from_text) {
+  ColumnBuilder builder(arrow::Type::STRING);
+  EXPECT_FALSE(builder.IsNumeric());
+  AppendText(&builder, nullptr);
+  AppendText(&builder, "");
+  AppendText(&builder, "12abc");
+  auto array = std::static_pointer_cast<arrow::StringArray>(Finish(&builder));
+  ASSERT_EQ(array->length(), 3);
+  EXPECT_TRUE(array->IsNull(0));
+  // empty string is a value, not NULL
+  EXPECT_FALSE(array->IsNull(1));
+  EXPECT_EQ(array->GetString(1), "");
+  EXPECT_EQ(array->GetString(2), "12abc");
+}
+}  // namespace primihub
@@ -0,0 +1,124 @@
+// Copyright [2023] <primihub.com>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <nlohmann/json.hpp>
+#include "gtest/gtest.h"
+#include "SQLiteCpp/SQLiteCpp.h"
+
+#include "src/primihub/common/common.h"
+#include "src/primihub/data_store/sqlite/sqlite_driver.h"
+
+namespace primihub {
+namespace {
+const int64_t kNumRows = 50;
+
+std::string MakeTestDB() {
+  char dir_template[] = "/tmp/sqlite_driver_test_XXXXXX";
+  char* dir = mkdtemp(dir_template);
+  EXPECT_NE(dir, nullptr);
+  std::string db_path = std::string(dir) + "/test.db";
+  SQLite::Database db(db_path, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+  db.exec("CREATE TABLE test_table (id INTEGER PRIMARY KEY, value REAL)");
+  SQLite::Transaction transaction(db);
+  for (int64_t i = 0; i < kNumRows; i++) {
+    db.exec("INSERT INTO test_table VALUES (" + std::to_string(i) + ", " +
+            std::to_string(i) + ".5)");
+  }
+  transaction.commit();
+  return db_path;
+}
+
+std::shared_ptr<SQLiteDriver> MakeDriver(const std::string& db_path) {
+  nlohmann::json js_access_info;
+  js_access_info["db_path"] = db_path;
+  js_access_info["tableName"] = "test_table";
+  DatasetMetaInfo meta_info;
+  meta_info.id = "sqlite_driver_test";
+  meta_info.driver_type = "SQLITE";
+  meta_info.access_info = js_access_info.dump();
+  meta_info.schema.emplace_back("id", arrow::Type::INT64);
+  meta_info.schema.emplace_back("value", arrow::Type::DOUBLE);
+  auto access_info = std::make_unique<SQLiteAccessInfo>();
+  auto ret = access_info->FromMetaInfo(meta_info);
+  EXPECT_EQ(ret, retcode::SUCCESS);
+  return std::make_shared<SQLiteDriver>("test", std::move(access_info));
+}
+
+std::vector<int64_t> ColumnOfInt64(const std::shared_ptr<arrow::Table>& table,
+                                   int col_index) {
+  std::vector<int64_t> values;
+  for (const auto& chunk : table->column(col_index)->chunks()) {
+    auto array = std::static_pointer_cast<arrow::Int64Array>(chunk);
+    for (int64_t i = 0; i < array->length(); i++) {
+      values.push_back(array->Value(i));
+    }
+  }
+  return values;
+}
+}  // namespace
+
+TEST(sqlite_driver, paged_read) {
+  auto driver = MakeDriver(MakeTestDB());
+  auto cursor = driver->read();
+  ASSERT_NE(cursor, nullptr);
+  std::vector<int64_t> expected_id;
+  for (int64_t i = 0; i < kNumRows; i++) {
+    expected_id.push_back(i);
+  }
+  std::vector<int64_t> paged_id;
+  const int64_t page_size = 7;
+  for (int64_t offset = 0; offset < kNumRows; offset += page_size) {
+    auto dataset = cursor->read(offset, page_size);
+    ASSERT_NE(dataset, nullptr);
+    auto table = std::get<std::shared_ptr<arrow::Table>>(dataset->data);
+    EXPECT_EQ(table->num_rows(), std::min(page_size, kNumRows - offset));
+    auto page_id = ColumnOfInt64(table, 0);
+    paged_id.insert(paged_id.end(), page_id.begin(), page_id.end());
+  }
+  EXPECT_EQ(paged_id, expected_id);
+  // page beyond the end is empty
+  auto dataset = cursor->read(kNumRows, page_size);
+  ASSERT_NE(dataset, nullptr);
+  EXPECT_EQ(
+      std::get<std::shared_ptr<arrow::Table>>(dataset->data)->num_rows(), 0);
+}
+
+TEST(sqlite_driver, next_batch) {
+  auto driver = MakeDriver(MakeTestDB());
+  auto cursor = driver->read();
+  ASSERT_NE(cursor, nullptr);
+  const int64_t batch_size = 16;
+  std::vector<int64_t> batch_id;
+  for (int round = 0; round < 2; round++) {
+    batch_id.clear();
+    while (auto batch = cursor->next(batch_size)) {
+      EXPECT_LE(batch->num_rows(), batch_size);
+      auto array =
+          std::static_pointer_cast<arrow::Int64Array>(batch->column(0));
+      for (int64_t i = 0; i < array->length(); i++) {
+        batch_id.push_back(array->Value(i));
+      }
+    }
+    ASSERT_EQ(batch_id.size(), static_cast<size_t>(kNumRows));
+    for (int64_t i = 0; i < kNumRows; i++) {
+      EXPECT_EQ(batch_id[i], i);
+    }
+    // rewind restarts the iteration
+    cursor->rewind();
+  }
+}
+
+TEST(sqlite_driver, invalid_page) {
+  auto driver = MakeDriver(MakeTestDB());
+  auto cursor = driver->read();
+  ASSERT_NE(cursor, nullptr);
+  EXPECT_THROW(cursor->read(-1, 10), std::runtime_error);
+  EXPECT_THROW(cursor->read(0, -1), std::runtime_error);
+}
+}  // namespace primihub
@@ -1,7 +1,10 @@
+#include <cmath>
 #include <cstdlib>
 #include <ctime>
 #include <exception>
 #include <fstream>
+#include <functional>
+#include <memory>
 #include <stdexcept>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -26,6 +29,7 @@ std::string expr = "-100/A";
 // std::string expr = "-100/(5-(A*B-C+A+2-1)*2)/2";
 // std::string expr = "A*B-C+A*2.2";
 // std::string expr = "A*B-C+A*2";
+// std::string expr = "A*B+B*A-C*C+(A*B)*C";
 f64<D32 > bit_flag = 1.0;
 template <Decimal Dbit>
 static void importColumnOwner(MPCExpressExecutor<Dbit> *mpc_exec,
@@ -287,3 +291,92 @@ TEST(mpc_express_executor, i64_executor_test) {
     }
   }
 }
+
+// Evaluate express by three parties and compare the result revealed to
+// party 0 with plaintext, columns A and B belong to party 0, C to party 1
+// and D to party 2.
+static std::vector<double>
+evaluateExpress(const std::string &express,
+                std::map<std::string, std::vector<double>> &col_and_val,
+                u32 party_id, uint16_t next_port, uint16_t prev_port) {
+  std::map<std::string, u32> col_and_owner = {
+      {"A", 0}, {"B", 0}, {"C", 1}, {"D", 2}};
+  std::map<std::string, bool> col_and_dtype = {
+      {"A", true}, {"B", true}, {"C", true}, {"D", true}};
+
+  auto mpc_exec = std::make_unique<MPCExpressExecutor<D16>>();
+  mpc_exec->initColumnConfig(party_id);
+  importColumnOwner(mpc_exec.get(), col_and_owner);
+  importColumnDtype(mpc_exec.get(), col_and_dtype);
+  mpc_exec->importExpress(express);
+  mpc_exec->resolveRunMode();
+  mpc_exec->InitFeedDict();
+  importColumnValues(mpc_exec.get(), col_and_val);
+
+  std::vector<double> final_val;
+  std::vector<uint32_t> parties = {0};
+  mpc_exec->initMPCRuntime(party_id, "127.0.0.1", "127.0.0.1", next_port,
+                           prev_port);
+  mpc_exec->runMPCEvaluate();
+  mpc_exec->revealMPCResult(parties, final_val);
+  return final_val;
+}
+
+static void checkExpress(
+    const std::string &express,
+    const std::function<double(double, double, double, double)> &plain) {
+  const size_t count = 10;
+  std::vector<double> a, b, c, d;
+  for (size_t i = 0; i < count; i++) {
+    a.emplace_back(i + 1.5);
+    b.emplace_back(-0.5 * i - 2);
+    c.emplace_back(i % 3 + 0.25);
+    d.emplace_back(2 - 0.25 * i);
+  }
+  std::map<std::string, std::vector<double>> col_and_val_0 = {{"A", a},
+                                                              {"B", b}};
+  std::map<std::string, std::vector<double>> col_and_val_1 = {{"C", c}};
+  std::map<std::string, std::vector<double>> col_and_val_2 = {{"D", d}};
+
+  pid_t pid_1 = fork();
+  if (pid_1 == 0) {
+    evaluateExpress(express, col_and_val_1, 1, 10230, 10210);
+    _exit(0);
+  }
+  pid_t pid_2 = fork();
+  if (pid_2 == 0) {
+    evaluateExpress(express, col_and_val_2, 2, 10220, 10230);
+    _exit(0);
+  }
+  auto result = evaluateExpress(express, col_and_val_0, 0, 10210, 10220);
+  waitpid(pid_1, nullptr, 0);
+  waitpid(pid_2, nullptr, 0);
+
+  ASSERT_EQ(result.size(), count);
+  for (size_t i = 0; i < count; i++) {
+    double expected = plain(a[i], b[i], c[i], d[i]);
+    EXPECT_NEAR(result[i], expected, 1e-3 * std::abs(expected) + 1e-2)
+        << "express: " << express << " index: " << i;
+  }
+}
+
+TEST(mpc_express_executor, repeated_subexpress) {
+  checkExpress("A*B+B*A-C*C+(A*B)*C",
+               [](double a, double b, double c, double d) {
+                 return 2 * a * b - c * c + a * b * c;
+               });
+}
+
+TEST(mpc_express_executor, nested_subexpress) {
+  checkExpress("(A*B-C)*(A*B-C)+A*B*D",
+               [](double a, double b, double c, double d) {
+                 return (a * b - c) * (a * b - c) + a * b * d;
+               });
+}
+
+TEST(mpc_express_executor, shared_leaf_in_batch) {
+  checkExpress("(A+C)*(A+C)*D-A*A+A*C+D*2",
+               [](double a, double b, double c, double d) {
+                 return (a + c) * (a + c) * d - a * a + a * c + d * 2;
+               });
+}
@@ -0,0 +1,151 @@
+// Copyright [2023] <primihub.com>
+// queries/s and latency of the keyword PIR server answering queries
+// against a SenderDB of fixed size. queries are run one after another,
+// the time of a query covers loading the request and computing all
+// result packages, packages are serialized and then dropped.
+// usage: keyword_pir_query_benchmark [db_size] [query_num]
+//            [items_per_query] [thread_num] [params_file]
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "src/primihub/kernel/pir/operator/keyword_pir_impl/keyword_pir_server.h"
+#include "apsi/receiver.h"
+
+namespace primihub::pir {
+using Receiver = apsi::receiver::Receiver;
+
+std::unique_ptr<PSIParams> LoadParams(const std::string& params_file) {
+  std::ifstream fin(params_file);
+  if (!fin.is_open()) {
+    std::cerr << "open " << params_file << " failed" << std::endl;
+    return nullptr;
+  }
+  std::stringstream params_json;
+  params_json << fin.rdbuf();
+  return std::make_unique<PSIParams>(PSIParams::Load(params_json.str()));
+}
+
+LabeledData MakeDb(size_t db_size) {
+  LabeledData db_data;
+  db_data.reserve(db_size);
+  for (size_t i = 0; i < db_size; i++) {
+    std::string key = "key_" + std::to_string(i);
+    std::string value = "value_" + std::to_string(i);
+    apsi::Label label(value.begin(), value.end());
+    label.resize(16, 0);
+    db_data.emplace_back(apsi::Item(key), std::move(label));
+  }
+  return db_data;
+}
+
+/**
+ * build a query the same way KeywordPirOperatorClient does,
+ * OPRF is answered locally with the key of sender_db
+*/
+std::string MakeQuery(const PSIParams& params, const SenderDB& sender_db,
+                      size_t first_key, size_t item_num) {
+  std::vector<apsi::Item> items;
+  for (size_t i = 0; i < item_num; i++) {
+    items.emplace_back("key_" + std::to_string(first_key + i));
+  }
+  Receiver receiver(params);
+  auto oprf_receiver = Receiver::CreateOPRFReceiver(items);
+  auto oprf_request = oprf_receiver.query_data();
+  std::string oprf_request_str{
+      reinterpret_cast<const char*>(oprf_request.data()), oprf_request.size()};
+  auto oprf_response =
+      OPRFSender::ProcessQueries(oprf_request_str, sender_db.get_oprf_key());
+  std::string oprf_response_str{
+      reinterpret_cast<const char*>(oprf_response.data()),
+      oprf_response.size()};
+  std::vector<apsi::HashedItem> oprf_items(oprf_receiver.item_count());
+  std::vector<apsi::LabelKey> label_keys(oprf_receiver.item_count());
+  oprf_receiver.process_responses(oprf_response_str, oprf_items, label_keys);
+  auto query = receiver.create_query(oprf_items);
+  std::ostringstream query_ss;
+  query.first->save(query_ss);
+  return query_ss.str();
+}
+}  // namespace primihub::pir
+
+int main(int argc, char* argv[]) {
+  using namespace primihub::pir;  // NOLINT
+  size_t db_size = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  size_t query_num = argc > 2 ? std::stoul(argv[2]) : 50;
+  size_t items_per_query = argc > 3 ? std::stoul(argv[3]) : 1;
+  size_t thread_num = argc > 4 ? std::stoul(argv[4]) : 0;
+  std::string params_file =
+      argc > 5 ? argv[5] : "config/pir_server_config.json";
+  if (db_size == 0 || query_num == 0) {
+    std::cerr << "db_size and query_num must be positive" << std::endl;
+    return -1;
+  }
+  if (thread_num == 0) {
+    thread_num = std::thread::hardware_concurrency();
+  }
+  ThreadPoolMgr::SetThreadCount(thread_num);
+
+  auto params = LoadParams(params_file);
+  if (params == nullptr) {
+    return -1;
+  }
+  auto sender_db = std::make_shared<SenderDB>(*params, 16, 16, false);
+  sender_db->set_data(MakeDb(db_size));
+
+  std::vector<std::string> queries;
+  for (size_t i = 0; i < query_num; i++) {
+    size_t first_key = (i * items_per_query * 7919) % db_size;
+    queries.push_back(
+        MakeQuery(*params, *sender_db, first_key, items_per_query));
+  }
+
+  primihub::pir::Options options{};
+  KeywordPirOperatorServer server(options);
+  std::vector<double> latency_ms;
+  size_t package_num = 0;
+  for (const auto& query : queries) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::istringstream query_in(query);
+    auto query_request = std::make_unique<SenderOperationQuery>();
+    query_request->load(query_in, sender_db->get_seal_context());
+    auto ret = server.RunQuery(sender_db, std::move(query_request),
+        [&](std::string&& package) {
+          package_num++;
+          return primihub::retcode::SUCCESS;
+        });
+    auto end = std::chrono::high_resolution_clock::now();
+    if (ret != primihub::retcode::SUCCESS) {
+      std::cerr << "run query failed" << std::endl;
+      return -1;
+    }
+    latency_ms.push_back(
+        std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  double total_ms = 0;
+  for (auto cost : latency_ms) {
+    total_ms += cost;
+  }
+  std::sort(latency_ms.begin(), latency_ms.end());
+  auto percentile = [&](double p) {
+    size_t index = static_cast<size_t>(p * (latency_ms.size() - 1) + 0.5);
+    return latency_ms[index];
+  };
+  std::cout << "db size: " << db_size << " "
+            << "queries: " << query_num << " "
+            << "items/query: " << items_per_query << " "
+            << "threads: " << thread_num << " "
+            << "packages/query: " << package_num / query_num << " "
+            << "queries/s: " << query_num * 1000.0 / total_ms << " "
+            << "p50(ms): " << percentile(0.5) << " "
+            << "p99(ms): " << percentile(0.99) << std::endl;
+  return 0;
+}
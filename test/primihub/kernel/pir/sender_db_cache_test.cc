@@ -0,0 +1,202 @@
+// "Copyright [2023] <PrimiHub>"
+#include <dirent.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/primihub/kernel/pir/operator/keyword_pir_impl/sender_db_cache.h"
+#include "src/primihub/util/file_util.h"
+
+namespace primihub::pir {
+namespace {
+// same as config/pir_server_config.json
+constexpr char kParamsJson[] = R"({
+  "table_params": {
+    "hash_func_count": 2, "table_size": 409, "max_items_per_bin": 20
+  },
+  "item_params": {"felts_per_item": 5},
+  "query_params": {
+    "ps_low_degree": 0,
+    "query_powers": [1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+                     11, 12, 13, 14, 15, 16, 17, 18, 19, 20]
+  },
+  "seal_params": {
+    "plain_modulus": 65537,
+    "poly_modulus_degree": 2048,
+    "coeff_modulus_bits": [48]
+  }
+})";
+
+LabeledData MakeData(size_t begin, size_t end, const std::string& prefix) {
+  LabeledData data;
+  for (size_t i = begin; i < end; i++) {
+    std::string value = prefix + std::to_string(i);
+    apsi::Label label(value.begin(), value.end());
+    label.resize(16, 0);
+    data.emplace_back(apsi::Item("key_" + std::to_string(i)),
+                      std::move(label));
+  }
+  return data;
+}
+
+void TruncateFile(const std::string& file_path, size_t size) {
+  ASSERT_EQ(truncate(file_path.c_str(), size), 0) << file_path;
+}
+
+class SenderDbCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char dir_template[] = "/tmp/sender_db_cache_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    dir_ = dir_template;
+    db_path_ = dir_ + "/sender_db";
+  }
+  void TearDown() override {
+    DIR* dir = opendir(dir_.c_str());
+    if (dir != nullptr) {
+      while (auto* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name != "." && name != "..") {
+          RemoveFile(dir_ + "/" + name);
+        }
+      }
+      closedir(dir);
+    }
+    rmdir(dir_.c_str());
+  }
+  std::string CacheFile(const std::string& file_name) {
+    return dir_ + "/" + file_name;
+  }
+  /**
+   * save 10 records and return the meta of the saved generation
+  */
+  DbCacheMeta SaveSmallDb(SenderDbCache* db_cache,
+                          const std::string& dataset_version) {
+    auto params = apsi::PSIParams::Load(kParamsJson);
+    apsi::sender::SenderDB sender_db(params, 16, 16, false);
+    auto data = MakeData(0, 10, "v1_");
+    sender_db.set_data(data);
+    DbCacheMeta meta;
+    EXPECT_EQ(db_cache->Save(sender_db, data, dataset_version),
+              retcode::SUCCESS);
+    EXPECT_EQ(db_cache->LoadMeta(&meta), retcode::SUCCESS);
+    return meta;
+  }
+
+  std::string dir_;
+  std::string db_path_;
+};
+}  // namespace
+
+TEST_F(SenderDbCacheTest, save_load_update) {
+  auto params = apsi::PSIParams::Load(kParamsJson);
+  apsi::sender::SenderDB sender_db(params, 16, 16, false);
+  auto data = MakeData(0, 100, "v1_");
+  sender_db.set_data(data);
+
+  SenderDbCache db_cache(db_path_);
+  EXPECT_FALSE(db_cache.Available());
+  ASSERT_EQ(db_cache.Save(sender_db, data, "v1"), retcode::SUCCESS);
+  DbCacheMeta meta;
+  ASSERT_EQ(db_cache.LoadMeta(&meta), retcode::SUCCESS);
+  EXPECT_EQ(meta.format_version, SenderDbCache::kFormatVersion);
+  EXPECT_EQ(meta.dataset_version, "v1");
+  EXPECT_EQ(meta.item_count, 100u);
+
+  auto loaded_db = db_cache.Load();
+  ASSERT_NE(loaded_db, nullptr);
+  EXPECT_EQ(loaded_db->get_item_count(), 100u);
+
+  // drop [0, 10), change labels of [10, 20), insert [100, 120)
+  auto new_data = MakeData(10, 20, "v2_");
+  auto unchanged = MakeData(20, 120, "v1_");
+  new_data.insert(new_data.end(), unchanged.begin(), unchanged.end());
+  ASSERT_EQ(db_cache.Update(new_data, loaded_db.get()), retcode::SUCCESS);
+  EXPECT_EQ(loaded_db->get_item_count(), 110u);
+  ASSERT_EQ(db_cache.Save(*loaded_db, new_data, "v2"), retcode::SUCCESS);
+  ASSERT_EQ(db_cache.LoadMeta(&meta), retcode::SUCCESS);
+  EXPECT_EQ(meta.dataset_version, "v2");
+
+  // nothing changed since the last save
+  auto reloaded_db = db_cache.Load();
+  ASSERT_NE(reloaded_db, nullptr);
+  ASSERT_EQ(db_cache.Update(new_data, reloaded_db.get()), retcode::SUCCESS);
+  EXPECT_EQ(reloaded_db->get_item_count(), 110u);
+}
+
+TEST_F(SenderDbCacheTest, update_without_item_index) {
+  SenderDbCache db_cache(db_path_);
+  auto meta = SaveSmallDb(&db_cache, "");
+  auto sender_db = db_cache.Load();
+  ASSERT_NE(sender_db, nullptr);
+  RemoveFile(CacheFile(meta.items_file));
+  EXPECT_NE(db_cache.Update(MakeData(0, 10, "v1_"), sender_db.get()),
+            retcode::SUCCESS);
+}
+
+TEST_F(SenderDbCacheTest, save_replaces_previous_generation) {
+  SenderDbCache db_cache(db_path_);
+  auto first = SaveSmallDb(&db_cache, "v1");
+  auto second = SaveSmallDb(&db_cache, "v2");
+  EXPECT_EQ(second.generation, first.generation + 1);
+  EXPECT_NE(second.db_file, first.db_file);
+  EXPECT_FALSE(FileExists(CacheFile(first.db_file)));
+  EXPECT_FALSE(FileExists(CacheFile(first.items_file)));
+  EXPECT_TRUE(FileExists(CacheFile(second.db_file)));
+  EXPECT_TRUE(FileExists(CacheFile(second.items_file)));
+  EXPECT_NE(db_cache.Load(), nullptr);
+}
+
+TEST_F(SenderDbCacheTest, truncated_db_is_rejected) {
+  SenderDbCache db_cache(db_path_);
+  auto meta = SaveSmallDb(&db_cache, "v1");
+  TruncateFile(CacheFile(meta.db_file), meta.db_size / 2);
+  EXPECT_EQ(db_cache.Load(), nullptr);
+}
+
+TEST_F(SenderDbCacheTest, partial_item_index_is_rejected) {
+  SenderDbCache db_cache(db_path_);
+  auto meta = SaveSmallDb(&db_cache, "v1");
+  auto sender_db = db_cache.Load();
+  ASSERT_NE(sender_db, nullptr);
+  TruncateFile(CacheFile(meta.items_file), meta.items_size - 1);
+  EXPECT_NE(db_cache.Update(MakeData(0, 10, "v1_"), sender_db.get()),
+            retcode::SUCCESS);
+}
+
+TEST_F(SenderDbCacheTest, interrupted_save_keeps_committed_generation) {
+  SenderDbCache db_cache(db_path_);
+  auto meta = SaveSmallDb(&db_cache, "v1");
+  // a save that died before its meta was renamed leaves only these behind
+  std::string next_prefix =
+      "sender_db." + std::to_string(meta.generation + 1);
+  std::ofstream(CacheFile(next_prefix + ".db")) << "partial";
+  std::ofstream(CacheFile(next_prefix + ".items")) << "partial";
+  std::ofstream(db_cache.MetaPath() + ".tmp") << "{\"format_version\":";
+
+  DbCacheMeta loaded_meta;
+  ASSERT_EQ(db_cache.LoadMeta(&loaded_meta), retcode::SUCCESS);
+  EXPECT_EQ(loaded_meta.generation, meta.generation);
+  EXPECT_EQ(loaded_meta.dataset_version, "v1");
+  auto sender_db = db_cache.Load();
+  ASSERT_NE(sender_db, nullptr);
+  EXPECT_EQ(db_cache.Update(MakeData(0, 10, "v1_"), sender_db.get()),
+            retcode::SUCCESS);
+  // the next save overwrites the leftovers
+  auto next_meta = SaveSmallDb(&db_cache, "v2");
+  EXPECT_EQ(next_meta.generation, meta.generation + 1);
+  EXPECT_NE(db_cache.Load(), nullptr);
+}
+
+TEST_F(SenderDbCacheTest, corrupted_meta_is_rejected) {
+  SenderDbCache db_cache(db_path_);
+  SaveSmallDb(&db_cache, "v1");
+  std::ofstream(db_cache.MetaPath(), std::ios::trunc) << "{\"format_";
+  DbCacheMeta meta;
+  EXPECT_NE(db_cache.LoadMeta(&meta), retcode::SUCCESS);
+  EXPECT_EQ(db_cache.Load(), nullptr);
+}
+}  // namespace primihub::pir
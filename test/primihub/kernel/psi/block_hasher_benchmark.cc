@@ -0,0 +1,65 @@
+// Copyright [2023] <primihub.com>
+// throughput of hashing PSI input into oc::block
+// sha1-serial: the former single thread RandomOracle loop
+// sha1: RandomOracle on all cores
+// aes: fixed-key AES batch hash on all cores
+// ids look like 18 digit identity numbers and 11 digit phone numbers
+// usage: block_hasher_benchmark [item_num] [thread_num]
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/primihub/kernel/psi/operator/block_hasher.h"
+
+namespace primihub::psi {
+std::vector<std::string> MakeIds(size_t item_num) {
+  std::mt19937_64 gen(20230701);
+  std::uniform_int_distribution<int> digit(0, 9);
+  std::vector<std::string> ids;
+  ids.reserve(item_num);
+  for (size_t i = 0; i < item_num; i++) {
+    size_t len = i % 2 == 0 ? 18 : 11;
+    std::string id(len, '0');
+    for (auto& c : id) {
+      c = static_cast<char>('0' + digit(gen));
+    }
+    ids.push_back(std::move(id));
+  }
+  return ids;
+}
+
+void Run(const std::string& name, BlockHasher* hasher, bool serial,
+         const std::vector<std::string>& ids) {
+  std::vector<oc::block> result(ids.size());
+  auto start = std::chrono::high_resolution_clock::now();
+  if (serial) {
+    hasher->HashRange(ids, 0, ids.size(), result.data());
+  } else {
+    hasher->Hash(ids, &result);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  double cost_ms =
+      std::chrono::duration<double, std::milli>(end - start).count();
+  std::cout << "mode: " << name << " "
+            << "items: " << ids.size() << " "
+            << "threads: " << (serial ? 1 : hasher->ThreadNum()) << " "
+            << "cost(ms): " << cost_ms << " "
+            << "hashes/s: " << ids.size() * 1000.0 / cost_ms << std::endl;
+}
+}  // namespace primihub::psi
+
+int main(int argc, char* argv[]) {
+  size_t item_num = argc > 1 ? std::stoul(argv[1]) : 5000000;
+  size_t thread_num = argc > 2 ? std::stoul(argv[2]) : 0;
+  using primihub::psi::BlockHasher;
+  using primihub::psi::BlockHashType;
+  auto ids = primihub::psi::MakeIds(item_num);
+  BlockHasher sha1_hasher(BlockHashType::SHA1, thread_num);
+  BlockHasher aes_hasher(BlockHashType::FIXED_KEY_AES, thread_num);
+  primihub::psi::Run("sha1-serial", &sha1_hasher, true, ids);
+  primihub::psi::Run("sha1", &sha1_hasher, false, ids);
+  primihub::psi::Run("aes", &aes_hasher, false, ids);
+  return 0;
+}
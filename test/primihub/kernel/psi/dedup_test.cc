@@ -0,0 +1,64 @@
+// "Copyright [2023] <PrimiHub>"
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/primihub/kernel/psi/dedup.h"
+
+namespace primihub::psi {
+namespace {
+std::vector<std::string> ReferenceDedup(const std::vector<std::string>& items) {
+  std::vector<std::string> result;
+  std::unordered_set<std::string> seen;
+  for (const auto& item : items) {
+    if (seen.insert(item).second) {
+      result.push_back(item);
+    }
+  }
+  return result;
+}
+}  // namespace
+
+TEST(psi_dedup, small_input) {
+  std::vector<std::string> items = {"b", "a", "b", "c", "a", "", ""};
+  int64_t duplicate_num = 0;
+  ASSERT_EQ(DeduplicateInPlace(&items, 4, &duplicate_num), retcode::SUCCESS);
+  EXPECT_EQ(items, std::vector<std::string>({"b", "a", "c", ""}));
+  EXPECT_EQ(duplicate_num, 3);
+}
+
+TEST(psi_dedup, empty_input) {
+  std::vector<std::string> items;
+  int64_t duplicate_num = -1;
+  ASSERT_EQ(DeduplicateInPlace(&items, 0, &duplicate_num), retcode::SUCCESS);
+  EXPECT_TRUE(items.empty());
+  EXPECT_EQ(duplicate_num, 0);
+}
+
+TEST(psi_dedup, partitioned_input) {
+  std::mt19937_64 rng(20231017);
+  std::vector<std::string> items;
+  for (size_t i = 0; i < 500000; i++) {
+    items.push_back("id_" + std::to_string(rng() % 200000));
+  }
+  auto expected = ReferenceDedup(items);
+  int64_t duplicate_num = 0;
+  std::vector<DedupPartitionStat> stats;
+  size_t item_num = items.size();
+  ASSERT_EQ(DeduplicateInPlace(&items, 8, &duplicate_num, &stats),
+            retcode::SUCCESS);
+  EXPECT_EQ(items, expected);
+  EXPECT_EQ(duplicate_num, item_num - expected.size());
+  EXPECT_EQ(stats.size(), 8);
+  int64_t stat_items = 0;
+  int64_t stat_duplicates = 0;
+  for (const auto& stat : stats) {
+    stat_items += stat.item_num;
+    stat_duplicates += stat.duplicate_num;
+  }
+  EXPECT_EQ(stat_items, item_num);
+  EXPECT_EQ(stat_duplicates, duplicate_num);
+}
+}  // namespace primihub::psi
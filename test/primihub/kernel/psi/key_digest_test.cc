@@ -0,0 +1,93 @@
+// "Copyright [2023] <PrimiHub>"
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "arrow/api.h"
+#include "src/primihub/kernel/psi/util.h"
+
+namespace primihub::psi {
+namespace {
+std::shared_ptr<arrow::Array> Int64Array(const std::vector<int64_t>& values) {
+  arrow::Int64Builder builder;
+  builder.AppendValues(values);
+  std::shared_ptr<arrow::Array> array;
+  builder.Finish(&array);
+  return array;
+}
+
+std::shared_ptr<arrow::Array> Int32Array(const std::vector<int32_t>& values) {
+  arrow::Int32Builder builder;
+  builder.AppendValues(values);
+  std::shared_ptr<arrow::Array> array;
+  builder.Finish(&array);
+  return array;
+}
+
+std::shared_ptr<arrow::Array> StringArray(
+    const std::vector<std::string>& values) {
+  arrow::StringBuilder builder;
+  builder.AppendValues(values);
+  std::shared_ptr<arrow::Array> array;
+  builder.Finish(&array);
+  return array;
+}
+}  // namespace
+
+TEST(key_digest, typed_and_string_keys_match) {
+  PsiCommonUtil util;
+  auto typed_schema = arrow::schema({arrow::field("id", arrow::int64()),
+                                     arrow::field("age", arrow::int32())});
+  auto typed_table = arrow::Table::Make(
+      typed_schema, {Int64Array({1, -20, 300}), Int32Array({7, 8, 9})});
+  auto str_schema = arrow::schema({arrow::field("id", arrow::utf8()),
+                                   arrow::field("age", arrow::utf8())});
+  auto str_table = arrow::Table::Make(
+      str_schema, {StringArray({"1", "-20", "300"}),
+                   StringArray({"7", "8", "9"})});
+  std::vector<std::string> typed_digests;
+  std::vector<std::string> str_digests;
+  ASSERT_EQ(util.HashKeyColumns(typed_table, &typed_digests),
+            retcode::SUCCESS);
+  ASSERT_EQ(util.HashKeyColumns(str_table, &str_digests), retcode::SUCCESS);
+  ASSERT_EQ(typed_digests.size(), 3);
+  EXPECT_EQ(typed_digests, str_digests);
+  for (const auto& digest : typed_digests) {
+    EXPECT_EQ(digest.size(), PsiCommonUtil::kKeyDigestSize);
+  }
+  EXPECT_NE(typed_digests[0], typed_digests[1]);
+}
+
+TEST(key_digest, chunked_columns) {
+  PsiCommonUtil util;
+  auto schema = arrow::schema({arrow::field("id", arrow::int64()),
+                               arrow::field("name", arrow::utf8())});
+  auto table = arrow::Table::Make(
+      schema, {Int64Array({1, 2, 3, 4}),
+               StringArray({"a", "b", "c", "d"})});
+  // chunk boundaries differ between the two columns
+  auto id_col = std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{Int64Array({1}), Int64Array({2, 3, 4})});
+  auto name_col = std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{StringArray({"a", "b", "c"}), StringArray({"d"})});
+  auto chunked_table = arrow::Table::Make(schema, {id_col, name_col});
+  std::vector<std::string> digests;
+  std::vector<std::string> chunked_digests;
+  ASSERT_EQ(util.HashKeyColumns(table, &digests), retcode::SUCCESS);
+  ASSERT_EQ(util.HashKeyColumns(chunked_table, &chunked_digests),
+            retcode::SUCCESS);
+  EXPECT_EQ(digests, chunked_digests);
+}
+
+TEST(key_digest, match_result_rows) {
+  PsiCommonUtil util;
+  std::vector<std::string> digests = {"a", "b", "a", "c"};
+  std::vector<std::string> result = {"a", "c"};
+  std::vector<int64_t> row_index;
+  util.MatchResultRows(digests, result, false, &row_index);
+  EXPECT_EQ(row_index, std::vector<int64_t>({0, 2, 3}));
+  util.MatchResultRows(digests, result, true, &row_index);
+  EXPECT_EQ(row_index, std::vector<int64_t>({0, 3}));
+}
+}  // namespace primihub::psi
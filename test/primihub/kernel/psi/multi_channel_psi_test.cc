@@ -0,0 +1,129 @@
+// "Copyright [2023] <PrimiHub>"
+#include <algorithm>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "cryptoTools/Network/IOService.h"
+#include "cryptoTools/Network/Session.h"
+#include "src/primihub/kernel/psi/operator/cm20_psi.h"
+#include "src/primihub/kernel/psi/operator/kkrt_psi.h"
+
+namespace primihub::psi {
+namespace {
+/**
+ * expose the protocol steps, the operators run over local sessions
+ * instead of the channels built from a LinkContext
+*/
+template <typename Operator>
+class TestOperator : public Operator {
+ public:
+  using Operator::Operator;
+  using Operator::NegotiateChannelNum;
+  using Operator::PsiRecv;
+  using Operator::PsiSend;
+};
+
+Options MakeOptions(const std::string& party_name) {
+  Options options;
+  options.link_ctx_ref = nullptr;
+  options.self_party = party_name;
+  options.thread_num = 2;
+  return options;
+}
+
+std::vector<std::string> MakeItems(size_t begin, size_t end) {
+  std::vector<std::string> items;
+  for (size_t i = begin; i < end; i++) {
+    items.push_back("item_" + std::to_string(i));
+  }
+  return items;
+}
+
+class LocalChannels {
+ public:
+  LocalChannels(uint32_t port, size_t channel_num)
+      : server_(ios_, "127.0.0.1", port, oc::SessionMode::Server),
+        client_(ios_, "127.0.0.1", port, oc::SessionMode::Client) {
+    for (size_t i = 0; i < channel_num; i++) {
+      server_chls_.push_back(server_.addChannel());
+      client_chls_.push_back(client_.addChannel());
+    }
+  }
+  ~LocalChannels() {
+    for (auto& chl : server_chls_) {
+      chl.close();
+    }
+    for (auto& chl : client_chls_) {
+      chl.close();
+    }
+    server_.stop();
+    client_.stop();
+  }
+  std::vector<oc::Channel>& server_chls() {return server_chls_;}
+  std::vector<oc::Channel>& client_chls() {return client_chls_;}
+
+ private:
+  oc::IOService ios_;
+  oc::Session server_;
+  oc::Session client_;
+  std::vector<oc::Channel> server_chls_;
+  std::vector<oc::Channel> client_chls_;
+};
+
+template <typename Operator>
+void CheckIntersection(uint32_t port, size_t channel_num) {
+  LocalChannels channels(port, channel_num);
+  auto client_input = MakeItems(0, 1000);
+  auto server_input = MakeItems(500, 1700);
+  TestOperator<Operator> server(MakeOptions(PARTY_SERVER));
+  auto send_fut = std::async(std::launch::async, [&]() {
+    return server.PsiSend(channels.server_chls(), server_input);
+  });
+  TestOperator<Operator> client(MakeOptions(PARTY_CLIENT));
+  std::vector<uint64_t> result_index;
+  ASSERT_EQ(client.PsiRecv(channels.client_chls(), client_input,
+                           &result_index),
+            retcode::SUCCESS);
+  ASSERT_EQ(send_fut.get(), retcode::SUCCESS);
+  std::sort(result_index.begin(), result_index.end());
+  std::vector<uint64_t> expected;
+  for (uint64_t i = 500; i < 1000; i++) {
+    expected.push_back(i);
+  }
+  EXPECT_EQ(result_index, expected);
+}
+}  // namespace
+
+TEST(multi_channel_psi, negotiate_single_channel_with_peer) {
+  // a party wanting one channel still answers the peer wanting more
+  LocalChannels channels(12131, 1);
+  TestOperator<MtKkrtPsiOperator> server(MakeOptions(PARTY_SERVER));
+  TestOperator<Cm20PsiOperator> client(MakeOptions(PARTY_CLIENT));
+  size_t server_channel_num = 4;
+  auto server_fut = std::async(std::launch::async, [&]() {
+    return server.NegotiateChannelNum(channels.server_chls()[0],
+                                      &server_channel_num);
+  });
+  size_t client_channel_num = 1;
+  ASSERT_EQ(client.NegotiateChannelNum(channels.client_chls()[0],
+                                       &client_channel_num),
+            retcode::SUCCESS);
+  ASSERT_EQ(server_fut.get(), retcode::SUCCESS);
+  EXPECT_EQ(server_channel_num, 1u);
+  EXPECT_EQ(client_channel_num, 1u);
+}
+
+TEST(multi_channel_psi, mt_kkrt_intersection) {
+  CheckIntersection<MtKkrtPsiOperator>(12132, 4);
+}
+
+TEST(multi_channel_psi, cm20_intersection) {
+  CheckIntersection<Cm20PsiOperator>(12133, 4);
+}
+
+TEST(multi_channel_psi, cm20_single_channel_intersection) {
+  CheckIntersection<Cm20PsiOperator>(12134, 1);
+}
+}  // namespace primihub::psi
@@ -0,0 +1,337 @@
+// Copyright [2023] <primihub.com>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+#include "gtest/gtest.h"
+#include "src/primihub/node/ds.h"
+#include "src/primihub/common/common.h"
+#include "src/primihub/util/compress_util.h"
+#include "src/primihub/util/file_util.h"
+
+namespace primihub {
+namespace {
+std::string MakeContent(size_t size) {
+  std::string content(size, '\0');
+  for (size_t i = 0; i < size; i++) {
+    content[i] = static_cast<char>('a' + i % 26);
+  }
+  return content;
+}
+
+std::string ReadFile(const std::string& file_path) {
+  std::ifstream fin(file_path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(fin),
+                     std::istreambuf_iterator<char>());
+}
+
+rpc::UploadFileRequest MakeUploadBlock(const std::string& file_name,
+                                       uint64_t offset,
+                                       const std::string& data,
+                                       bool is_end) {
+  rpc::UploadFileRequest request;
+  request.set_file_name(file_name);
+  request.set_offset(offset);
+  request.set_data(data);
+  request.set_raw_size(data.size());
+  request.set_is_end(is_end);
+  return request;
+}
+
+class DataServiceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char dir_template[] = "/tmp/ds_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    dir_ = dir_template;
+    ServerConfig::getInstance().StoragePath() = dir_;
+    service_ = std::make_unique<DataServiceImpl>(nullptr);
+    grpc::ServerBuilder builder;
+    builder.RegisterService(service_.get());
+    server_ = builder.BuildAndStart();
+    ASSERT_NE(server_, nullptr);
+    stub_ = rpc::DataSetService::NewStub(
+        server_->InProcessChannel(grpc::ChannelArguments()));
+  }
+
+  void TearDown() override {
+    if (server_ != nullptr) {
+      server_->Shutdown();
+    }
+    for (const auto& file_name : files_) {
+      std::remove((dir_ + "/" + file_name).c_str());
+    }
+    rmdir(dir_.c_str());
+  }
+
+  std::string WriteFile(const std::string& file_name,
+                        const std::string& content) {
+    files_.push_back(file_name);
+    std::string file_path = dir_ + "/" + file_name;
+    std::ofstream fout(file_path, std::ios::binary | std::ios::trunc);
+    fout.write(content.data(), content.size());
+    return file_path;
+  }
+
+  std::vector<rpc::DownloadRespone> Download(
+      const rpc::DownloadRequest& request) {
+    grpc::ClientContext context;
+    auto reader = stub_->DownloadData(&context, request);
+    std::vector<rpc::DownloadRespone> responses;
+    rpc::DownloadRespone response;
+    while (reader->Read(&response)) {
+      responses.push_back(response);
+    }
+    EXPECT_TRUE(reader->Finish().ok());
+    return responses;
+  }
+
+  /**
+   * put the blocks of each file together by offset,
+   * and count the end blocks of each file
+  */
+  std::map<std::string, std::string> Assemble(
+      const std::vector<rpc::DownloadRespone>& responses,
+      std::map<std::string, int>* end_count) {
+    std::map<std::string, std::string> files;
+    for (const auto& response : responses) {
+      EXPECT_EQ(response.code(), rpc::Status::SUCCESS) << response.info();
+      std::string data = response.data();
+      if (response.compress_type() == rpc::CompressType::ZLIB) {
+        std::string raw_data;
+        EXPECT_EQ(ZlibUncompress(data, response.raw_size(), &raw_data),
+                  retcode::SUCCESS);
+        data = std::move(raw_data);
+      }
+      auto& content = files[response.file_name()];
+      // blocks of one file are in order even if files are interleaved
+      EXPECT_EQ(response.offset(), content.size());
+      EXPECT_EQ((*end_count)[response.file_name()], 0);
+      content.append(data);
+      if (response.is_end()) {
+        (*end_count)[response.file_name()]++;
+      }
+    }
+    return files;
+  }
+
+  std::string dir_;
+  std::vector<std::string> files_;
+  std::unique_ptr<DataServiceImpl> service_;
+  std::unique_ptr<grpc::Server> server_;
+  std::unique_ptr<rpc::DataSetService::Stub> stub_;
+};
+}  // namespace
+
+TEST(upload_name, reject_path_outside_storage) {
+  EXPECT_TRUE(IsValidUploadName("data.csv"));
+  EXPECT_TRUE(IsValidUploadName("dir/sub-dir/data_1.csv"));
+  EXPECT_TRUE(IsValidUploadName("dir/..data"));
+  EXPECT_FALSE(IsValidUploadName(""));
+  EXPECT_FALSE(IsValidUploadName(".."));
+  EXPECT_FALSE(IsValidUploadName("../data.csv"));
+  EXPECT_FALSE(IsValidUploadName("dir/../../data.csv"));
+  EXPECT_FALSE(IsValidUploadName("dir/.."));
+  EXPECT_FALSE(IsValidUploadName("/etc/passwd"));
+}
+
+TEST(upload_name, reject_shell_metacharacters) {
+  for (const std::string name : {"a;rm -rf x", "a b", "$(id)", "`id`",
+                                 "a|b", "a&b", "a>b", "a\nb", "a*"}) {
+    EXPECT_FALSE(IsValidUploadName(name)) << name;
+  }
+}
+
+TEST_F(DataServiceTest, download_range_from_offset) {
+  auto content = MakeContent(1000);
+  auto file_path = WriteFile("range.csv", content);
+  rpc::DownloadRequest request;
+  request.add_file_list(file_path);
+  auto range = request.add_file_range();
+  range->set_file_name(file_path);
+  range->set_offset(100);
+  range->set_length(300);
+  auto responses = Download(request);
+  ASSERT_EQ(responses.size(), 1u);
+  EXPECT_EQ(responses[0].code(), rpc::Status::SUCCESS);
+  EXPECT_EQ(responses[0].offset(), 100u);
+  EXPECT_EQ(responses[0].data(), content.substr(100, 300));
+  EXPECT_TRUE(responses[0].is_end());
+  EXPECT_EQ(responses[0].file_size(), content.size());
+  EXPECT_GT(responses[0].mtime(), 0);
+}
+
+TEST_F(DataServiceTest, download_offset_beyond_file_fails) {
+  auto file_path = WriteFile("short.csv", MakeContent(10));
+  rpc::DownloadRequest request;
+  request.add_file_list(file_path);
+  auto range = request.add_file_range();
+  range->set_file_name(file_path);
+  range->set_offset(11);
+  auto responses = Download(request);
+  ASSERT_FALSE(responses.empty());
+  EXPECT_EQ(responses.back().code(), rpc::Status::FAIL);
+}
+
+TEST_F(DataServiceTest, download_multi_file_end_of_each_file) {
+  // the large file is split into several blocks
+  std::vector<std::string> contents{MakeContent(LIMITED_PACKAGE_SIZE + 100),
+                                    MakeContent(0),
+                                    MakeContent(200)};
+  rpc::DownloadRequest request;
+  std::vector<std::string> file_paths;
+  for (size_t i = 0; i < contents.size(); i++) {
+    file_paths.push_back(
+        WriteFile("multi_" + std::to_string(i) + ".csv", contents[i]));
+    request.add_file_list(file_paths.back());
+  }
+  std::map<std::string, int> end_count;
+  auto files = Assemble(Download(request), &end_count);
+  ASSERT_EQ(files.size(), contents.size());
+  for (size_t i = 0; i < contents.size(); i++) {
+    EXPECT_EQ(files[file_paths[i]], contents[i]);
+    EXPECT_EQ(end_count[file_paths[i]], 1);
+  }
+}
+
+TEST_F(DataServiceTest, download_parallel_compressed) {
+  rpc::DownloadRequest request;
+  request.set_parallel_num(3);
+  request.set_compress_type(rpc::CompressType::ZLIB);
+  std::map<std::string, std::string> contents;
+  for (size_t i = 0; i < 5; i++) {
+    auto content = MakeContent(LIMITED_PACKAGE_SIZE / 2 * (i + 1));
+    auto file_path =
+        WriteFile("parallel_" + std::to_string(i) + ".csv", content);
+    request.add_file_list(file_path);
+    contents[file_path] = std::move(content);
+  }
+  std::map<std::string, int> end_count;
+  auto files = Assemble(Download(request), &end_count);
+  EXPECT_EQ(files, contents);
+  for (const auto& [file_path, content] : contents) {
+    EXPECT_EQ(end_count[file_path], 1) << file_path;
+  }
+}
+
+TEST_F(DataServiceTest, upload_resume_after_interruption) {
+  auto content = MakeContent(1000);
+  files_.push_back("upload.csv");
+  files_.push_back("upload.csv.uploading");
+  rpc::UploadFileResponse reply;
+  {
+    grpc::ClientContext context;
+    auto writer = stub_->UploadData(&context, &reply);
+    ASSERT_TRUE(writer->Write(
+        MakeUploadBlock("upload.csv", 0, content.substr(0, 400), false)));
+    // the stream is closed before the last block
+    writer->WritesDone();
+    ASSERT_TRUE(writer->Finish().ok());
+  }
+  EXPECT_EQ(reply.code(), rpc::Status::FAIL);
+  EXPECT_EQ(reply.size(), 400u);
+  EXPECT_FALSE(FileExists(dir_ + "/upload.csv"));
+
+  // a wrong offset does not corrupt the temporary file
+  rpc::UploadFileResponse wrong_reply;
+  {
+    grpc::ClientContext context;
+    auto writer = stub_->UploadData(&context, &wrong_reply);
+    writer->Write(
+        MakeUploadBlock("upload.csv", 300, content.substr(300), true));
+    writer->WritesDone();
+    ASSERT_TRUE(writer->Finish().ok());
+  }
+  EXPECT_EQ(wrong_reply.code(), rpc::Status::FAIL);
+  EXPECT_EQ(wrong_reply.size(), 400u);
+
+  rpc::UploadFileResponse resume_reply;
+  {
+    grpc::ClientContext context;
+    auto writer = stub_->UploadData(&context, &resume_reply);
+    std::string compressed;
+    ASSERT_EQ(ZlibCompress(content.substr(400), &compressed),
+              retcode::SUCCESS);
+    auto block = MakeUploadBlock("upload.csv", 400, compressed, true);
+    block.set_compress_type(rpc::CompressType::ZLIB);
+    block.set_raw_size(content.size() - 400);
+    ASSERT_TRUE(writer->Write(block));
+    writer->WritesDone();
+    ASSERT_TRUE(writer->Finish().ok());
+  }
+  EXPECT_EQ(resume_reply.code(), rpc::Status::SUCCESS)
+      << resume_reply.info();
+  EXPECT_EQ(resume_reply.size(), content.size());
+  EXPECT_EQ(ReadFile(dir_ + "/upload.csv"), content);
+  EXPECT_FALSE(FileExists(dir_ + "/upload.csv.uploading"));
+}
+
+TEST_F(DataServiceTest, upload_rejects_invalid_name) {
+  rpc::UploadFileResponse reply;
+  grpc::ClientContext context;
+  auto writer = stub_->UploadData(&context, &reply);
+  writer->Write(MakeUploadBlock("../escape.csv", 0, "data", true));
+  writer->WritesDone();
+  ASSERT_TRUE(writer->Finish().ok());
+  EXPECT_EQ(reply.code(), rpc::Status::FAIL);
+  EXPECT_FALSE(FileExists(dir_ + "/../escape.csv"));
+}
+
+TEST_F(DataServiceTest, upload_rejects_oversized_raw_size) {
+  files_.push_back("oversized.csv.uploading");
+  rpc::UploadFileResponse reply;
+  grpc::ClientContext context;
+  auto writer = stub_->UploadData(&context, &reply);
+  std::string compressed;
+  ASSERT_EQ(ZlibCompress("data", &compressed), retcode::SUCCESS);
+  auto block = MakeUploadBlock("oversized.csv", 0, compressed, true);
+  block.set_compress_type(rpc::CompressType::ZLIB);
+  block.set_raw_size(LIMITED_PACKAGE_SIZE + 1);
+  writer->Write(block);
+  writer->WritesDone();
+  ASSERT_TRUE(writer->Finish().ok());
+  EXPECT_EQ(reply.code(), rpc::Status::FAIL);
+  EXPECT_EQ(reply.size(), 0u);
+}
+
+TEST_F(DataServiceTest, concurrent_upload_of_same_file_is_rejected) {
+  files_.push_back("same.csv");
+  files_.push_back("same.csv.uploading");
+  rpc::UploadFileResponse first_reply;
+  grpc::ClientContext first_context;
+  auto first_writer = stub_->UploadData(&first_context, &first_reply);
+  ASSERT_TRUE(first_writer->Write(
+      MakeUploadBlock("same.csv", 0, "first", false)));
+  // the temporary file is created once the first upload owns the file
+  auto tmp_path = dir_ + "/same.csv.uploading";
+  for (int i = 0; i < 500 && !FileExists(tmp_path); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_TRUE(FileExists(tmp_path));
+
+  rpc::UploadFileResponse second_reply;
+  {
+    grpc::ClientContext context;
+    auto writer = stub_->UploadData(&context, &second_reply);
+    writer->Write(MakeUploadBlock("same.csv", 0, "second", true));
+    writer->WritesDone();
+    ASSERT_TRUE(writer->Finish().ok());
+  }
+  EXPECT_EQ(second_reply.code(), rpc::Status::FAIL);
+
+  ASSERT_TRUE(first_writer->Write(
+      MakeUploadBlock("same.csv", 5, "_end", true)));
+  first_writer->WritesDone();
+  ASSERT_TRUE(first_writer->Finish().ok());
+  EXPECT_EQ(first_reply.code(), rpc::Status::SUCCESS) << first_reply.info();
+  EXPECT_EQ(ReadFile(dir_ + "/same.csv"), "first_end");
+}
+}  // namespace primihub
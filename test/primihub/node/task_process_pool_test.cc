@@ -0,0 +1,121 @@
+// Copyright [2023] <primihub.com>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/primihub/node/worker/task_process_pool.h"
+#include "src/primihub/task_engine/task_process_protocol.h"
+
+namespace primihub {
+namespace {
+// shell scripts stand in for task_main --serve,
+// markers go to stdout and log to stderr
+std::unique_ptr<TaskProcessPool> MakePool(const std::string& script,
+                                          size_t pool_size = 1) {
+  std::vector<std::string> args{"-c", script};
+  return std::make_unique<TaskProcessPool>("/bin/sh", args, pool_size);
+}
+
+const char kNormalTask[] =
+    "read req; "
+    "echo \"log of $req\" >&2; "
+    "echo '#PRIMIHUB_TASK_FINISHED 0' >&2; "
+    "echo '#PRIMIHUB_TASK_STARTED'; "
+    "echo '#PRIMIHUB_TASK_FINISHED 0'";
+}  // namespace
+
+TEST(TaskProcessProtocolTest, ParseFinishedMarker) {
+  using task_engine::ParseFinishedMarker;
+  int code{1};
+  EXPECT_TRUE(ParseFinishedMarker(task_engine::MakeFinishedMarker(0), &code));
+  EXPECT_EQ(code, 0);
+  EXPECT_TRUE(ParseFinishedMarker("#PRIMIHUB_TASK_FINISHED -1", &code));
+  EXPECT_EQ(code, -1);
+  EXPECT_FALSE(ParseFinishedMarker("#PRIMIHUB_TASK_FINISHED", &code));
+  EXPECT_FALSE(ParseFinishedMarker("#PRIMIHUB_TASK_FINISHED ", &code));
+  EXPECT_FALSE(ParseFinishedMarker("#PRIMIHUB_TASK_FINISHED 0abc", &code));
+  EXPECT_FALSE(ParseFinishedMarker("#PRIMIHUB_TASK_FINISHED abc", &code));
+  EXPECT_FALSE(ParseFinishedMarker(
+      "#PRIMIHUB_TASK_FINISHED 99999999999999999999", &code));
+  EXPECT_FALSE(ParseFinishedMarker("I0701 log line", &code));
+}
+
+TEST(TaskProcessPoolTest, ProcessIsReplacedAfterTask) {
+  auto pool = MakePool(kNormalTask);
+  ASSERT_EQ(pool->IdleNum(), 1);
+  for (int i = 0; i < 2; i++) {
+    auto process = pool->Acquire();
+    ASSERT_NE(process, nullptr);
+    EXPECT_EQ(pool->IdleNum(), 0);
+    std::vector<std::string> logs;
+    double startup_ms{-1};
+    auto ret = process->Run(
+        "request" + std::to_string(i),
+        [&](const std::string& line) {logs.push_back(line);},
+        &startup_ms);
+    EXPECT_EQ(ret, retcode::SUCCESS);
+    EXPECT_GE(startup_ms, 0);
+    // a marker written to the log channel is only a log line
+    std::vector<std::string> expected_logs{
+        "log of request" + std::to_string(i), "#PRIMIHUB_TASK_FINISHED 0"};
+    EXPECT_EQ(logs, expected_logs);
+    EXPECT_TRUE(process->Used());
+    EXPECT_FALSE(process->IsAlive());
+    pool->Release(std::move(process));
+    EXPECT_EQ(pool->IdleNum(), 1);
+  }
+}
+
+TEST(TaskProcessPoolTest, UnusedProcessIsReused) {
+  auto pool = MakePool(kNormalTask);
+  auto process = pool->Acquire();
+  ASSERT_NE(process, nullptr);
+  auto pid = process->Handle().id();
+  pool->Release(std::move(process));
+  process = pool->Acquire();
+  ASSERT_NE(process, nullptr);
+  EXPECT_EQ(process->Handle().id(), pid);
+}
+
+TEST(TaskProcessPoolTest, ChildCrash) {
+  auto pool = MakePool(
+      "read req; echo '#PRIMIHUB_TASK_STARTED'; kill -9 $$");
+  auto process = pool->Acquire();
+  ASSERT_NE(process, nullptr);
+  double startup_ms{0};
+  auto ret = process->Run("request", [](const std::string&) {}, &startup_ms);
+  EXPECT_EQ(ret, retcode::FAIL);
+  EXPECT_FALSE(process->IsAlive());
+  pool->Release(std::move(process));
+  EXPECT_EQ(pool->IdleNum(), 1);
+}
+
+TEST(TaskProcessPoolTest, MalformedMarker) {
+  auto pool = MakePool(
+      "read req; echo '#PRIMIHUB_TASK_FINISHED 0abc'; exec sleep 100");
+  auto process = pool->Acquire();
+  ASSERT_NE(process, nullptr);
+  auto start = std::chrono::steady_clock::now();
+  double startup_ms{0};
+  auto ret = process->Run("request", [](const std::string&) {}, &startup_ms);
+  EXPECT_EQ(ret, retcode::FAIL);
+  // the broken process is killed instead of waited for
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  EXPECT_FALSE(process->IsAlive());
+}
+
+TEST(TaskProcessPoolTest, WriteToClosedInputFails) {
+  // the process closes stdin before the request arrives,
+  // the write fails with EPIPE and SIGPIPE does not kill the test
+  auto pool = MakePool("exec 0<&-; exec sleep 1");
+  auto process = pool->Acquire();
+  ASSERT_NE(process, nullptr);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  double startup_ms{0};
+  auto ret = process->Run("request", [](const std::string&) {}, &startup_ms);
+  EXPECT_EQ(ret, retcode::FAIL);
+}
+}  // namespace primihub
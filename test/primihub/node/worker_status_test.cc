@@ -0,0 +1,77 @@
+// Copyright [2023] <primihub.com>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/primihub/node/worker/worker.h"
+
+namespace primihub {
+namespace {
+const std::string kNodeId = "node0";  // NOLINT
+constexpr auto kNoWait = std::chrono::milliseconds(0);
+
+rpc::TaskStatus MakeStatus(const std::string& party,
+                           rpc::TaskStatus::StatusCode code) {
+  rpc::TaskStatus task_status;
+  task_status.mutable_task_info()->set_request_id("request_0");
+  task_status.set_party(party);
+  task_status.set_status(code);
+  return task_status;
+}
+
+std::vector<rpc::TaskStatus> ReadAll(Worker* worker, size_t* cursor) {
+  std::vector<rpc::TaskStatus> statuses;
+  rpc::TaskStatus task_status;
+  while (worker->waitTaskStatus(cursor, &task_status, kNoWait) ==
+         retcode::SUCCESS) {
+    statuses.push_back(task_status);
+  }
+  return statuses;
+}
+}  // namespace
+
+TEST(worker_status, watchers_do_not_consume_statuses) {
+  Worker worker(kNodeId, "request_0", nullptr);
+  worker.setPartyCount(2);
+  worker.updateTaskStatus(MakeStatus("party_0", rpc::TaskStatus::RUNNING));
+  size_t first_cursor = 0;
+  auto first = ReadAll(&worker, &first_cursor);
+  ASSERT_EQ(first.size(), 1u);
+
+  worker.updateTaskStatus(MakeStatus("party_0", rpc::TaskStatus::SUCCESS));
+  worker.updateTaskStatus(MakeStatus("party_1", rpc::TaskStatus::SUCCESS));
+  EXPECT_TRUE(worker.isSchedulerFinished());
+  // a late watcher still sees every status from the beginning
+  size_t second_cursor = 0;
+  auto second = ReadAll(&worker, &second_cursor);
+  ASSERT_EQ(second.size(), 3u);
+  EXPECT_EQ(second[0].status(), rpc::TaskStatus::RUNNING);
+  EXPECT_EQ(second[2].party(), "party_1");
+  auto rest = ReadAll(&worker, &first_cursor);
+  ASSERT_EQ(rest.size(), 2u);
+  EXPECT_EQ(rest[0].status(), rpc::TaskStatus::SUCCESS);
+}
+
+TEST(worker_status, final_status_of_each_party) {
+  Worker worker(kNodeId, "request_0", nullptr);
+  worker.setPartyCount(2);
+  worker.updateTaskStatus(MakeStatus("party_0", rpc::TaskStatus::RUNNING));
+  worker.updateTaskStatus(MakeStatus("party_0", rpc::TaskStatus::SUCCESS));
+  worker.updateTaskStatus(MakeStatus("party_1", rpc::TaskStatus::FAIL));
+  auto final_status = worker.finalTaskStatus();
+  ASSERT_EQ(final_status.size(), 2u);
+  EXPECT_EQ(final_status[0].status(), rpc::TaskStatus::SUCCESS);
+  EXPECT_EQ(final_status[1].status(), rpc::TaskStatus::FAIL);
+}
+
+TEST(worker_status, wait_times_out_without_new_status) {
+  Worker worker(kNodeId, "request_0", nullptr);
+  size_t cursor = 0;
+  rpc::TaskStatus task_status;
+  EXPECT_EQ(worker.waitTaskStatus(&cursor, &task_status,
+                                  std::chrono::milliseconds(10)),
+            retcode::FAIL);
+  EXPECT_EQ(cursor, 0u);
+}
+}  // namespace primihub
@@ -0,0 +1,190 @@
+#include <glog/logging.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "src/primihub/operator/aby3_operator.h"
+#include "gtest/gtest.h"
+
+using namespace primihub;
+
+static void run_mpc(uint64_t party_id, std::string ip, uint16_t next_port,
+                    uint16_t prev_port, const std::vector<double> &vals,
+                    bool is_max, eMatrix<double> *result) {
+  std::string next_name, prev_name;
+  if (party_id == 0) {
+    next_name = "01";
+    prev_name = "02";
+  } else if (party_id == 1) {
+    next_name = "12";
+    prev_name = "01";
+  } else if (party_id == 2) {
+    next_name = "02";
+    prev_name = "12";
+  }
+
+  MPCOperator *mpc_exec = new MPCOperator(party_id, next_name, prev_name);
+  mpc_exec->setup(ip, ip, next_port, prev_port);
+
+  try {
+    eMatrix<double> m(vals.size(), 1);
+    for (size_t i = 0; i < vals.size(); i++)
+      m(i, 0) = vals[i];
+    std::vector<sf64Matrix<D16>> sh_vals;
+    for (uint64_t i = 0; i < 3; i++) {
+      sf64Matrix<D16> sh_val(vals.size(), 1);
+      if (i == party_id)
+        mpc_exec->createShares(m, sh_val);
+      else
+        mpc_exec->createShares(sh_val);
+      sh_vals.emplace_back(sh_val);
+    }
+    auto sh_res = mpc_exec->MPC_MaxOrMin(sh_vals, is_max);
+    *result = mpc_exec->revealAll(sh_res);
+  } catch (std::exception &e) {
+    LOG(ERROR) << "In party " << party_id << ":\n" << e.what() << ".";
+  }
+
+  mpc_exec->fini();
+  delete mpc_exec;
+}
+
+static void check_max_or_min(const std::vector<std::vector<double>>& party_val,
+                             bool is_max) {
+  size_t num = party_val[0].size();
+  pid_t pid_2 = fork();
+  if (pid_2 == 0) {
+    eMatrix<double> result;
+    run_mpc(2, "127.0.0.1", 10120, 10130, party_val[2], is_max, &result);
+    _exit(0);
+  }
+  pid_t pid_1 = fork();
+  if (pid_1 == 0) {
+    eMatrix<double> result;
+    run_mpc(1, "127.0.0.1", 10130, 10110, party_val[1], is_max, &result);
+    _exit(0);
+  }
+
+  eMatrix<double> result;
+  run_mpc(0, "127.0.0.1", 10110, 10120, party_val[0], is_max, &result);
+  waitpid(pid_1, nullptr, 0);
+  waitpid(pid_2, nullptr, 0);
+
+  ASSERT_EQ(result.rows(), num);
+  for (size_t i = 0; i < num; i++) {
+    double expected = is_max ?
+        std::max({party_val[0][i], party_val[1][i], party_val[2][i]}) :
+        std::min({party_val[0][i], party_val[1][i], party_val[2][i]});
+    EXPECT_NEAR(result(i, 0), expected, 1e-3) << "index: " << i;
+  }
+}
+
+static std::vector<std::vector<double>> MakeValues() {
+  std::vector<std::vector<double>> party_val(3);
+  for (int i = 0; i < 100; i++) {
+    party_val[0].push_back(1.5 * i - 20);
+    party_val[1].push_back(-0.75 * i + 30);
+    party_val[2].push_back((i % 7) * 3.25 - 5);
+  }
+  return party_val;
+}
+
+/**
+ * values at and near +-kMaxOrMinBound, the widest difference is 2^46,
+ * together with the sentinel a party without data sends
+ */
+static std::vector<std::vector<double>> MakeBoundValues(bool is_max) {
+  constexpr double kBound = MPCOperator::kMaxOrMinBound;
+  double sentinel = is_max ? -kBound : kBound;
+  std::vector<std::vector<double>> party_val(3);
+  party_val[0] = {kBound, -kBound, kBound - 1.5, -kBound + 0.25, -7.5,
+                  -kBound, 0, sentinel};
+  party_val[1] = {-kBound, kBound, -kBound + 2, kBound - 0.5, -1e8,
+                  -kBound + 1, -0.125, -123456.75};
+  party_val[2] = {sentinel, sentinel, sentinel, sentinel, -3e8,
+                  -kBound + 0.5, -kBound, sentinel};
+  return party_val;
+}
+
+/**
+ * timestamps, amounts and ids far beyond 2^29, all of them have to be
+ * returned exactly instead of a clamped value
+ */
+static std::vector<std::vector<double>> MakeLargeValues() {
+  std::vector<std::vector<double>> party_val(3);
+  party_val[0] = {1700000000123.0, -987654321098.5, 536870913.0,
+                  -536870913.0, 30000000000000.0, 2.0};
+  party_val[1] = {1700000000124.0, -987654321099.0, 536870912.0,
+                  -536870912.0, -30000000000000.0, 1e12};
+  party_val[2] = {1699999999999.25, 123.0, 1e9, -1e9, 29999999999999.5,
+                  -1e12};
+  return party_val;
+}
+
+static void run_out_of_bound(uint64_t party_id, uint16_t next_port,
+                             uint16_t prev_port, bool local_out_of_bound,
+                             bool *result) {
+  std::string next_name[3] = {"01", "12", "02"};
+  std::string prev_name[3] = {"02", "01", "12"};
+  MPCOperator mpc_exec(party_id, next_name[party_id], prev_name[party_id]);
+  mpc_exec.setup("127.0.0.1", "127.0.0.1", next_port, prev_port);
+  try {
+    *result = mpc_exec.MaxOrMinOutOfBound(local_out_of_bound);
+  } catch (std::exception &e) {
+    LOG(ERROR) << "In party " << party_id << ":\n" << e.what() << ".";
+  }
+  mpc_exec.fini();
+}
+
+static bool check_out_of_bound(const std::vector<bool>& party_flag) {
+  pid_t pid_2 = fork();
+  if (pid_2 == 0) {
+    bool result{false};
+    run_out_of_bound(2, 10120, 10130, party_flag[2], &result);
+    _exit(0);
+  }
+  pid_t pid_1 = fork();
+  if (pid_1 == 0) {
+    bool result{false};
+    run_out_of_bound(1, 10130, 10110, party_flag[1], &result);
+    _exit(0);
+  }
+  bool result{false};
+  run_out_of_bound(0, 10110, 10120, party_flag[0], &result);
+  waitpid(pid_1, nullptr, 0);
+  waitpid(pid_2, nullptr, 0);
+  return result;
+}
+
+TEST(max_or_min_op, mpc_max_op) {
+  check_max_or_min(MakeValues(), true);
+}
+
+TEST(max_or_min_op, mpc_min_op) {
+  check_max_or_min(MakeValues(), false);
+}
+
+TEST(max_or_min_op, mpc_max_op_near_bound) {
+  check_max_or_min(MakeBoundValues(true), true);
+}
+
+TEST(max_or_min_op, mpc_min_op_near_bound) {
+  check_max_or_min(MakeBoundValues(false), false);
+}
+
+TEST(max_or_min_op, mpc_max_op_beyond_2_29) {
+  check_max_or_min(MakeLargeValues(), true);
+}
+
+TEST(max_or_min_op, mpc_min_op_beyond_2_29) {
+  check_max_or_min(MakeLargeValues(), false);
+}
+
+TEST(max_or_min_op, out_of_bound_of_any_party_is_seen_by_all) {
+  EXPECT_FALSE(check_out_of_bound({false, false, false}));
+  EXPECT_TRUE(check_out_of_bound({false, true, false}));
+  EXPECT_TRUE(check_out_of_bound({true, false, true}));
+}
@@ -0,0 +1,71 @@
+// Copyright [2023] <primihub.com>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "src/primihub/service/dataset/meta_cache.h"
+
+namespace primihub::service {
+DatasetMetaInfo MakeMetaInfo(const std::string& id) {
+  DatasetMetaInfo meta_info;
+  meta_info.id = id;
+  meta_info.driver_type = "CSV";
+  meta_info.access_info = "/data/" + id + ".csv";
+  return meta_info;
+}
+
+TEST(DatasetMetaCacheTest, HitAndMiss) {
+  DatasetMetaCache cache;
+  DatasetMetaInfo meta_info;
+  EXPECT_FALSE(cache.Get("a", &meta_info));
+  EXPECT_TRUE(cache.Put("a", MakeMetaInfo("a"), cache.Version()));
+  EXPECT_TRUE(cache.Get("a", &meta_info));
+  EXPECT_EQ(meta_info.access_info, "/data/a.csv");
+  EXPECT_EQ(cache.HitCount(), 1);
+  EXPECT_EQ(cache.MissCount(), 1);
+}
+
+TEST(DatasetMetaCacheTest, EvictLeastRecentlyUsed) {
+  DatasetMetaCache cache(2);
+  DatasetMetaInfo meta_info;
+  cache.Put("a", MakeMetaInfo("a"), cache.Version());
+  cache.Put("b", MakeMetaInfo("b"), cache.Version());
+  EXPECT_TRUE(cache.Get("a", &meta_info));
+  cache.Put("c", MakeMetaInfo("c"), cache.Version());
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_TRUE(cache.Get("a", &meta_info));
+  EXPECT_FALSE(cache.Get("b", &meta_info));
+  EXPECT_TRUE(cache.Get("c", &meta_info));
+}
+
+TEST(DatasetMetaCacheTest, StalePutIsRejected) {
+  DatasetMetaCache cache;
+  DatasetMetaInfo meta_info;
+  auto version = cache.Version();
+  // dataset is registered again while the old meta is being resolved
+  cache.Invalidate("a");
+  EXPECT_FALSE(cache.Put("a", MakeMetaInfo("a"), version));
+  EXPECT_FALSE(cache.Get("a", &meta_info));
+  cache.Put("a", MakeMetaInfo("a"), cache.Version());
+  cache.Invalidate("a");
+  EXPECT_FALSE(cache.Get("a", &meta_info));
+}
+
+TEST(DatasetMetaCacheTest, Expire) {
+  DatasetMetaCache cache(DatasetMetaCache::kDefaultCapacity, 10);
+  DatasetMetaInfo meta_info;
+  cache.Put("a", MakeMetaInfo("a"), cache.Version());
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(cache.Get("a", &meta_info));
+  EXPECT_EQ(cache.Size(), 0);
+}
+
+TEST(DatasetMetaCacheTest, ZeroTtlDisablesCache) {
+  DatasetMetaCache cache;
+  DatasetMetaInfo meta_info;
+  cache.Put("a", MakeMetaInfo("a"), cache.Version());
+  cache.SetTtl(0);
+  EXPECT_FALSE(cache.Get("a", &meta_info));
+  EXPECT_FALSE(cache.Put("a", MakeMetaInfo("a"), cache.Version()));
+  EXPECT_EQ(cache.Size(), 0);
+}
+}  // namespace primihub::service
@@ -0,0 +1,412 @@
+// Copyright [2023] <primihub.com>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glog/logging.h>
+#include <grpcpp/grpcpp.h>
+#include "gtest/gtest.h"
+#include "src/primihub/common/common.h"
+#include "src/primihub/protos/worker.grpc.pb.h"
+#include "src/primihub/protos/worker.pb.h"
+#include "src/primihub/task/pybind_wrapper/mpc_task_wrapper.h"
+#include "src/primihub/task/semantic/mpc_task.h"
+
+namespace primihub::task {
+namespace {
+using StatisticsRequest = MPCExecutor::StatisticsRequest;
+using Batch = std::vector<StatisticsRequest>;
+// node port of PARTY0, PARTY1 and the auxiliary compute server
+constexpr uint16_t kNodePort[3] = {10310, 10311, 10312};
+
+rpc::Node MakeNode(uint16_t port, int party_id) {
+  rpc::Node node;
+  node.set_ip("127.0.0.1");
+  node.set_port(port);
+  node.set_party_id(party_id);
+  return node;
+}
+
+std::string MakeTaskRequest(const std::string& party_name,
+                            uint16_t aux_port, uint16_t proxy_port = 0) {
+  rpc::PushTaskRequest request;
+  auto task = request.mutable_task();
+  task->set_party_name(party_name);
+  task->mutable_task_info()->set_task_id("mpc_task_wrapper_test");
+  task->mutable_task_info()->set_job_id("job");
+  task->mutable_task_info()->set_request_id("request");
+  auto& party_access_info = *task->mutable_party_access_info();
+  for (int i = 0; i < 2; i++) {
+    party_access_info["PARTY" + std::to_string(i)] =
+        MakeNode(kNodePort[i], i);
+  }
+  auto& auxiliary_server = *task->mutable_auxiliary_server();
+  auxiliary_server[AUX_COMPUTE_NODE] = MakeNode(aux_port, 0);
+  if (proxy_port != 0) {
+    auxiliary_server[PROXY_NODE] = MakeNode(proxy_port, 0);
+  }
+  return request.SerializeAsString();
+}
+
+/**
+ * stands in for the node of a party: data sent to the party is kept
+ * until the party fetches it by ForwardRecv, ExecuteTask runs the task
+ * of the auxiliary server. ForwardRecvStream is not implemented,
+ * so channels fall back to ForwardRecv
+*/
+class FakeNode final : public rpc::VMNode::Service {
+ public:
+  explicit FakeNode(uint16_t port) : port_(port) {}
+  ~FakeNode() override {
+    for (auto& task_thread : task_threads_) {
+      task_thread.join();
+    }
+  }
+
+  grpc::Status Send(grpc::ServerContext* context,
+                    grpc::ServerReader<rpc::TaskRequest>* reader,
+                    rpc::TaskResponse* response) override {
+    rpc::TaskRequest request;
+    std::string key;
+    std::string role;
+    std::string data;
+    bool recv_meta_info{false};
+    while (reader->Read(&request)) {
+      if (!recv_meta_info) {
+        role = request.role();
+        key = QueueKey(request.task_info(), role);
+        recv_meta_info = true;
+      }
+      data.append(request.data());
+    }
+    {
+      std::lock_guard<std::mutex> lck(mtx_);
+      received_[role] = data;
+      queues_[key].push_back(std::move(data));
+    }
+    cv_.notify_all();
+    response->set_ret_code(rpc::retcode::SUCCESS);
+    return grpc::Status::OK;
+  }
+
+  grpc::Status ForwardRecv(grpc::ServerContext* context,
+                           const rpc::TaskRequest* request,
+                           grpc::ServerWriter<rpc::TaskRequest>* writer)
+                           override {
+    std::string data;
+    {
+      std::unique_lock<std::mutex> lck(mtx_);
+      auto& queue = queues_[QueueKey(request->task_info(), request->role())];
+      while (queue.empty()) {
+        if (context->IsCancelled()) {
+          return grpc::Status::CANCELLED;
+        }
+        cv_.wait_for(lck, std::chrono::milliseconds(100));
+      }
+      data = std::move(queue.front());
+      queue.pop_front();
+    }
+    rpc::TaskRequest response;
+    response.mutable_task_info()->CopyFrom(request->task_info());
+    response.set_role(request->role());
+    response.set_data_len(data.size());
+    response.set_data(std::move(data));
+    writer->Write(response);
+    return grpc::Status::OK;
+  }
+
+  grpc::Status ExecuteTask(grpc::ServerContext* context,
+                           const rpc::PushTaskRequest* request,
+                           rpc::PushTaskReply* reply) override {
+    // same as the node, the auxiliary server receives from its own proxy
+    auto task_request = std::make_shared<rpc::PushTaskRequest>(*request);
+    auto auxiliary_server =
+        task_request->mutable_task()->mutable_auxiliary_server();
+    (*auxiliary_server)[PROXY_NODE] = MakeNode(port_, 0);
+    std::lock_guard<std::mutex> lck(mtx_);
+    executed_.push_back(task_request->task().task_info());
+    task_threads_.emplace_back([this, task_request]() {
+      const auto& task_config = task_request->task();
+      MPCTask task(task_config.code(), &task_config);
+      int ret = task.execute();
+      {
+        std::lock_guard<std::mutex> lck(mtx_);
+        task_results_.push_back(ret);
+      }
+      cv_.notify_all();
+    });
+    return grpc::Status::OK;
+  }
+
+  grpc::Status StopTask(grpc::ServerContext* context,
+                        const rpc::TaskContext* request,
+                        rpc::Empty* response) override {
+    return grpc::Status::OK;
+  }
+
+  grpc::Status CompleteStatus(grpc::ServerContext* context,
+                              const rpc::CompleteStatusRequest* request,
+                              rpc::Empty* response) override {
+    return grpc::Status::OK;
+  }
+
+  /**
+   * wait until every task started by ExecuteTask has returned
+  */
+  bool WaitForTasks(std::chrono::seconds timeout) {
+    std::unique_lock<std::mutex> lck(mtx_);
+    return cv_.wait_for(lck, timeout, [this]() {
+      return !executed_.empty() && task_results_.size() == executed_.size();
+    });
+  }
+
+  std::vector<rpc::TaskContext> Executed() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return executed_;
+  }
+
+  std::vector<int> TaskResults() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return task_results_;
+  }
+
+  bool Received(const std::string& role, std::string* data) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    auto it = received_.find(role);
+    if (it == received_.end()) {
+      return false;
+    }
+    *data = it->second;
+    return true;
+  }
+
+ private:
+  // tasks are distinguished by request id like the workers of the node
+  static std::string QueueKey(const rpc::TaskContext& task_info,
+                              const std::string& role) {
+    return task_info.request_id() + ":" + role;
+  }
+
+  uint16_t port_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::map<std::string, std::deque<std::string>> queues_;
+  std::map<std::string, std::string> received_;
+  std::vector<rpc::TaskContext> executed_;
+  std::vector<int> task_results_;
+  std::vector<std::thread> task_threads_;
+};
+
+std::unique_ptr<grpc::Server> StartNode(FakeNode* node, uint16_t port) {
+  grpc::ServerBuilder builder;
+  builder.AddListeningPort("127.0.0.1:" + std::to_string(port),
+                           grpc::InsecureServerCredentials());
+  builder.RegisterService(node);
+  return builder.BuildAndStart();
+}
+
+void StopNode(grpc::Server* server) {
+  // let the sends of peers in flight finish
+  server->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(1));
+}
+
+/**
+ * two batches of a party, op types are interleaved,
+ * so that every batch is grouped into several ops
+*/
+std::vector<Batch> MakeBatches(int party_id) {
+  std::vector<Batch> batches(2);
+  for (int i = 0; i < 4; i++) {
+    double x = party_id == 0 ? 1.5 * i - 2 : 3.25 - 0.75 * i;
+    batches[0].push_back({rpc::Algorithm::MAX, x});
+    batches[0].push_back({rpc::Algorithm::SUM, 10 * x + party_id});
+    batches[0].push_back({rpc::Algorithm::MIN, -x});
+  }
+  for (int i = 0; i < 3; i++) {
+    double x = party_id == 0 ? 100.5 + i : -20.25 * i;
+    batches[1].push_back({rpc::Algorithm::AVG, x, 10 + i + 5 * party_id});
+    batches[1].push_back({rpc::Algorithm::MIN, x / 4});
+    batches[1].push_back({rpc::Algorithm::MAX, 1e9 + x});
+  }
+  return batches;
+}
+
+double Plaintext(const StatisticsRequest& req_0,
+                 const StatisticsRequest& req_1) {
+  switch (req_0.op_type) {
+  case rpc::Algorithm::MAX:
+    return std::max(req_0.value, req_1.value);
+  case rpc::Algorithm::MIN:
+    return std::min(req_0.value, req_1.value);
+  case rpc::Algorithm::SUM:
+    return req_0.value + req_1.value;
+  case rpc::Algorithm::AVG:
+    return (req_0.value + req_1.value) / (req_0.rows + req_1.rows);
+  default:
+    return 0;
+  }
+}
+
+bool MatchPlaintext(const std::vector<std::vector<double>>& results) {
+  auto batches_0 = MakeBatches(0);
+  auto batches_1 = MakeBatches(1);
+  if (results.size() != batches_0.size()) {
+    LOG(ERROR) << "results of " << results.size() << " batches, "
+               << "expected: " << batches_0.size();
+    return false;
+  }
+  bool match{true};
+  for (size_t i = 0; i < batches_0.size(); i++) {
+    if (results[i].size() != batches_0[i].size()) {
+      LOG(ERROR) << "batch: " << i << " size: " << results[i].size() << ", "
+                 << "expected: " << batches_0[i].size();
+      match = false;
+      continue;
+    }
+    for (size_t j = 0; j < batches_0[i].size(); j++) {
+      double expected = Plaintext(batches_0[i][j], batches_1[i][j]);
+      if (std::abs(results[i][j] - expected) >
+          1e-3 * std::abs(expected) + 1e-2) {
+        LOG(ERROR) << "batch: " << i << " index: " << j << " "
+                   << "result: " << results[i][j] << " expected: " << expected;
+        match = false;
+      }
+    }
+  }
+  return match;
+}
+
+/**
+ * open a session, run every batch in it and close it,
+ * the node of the party must be started before
+*/
+retcode RunSession(int party_id, std::vector<std::vector<double>>* results) {
+  std::string party_name = "PARTY" + std::to_string(party_id);
+  MPCExecutor executor(MakeTaskRequest(party_name, kNodePort[2],
+                                       kNodePort[party_id]));
+  auto ret = executor.OpenSession();
+  if (ret != retcode::SUCCESS) {
+    LOG(ERROR) << party_name << " open session failed";
+    return retcode::FAIL;
+  }
+  for (const auto& batch : MakeBatches(party_id)) {
+    std::vector<double> result;
+    ret = executor.ExecuteBatch(batch, &result);
+    if (ret != retcode::SUCCESS) {
+      LOG(ERROR) << party_name << " execute batch failed";
+      return retcode::FAIL;
+    }
+    results->push_back(std::move(result));
+  }
+  ret = executor.CloseSession();
+  if (ret != retcode::SUCCESS || executor.InSession()) {
+    LOG(ERROR) << party_name << " close session failed";
+    return retcode::FAIL;
+  }
+  return retcode::SUCCESS;
+}
+
+/**
+ * the auxiliary server is invited once and serves both batches,
+ * its session is closed by the empty plan after the last batch
+*/
+bool ServeSessionOfAuxiliaryServer() {
+  FakeNode node(kNodePort[2]);
+  auto server = StartNode(&node, kNodePort[2]);
+  if (server == nullptr) {
+    return false;
+  }
+  bool served = node.WaitForTasks(std::chrono::seconds(120));
+  StopNode(server.get());
+  if (!served) {
+    LOG(ERROR) << "session of auxiliary server is not closed";
+    return false;
+  }
+  auto executed = node.Executed();
+  auto task_results = node.TaskResults();
+  if (executed.size() != 1 || task_results[0] != 0) {
+    LOG(ERROR) << "auxiliary server is invited " << executed.size() << " "
+               << "times, first task returns: " << task_results[0];
+    return false;
+  }
+  std::vector<size_t> plan_size;
+  std::string plan_str;
+  while (node.Received(MPCTask::SessionPlanKey(executed[0], plan_size.size()),
+                       &plan_str)) {
+    rpc::ParamValue pv;
+    if (!pv.ParseFromString(plan_str)) {
+      return false;
+    }
+    plan_size.push_back(pv.value_int64_array().value_int64_array_size());
+  }
+  // three ops for each batch, then the empty plan
+  std::vector<size_t> expected_plan_size{6, 6, 0};
+  if (plan_size != expected_plan_size) {
+    LOG(ERROR) << "auxiliary server received " << plan_size.size() << " plans";
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+TEST(MPCExecutorTest, BatchesInOneSession) {
+  // fork before any grpc object is created
+  pid_t pid_aux = fork();
+  if (pid_aux == 0) {
+    _exit(ServeSessionOfAuxiliaryServer() ? 0 : 1);
+  }
+  pid_t pid_1 = fork();
+  if (pid_1 == 0) {
+    FakeNode node(kNodePort[1]);
+    auto server = StartNode(&node, kNodePort[1]);
+    std::vector<std::vector<double>> results;
+    bool succ = server != nullptr &&
+                RunSession(1, &results) == retcode::SUCCESS &&
+                MatchPlaintext(results);
+    if (server != nullptr) {
+      StopNode(server.get());
+    }
+    _exit(succ ? 0 : 1);
+  }
+
+  // wait for the nodes of the other parties
+  sleep(1);
+  FakeNode node(kNodePort[0]);
+  auto server = StartNode(&node, kNodePort[0]);
+  ASSERT_NE(server, nullptr);
+  std::vector<std::vector<double>> results;
+  EXPECT_EQ(RunSession(0, &results), retcode::SUCCESS);
+  EXPECT_TRUE(MatchPlaintext(results));
+
+  int status{0};
+  waitpid(pid_1, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << "PARTY1";
+  waitpid(pid_aux, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+      << AUX_COMPUTE_NODE;
+  StopNode(server.get());
+}
+
+TEST(MPCExecutorTest, EmptyBatchReturnsWithoutCommunication) {
+  // auxiliary server is not reachable, any communication fails the test
+  for (const auto& party_name : {"PARTY0", "PARTY1"}) {
+    MPCExecutor executor(MakeTaskRequest(party_name, 1));
+    std::vector<double> result{1.0, 2.0};
+    EXPECT_EQ(executor.ExecuteBatch({}, &result), retcode::SUCCESS)
+        << party_name;
+    EXPECT_TRUE(result.empty()) << party_name;
+    EXPECT_FALSE(executor.InSession()) << party_name;
+  }
+}
+}  // namespace primihub::task
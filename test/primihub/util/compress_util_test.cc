@@ -0,0 +1,43 @@
+// Copyright [2023] <primihub.com>
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "src/primihub/util/compress_util.h"
+
+namespace primihub {
+TEST(CompressUtilTest, ZlibRoundTrip) {
+  std::string raw;
+  std::mt19937 gen(1);
+  for (int i = 0; i < 100000; i++) {
+    raw.append(std::to_string(gen() % 1000)).append(",");
+  }
+  std::string compressed;
+  EXPECT_EQ(ZlibCompress(raw, &compressed), retcode::SUCCESS);
+  EXPECT_LT(compressed.size(), raw.size());
+  std::string uncompressed;
+  EXPECT_EQ(ZlibUncompress(compressed, raw.size(), &uncompressed),
+            retcode::SUCCESS);
+  EXPECT_EQ(uncompressed, raw);
+}
+
+TEST(CompressUtilTest, ZlibEmptyData) {
+  std::string compressed;
+  EXPECT_EQ(ZlibCompress("", &compressed), retcode::SUCCESS);
+  std::string uncompressed;
+  EXPECT_EQ(ZlibUncompress(compressed, 0, &uncompressed), retcode::SUCCESS);
+  EXPECT_TRUE(uncompressed.empty());
+}
+
+TEST(CompressUtilTest, ZlibRejectCorruptedData) {
+  std::string raw(4096, 'a');
+  std::string compressed;
+  EXPECT_EQ(ZlibCompress(raw, &compressed), retcode::SUCCESS);
+  compressed[compressed.size() / 2] ^= 0x5a;
+  std::string uncompressed;
+  EXPECT_EQ(ZlibUncompress(compressed, raw.size(), &uncompressed),
+            retcode::FAIL);
+  EXPECT_EQ(ZlibUncompress(compressed.substr(0, 4), raw.size(), &uncompressed),
+            retcode::FAIL);
+}
+}  // namespace primihub
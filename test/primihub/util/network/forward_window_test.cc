@@ -0,0 +1,161 @@
+// Copyright [2023] <primihub.com>
+#include <chrono>
+#include <future>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/primihub/util/network/forward_window.h"
+
+namespace primihub::network {
+namespace {
+constexpr auto kTimeout = std::chrono::milliseconds(1);
+}  // namespace
+
+TEST(ForwardWindowTest, StreamBrokenInTransfer) {
+  constexpr int kMessageNum = 1000;
+  ThreadSafeQueue<std::string> queue;
+  for (int i = 0; i < kMessageNum; i++) {
+    queue.push(std::to_string(i));
+  }
+  ForwardWindow window;
+  std::vector<std::string> received;
+  std::mt19937 gen(1);
+  int stream_num = 0;
+  while (received.size() < kMessageNum && stream_num < 10000) {
+    stream_num++;
+    auto stream_id = window.Restart(received.size());
+    // messages written on the stream before it breaks
+    std::vector<ForwardWindow::Message> written;
+    size_t write_num = gen() % 20 + 1;
+    for (size_t i = 0; i < write_num; i++) {
+      bool resent{false};
+      auto message = window.Next(stream_id, &queue, kTimeout, &resent);
+      if (message == nullptr) {
+        break;
+      }
+      written.push_back(message);
+    }
+    // receiver gets part of them, the rest is lost with the stream
+    size_t delivered = gen() % (written.size() + 1);
+    for (size_t i = 0; i < delivered; i++) {
+      received.push_back(*written[i]);
+      if (gen() % 4 == 0) {
+        window.Ack(received.size());
+      }
+    }
+  }
+  ASSERT_EQ(received.size(), kMessageNum);
+  for (int i = 0; i < kMessageNum; i++) {
+    EXPECT_EQ(received[i], std::to_string(i));
+  }
+  window.Ack(received.size());
+  EXPECT_EQ(window.UnackedNum(), 0);
+}
+
+TEST(ForwardWindowTest, ResendBeforeNewMessage) {
+  ThreadSafeQueue<std::string> queue;
+  for (int i = 0; i < 4; i++) {
+    queue.push(std::to_string(i));
+  }
+  ForwardWindow window;
+  auto stream_id = window.Restart(0);
+  bool resent{false};
+  for (int i = 0; i < 3; i++) {
+    auto message = window.Next(stream_id, &queue, kTimeout, &resent);
+    ASSERT_NE(message, nullptr);
+    EXPECT_FALSE(resent);
+  }
+  // receiver has got "0" only
+  stream_id = window.Restart(1);
+  for (auto expected : {"1", "2"}) {
+    auto message = window.Next(stream_id, &queue, kTimeout, &resent);
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(*message, expected);
+    EXPECT_TRUE(resent);
+  }
+  auto message = window.Next(stream_id, &queue, kTimeout, &resent);
+  ASSERT_NE(message, nullptr);
+  EXPECT_EQ(*message, "3");
+  EXPECT_FALSE(resent);
+  EXPECT_EQ(window.Next(stream_id, &queue, kTimeout, &resent), nullptr);
+}
+
+TEST(ForwardWindowTest, StaleStreamGetsNothing) {
+  ThreadSafeQueue<std::string> queue;
+  queue.push("0");
+  ForwardWindow window;
+  auto old_stream = window.Restart(0);
+  auto new_stream = window.Restart(0);
+  bool resent{false};
+  EXPECT_TRUE(window.IsStale(old_stream));
+  EXPECT_EQ(window.Next(old_stream, &queue, kTimeout, &resent), nullptr);
+  auto message = window.Next(new_stream, &queue, kTimeout, &resent);
+  ASSERT_NE(message, nullptr);
+  EXPECT_EQ(*message, "0");
+}
+
+TEST(ForwardWindowTest, NewReceiverAcksNothing) {
+  ThreadSafeQueue<std::string> queue;
+  queue.push("0");
+  queue.push("1");
+  ForwardWindow window;
+  auto stream_id = window.Restart(0);
+  bool resent{false};
+  window.Next(stream_id, &queue, kTimeout, &resent);
+  window.Ack(1);
+  window.Next(stream_id, &queue, kTimeout, &resent);
+  // a new channel counts from 0 again
+  stream_id = window.Restart(0);
+  EXPECT_EQ(window.UnackedNum(), 1);
+  auto message = window.Next(stream_id, &queue, kTimeout, &resent);
+  ASSERT_NE(message, nullptr);
+  EXPECT_EQ(*message, "1");
+  EXPECT_TRUE(resent);
+}
+
+TEST(ForwardWindowTest, WaitingStreamDoesNotBlockAck) {
+  ThreadSafeQueue<std::string> queue;
+  ForwardWindow window;
+  auto stream_id = window.Restart(0);
+  auto waiting = std::async(std::launch::async, [&]() {
+    bool resent{false};
+    return window.Next(stream_id, &queue, std::chrono::seconds(2), &resent);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto start = std::chrono::steady_clock::now();
+  window.Ack(0);
+  EXPECT_FALSE(window.IsStale(stream_id));
+  auto new_stream = window.Restart(0);
+  EXPECT_TRUE(window.IsStale(stream_id));
+  auto cost = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(cost, std::chrono::milliseconds(500));
+  queue.shutdown();
+  EXPECT_EQ(waiting.get(), nullptr);
+  EXPECT_FALSE(window.IsStale(new_stream));
+}
+
+TEST(ForwardWindowTest, MessagePoppedByStaleStreamIsNotLost) {
+  ThreadSafeQueue<std::string> queue;
+  ForwardWindow window;
+  auto old_stream = window.Restart(0);
+  auto waiting = std::async(std::launch::async, [&]() {
+    bool resent{false};
+    return window.Next(old_stream, &queue, std::chrono::seconds(2), &resent);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto new_stream = window.Restart(0);
+  queue.push("0");
+  // popped by the old stream which is stale now
+  EXPECT_EQ(waiting.get(), nullptr);
+  bool resent{true};
+  auto message = window.Next(new_stream, &queue, kTimeout, &resent);
+  ASSERT_NE(message, nullptr);
+  EXPECT_EQ(*message, "0");
+  // it was never written, so it is not a resent one
+  EXPECT_FALSE(resent);
+  EXPECT_EQ(window.Next(new_stream, &queue, kTimeout, &resent), nullptr);
+}
+}  // namespace primihub::network
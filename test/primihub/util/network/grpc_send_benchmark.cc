@@ -0,0 +1,102 @@
+// Copyright [2023] <primihub.com>
+// benchmark for splitting a large payload into TaskRequest packages
+// before: all packages are built into a vector before the first write
+// after: packages are built and written one by one by GrpcChannel
+// usage: grpc_send_benchmark <vector|stream> [payload_size_mb]
+// run each mode in its own process, peak RSS is reported per process
+#include <sys/resource.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "src/primihub/common/common.h"
+#include "src/primihub/util/util.h"
+#include "src/primihub/util/network/grpc_link_context.h"
+
+namespace primihub::network {
+/**
+ * stand-in for grpc stream writer,
+ * serialize each package like grpc does before it is put on the wire
+*/
+class CountingWriter {
+ public:
+  bool Write(const rpc::TaskRequest& request, grpc::WriteOptions options) {
+    request.SerializeToString(&wire_buf_);
+    written_bytes_ += wire_buf_.size();
+    return true;
+  }
+  size_t written_bytes() const {return written_bytes_;}
+
+ private:
+  std::string wire_buf_;
+  size_t written_bytes_{0};
+};
+
+// the original implementation which copy the whole payload before writing
+void BuildAllTaskRequest(const std::string& role, std::string_view data_sv,
+                         std::vector<rpc::TaskRequest>* send_pb_data) {
+  size_t sended_size = 0;
+  size_t max_package_size = LIMITED_PACKAGE_SIZE;
+  size_t total_length = data_sv.size();
+  do {
+    rpc::TaskRequest task_request;
+    task_request.set_role(role);
+    task_request.set_data_len(total_length);
+    auto data_ptr = task_request.mutable_data();
+    data_ptr->reserve(max_package_size);
+    size_t data_len = std::min(max_package_size, total_length - sended_size);
+    data_ptr->append(data_sv.data() + sended_size, data_len);
+    sended_size += data_len;
+    send_pb_data->emplace_back(std::move(task_request));
+  } while (sended_size < total_length);
+}
+
+double PeakRssMB() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;
+}
+}  // namespace primihub::network
+
+int main(int argc, char** argv) {
+  using namespace primihub::network;  // NOLINT
+  google::InitGoogleLogging(argv[0]);
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0]
+              << " <vector|stream> [payload_size_mb]" << std::endl;
+    return -1;
+  }
+  std::string mode = argv[1];
+  size_t payload_mb = argc > 2 ? std::stoul(argv[2]) : 1024;
+  std::string payload(payload_mb * 1024 * 1024, 'a');
+  double base_rss_mb = PeakRssMB();
+
+  CountingWriter writer;
+  primihub::SCopedTimer timer;
+  if (mode == "vector") {
+    std::vector<rpc::TaskRequest> send_requests;
+    BuildAllTaskRequest("default", payload, &send_requests);
+    for (const auto& request : send_requests) {
+      writer.Write(request, grpc::WriteOptions());
+    }
+  } else {
+    GrpcLinkContext link_ctx;
+    primihub::Node node("127.0.0.1", 50050, false);
+    GrpcChannel channel(node, &link_ctx);
+    channel.WriteTaskRequest("default", payload, &writer);
+  }
+  auto time_cost_ms = std::max<double>(timer.timeElapse(), 1);
+  double mb_per_second = payload_mb * 1000.0 / time_cost_ms;
+  std::cout << "mode: " << mode << " "
+            << "payload(MB): " << payload_mb << " "
+            << "written(MB): " << writer.written_bytes() / (1024.0 * 1024) << " "
+            << "time cost(ms): " << time_cost_ms << " "
+            << "throughput(MB/s): " << mb_per_second << " "
+            << "extra peak RSS(MB): " << PeakRssMB() - base_rss_mb
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,137 @@
+// Copyright [2023] <primihub.com>
+// round trip latency of 1KB messages through the async send/recv pattern
+// used by TaskMessagePassInterface
+// thread: one detached thread is created for each async operation
+// executor: operations are posted to the shared IoExecutor strands
+// usage: io_executor_benchmark <thread|executor> [round_trips] [msg_size]
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/primihub/util/network/io_executor.h"
+#include "src/primihub/util/threadsafe_queue.h"
+
+namespace primihub::network {
+using Callback = std::function<void(std::string)>;
+
+/**
+ * in memory peer link, recv blocks until the peer sends like forwardRecv
+*/
+class MockPipe {
+ public:
+  MockPipe(bool use_executor, ThreadSafeQueue<std::string>* send_queue,
+           ThreadSafeQueue<std::string>* recv_queue)
+      : use_executor_(use_executor),
+        send_queue_(send_queue), recv_queue_(recv_queue) {
+    if (use_executor_) {
+      send_strand_ = IoExecutor::Global().NewStrand();
+      recv_strand_ = IoExecutor::Global().NewStrand(true);
+    }
+  }
+
+  void async_send(std::string data, std::function<void()> fn) {
+    auto op = [this, data = std::move(data), fn = std::move(fn)]() mutable {
+      send_queue_->push(std::move(data));
+      fn();
+    };
+    if (use_executor_) {
+      IoExecutor::Global().Post(send_strand_,
+          [op = std::move(op)](bool cancelled) mutable { op(); });
+    } else {
+      std::thread(std::move(op)).detach();
+    }
+  }
+
+  void async_recv(Callback fn) {
+    auto op = [this, fn = std::move(fn)]() {
+      std::string data;
+      recv_queue_->wait_and_pop(data);
+      fn(std::move(data));
+    };
+    if (use_executor_) {
+      IoExecutor::Global().Post(recv_strand_,
+          [op = std::move(op)](bool cancelled) { op(); });
+    } else {
+      std::thread(std::move(op)).detach();
+    }
+  }
+
+ private:
+  bool use_executor_{false};
+  IoExecutor::StrandId send_strand_{0};
+  IoExecutor::StrandId recv_strand_{0};
+  ThreadSafeQueue<std::string>* send_queue_{nullptr};
+  ThreadSafeQueue<std::string>* recv_queue_{nullptr};
+};
+
+int Run(bool use_executor, size_t round_trips, size_t msg_size) {
+  ThreadSafeQueue<std::string> client_to_server;
+  ThreadSafeQueue<std::string> server_to_client;
+  MockPipe client(use_executor, &client_to_server, &server_to_client);
+  MockPipe server(use_executor, &server_to_client, &client_to_server);
+  std::string payload(msg_size, 'a');
+  std::vector<double> latency_us;
+  latency_us.reserve(round_trips);
+  auto total_start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < round_trips; i++) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::promise<void> done;
+    // server echoes the message back
+    server.async_recv([&server](std::string data) {
+      server.async_send(std::move(data), []() {});
+    });
+    client.async_send(payload, []() {});
+    client.async_recv([&done](std::string data) { done.set_value(); });
+    done.get_future().wait();
+    auto end = std::chrono::high_resolution_clock::now();
+    latency_us.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  auto total_end = std::chrono::high_resolution_clock::now();
+  double total_ms =
+      std::chrono::duration<double, std::milli>(total_end - total_start).count();
+  std::sort(latency_us.begin(), latency_us.end());
+  double sum = 0;
+  for (auto v : latency_us) {
+    sum += v;
+  }
+  auto percentile = [&](double p) {
+    size_t idx = static_cast<size_t>(p * (latency_us.size() - 1));
+    return latency_us[idx];
+  };
+  std::cout << "mode: " << (use_executor ? "executor" : "thread") << " "
+            << "msg size: " << msg_size << " "
+            << "round trips: " << round_trips << "\n"
+            << "avg(us): " << sum / latency_us.size() << " "
+            << "p50(us): " << percentile(0.5) << " "
+            << "p99(us): " << percentile(0.99) << " "
+            << "round trips/s: " << round_trips * 1000.0 / total_ms
+            << std::endl;
+  if (use_executor) {
+    std::cout << "io executor threads: "
+              << IoExecutor::Global().ThreadNum() << std::endl;
+  }
+  return 0;
+}
+}  // namespace primihub::network
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0]
+              << " <thread|executor> [round_trips] [msg_size]" << std::endl;
+    return -1;
+  }
+  std::string mode = argv[1];
+  size_t round_trips = argc > 2 ? std::stoul(argv[2]) : 10000;
+  size_t msg_size = argc > 3 ? std::stoul(argv[3]) : 1024;
+  if (round_trips == 0) {
+    std::cerr << "round_trips must be positive" << std::endl;
+    return -1;
+  }
+  return primihub::network::Run(mode == "executor", round_trips, msg_size);
+}
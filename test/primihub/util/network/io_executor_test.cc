@@ -0,0 +1,151 @@
+// Copyright [2023] <primihub.com>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/primihub/util/network/io_executor.h"
+
+namespace primihub::network {
+TEST(IoExecutorTest, KeepOrderInStrand) {
+  IoExecutor executor(4);
+  std::vector<IoExecutor::StrandId> strands;
+  for (int i = 0; i < 4; i++) {
+    strands.push_back(executor.NewStrand());
+  }
+  std::mutex mtx;
+  std::vector<std::vector<int>> result(strands.size());
+  std::atomic<int> finished{0};
+  for (int i = 0; i < 1000; i++) {
+    for (size_t s = 0; s < strands.size(); s++) {
+      executor.Post(strands[s], [&, s, i](bool cancelled) {
+        std::lock_guard<std::mutex> lck(mtx);
+        result[s].push_back(i);
+        finished++;
+      });
+    }
+  }
+  while (finished.load() < 4000) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  for (auto& seq : result) {
+    ASSERT_EQ(seq.size(), 1000);
+    for (int i = 0; i < 1000; i++) {
+      EXPECT_EQ(seq[i], i);
+    }
+  }
+  EXPECT_LE(executor.ThreadNum(), 4);
+}
+
+TEST(IoExecutorTest, BlockedStrandDoesNotBlockOthers) {
+  IoExecutor executor(4);
+  auto recv_strand = executor.NewStrand();
+  auto send_strand = executor.NewStrand();
+  std::promise<void> data_ready;
+  auto data_fut = data_ready.get_future();
+  std::promise<void> recv_done;
+  // recv blocks until the send on the other strand is run
+  executor.Post(recv_strand, [&](bool cancelled) {
+    data_fut.wait();
+    recv_done.set_value();
+  });
+  executor.Post(send_strand, [&](bool cancelled) { data_ready.set_value(); });
+  auto status = recv_done.get_future().wait_for(std::chrono::seconds(5));
+  EXPECT_EQ(status, std::future_status::ready);
+}
+
+TEST(IoExecutorTest, BlockedRecvMoreThanMaxThreadNum) {
+  // more recvs are blocked than the executor has bounded workers,
+  // the sends they wait for must still be run
+  constexpr size_t kMaxThreadNum = 2;
+  constexpr int kChannelNum = 16;
+  IoExecutor executor(kMaxThreadNum);
+  std::vector<std::promise<void>> data_ready(kChannelNum);
+  std::vector<std::promise<void>> recv_done(kChannelNum);
+  for (int i = 0; i < kChannelNum; i++) {
+    auto recv_strand = executor.NewStrand(true);
+    auto data_fut = data_ready[i].get_future().share();
+    executor.Post(recv_strand, [&, i, data_fut](bool cancelled) {
+      data_fut.wait();
+      recv_done[i].set_value();
+    });
+  }
+  for (int i = 0; i < kChannelNum; i++) {
+    auto send_strand = executor.NewStrand();
+    executor.Post(send_strand,
+                  [&, i](bool cancelled) { data_ready[i].set_value(); });
+  }
+  for (int i = 0; i < kChannelNum; i++) {
+    auto status = recv_done[i].get_future().wait_for(std::chrono::seconds(5));
+    ASSERT_EQ(status, std::future_status::ready);
+  }
+  EXPECT_LE(executor.BoundedThreadNum(), kMaxThreadNum);
+}
+
+TEST(IoExecutorTest, CancelQueuedTask) {
+  IoExecutor executor(2);
+  auto strand = executor.NewStrand();
+  std::promise<void> release;
+  auto release_fut = release.get_future().share();
+  std::atomic<int> run_num{0};
+  std::atomic<int> cancel_num{0};
+  std::promise<void> started;
+  executor.Post(strand, [&, release_fut](bool cancelled) {
+    started.set_value();
+    release_fut.wait();
+    run_num++;
+  });
+  started.get_future().wait();
+  for (int i = 0; i < 10; i++) {
+    executor.Post(strand, [&](bool cancelled) {
+      cancelled ? cancel_num++ : run_num++;
+    });
+  }
+  executor.CancelStrand(strand);
+  EXPECT_EQ(cancel_num.load(), 10);
+  release.set_value();
+  std::promise<void> done;
+  executor.Post(strand, [&](bool cancelled) { done.set_value(); });
+  done.get_future().wait();
+  EXPECT_EQ(run_num.load(), 1);
+}
+
+TEST(IoExecutorTest, CancelWaitsForRunningTask) {
+  IoExecutor executor(2);
+  auto strand = executor.NewStrand(true);
+  std::atomic<bool> finished{false};
+  std::promise<void> started;
+  executor.Post(strand, [&](bool cancelled) {
+    started.set_value();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    finished = true;
+  });
+  started.get_future().wait();
+  executor.CancelStrand(strand, /*wait=*/true);
+  EXPECT_TRUE(finished.load());
+}
+
+TEST(IoExecutorTest, CancelFromRunningTaskDoesNotWait) {
+  IoExecutor executor(2);
+  auto strand = executor.NewStrand();
+  std::atomic<int> cancel_num{0};
+  std::promise<void> done;
+  executor.Post(strand, [&](bool cancelled) {
+    executor.Post(strand, [&](bool cancelled) {
+      if (cancelled) {
+        cancel_num++;
+      }
+    });
+    // the owner of the strand may be destroyed by its own task
+    executor.CancelStrand(strand, /*wait=*/true);
+    done.set_value();
+  });
+  auto done_fut = done.get_future();
+  ASSERT_EQ(done_fut.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  EXPECT_EQ(cancel_num.load(), 1);
+}
+}  // namespace primihub::network
@@ -0,0 +1,37 @@
+// Copyright [2023] <primihub.com>
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/primihub/util/thread_pool.h"
+
+namespace primihub {
+TEST(ThreadPoolTest, ResultKeepOrderOfSubmission) {
+  ThreadPool pool(4);
+  EXPECT_EQ(pool.size(), 4);
+  std::vector<std::future<int>> futs;
+  for (int i = 0; i < 100; i++) {
+    futs.push_back(pool.enqueue([](int x) { return x * x; }, i));
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(futs[i].get(), i * i);
+  }
+}
+
+TEST(ThreadPoolTest, FinishPendingTaskWhenDestroy) {
+  std::atomic<int> counter{0};
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < 1000; i++) {
+      pool.enqueue([&counter]() { counter++; });
+    }
+  }
+  EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(ThreadPoolTest, DefaultThreadNum) {
+  ThreadPool pool;
+  EXPECT_EQ(pool.size(), ThreadPool::DefaultThreadNum());
+  EXPECT_GE(pool.size(), 1);
+}
+}  // namespace primihub
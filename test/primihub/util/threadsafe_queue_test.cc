@@ -0,0 +1,61 @@
+// Copyright [2023] <primihub.com>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "src/primihub/util/threadsafe_queue.h"
+
+namespace primihub {
+TEST(BoundedThreadSafeQueueTest, KeepFifoOrder) {
+  BoundedThreadSafeQueue<int> queue(4);
+  std::thread producer([&]() {
+    for (int i = 0; i < 1000; i++) {
+      EXPECT_TRUE(queue.push(int(i)));
+    }
+  });
+  for (int i = 0; i < 1000; i++) {
+    int item = -1;
+    EXPECT_TRUE(queue.wait_and_pop(item));
+    EXPECT_EQ(item, i);
+    EXPECT_LE(queue.size(), queue.capacity());
+  }
+  producer.join();
+}
+
+TEST(BoundedThreadSafeQueueTest, PushBlockWhenFull) {
+  BoundedThreadSafeQueue<int> queue(2);
+  EXPECT_TRUE(queue.push(0));
+  EXPECT_TRUE(queue.push(1));
+  std::atomic<bool> pushed{false};
+  std::thread producer([&]() {
+    queue.push(2);
+    pushed.store(true);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(pushed.load());
+  int item = -1;
+  EXPECT_TRUE(queue.wait_and_pop(item));
+  producer.join();
+  EXPECT_TRUE(pushed.load());
+  EXPECT_EQ(queue.size(), 2);
+}
+
+TEST(BoundedThreadSafeQueueTest, ShutdownWakeUpBlockedThreads) {
+  BoundedThreadSafeQueue<int> full_queue(1);
+  EXPECT_TRUE(full_queue.push(0));
+  std::thread producer([&]() {
+    EXPECT_FALSE(full_queue.push(1));
+  });
+  BoundedThreadSafeQueue<int> empty_queue(1);
+  std::thread consumer([&]() {
+    int item = -1;
+    EXPECT_FALSE(empty_queue.wait_and_pop(item));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  full_queue.shutdown();
+  empty_queue.shutdown();
+  producer.join();
+  consumer.join();
+}
+}  // namespace primihub